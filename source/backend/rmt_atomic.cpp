@@ -17,6 +17,30 @@ uint64_t RmtThreadAtomicRead(volatile uint64_t* address)
     return InterlockedOr(address, 0);
 }
 
+int32_t RmtThreadAtomicLoad(volatile int32_t* address)
+{
+    RMT_STATIC_ASSERT(sizeof(LONG) == sizeof(int32_t));
+    return ReadAcquire((volatile LONG*)address);
+}
+
+int64_t RmtThreadAtomicLoad64(volatile int64_t* address)
+{
+    RMT_STATIC_ASSERT(sizeof(LONG64) == sizeof(int64_t));
+    return ReadAcquire64((volatile LONG64*)address);
+}
+
+void RmtThreadAtomicStore(volatile int32_t* address, int32_t value)
+{
+    RMT_STATIC_ASSERT(sizeof(LONG) == sizeof(int32_t));
+    WriteRelease((volatile LONG*)address, (LONG)value);
+}
+
+void RmtThreadAtomicStore64(volatile int64_t* address, int64_t value)
+{
+    RMT_STATIC_ASSERT(sizeof(LONG64) == sizeof(int64_t));
+    WriteRelease64((volatile LONG64*)address, (LONG64)value);
+}
+
 uint64_t RmtThreadAtomicWrite(volatile uint64_t* address, uint64_t value)
 {
     return InterlockedExchange(address, value);
@@ -61,6 +85,26 @@ uint64_t         RmtThreadAtomicRead(volatile uint64_t* address)
     return __atomic_or_fetch(address, 0, memorder);
 }
 
+int32_t RmtThreadAtomicLoad(volatile int32_t* address)
+{
+    return __atomic_load_n(address, __ATOMIC_ACQUIRE);
+}
+
+int64_t RmtThreadAtomicLoad64(volatile int64_t* address)
+{
+    return __atomic_load_n(address, __ATOMIC_ACQUIRE);
+}
+
+void RmtThreadAtomicStore(volatile int32_t* address, int32_t value)
+{
+    __atomic_store_n(address, value, __ATOMIC_RELEASE);
+}
+
+void RmtThreadAtomicStore64(volatile int64_t* address, int64_t value)
+{
+    __atomic_store_n(address, value, __ATOMIC_RELEASE);
+}
+
 uint64_t RmtThreadAtomicWrite(volatile uint64_t* address, uint64_t value)
 {
     return __atomic_exchange_n(address, value, memorder);
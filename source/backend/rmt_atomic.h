@@ -20,6 +20,41 @@ extern "C" {
 ///
 uint64_t RmtThreadAtomicRead(volatile uint64_t* address);
 
+/// Atomically read a 32bit value from a specified address with acquire ordering, without writing to it.
+///
+/// Unlike <c><i>RmtThreadAtomicRead</i></c> this doesn't take ownership of the cache line, so it is
+/// cheap enough to poll with.
+///
+/// @param [in] address                     The address of the 32bit value to read.
+///
+/// @returns
+/// The 32bit value at the specified address.
+///
+int32_t RmtThreadAtomicLoad(volatile int32_t* address);
+
+/// Atomically read a 64bit value from a specified address with acquire ordering, without writing to it.
+///
+/// @param [in] address                     The address of the 64bit value to read.
+///
+/// @returns
+/// The 64bit value at the specified address.
+///
+int64_t RmtThreadAtomicLoad64(volatile int64_t* address);
+
+/// Atomically write a 32bit value to a specified address with release ordering.
+///
+/// @param [in] address                     The address of the 32bit value to write.
+/// @param [in] value                       The 32bit value to write to <c><i>address</i></c>.
+///
+void RmtThreadAtomicStore(volatile int32_t* address, int32_t value);
+
+/// Atomically write a 64bit value to a specified address with release ordering.
+///
+/// @param [in] address                     The address of the 64bit value to write.
+/// @param [in] value                       The 64bit value to write to <c><i>address</i></c>.
+///
+void RmtThreadAtomicStore64(volatile int64_t* address, int64_t value);
+
 /// Atomically write a 64bit value from a specified address.
 ///
 /// @param [in] address                     The address of the 64bit value to write.
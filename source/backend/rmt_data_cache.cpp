@@ -0,0 +1,1515 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \brief  Implementation of the cache file which keeps generated snapshots and timelines between sessions.
+//=============================================================================
+
+#include "rmt_data_cache.h"
+#include "rmt_data_set.h"
+#include "rmt_data_snapshot.h"
+#include "rmt_progress.h"
+#include <rmt_assert.h>
+#include <rmt_util.h>
+#include <stdio.h>   // for snprintf()
+#include <string.h>  // for memcpy(), memset()
+#include <stdlib.h>  // for malloc(), free()
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>  // for _chsize_s()
+#else
+#include "linux/safe_crt.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // #ifdef _WIN32
+
+// the four characters at the start of every cache file.
+#define CACHE_FILE_MAGIC (0x43564d52)
+
+// the alignment of the entries in the cache file, and the sections inside each entry.
+#define CACHE_ALIGNMENT (16)
+
+// the number of bytes of a section read or written between checks for cancellation.
+#define CACHE_CHUNK_SIZE (1024 * 1024)
+
+// the header at the start of a cache file, identifying the RMT streams the entries were generated
+// from and the layout of the structures they were written with.
+typedef struct CacheFileHeader
+{
+    uint32_t magic;                           // CACHE_FILE_MAGIC.
+    uint32_t version;                         // RMT_DATA_CACHE_VERSION.
+    uint32_t pointer_size;                    // the size of a pointer.
+    uint32_t snapshot_size;                   // the size of a RmtDataSnapshot structure.
+    uint32_t timeline_size;                   // the size of a RmtDataTimeline structure.
+    uint32_t virtual_allocation_size;         // the size of a RmtVirtualAllocation structure.
+    uint32_t resource_size;                   // the size of a RmtResource structure.
+    int32_t  stream_count;                    // the number of RMT streams in the trace.
+    uint64_t stream_size;                     // the total size of the RMT streams, in bytes.
+    uint64_t maximum_timestamp;               // the last timestamp in the RMT streams.
+    uint64_t target_process_id;               // the process the trace was captured for.
+    uint32_t cpu_frequency;                   // the frequency of the timestamps.
+    int32_t  max_virtual_allocation_count;    // the data profile the snapshot buffers are sized from.
+    int32_t  max_concurrent_resources;        // the data profile the snapshot buffers are sized from.
+    int32_t  total_virtual_allocation_count;  // the data profile the snapshot buffers are sized from.
+} CacheFileHeader;
+
+// the types of entry in a cache file.
+typedef enum CacheEntryType
+{
+    kCacheEntryTypeSnapshot = 1,  // a RmtDataSnapshot, keyed by the timestamp of its snapshot point.
+    kCacheEntryTypeTimeline = 2,  // a RmtDataTimeline, keyed by its timeline type.
+} CacheEntryType;
+
+// the header at the start of each entry in a cache file. Entries are only ever appended, so the header
+// of an entry which wasn't completely written claims more bytes than are left in the file.
+typedef struct CacheEntryHeader
+{
+    uint32_t type;      // the CacheEntryType of the entry.
+    uint32_t reserved;  // padding, always 0.
+    uint64_t key;       // the value the entry is found by.
+    uint64_t size;      // the size of the entry in bytes, including this header.
+} CacheEntryHeader;
+
+// a range of memory, either in the process or in a cache entry.
+typedef struct CacheSection
+{
+    uint64_t base;  // the address of the memory, or the offset of the section from the start of the entry.
+    uint64_t size;  // the size of the memory, in bytes.
+} CacheSection;
+
+// the sections of a snapshot entry. The lists are sized for the whole trace, so only the parts of their
+// arrays in use are written, and the arrays are laid out in buffers of the full size again when read.
+typedef enum CacheSnapshotSection
+{
+    kCacheSnapshotSectionAllocationIntervals,   // the intervals in the allocation tree, each written after its parent.
+    kCacheSnapshotSectionAllocationDetails,     // the allocation details, up to the last one pointed to.
+    kCacheSnapshotSectionResourceConnectivity,  // the resource pointers of the allocations, up to the last one used.
+    kCacheSnapshotSectionUnboundMemoryRegions,  // the unbound memory regions of the allocations, up to the last one used.
+    kCacheSnapshotSectionResources,             // the resources in the resource list.
+    kCacheSnapshotSectionResourceDetails,       // the name and description of each resource, in resource order.
+    kCacheSnapshotSectionResourceIdNodes,       // the node of each resource in the resource ID tree, in resource order.
+    kCacheSnapshotSectionBackingStorage,        // the backing storage of each resource.
+    kCacheSnapshotSectionPageDirectoryLevel1,   // the level 1 page directories used by the page table.
+    kCacheSnapshotSectionPageDirectoryLevel2,   // the level 2 page directories used by the page table.
+    kCacheSnapshotSectionPageDirectoryLevel3,   // the level 3 page directories used by the page table.
+
+    // add above this.
+    kCacheSnapshotSectionCount
+} CacheSnapshotSection;
+
+// an entry holding a snapshot. Every pointer in the lists, the page table and the sections is written
+// as an offset from the start of the entry, or 0 for NULL.
+typedef struct CacheSnapshotEntry
+{
+    CacheEntryHeader         header;                                                 // the entry header.
+    RmtGpuAddress            minimum_virtual_address;                                // copied from the snapshot.
+    RmtGpuAddress            maximum_virtual_address;                                // copied from the snapshot.
+    uint64_t                 minimum_allocation_timestamp;                           // copied from the snapshot.
+    uint64_t                 maximum_allocation_timestamp;                           // copied from the snapshot.
+    uint64_t                 minimum_resource_size_in_bytes;                         // copied from the snapshot.
+    uint64_t                 maximum_resource_size_in_bytes;                         // copied from the snapshot.
+    uint64_t                 maximum_physical_memory_in_bytes;                       // copied from the snapshot.
+    RmtVirtualAllocationList virtual_allocation_list;                                // the virtual allocation list.
+    RmtResourceList          resource_list;                                          // the resource list.
+    RmtProcessMap            process_map;                                            // copied from the snapshot.
+    RmtSnapshotAggregates    aggregates;                                             // copied from the snapshot.
+    RmtPageDirectoryLevel1*  page_directory_level0[RMT_PAGE_DIRECTORY_LEVEL_0_SIZE];  // the root of the page table.
+    uint64_t                 mapped_per_heap[kRmtHeapTypeCount];                     // copied from the page table.
+    RmtSegmentInfo           segment_info[RMT_MAXIMUM_SEGMENTS];                     // copied from the page table.
+    int32_t                  segment_info_count;                                     // copied from the page table.
+    uint64_t                 target_process_id;                                      // copied from the page table.
+    int32_t                  region_stack_count;                                     // the size of the region stack to allocate.
+    int32_t                  resource_backing_storage_count;                         // the number of resources in the backing storage section.
+    CacheSection             sections[kCacheSnapshotSectionCount];                   // where each section is in the entry.
+} CacheSnapshotEntry;
+
+// a value repeated a number of times in a row in a timeline.
+typedef struct CacheTimelineRun
+{
+    uint64_t value;  // the value.
+    uint64_t count;  // the number of times it is repeated.
+} CacheTimelineRun;
+
+// an entry holding a timeline. The values of every series are written one series after the other as
+// runs of repeated values, and the pointers to them aren't written.
+typedef struct CacheTimelineEntry
+{
+    CacheEntryHeader header;    // the entry header.
+    RmtDataTimeline  timeline;  // the timeline.
+    CacheSection     runs;      // where the runs of values are in the entry.
+} CacheTimelineEntry;
+
+// the pointers are translated from the memory in one set of sections to the same place in another.
+typedef struct CacheTranslation
+{
+    const CacheSection* from;           // the sections the pointers point in to.
+    const CacheSection* to;             // the sections the pointers should point in to.
+    int32_t             section_count;  // the number of sections in each set.
+} CacheTranslation;
+
+// a cache file mapped in to memory for reading.
+typedef struct CacheFileMapping
+{
+    const uint8_t* data;  // the start of the mapped file.
+    uint64_t       size;  // the size of the file, in bytes.
+#ifdef _WIN32
+    HANDLE file_handle;     // the handle of the file.
+    HANDLE mapping_handle;  // the handle of the file mapping.
+#endif  // #ifdef _WIN32
+} CacheFileMapping;
+
+// Helper function call the correct allocation function.
+static void* PerformAllocation(RmtDataSet* data_set, size_t size_in_bytes, size_t alignment)
+{
+    if (data_set->allocate_func == nullptr)
+    {
+        return malloc(size_in_bytes);
+    }
+
+    return (data_set->allocate_func)(size_in_bytes, alignment);
+}
+
+// Helper functo call the correct free function.
+static void PerformFree(RmtDataSet* data_set, void* pointer)
+{
+    if (data_set->free_func == nullptr)
+    {
+        return free(pointer);
+    }
+
+    return (data_set->free_func)(pointer);
+}
+
+// round a size up to the alignment of the cache file.
+static uint64_t AlignToCache(uint64_t size)
+{
+    return (size + (CACHE_ALIGNMENT - 1)) & ~((uint64_t)CACHE_ALIGNMENT - 1);
+}
+
+// get the path of the cache file, next to the RMV file.
+static void GetCacheFilePath(const RmtDataSet* data_set, char* out_path, size_t out_path_size)
+{
+    snprintf(out_path, out_path_size, "%.*s%s", RMT_MAXIMUM_FILE_PATH, data_set->file_path, RMT_DATA_CACHE_FILE_EXTENSION);
+}
+
+// fill in the header a valid cache file for a data set starts with.
+static void BuildFileHeader(const RmtDataSet* data_set, CacheFileHeader* out_header)
+{
+    memset(out_header, 0, sizeof(CacheFileHeader));
+    out_header->magic                   = CACHE_FILE_MAGIC;
+    out_header->version                 = RMT_DATA_CACHE_VERSION;
+    out_header->pointer_size            = sizeof(void*);
+    out_header->snapshot_size           = sizeof(RmtDataSnapshot);
+    out_header->timeline_size           = sizeof(RmtDataTimeline);
+    out_header->virtual_allocation_size = sizeof(RmtVirtualAllocation);
+    out_header->resource_size           = sizeof(RmtResource);
+    out_header->stream_count            = data_set->stream_count;
+    for (int32_t current_stream_index = 0; current_stream_index < data_set->stream_count; ++current_stream_index)
+    {
+        out_header->stream_size += data_set->streams[current_stream_index].stream_size;
+    }
+    out_header->maximum_timestamp              = data_set->maximum_timestamp;
+    out_header->target_process_id              = data_set->target_process_id;
+    out_header->cpu_frequency                  = data_set->cpu_frequency;
+    out_header->max_virtual_allocation_count   = data_set->data_profile.max_virtual_allocation_count;
+    out_header->max_concurrent_resources       = data_set->data_profile.max_concurrent_resources;
+    out_header->total_virtual_allocation_count = data_set->data_profile.total_virtual_allocation_count;
+}
+
+// map a cache file in to memory.
+static RmtErrorCode MapCacheFile(const char* path, CacheFileMapping* out_mapping)
+{
+    memset(out_mapping, 0, sizeof(CacheFileMapping));
+
+#ifdef _WIN32
+    out_mapping->file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    RMT_RETURN_ON_ERROR(out_mapping->file_handle != INVALID_HANDLE_VALUE, RMT_ERROR_FILE_NOT_OPEN);
+
+    LARGE_INTEGER file_size;
+    if ((GetFileSizeEx(out_mapping->file_handle, &file_size) == FALSE) || (file_size.QuadPart < (LONGLONG)sizeof(CacheFileHeader)))
+    {
+        CloseHandle(out_mapping->file_handle);
+        return RMT_ERROR_FILE_NOT_OPEN;
+    }
+
+    out_mapping->mapping_handle = CreateFileMappingA(out_mapping->file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (out_mapping->mapping_handle == NULL)
+    {
+        CloseHandle(out_mapping->file_handle);
+        return RMT_ERROR_FILE_NOT_OPEN;
+    }
+
+    out_mapping->data = (const uint8_t*)MapViewOfFile(out_mapping->mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (out_mapping->data == NULL)
+    {
+        CloseHandle(out_mapping->mapping_handle);
+        CloseHandle(out_mapping->file_handle);
+        return RMT_ERROR_FILE_NOT_OPEN;
+    }
+    out_mapping->size = (uint64_t)file_size.QuadPart;
+#else
+    const int file_descriptor = open(path, O_RDONLY);
+    RMT_RETURN_ON_ERROR(file_descriptor >= 0, RMT_ERROR_FILE_NOT_OPEN);
+
+    struct stat file_status;
+    if ((fstat(file_descriptor, &file_status) != 0) || (file_status.st_size < (off_t)sizeof(CacheFileHeader)))
+    {
+        close(file_descriptor);
+        return RMT_ERROR_FILE_NOT_OPEN;
+    }
+
+    // the mapping keeps the file open, so the descriptor isn't needed once it is made.
+    void* data = mmap(NULL, (size_t)file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+    RMT_RETURN_ON_ERROR(data != MAP_FAILED, RMT_ERROR_FILE_NOT_OPEN);
+
+    out_mapping->data = (const uint8_t*)data;
+    out_mapping->size = (uint64_t)file_status.st_size;
+#endif  // #ifdef _WIN32
+
+    return RMT_OK;
+}
+
+// unmap a cache file mapped with MapCacheFile.
+static void UnmapCacheFile(CacheFileMapping* mapping)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(mapping->data);
+    CloseHandle(mapping->mapping_handle);
+    CloseHandle(mapping->file_handle);
+#else
+    munmap((void*)mapping->data, (size_t)mapping->size);
+#endif  // #ifdef _WIN32
+
+    memset(mapping, 0, sizeof(CacheFileMapping));
+}
+
+// find an entry in a mapped cache file. Also finds where the complete entries in the file end, which is
+// where the next entry should be written.
+static RmtErrorCode FindEntry(const CacheFileMapping* mapping,
+                              const CacheFileHeader*  expected_header,
+                              CacheEntryType          type,
+                              uint64_t                key,
+                              const CacheEntryHeader** out_entry,
+                              uint64_t*                out_end_offset)
+{
+    *out_entry      = NULL;
+    *out_end_offset = 0;
+
+    // the whole cache is thrown away if it doesn't belong to this trace and version.
+    RMT_RETURN_ON_ERROR(memcmp(mapping->data, expected_header, sizeof(CacheFileHeader)) == 0, RMT_ERROR_FILE_NOT_OPEN);
+
+    uint64_t current_offset = AlignToCache(sizeof(CacheFileHeader));
+    while ((current_offset + sizeof(CacheEntryHeader)) <= mapping->size)
+    {
+        const CacheEntryHeader* current_entry = (const CacheEntryHeader*)(mapping->data + current_offset);
+        if ((current_entry->size < sizeof(CacheEntryHeader)) || (current_entry->size > (mapping->size - current_offset)))
+        {
+            break;
+        }
+
+        if ((current_entry->type == (uint32_t)type) && (current_entry->key == key) && (*out_entry == NULL))
+        {
+            *out_entry = current_entry;
+        }
+        current_offset += AlignToCache(current_entry->size);
+    }
+
+    *out_end_offset = current_offset;
+    return (*out_entry != NULL) ? RMT_OK : RMT_ERROR_INDEX_OUT_OF_RANGE;
+}
+
+// write zeros to a file to pad it to the alignment of the cache file.
+static bool WritePadding(FILE* file, uint64_t size)
+{
+    static const uint8_t kPadding[CACHE_ALIGNMENT] = {0};
+    const uint64_t       padding_size              = AlignToCache(size) - size;
+    return fwrite(kPadding, 1, (size_t)padding_size, file) == padding_size;
+}
+
+// write a section of an entry to a file, a chunk at a time so a cancelled operation stops part way through.
+static RmtErrorCode WriteSection(FILE* file, const void* data, uint64_t size, RmtProgress* progress)
+{
+    const uint8_t* current_data   = (const uint8_t*)data;
+    uint64_t       remaining_size = size;
+    while (remaining_size > 0)
+    {
+        RMT_RETURN_ON_ERROR(!RmtProgressIsCancelled(progress), RMT_ERROR_CANCELLED);
+
+        const size_t chunk_size = (size_t)RMT_MINIMUM(remaining_size, (uint64_t)CACHE_CHUNK_SIZE);
+        RMT_RETURN_ON_ERROR(fwrite(current_data, 1, chunk_size, file) == chunk_size, RMT_ERROR_FILE_NOT_OPEN);
+        current_data += chunk_size;
+        remaining_size -= chunk_size;
+    }
+
+    return WritePadding(file, size) ? RMT_OK : RMT_ERROR_FILE_NOT_OPEN;
+}
+
+// cut a cache file back to the end of its last complete entry.
+static bool TruncateCacheFile(FILE* file, uint64_t size)
+{
+    fflush(file);
+#ifdef _WIN32
+    return _chsize_s(_fileno(file), (__int64)size) == 0;
+#else
+    return ftruncate(fileno(file), (off_t)size) == 0;
+#endif  // #ifdef _WIN32
+}
+
+// append an entry to the cache file of a data set, starting a new cache file if the existing one is for
+// another trace or ends with an entry that wasn't completely written. The entry is written as the fixed
+// size structure at its start followed by each of its sections.
+static RmtErrorCode AppendEntry(RmtDataSet*         data_set,
+                                RmtProgress*        progress,
+                                const void*         entry,
+                                size_t              entry_size,
+                                const void* const*  section_data,
+                                const CacheSection* sections,
+                                int32_t             section_count)
+{
+    char cache_file_path[RMT_MAXIMUM_FILE_PATH + sizeof(RMT_DATA_CACHE_FILE_EXTENSION)];
+    GetCacheFilePath(data_set, cache_file_path, sizeof(cache_file_path));
+
+    CacheFileHeader expected_header;
+    BuildFileHeader(data_set, &expected_header);
+
+    const CacheEntryHeader* entry_header = (const CacheEntryHeader*)entry;
+
+    // check whether the entry is there already and the file can be appended to.
+    bool             append  = false;
+    CacheFileMapping mapping = {};
+    if (MapCacheFile(cache_file_path, &mapping) == RMT_OK)
+    {
+        const CacheEntryHeader* existing_entry = NULL;
+        uint64_t                end_offset     = 0;
+        const RmtErrorCode      error_code =
+            FindEntry(&mapping, &expected_header, (CacheEntryType)entry_header->type, entry_header->key, &existing_entry, &end_offset);
+        const uint64_t file_size = mapping.size;
+        UnmapCacheFile(&mapping);
+
+        if (error_code == RMT_OK)
+        {
+            return RMT_OK;
+        }
+
+        append = (error_code == RMT_ERROR_INDEX_OUT_OF_RANGE) && (end_offset == AlignToCache(file_size));
+    }
+
+    RMT_RETURN_ON_ERROR(!RmtProgressIsCancelled(progress), RMT_ERROR_CANCELLED);
+
+    FILE*         file     = NULL;
+    const errno_t error_no = fopen_s(&file, cache_file_path, append ? "ab" : "wb");
+    RMT_RETURN_ON_ERROR((file != NULL) && (error_no == 0), RMT_ERROR_FILE_NOT_OPEN);
+
+    bool written = true;
+    if (!append)
+    {
+        written = (fwrite(&expected_header, 1, sizeof(CacheFileHeader), file) == sizeof(CacheFileHeader)) && WritePadding(file, sizeof(CacheFileHeader));
+    }
+
+    // the file may end part way through a padded entry, so pad it before appending.
+    if (written && append)
+    {
+        fseek(file, 0, SEEK_END);
+        written = WritePadding(file, (uint64_t)ftell(file));
+    }
+
+    const uint64_t entry_offset = (uint64_t)ftell(file);
+    RmtErrorCode   error_code   = RMT_ERROR_FILE_NOT_OPEN;
+    if (written && (fwrite(entry, 1, entry_size, file) == entry_size) && WritePadding(file, entry_size))
+    {
+        error_code = RMT_OK;
+        for (int32_t current_section_index = 0; (error_code == RMT_OK) && (current_section_index < section_count); ++current_section_index)
+        {
+            error_code = WriteSection(file, section_data[current_section_index], sections[current_section_index].size, progress);
+        }
+    }
+
+    // drop a partly written entry, so the next entry is appended after the last complete one. If this
+    // fails, the partly written entry is found when the file is next read and the file is started again.
+    if (error_code != RMT_OK)
+    {
+        TruncateCacheFile(file, entry_offset);
+    }
+
+    fclose(file);
+    return error_code;
+}
+
+// copy a section of an entry out of the mapped file, a chunk at a time so a cancelled operation stops
+// part way through. The progress is the number of bytes of the entry copied so far.
+static RmtErrorCode ReadSection(const CacheEntryHeader* entry,
+                                const CacheSection*     section,
+                                void*                   out_data,
+                                RmtProgress*            progress,
+                                uint64_t*               bytes_read)
+{
+    const uint8_t* current_data   = (const uint8_t*)entry + section->base;
+    uint8_t*       current_output = (uint8_t*)out_data;
+    uint64_t       remaining_size = section->size;
+    while (remaining_size > 0)
+    {
+        RMT_RETURN_ON_ERROR(RmtProgressUpdate(progress, *bytes_read, entry->size, 0) == RMT_OK, RMT_ERROR_CANCELLED);
+
+        const size_t chunk_size = (size_t)RMT_MINIMUM(remaining_size, (uint64_t)CACHE_CHUNK_SIZE);
+        memcpy(current_output, current_data, chunk_size);
+        current_data += chunk_size;
+        current_output += chunk_size;
+        remaining_size -= chunk_size;
+        *bytes_read += chunk_size;
+    }
+
+    return RMT_OK;
+}
+
+// point a section at a range of memory in the process.
+static void SetSection(CacheSection* section, const void* base, uint64_t size)
+{
+    section->base = (uint64_t)(uintptr_t)base;
+    section->size = size;
+}
+
+// lay out the sections of an entry one after the other, after the structure at the start of the entry.
+static uint64_t LayoutSections(size_t entry_size, const CacheSection* memory_sections, CacheSection* out_entry_sections, int32_t section_count)
+{
+    uint64_t current_offset = AlignToCache(entry_size);
+    for (int32_t current_section_index = 0; current_section_index < section_count; ++current_section_index)
+    {
+        out_entry_sections[current_section_index].base = current_offset;
+        out_entry_sections[current_section_index].size = memory_sections[current_section_index].size;
+        current_offset += AlignToCache(memory_sections[current_section_index].size);
+    }
+    return current_offset;
+}
+
+// check the sections of an entry are inside it.
+static bool ValidateSections(const CacheEntryHeader* entry, const CacheSection* sections, int32_t section_count)
+{
+    for (int32_t current_section_index = 0; current_section_index < section_count; ++current_section_index)
+    {
+        const CacheSection* current_section = &sections[current_section_index];
+        if ((current_section->base % CACHE_ALIGNMENT) != 0 || (current_section->base > entry->size) ||
+            (current_section->size > (entry->size - current_section->base)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// translate a pointer stored in memory from one set of sections to the same place in the other set.
+// Pointers which aren't inside any of the sections are set to NULL. A pointer to the end of a section
+// is kept if no section holds the memory it points at, as it may point to an empty array at the end
+// of the part of a list that is written. The pointer may be of any type, so it is copied in and out
+// with memcpy() rather than read through a pointer of another type.
+static void TranslatePointer(const CacheTranslation* translation, void* pointer_address)
+{
+    uintptr_t value = 0;
+    memcpy(&value, pointer_address, sizeof(uintptr_t));
+
+    uintptr_t translated_value = 0;
+    for (int32_t current_pass = 0; (value != 0) && (translated_value == 0) && (current_pass < 2); ++current_pass)
+    {
+        for (int32_t current_section_index = 0; current_section_index < translation->section_count; ++current_section_index)
+        {
+            const CacheSection* from   = &translation->from[current_section_index];
+            const uint64_t      offset = (uint64_t)value - from->base;
+            if (((uint64_t)value >= from->base) && ((offset < from->size) || ((current_pass == 1) && (offset == from->size))))
+            {
+                translated_value = (uintptr_t)(translation->to[current_section_index].base + offset);
+                break;
+            }
+        }
+    }
+
+    memcpy(pointer_address, &translated_value, sizeof(uintptr_t));
+}
+
+// get the index of the element a pointer points to in an array, or -1 if it doesn't point to one of
+// the first element_count elements.
+static int64_t GetArrayIndex(const void* array, size_t element_size, int64_t element_count, const void* pointer)
+{
+    const uintptr_t base    = (uintptr_t)array;
+    const uintptr_t address = (uintptr_t)pointer;
+    if ((pointer == NULL) || (address < base) || (((address - base) % element_size) != 0) || (((address - base) / element_size) >= (uint64_t)element_count))
+    {
+        return -1;
+    }
+    return (int64_t)((address - base) / element_size);
+}
+
+// get the offset in an entry of an element of an array in one of its sections.
+static uintptr_t GetEntryOffset(const CacheSection* section, size_t element_size, int64_t element_index)
+{
+    return (uintptr_t)(section->base + (uint64_t)element_index * element_size);
+}
+
+// copy the intervals in the allocation tree in breadth first order, so each interval is copied after its
+// parent. The children of each copied interval are set to the index of the copy, which is never 0 as
+// that is the root. Returns false if the tree holds more intervals than the list has room for.
+static bool GatherAllocationIntervals(const RmtVirtualAllocationList* virtual_allocation_list,
+                                      RmtVirtualAllocationInterval*   out_intervals,
+                                      int32_t*                        out_interval_count)
+{
+    int32_t interval_count = 0;
+    if (virtual_allocation_list->root != NULL)
+    {
+        out_intervals[interval_count++] = *virtual_allocation_list->root;
+    }
+
+    for (int32_t current_interval_index = 0; current_interval_index < interval_count; ++current_interval_index)
+    {
+        RmtVirtualAllocationInterval*  current_interval = &out_intervals[current_interval_index];
+        RmtVirtualAllocationInterval** children[2]      = {&current_interval->left, &current_interval->right};
+        for (int32_t current_child_index = 0; current_child_index < 2; ++current_child_index)
+        {
+            if (*children[current_child_index] == NULL)
+            {
+                continue;
+            }
+
+            if (interval_count >= virtual_allocation_list->total_allocations)
+            {
+                return false;
+            }
+
+            out_intervals[interval_count]  = **children[current_child_index];
+            *children[current_child_index] = (RmtVirtualAllocationInterval*)(uintptr_t)interval_count;
+            interval_count++;
+        }
+    }
+
+    *out_interval_count = interval_count;
+    return true;
+}
+
+// translate the pointers in a page table. The level 3 directories hold no pointers.
+static void TranslatePageTable(const CacheTranslation* translation, RmtPageDirectoryLevel1** level0, uint8_t* level1_nodes, uint8_t* level2_nodes)
+{
+    for (int32_t current_level0_index = 0; current_level0_index < RMT_PAGE_DIRECTORY_LEVEL_0_SIZE; ++current_level0_index)
+    {
+        TranslatePointer(translation, &level0[current_level0_index]);
+    }
+
+    RmtPageDirectoryLevel1* level1 = (RmtPageDirectoryLevel1*)level1_nodes;
+    const uint64_t level1_count    = translation->from[kCacheSnapshotSectionPageDirectoryLevel1].size / sizeof(RmtPageDirectoryLevel1);
+    for (uint64_t current_node_index = 0; current_node_index < level1_count; ++current_node_index)
+    {
+        for (int32_t current_directory_index = 0; current_directory_index < RMT_PAGE_DIRECTORY_LEVEL_1_SIZE; ++current_directory_index)
+        {
+            TranslatePointer(translation, &level1[current_node_index].page_directory[current_directory_index]);
+        }
+    }
+
+    RmtPageDirectoryLevel2* level2 = (RmtPageDirectoryLevel2*)level2_nodes;
+    const uint64_t level2_count    = translation->from[kCacheSnapshotSectionPageDirectoryLevel2].size / sizeof(RmtPageDirectoryLevel2);
+    for (uint64_t current_node_index = 0; current_node_index < level2_count; ++current_node_index)
+    {
+        for (int32_t current_directory_index = 0; current_directory_index < RMT_PAGE_DIRECTORY_LEVEL_2_SIZE; ++current_directory_index)
+        {
+            TranslatePointer(translation, &level2[current_node_index].page_directory[current_directory_index]);
+        }
+    }
+}
+
+// restore a pool after the blocks at the start of its buffer are read. The blocks after them are still
+// linked together from when the pool was initialized.
+static void RestorePool(RmtPool* pool, size_t allocated)
+{
+    const size_t block_count = pool->buffer_size / pool->block_size;
+    pool->head               = (allocated < block_count) ? (void*)((uintptr_t)pool->buffer + (allocated * pool->block_size)) : NULL;
+    pool->allocated          = allocated;
+}
+
+// restore a page directory pool after it is read. The page table is complete, so the pool has no free blocks.
+static void RestorePageDirectoryPool(RmtPool* pool, void* nodes, size_t nodes_size, size_t node_size, const CacheSection* section)
+{
+    pool->head        = NULL;
+    pool->buffer      = nodes;
+    pool->buffer_size = nodes_size;
+    pool->block_size  = node_size;
+    pool->allocated   = (size_t)(section->size / node_size);
+}
+
+// get the number of resources the lists of a snapshot are initialized for.
+static int32_t GetMaximumConcurrentResources(const RmtDataSet* data_set)
+{
+    return data_set->data_profile.max_concurrent_resources + 200;
+}
+
+// get the size of the buffer the virtual allocation list of a snapshot is initialized with.
+static size_t GetVirtualAllocationBufferSize(const RmtDataSet* data_set)
+{
+    return RmtVirtualAllocationListGetBufferSize(data_set->data_profile.total_virtual_allocation_count, GetMaximumConcurrentResources(data_set));
+}
+
+// get the size of the buffer the resource list of a snapshot is initialized with.
+static size_t GetResourceListBufferSize(const RmtDataSet* data_set)
+{
+    return RmtResourceListGetBufferSize(GetMaximumConcurrentResources(data_set));
+}
+
+// check a section holds a whole number of elements, and no more than an array has room for.
+static bool ValidateArraySection(const CacheSection* section, size_t element_size, int64_t element_capacity)
+{
+    return ((section->size % element_size) == 0) && ((section->size / element_size) <= (uint64_t)RMT_MAXIMUM(element_capacity, 0));
+}
+
+// check the sections of a snapshot entry fit in the buffers a snapshot of the data set would have.
+static bool ValidateSnapshotEntry(const RmtDataSet* data_set, const CacheSnapshotEntry* entry, const CacheSection* sections)
+{
+    if ((entry->header.size < sizeof(CacheSnapshotEntry)) || !ValidateSections(&entry->header, sections, kCacheSnapshotSectionCount))
+    {
+        return false;
+    }
+
+    // the lists are laid out again from the data profile, which is part of the file header.
+    const bool    has_virtual_allocations  = (entry->virtual_allocation_list.allocation_intervals != NULL);
+    const bool    has_resources            = (entry->resource_list.resources != NULL);
+    const int64_t total_allocations        = has_virtual_allocations ? data_set->data_profile.total_virtual_allocation_count : 0;
+    const int64_t connectivity_capacity    = has_virtual_allocations ? GetMaximumConcurrentResources(data_set) : 0;
+    const int64_t resource_capacity        = has_resources ? GetMaximumConcurrentResources(data_set) : 0;
+    const int32_t resource_count           = entry->resource_list.resource_count;
+    const int64_t allocation_detail_count  = (int64_t)(sections[kCacheSnapshotSectionAllocationDetails].size / sizeof(RmtVirtualAllocation));
+    if (!ValidateArraySection(&sections[kCacheSnapshotSectionAllocationIntervals], sizeof(RmtVirtualAllocationInterval), total_allocations) ||
+        !ValidateArraySection(&sections[kCacheSnapshotSectionAllocationDetails], sizeof(RmtVirtualAllocation), total_allocations) ||
+        !ValidateArraySection(&sections[kCacheSnapshotSectionResourceConnectivity], sizeof(RmtResource*), connectivity_capacity) ||
+        !ValidateArraySection(&sections[kCacheSnapshotSectionUnboundMemoryRegions], sizeof(RmtMemoryRegion), total_allocations + connectivity_capacity) ||
+        !ValidateArraySection(&sections[kCacheSnapshotSectionResources], sizeof(RmtResource), resource_capacity) ||
+        (entry->virtual_allocation_list.allocation_count < 0) || (entry->virtual_allocation_list.allocation_count > allocation_detail_count) ||
+        (resource_count < 0) || (sections[kCacheSnapshotSectionResources].size != (uint64_t)resource_count * sizeof(RmtResource)) ||
+        (sections[kCacheSnapshotSectionResourceDetails].size != (uint64_t)resource_count * sizeof(RmtResourceDetails)) ||
+        (sections[kCacheSnapshotSectionResourceIdNodes].size != (uint64_t)resource_count * sizeof(RmtResourceIdNode)))
+    {
+        return false;
+    }
+
+    // the lists must have been laid out for the same capacities as the lists they are read back in to.
+    if ((has_virtual_allocations && (entry->virtual_allocation_list.total_allocations != total_allocations)) ||
+        (has_resources && (entry->resource_list.maximum_concurrent_resources != resource_capacity)))
+    {
+        return false;
+    }
+
+    if ((entry->resource_backing_storage_count < 0) || (entry->region_stack_count < 0) || (entry->segment_info_count < 0) ||
+        (entry->segment_info_count > RMT_MAXIMUM_SEGMENTS))
+    {
+        return false;
+    }
+
+    const uint64_t backing_storage_size = (uint64_t)entry->resource_backing_storage_count * kRmtResourceBackingStorageCount * sizeof(uint64_t);
+    if (sections[kCacheSnapshotSectionBackingStorage].size != backing_storage_size)
+    {
+        return false;
+    }
+
+    // the page directories must fit in the page table they are copied in to.
+    const CacheSection* level1 = &sections[kCacheSnapshotSectionPageDirectoryLevel1];
+    const CacheSection* level2 = &sections[kCacheSnapshotSectionPageDirectoryLevel2];
+    const CacheSection* level3 = &sections[kCacheSnapshotSectionPageDirectoryLevel3];
+    return ((level1->size % sizeof(RmtPageDirectoryLevel1)) == 0) && (level1->size <= sizeof(RmtPageTable::level1_nodes)) &&
+           ((level2->size % sizeof(RmtPageDirectoryLevel2)) == 0) && (level2->size <= sizeof(RmtPageTable::level2_nodes)) &&
+           ((level3->size % sizeof(RmtPageDirectoryLevel3)) == 0) && (level3->size <= sizeof(RmtPageTable::level3_nodes));
+}
+
+// translate the pointers in the parts of the lists of a snapshot that were read from an entry, and restore
+// the pools and columns the entry doesn't hold.
+static void RestoreSnapshotLists(const CacheTranslation* translation, const CacheSnapshotEntry* entry, RmtDataSnapshot* snapshot)
+{
+    const CacheSection* sections = translation->from;
+
+    // the list structures are copied from the entry, keeping the arrays the lists were just initialized with.
+    RmtVirtualAllocationList* virtual_allocation_list = &snapshot->virtual_allocation_list;
+    const RmtVirtualAllocationList initialized_virtual_allocation_list = *virtual_allocation_list;
+    *virtual_allocation_list                                           = entry->virtual_allocation_list;
+    virtual_allocation_list->allocation_intervals                      = initialized_virtual_allocation_list.allocation_intervals;
+    virtual_allocation_list->allocation_interval_pool                  = initialized_virtual_allocation_list.allocation_interval_pool;
+    virtual_allocation_list->allocation_details                        = initialized_virtual_allocation_list.allocation_details;
+    virtual_allocation_list->resource_connectivity                     = initialized_virtual_allocation_list.resource_connectivity;
+    virtual_allocation_list->unbound_memory_regions                    = initialized_virtual_allocation_list.unbound_memory_regions;
+    TranslatePointer(translation, &virtual_allocation_list->root);
+
+    RmtResourceList*      resource_list             = &snapshot->resource_list;
+    const RmtResourceList initialized_resource_list = *resource_list;
+    *resource_list                                  = entry->resource_list;
+    resource_list->resource_id_nodes                = initialized_resource_list.resource_id_nodes;
+    resource_list->resource_id_node_pool            = initialized_resource_list.resource_id_node_pool;
+    resource_list->resources                        = initialized_resource_list.resources;
+    resource_list->resource_details                 = initialized_resource_list.resource_details;
+    resource_list->columns                          = initialized_resource_list.columns;
+    resource_list->virtual_allocation_list          = &snapshot->virtual_allocation_list;
+    TranslatePointer(translation, &resource_list->root);
+
+    if (virtual_allocation_list->allocation_intervals != NULL)
+    {
+        const int64_t interval_count = (int64_t)(sections[kCacheSnapshotSectionAllocationIntervals].size / sizeof(RmtVirtualAllocationInterval));
+        for (int64_t current_interval_index = 0; current_interval_index < interval_count; ++current_interval_index)
+        {
+            RmtVirtualAllocationInterval* current_interval = &virtual_allocation_list->allocation_intervals[current_interval_index];
+            TranslatePointer(translation, &current_interval->allocation);
+            TranslatePointer(translation, &current_interval->left);
+            TranslatePointer(translation, &current_interval->right);
+        }
+        RestorePool(&virtual_allocation_list->allocation_interval_pool, (size_t)interval_count);
+
+        const int64_t allocation_count = (int64_t)(sections[kCacheSnapshotSectionAllocationDetails].size / sizeof(RmtVirtualAllocation));
+        for (int64_t current_allocation_index = 0; current_allocation_index < allocation_count; ++current_allocation_index)
+        {
+            TranslatePointer(translation, &virtual_allocation_list->allocation_details[current_allocation_index].resources);
+            TranslatePointer(translation, &virtual_allocation_list->allocation_details[current_allocation_index].unbound_memory_regions);
+        }
+
+        const int64_t connectivity_count = (int64_t)(sections[kCacheSnapshotSectionResourceConnectivity].size / sizeof(RmtResource*));
+        for (int64_t current_resource_index = 0; current_resource_index < connectivity_count; ++current_resource_index)
+        {
+            TranslatePointer(translation, &virtual_allocation_list->resource_connectivity[current_resource_index]);
+        }
+    }
+
+    if (resource_list->resources != NULL)
+    {
+        for (int32_t current_resource_index = 0; current_resource_index < resource_list->resource_count; ++current_resource_index)
+        {
+            RmtResource*       current_resource = &resource_list->resources[current_resource_index];
+            RmtResourceIdNode* current_node     = &resource_list->resource_id_nodes[current_resource_index];
+            TranslatePointer(translation, &current_resource->bound_allocation);
+            TranslatePointer(translation, &current_resource->details);
+            TranslatePointer(translation, &current_resource->id_node);
+            TranslatePointer(translation, &current_node->resource);
+            TranslatePointer(translation, &current_node->left);
+            TranslatePointer(translation, &current_node->right);
+        }
+        RestorePool(&resource_list->resource_id_node_pool, (size_t)resource_list->resource_count);
+        RmtResourceListUpdateColumns(resource_list);
+    }
+}
+
+RmtErrorCode RmtDataCacheReadSnapshot(RmtDataSet* data_set, RmtSnapshotPoint* snapshot_point, RmtProgress* progress, RmtDataSnapshot* out_snapshot)
+{
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(snapshot_point, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(out_snapshot, RMT_ERROR_INVALID_POINTER);
+
+    char cache_file_path[RMT_MAXIMUM_FILE_PATH + sizeof(RMT_DATA_CACHE_FILE_EXTENSION)];
+    GetCacheFilePath(data_set, cache_file_path, sizeof(cache_file_path));
+
+    CacheFileHeader expected_header;
+    BuildFileHeader(data_set, &expected_header);
+
+    CacheFileMapping mapping    = {};
+    RmtErrorCode     error_code = MapCacheFile(cache_file_path, &mapping);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+    const CacheEntryHeader* entry_header = NULL;
+    uint64_t                end_offset   = 0;
+    error_code = FindEntry(&mapping, &expected_header, kCacheEntryTypeSnapshot, snapshot_point->timestamp, &entry_header, &end_offset);
+    if (error_code != RMT_OK)
+    {
+        UnmapCacheFile(&mapping);
+        return error_code;
+    }
+
+    // check the entry before anything is copied out of it.
+    const CacheSnapshotEntry* entry = (const CacheSnapshotEntry*)entry_header;
+    CacheSection              sections[kCacheSnapshotSectionCount];
+    memcpy(sections, entry->sections, sizeof(sections));
+    if (!ValidateSnapshotEntry(data_set, entry, sections))
+    {
+        UnmapCacheFile(&mapping);
+        return RMT_ERROR_MALFORMED_DATA;
+    }
+
+    // allocate the buffers and lay out the lists the same way as a generated snapshot, so the parts of the
+    // lists that weren't written are ready to use and the snapshot is destroyed the same way.
+    out_snapshot->data_set                  = data_set;
+    out_snapshot->virtual_allocation_buffer = NULL;
+    out_snapshot->resource_list_buffer      = NULL;
+    out_snapshot->resource_backing_storage  = NULL;
+    out_snapshot->region_stack_buffer       = NULL;
+    memset(&out_snapshot->virtual_allocation_list, 0, sizeof(RmtVirtualAllocationList));
+    memset(&out_snapshot->resource_list, 0, sizeof(RmtResourceList));
+
+    bool allocated = true;
+    if (entry->virtual_allocation_list.allocation_intervals != NULL)
+    {
+        const size_t virtual_allocation_buffer_size = GetVirtualAllocationBufferSize(data_set);
+        out_snapshot->virtual_allocation_buffer     = PerformAllocation(data_set, virtual_allocation_buffer_size, sizeof(uint32_t));
+        allocated = (out_snapshot->virtual_allocation_buffer != NULL) && (RmtVirtualAllocationListInitialize(&out_snapshot->virtual_allocation_list,
+                                                                                                             out_snapshot->virtual_allocation_buffer,
+                                                                                                             virtual_allocation_buffer_size,
+                                                                                                             data_set->data_profile.max_virtual_allocation_count,
+                                                                                                             GetMaximumConcurrentResources(data_set),
+                                                                                                             data_set->data_profile.total_virtual_allocation_count) == RMT_OK);
+    }
+
+    if (allocated && (entry->resource_list.resources != NULL))
+    {
+        const size_t resource_list_buffer_size = GetResourceListBufferSize(data_set);
+        out_snapshot->resource_list_buffer     = PerformAllocation(data_set, resource_list_buffer_size, sizeof(uint32_t));
+        allocated                              = (out_snapshot->resource_list_buffer != NULL) && (RmtResourceListInitialize(&out_snapshot->resource_list,
+                                                                                                   out_snapshot->resource_list_buffer,
+                                                                                                   resource_list_buffer_size,
+                                                                                                   &out_snapshot->virtual_allocation_list,
+                                                                                                   GetMaximumConcurrentResources(data_set)) == RMT_OK);
+    }
+
+    if (allocated && (sections[kCacheSnapshotSectionBackingStorage].size > 0))
+    {
+        out_snapshot->resource_backing_storage =
+            (uint64_t*)PerformAllocation(data_set, (size_t)sections[kCacheSnapshotSectionBackingStorage].size, sizeof(uint64_t));
+        allocated = (out_snapshot->resource_backing_storage != NULL);
+    }
+
+    if (allocated && (entry->region_stack_count > 0))
+    {
+        out_snapshot->region_stack_buffer =
+            (RmtMemoryRegion*)PerformAllocation(data_set, sizeof(RmtMemoryRegion) * entry->region_stack_count, sizeof(RmtMemoryRegion));
+        allocated = (out_snapshot->region_stack_buffer != NULL);
+    }
+
+    if (!allocated)
+    {
+        RmtDataSnapshotDestroy(out_snapshot);
+        UnmapCacheFile(&mapping);
+        return RMT_ERROR_OUT_OF_MEMORY;
+    }
+
+    // each section is copied to the start of the array it was written from. The page directories are
+    // copied straight in to the page table, so only the directories in use are touched.
+    RmtPageTable* page_table = &out_snapshot->page_table;
+    void*         arrays[kCacheSnapshotSectionCount];
+    arrays[kCacheSnapshotSectionAllocationIntervals]  = out_snapshot->virtual_allocation_list.allocation_intervals;
+    arrays[kCacheSnapshotSectionAllocationDetails]    = out_snapshot->virtual_allocation_list.allocation_details;
+    arrays[kCacheSnapshotSectionResourceConnectivity] = out_snapshot->virtual_allocation_list.resource_connectivity;
+    arrays[kCacheSnapshotSectionUnboundMemoryRegions] = out_snapshot->virtual_allocation_list.unbound_memory_regions;
+    arrays[kCacheSnapshotSectionResources]            = out_snapshot->resource_list.resources;
+    arrays[kCacheSnapshotSectionResourceDetails]      = out_snapshot->resource_list.resource_details;
+    arrays[kCacheSnapshotSectionResourceIdNodes]      = out_snapshot->resource_list.resource_id_nodes;
+    arrays[kCacheSnapshotSectionBackingStorage]       = out_snapshot->resource_backing_storage;
+    arrays[kCacheSnapshotSectionPageDirectoryLevel1]  = page_table->level1_nodes;
+    arrays[kCacheSnapshotSectionPageDirectoryLevel2]  = page_table->level2_nodes;
+    arrays[kCacheSnapshotSectionPageDirectoryLevel3]  = page_table->level3_nodes;
+
+    CacheSection memory_sections[kCacheSnapshotSectionCount];
+    uint64_t     bytes_read = 0;
+    for (int32_t current_section_index = 0; (error_code == RMT_OK) && (current_section_index < kCacheSnapshotSectionCount); ++current_section_index)
+    {
+        SetSection(&memory_sections[current_section_index], arrays[current_section_index], sections[current_section_index].size);
+        error_code = ReadSection(entry_header, &sections[current_section_index], arrays[current_section_index], progress, &bytes_read);
+    }
+
+    if (error_code != RMT_OK)
+    {
+        RmtDataSnapshotDestroy(out_snapshot);
+        UnmapCacheFile(&mapping);
+        return error_code;
+    }
+
+    // set up the snapshot the same way as a generated one.
+    out_snapshot->snapshot_point = snapshot_point;
+    memset(out_snapshot->name, 0, sizeof(out_snapshot->name));
+    memcpy(out_snapshot->name, snapshot_point->name, RMT_MINIMUM(strlen(snapshot_point->name), sizeof(out_snapshot->name) - 1));
+    out_snapshot->timestamp                        = snapshot_point->timestamp;
+    out_snapshot->minimum_virtual_address          = entry->minimum_virtual_address;
+    out_snapshot->maximum_virtual_address          = entry->maximum_virtual_address;
+    out_snapshot->minimum_allocation_timestamp     = entry->minimum_allocation_timestamp;
+    out_snapshot->maximum_allocation_timestamp     = entry->maximum_allocation_timestamp;
+    out_snapshot->minimum_resource_size_in_bytes   = entry->minimum_resource_size_in_bytes;
+    out_snapshot->maximum_resource_size_in_bytes   = entry->maximum_resource_size_in_bytes;
+    out_snapshot->maximum_physical_memory_in_bytes = entry->maximum_physical_memory_in_bytes;
+    out_snapshot->process_map                      = entry->process_map;
+    out_snapshot->aggregates                       = entry->aggregates;
+    memcpy(page_table->level0, entry->page_directory_level0, sizeof(page_table->level0));
+    memcpy(page_table->mapped_per_heap, entry->mapped_per_heap, sizeof(page_table->mapped_per_heap));
+    memcpy(page_table->segment_info, entry->segment_info, sizeof(page_table->segment_info));
+    page_table->segment_info_count               = entry->segment_info_count;
+    page_table->target_process_id                = entry->target_process_id;
+    out_snapshot->resource_backing_storage_count = entry->resource_backing_storage_count;
+    out_snapshot->region_stack_count             = entry->region_stack_count;
+
+    // turn the offsets in the copied entry back in to pointers.
+    const CacheTranslation translation = {sections, memory_sections, kCacheSnapshotSectionCount};
+    RestoreSnapshotLists(&translation, entry, out_snapshot);
+    TranslatePageTable(&translation,
+                       page_table->level0,
+                       (uint8_t*)arrays[kCacheSnapshotSectionPageDirectoryLevel1],
+                       (uint8_t*)arrays[kCacheSnapshotSectionPageDirectoryLevel2]);
+    UnmapCacheFile(&mapping);
+
+    RestorePageDirectoryPool(&page_table->level1_allocator,
+                             page_table->level1_nodes,
+                             sizeof(page_table->level1_nodes),
+                             sizeof(RmtPageDirectoryLevel1),
+                             &sections[kCacheSnapshotSectionPageDirectoryLevel1]);
+    RestorePageDirectoryPool(&page_table->level2_allocator,
+                             page_table->level2_nodes,
+                             sizeof(page_table->level2_nodes),
+                             sizeof(RmtPageDirectoryLevel2),
+                             &sections[kCacheSnapshotSectionPageDirectoryLevel2]);
+    RestorePageDirectoryPool(&page_table->level3_allocator,
+                             page_table->level3_nodes,
+                             sizeof(page_table->level3_nodes),
+                             sizeof(RmtPageDirectoryLevel3),
+                             &sections[kCacheSnapshotSectionPageDirectoryLevel3]);
+    return RMT_OK;
+}
+
+// find the parts of the virtual allocation list of a snapshot to write, and copy the allocation intervals
+// in the tree in to the staging buffer for them.
+static bool MeasureVirtualAllocationList(const RmtDataSnapshot*        snapshot,
+                                         RmtVirtualAllocationInterval* out_intervals,
+                                         int32_t*                      out_interval_count,
+                                         CacheSection*                 out_memory_sections)
+{
+    const RmtVirtualAllocationList* virtual_allocation_list = &snapshot->virtual_allocation_list;
+    const int32_t                   total_allocations       = virtual_allocation_list->total_allocations;
+    const int32_t connectivity_capacity = GetMaximumConcurrentResources(snapshot->data_set);
+    const int32_t unbound_capacity      = total_allocations + connectivity_capacity;
+
+    if (!GatherAllocationIntervals(virtual_allocation_list, out_intervals, out_interval_count))
+    {
+        return false;
+    }
+
+    // compacting the list moves allocations without updating the intervals pointing to them, so the details
+    // are written up to the last one pointed to by an interval or a resource, not just the live ones.
+    int64_t allocation_count = virtual_allocation_list->allocation_count;
+    for (int32_t current_interval_index = 0; current_interval_index < *out_interval_count; ++current_interval_index)
+    {
+        const int64_t allocation_index = GetArrayIndex(
+            virtual_allocation_list->allocation_details, sizeof(RmtVirtualAllocation), total_allocations, out_intervals[current_interval_index].allocation);
+        allocation_count = RMT_MAXIMUM(allocation_count, allocation_index + 1);
+    }
+    for (int32_t current_resource_index = 0; current_resource_index < snapshot->resource_list.resource_count; ++current_resource_index)
+    {
+        const int64_t allocation_index = GetArrayIndex(virtual_allocation_list->allocation_details,
+                                                       sizeof(RmtVirtualAllocation),
+                                                       total_allocations,
+                                                       snapshot->resource_list.resources[current_resource_index].bound_allocation);
+        allocation_count = RMT_MAXIMUM(allocation_count, allocation_index + 1);
+    }
+
+    // the resource pointers and unbound regions of the allocations are written up to the last one used.
+    int64_t connectivity_count = 0;
+    int64_t unbound_count      = 0;
+    for (int64_t current_allocation_index = 0; current_allocation_index < allocation_count; ++current_allocation_index)
+    {
+        const RmtVirtualAllocation* current_allocation = &virtual_allocation_list->allocation_details[current_allocation_index];
+        const int64_t               connectivity_index =
+            GetArrayIndex(virtual_allocation_list->resource_connectivity, sizeof(RmtResource*), connectivity_capacity + 1, current_allocation->resources);
+        if ((connectivity_index >= 0) && (current_allocation->resource_count >= 0))
+        {
+            connectivity_count = RMT_MAXIMUM(connectivity_count, RMT_MINIMUM(connectivity_index + current_allocation->resource_count, connectivity_capacity));
+        }
+
+        const int64_t unbound_index = GetArrayIndex(
+            virtual_allocation_list->unbound_memory_regions, sizeof(RmtMemoryRegion), unbound_capacity + 1, current_allocation->unbound_memory_regions);
+        if ((unbound_index >= 0) && (current_allocation->unbound_memory_region_count >= 0))
+        {
+            unbound_count = RMT_MAXIMUM(unbound_count, RMT_MINIMUM(unbound_index + current_allocation->unbound_memory_region_count, unbound_capacity));
+        }
+    }
+
+    // the intervals are gathered in to a different order, so their pointers are translated by hand.
+    SetSection(&out_memory_sections[kCacheSnapshotSectionAllocationIntervals], NULL, *out_interval_count * sizeof(RmtVirtualAllocationInterval));
+    SetSection(&out_memory_sections[kCacheSnapshotSectionAllocationDetails],
+               virtual_allocation_list->allocation_details,
+               allocation_count * sizeof(RmtVirtualAllocation));
+    SetSection(&out_memory_sections[kCacheSnapshotSectionResourceConnectivity],
+               virtual_allocation_list->resource_connectivity,
+               connectivity_count * sizeof(RmtResource*));
+    SetSection(&out_memory_sections[kCacheSnapshotSectionUnboundMemoryRegions],
+               virtual_allocation_list->unbound_memory_regions,
+               unbound_count * sizeof(RmtMemoryRegion));
+    return true;
+}
+
+// copy the resource details and resource ID nodes of the resources in a snapshot in to staging buffers in
+// resource order, so the details and node of each resource are found from the index of the resource.
+static bool GatherResources(const RmtResourceList*  resource_list,
+                            const CacheTranslation* translation,
+                            const CacheSection*     entry_sections,
+                            RmtResource*            out_resources,
+                            RmtResourceDetails*     out_details,
+                            RmtResourceIdNode*      out_nodes)
+{
+    const CacheSection* nodes_section   = &entry_sections[kCacheSnapshotSectionResourceIdNodes];
+    const CacheSection* details_section = &entry_sections[kCacheSnapshotSectionResourceDetails];
+    const int32_t       resource_count  = resource_list->resource_count;
+    for (int32_t current_resource_index = 0; current_resource_index < resource_count; ++current_resource_index)
+    {
+        const RmtResource* resource = &resource_list->resources[current_resource_index];
+        RmtResource*       copy     = &out_resources[current_resource_index];
+        *copy                       = *resource;
+        TranslatePointer(translation, &copy->bound_allocation);
+
+        memset(&out_details[current_resource_index], 0, sizeof(RmtResourceDetails));
+        if (resource->details != NULL)
+        {
+            out_details[current_resource_index] = *resource->details;
+        }
+        copy->details = (RmtResourceDetails*)GetEntryOffset(details_section, sizeof(RmtResourceDetails), current_resource_index);
+
+        memset(&out_nodes[current_resource_index], 0, sizeof(RmtResourceIdNode));
+        copy->id_node = NULL;
+        if (resource->id_node == NULL)
+        {
+            continue;
+        }
+
+        // each node in the tree is found from the resource it points to.
+        RmtResourceIdNode* node = &out_nodes[current_resource_index];
+        *node                   = *resource->id_node;
+        copy->id_node           = (RmtResourceIdNode*)GetEntryOffset(nodes_section, sizeof(RmtResourceIdNode), current_resource_index);
+        TranslatePointer(translation, &node->resource);
+
+        RmtResourceIdNode** children[2] = {&node->left, &node->right};
+        for (int32_t current_child_index = 0; current_child_index < 2; ++current_child_index)
+        {
+            const RmtResourceIdNode* child = *children[current_child_index];
+            if (child == NULL)
+            {
+                continue;
+            }
+
+            const int64_t child_index = GetArrayIndex(resource_list->resources, sizeof(RmtResource), resource_count, child->resource);
+            if ((child_index < 0) || (resource_list->resources[child_index].id_node != child))
+            {
+                return false;
+            }
+            *children[current_child_index] = (RmtResourceIdNode*)GetEntryOffset(nodes_section, sizeof(RmtResourceIdNode), child_index);
+        }
+    }
+
+    return true;
+}
+
+RmtErrorCode RmtDataCacheWriteSnapshot(RmtDataSet* data_set, const RmtDataSnapshot* snapshot, RmtProgress* progress)
+{
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(snapshot, RMT_ERROR_INVALID_POINTER);
+
+    if (data_set->read_only)
+    {
+        return RMT_OK;
+    }
+
+    RMT_RETURN_ON_ERROR(!RmtProgressIsCancelled(progress), RMT_ERROR_CANCELLED);
+
+    const RmtVirtualAllocationList* virtual_allocation_list = &snapshot->virtual_allocation_list;
+    const RmtResourceList*          resource_list           = &snapshot->resource_list;
+    const bool                      has_virtual_allocations = (snapshot->virtual_allocation_buffer != NULL);
+    const bool                      has_resources           = (snapshot->resource_list_buffer != NULL);
+    const int32_t                   resource_count          = has_resources ? resource_list->resource_count : 0;
+
+    // the sections holding pointers are translated in staging buffers, leaving the snapshot untouched. The
+    // region stack is scratch memory, so it is allocated again when the snapshot is read rather than written.
+    CacheSection memory_sections[kCacheSnapshotSectionCount];
+    memset(memory_sections, 0, sizeof(memory_sections));
+    void* copies[kCacheSnapshotSectionCount] = {};
+    bool  copied                             = true;
+
+    int32_t interval_count = 0;
+    if (has_virtual_allocations)
+    {
+        copies[kCacheSnapshotSectionAllocationIntervals] =
+            PerformAllocation(data_set, RMT_MAXIMUM(virtual_allocation_list->total_allocations, 1) * sizeof(RmtVirtualAllocationInterval), sizeof(uint64_t));
+        copied = (copies[kCacheSnapshotSectionAllocationIntervals] != NULL) &&
+                 MeasureVirtualAllocationList(
+                     snapshot, (RmtVirtualAllocationInterval*)copies[kCacheSnapshotSectionAllocationIntervals], &interval_count, memory_sections);
+    }
+
+    // the resources are written in the order they are in the list, along with their details and nodes.
+    SetSection(&memory_sections[kCacheSnapshotSectionResources], resource_list->resources, resource_count * sizeof(RmtResource));
+    SetSection(&memory_sections[kCacheSnapshotSectionResourceDetails], NULL, resource_count * sizeof(RmtResourceDetails));
+    SetSection(&memory_sections[kCacheSnapshotSectionResourceIdNodes], NULL, resource_count * sizeof(RmtResourceIdNode));
+    SetSection(&memory_sections[kCacheSnapshotSectionBackingStorage],
+               snapshot->resource_backing_storage,
+               (uint64_t)snapshot->resource_backing_storage_count * kRmtResourceBackingStorageCount * sizeof(uint64_t));
+
+    // the page directories are allocated in order and never freed, so only the ones in use are written.
+    const RmtPageTable* page_table = &snapshot->page_table;
+    SetSection(&memory_sections[kCacheSnapshotSectionPageDirectoryLevel1],
+               page_table->level1_nodes,
+               page_table->level1_allocator.allocated * sizeof(RmtPageDirectoryLevel1));
+    SetSection(&memory_sections[kCacheSnapshotSectionPageDirectoryLevel2],
+               page_table->level2_nodes,
+               page_table->level2_allocator.allocated * sizeof(RmtPageDirectoryLevel2));
+    SetSection(&memory_sections[kCacheSnapshotSectionPageDirectoryLevel3],
+               page_table->level3_nodes,
+               page_table->level3_allocator.allocated * sizeof(RmtPageDirectoryLevel3));
+
+    CacheSnapshotEntry* entry = (CacheSnapshotEntry*)calloc(1, sizeof(CacheSnapshotEntry));
+    if (entry == NULL)
+    {
+        PerformFree(data_set, copies[kCacheSnapshotSectionAllocationIntervals]);
+        return RMT_ERROR_OUT_OF_MEMORY;
+    }
+
+    entry->header.type                      = kCacheEntryTypeSnapshot;
+    entry->header.key                       = snapshot->timestamp;
+    entry->header.size                      = LayoutSections(sizeof(CacheSnapshotEntry), memory_sections, entry->sections, kCacheSnapshotSectionCount);
+    entry->minimum_virtual_address          = snapshot->minimum_virtual_address;
+    entry->maximum_virtual_address          = snapshot->maximum_virtual_address;
+    entry->minimum_allocation_timestamp     = snapshot->minimum_allocation_timestamp;
+    entry->maximum_allocation_timestamp     = snapshot->maximum_allocation_timestamp;
+    entry->minimum_resource_size_in_bytes   = snapshot->minimum_resource_size_in_bytes;
+    entry->maximum_resource_size_in_bytes   = snapshot->maximum_resource_size_in_bytes;
+    entry->maximum_physical_memory_in_bytes = snapshot->maximum_physical_memory_in_bytes;
+    entry->process_map                      = snapshot->process_map;
+    entry->aggregates                       = snapshot->aggregates;
+    memcpy(entry->page_directory_level0, page_table->level0, sizeof(entry->page_directory_level0));
+    memcpy(entry->mapped_per_heap, page_table->mapped_per_heap, sizeof(entry->mapped_per_heap));
+    memcpy(entry->segment_info, page_table->segment_info, sizeof(entry->segment_info));
+    entry->segment_info_count             = page_table->segment_info_count;
+    entry->target_process_id              = page_table->target_process_id;
+    entry->region_stack_count             = snapshot->region_stack_count;
+    entry->resource_backing_storage_count = snapshot->resource_backing_storage_count;
+
+    // the list structures keep their counts. The arrays are laid out again when read, so each array pointer
+    // is only kept to show whether the snapshot had the list, and the pools and columns aren't written.
+    entry->virtual_allocation_list = *virtual_allocation_list;
+    entry->resource_list           = *resource_list;
+    memset(&entry->virtual_allocation_list.allocation_interval_pool, 0, sizeof(RmtPool));
+    memset(&entry->resource_list.resource_id_node_pool, 0, sizeof(RmtPool));
+    memset(&entry->resource_list.columns, 0, sizeof(RmtResourceListColumns));
+    entry->resource_list.virtual_allocation_list = NULL;
+    entry->resource_list.resource_count          = resource_count;
+
+    const CacheTranslation translation = {memory_sections, entry->sections, kCacheSnapshotSectionCount};
+    RmtVirtualAllocationList* entry_virtual_allocation_list = &entry->virtual_allocation_list;
+    entry_virtual_allocation_list->root                     = NULL;
+    entry_virtual_allocation_list->allocation_intervals     = NULL;
+    entry_virtual_allocation_list->allocation_details       = NULL;
+    entry_virtual_allocation_list->resource_connectivity    = NULL;
+    entry_virtual_allocation_list->unbound_memory_regions   = NULL;
+    if (has_virtual_allocations)
+    {
+        const CacheSection* intervals_section = &entry->sections[kCacheSnapshotSectionAllocationIntervals];
+        entry_virtual_allocation_list->allocation_intervals =
+            (RmtVirtualAllocationInterval*)GetEntryOffset(intervals_section, sizeof(RmtVirtualAllocationInterval), 0);
+        entry_virtual_allocation_list->allocation_details =
+            (RmtVirtualAllocation*)GetEntryOffset(&entry->sections[kCacheSnapshotSectionAllocationDetails], sizeof(RmtVirtualAllocation), 0);
+        entry_virtual_allocation_list->resource_connectivity =
+            (RmtResource**)GetEntryOffset(&entry->sections[kCacheSnapshotSectionResourceConnectivity], sizeof(RmtResource*), 0);
+        entry_virtual_allocation_list->unbound_memory_regions =
+            (RmtMemoryRegion*)GetEntryOffset(&entry->sections[kCacheSnapshotSectionUnboundMemoryRegions], sizeof(RmtMemoryRegion), 0);
+        if (interval_count > 0)
+        {
+            entry_virtual_allocation_list->root = entry_virtual_allocation_list->allocation_intervals;
+        }
+    }
+
+    RmtResourceList* entry_resource_list   = &entry->resource_list;
+    entry_resource_list->root              = NULL;
+    entry_resource_list->resource_id_nodes = NULL;
+    entry_resource_list->resources         = NULL;
+    entry_resource_list->resource_details  = NULL;
+    if (has_resources)
+    {
+        entry_resource_list->resources =
+            (RmtResource*)GetEntryOffset(&entry->sections[kCacheSnapshotSectionResources], sizeof(RmtResource), 0);
+        entry_resource_list->resource_details =
+            (RmtResourceDetails*)GetEntryOffset(&entry->sections[kCacheSnapshotSectionResourceDetails], sizeof(RmtResourceDetails), 0);
+        entry_resource_list->resource_id_nodes =
+            (RmtResourceIdNode*)GetEntryOffset(&entry->sections[kCacheSnapshotSectionResourceIdNodes], sizeof(RmtResourceIdNode), 0);
+
+        const RmtResourceIdNode* root  = resource_list->root;
+        const int64_t root_index       = (root != NULL) ? GetArrayIndex(resource_list->resources, sizeof(RmtResource), resource_count, root->resource) : -1;
+        copied                         = copied && ((root == NULL) || ((root_index >= 0) && (resource_list->resources[root_index].id_node == root)));
+        if (root_index >= 0)
+        {
+            entry_resource_list->root =
+                (RmtResourceIdNode*)GetEntryOffset(&entry->sections[kCacheSnapshotSectionResourceIdNodes], sizeof(RmtResourceIdNode), root_index);
+        }
+    }
+
+    // stage the sections which hold pointers.
+    const int32_t staged_sections[] = {kCacheSnapshotSectionAllocationDetails,
+                                       kCacheSnapshotSectionResourceConnectivity,
+                                       kCacheSnapshotSectionResources,
+                                       kCacheSnapshotSectionResourceDetails,
+                                       kCacheSnapshotSectionResourceIdNodes,
+                                       kCacheSnapshotSectionPageDirectoryLevel1,
+                                       kCacheSnapshotSectionPageDirectoryLevel2};
+    for (int32_t current_staged_index = 0; copied && (current_staged_index < RMT_ARRAY_ELEMENTS(staged_sections)); ++current_staged_index)
+    {
+        const int32_t section_index = staged_sections[current_staged_index];
+        if (memory_sections[section_index].size > 0)
+        {
+            copies[section_index] = PerformAllocation(data_set, (size_t)memory_sections[section_index].size, sizeof(uint64_t));
+            copied                = (copies[section_index] != NULL);
+        }
+    }
+
+    RmtErrorCode error_code = RMT_ERROR_OUT_OF_MEMORY;
+    if (copied)
+    {
+        // the intervals point to each other by index once gathered.
+        RmtVirtualAllocationInterval* intervals = (RmtVirtualAllocationInterval*)copies[kCacheSnapshotSectionAllocationIntervals];
+        for (int32_t current_interval_index = 0; current_interval_index < interval_count; ++current_interval_index)
+        {
+            RmtVirtualAllocationInterval* current_interval = &intervals[current_interval_index];
+            const CacheSection*           section          = &entry->sections[kCacheSnapshotSectionAllocationIntervals];
+            TranslatePointer(&translation, &current_interval->allocation);
+            if (current_interval->left != NULL)
+            {
+                current_interval->left = (RmtVirtualAllocationInterval*)GetEntryOffset(
+                    section, sizeof(RmtVirtualAllocationInterval), (int64_t)(uintptr_t)current_interval->left);
+            }
+            if (current_interval->right != NULL)
+            {
+                current_interval->right = (RmtVirtualAllocationInterval*)GetEntryOffset(
+                    section, sizeof(RmtVirtualAllocationInterval), (int64_t)(uintptr_t)current_interval->right);
+            }
+        }
+
+        RmtVirtualAllocation* allocations      = (RmtVirtualAllocation*)copies[kCacheSnapshotSectionAllocationDetails];
+        const uint64_t        allocation_count = memory_sections[kCacheSnapshotSectionAllocationDetails].size / sizeof(RmtVirtualAllocation);
+        for (uint64_t current_allocation_index = 0; current_allocation_index < allocation_count; ++current_allocation_index)
+        {
+            allocations[current_allocation_index] = virtual_allocation_list->allocation_details[current_allocation_index];
+            TranslatePointer(&translation, &allocations[current_allocation_index].resources);
+            TranslatePointer(&translation, &allocations[current_allocation_index].unbound_memory_regions);
+        }
+
+        RmtResource**  connectivity       = (RmtResource**)copies[kCacheSnapshotSectionResourceConnectivity];
+        const uint64_t connectivity_count = memory_sections[kCacheSnapshotSectionResourceConnectivity].size / sizeof(RmtResource*);
+        for (uint64_t current_resource_index = 0; current_resource_index < connectivity_count; ++current_resource_index)
+        {
+            connectivity[current_resource_index] = virtual_allocation_list->resource_connectivity[current_resource_index];
+            TranslatePointer(&translation, &connectivity[current_resource_index]);
+        }
+
+        copied = GatherResources(resource_list,
+                                 &translation,
+                                 entry->sections,
+                                 (RmtResource*)copies[kCacheSnapshotSectionResources],
+                                 (RmtResourceDetails*)copies[kCacheSnapshotSectionResourceDetails],
+                                 (RmtResourceIdNode*)copies[kCacheSnapshotSectionResourceIdNodes]);
+
+        if (memory_sections[kCacheSnapshotSectionPageDirectoryLevel1].size > 0)
+        {
+            memcpy(copies[kCacheSnapshotSectionPageDirectoryLevel1],
+                   page_table->level1_nodes,
+                   (size_t)memory_sections[kCacheSnapshotSectionPageDirectoryLevel1].size);
+        }
+        if (memory_sections[kCacheSnapshotSectionPageDirectoryLevel2].size > 0)
+        {
+            memcpy(copies[kCacheSnapshotSectionPageDirectoryLevel2],
+                   page_table->level2_nodes,
+                   (size_t)memory_sections[kCacheSnapshotSectionPageDirectoryLevel2].size);
+        }
+        TranslatePageTable(&translation,
+                           entry->page_directory_level0,
+                           (uint8_t*)copies[kCacheSnapshotSectionPageDirectoryLevel1],
+                           (uint8_t*)copies[kCacheSnapshotSectionPageDirectoryLevel2]);
+
+        // a resource tree which can't be written in resource order is left out of the cache.
+        error_code = RMT_ERROR_MALFORMED_DATA;
+        if (copied)
+        {
+            const void* section_data[kCacheSnapshotSectionCount];
+            for (int32_t current_section_index = 0; current_section_index < kCacheSnapshotSectionCount; ++current_section_index)
+            {
+                section_data[current_section_index] = (copies[current_section_index] != NULL)
+                                                          ? (const void*)copies[current_section_index]
+                                                          : (const void*)(uintptr_t)memory_sections[current_section_index].base;
+            }
+            error_code = AppendEntry(data_set, progress, entry, sizeof(CacheSnapshotEntry), section_data, entry->sections, kCacheSnapshotSectionCount);
+        }
+    }
+
+    for (int32_t current_section_index = 0; current_section_index < kCacheSnapshotSectionCount; ++current_section_index)
+    {
+        PerformFree(data_set, copies[current_section_index]);
+    }
+    free(entry);
+    return error_code;
+}
+
+// check the series of a timeline entry have the layout the timeline is read back in to, one level per
+// series with the same number of values in each, and get the number of values in each series.
+static bool ValidateTimelineSeries(const RmtDataTimeline* timeline, int32_t* out_value_count)
+{
+    *out_value_count = 0;
+    if ((timeline->series_count < 0) || (timeline->series_count > RMT_MAXIMUM_TIMELINE_DATA_SERIES))
+    {
+        return false;
+    }
+
+    for (int32_t current_series_index = 0; current_series_index < timeline->series_count; ++current_series_index)
+    {
+        const RmtDataTimelineSeries* current_series = &timeline->series[current_series_index];
+        const int32_t                value_count    = timeline->series[0].levels[0].value_count;
+        if ((current_series->level_count != 1) || (current_series->levels[0].value_count != value_count) || (value_count < 0))
+        {
+            return false;
+        }
+        *out_value_count = value_count;
+    }
+    return true;
+}
+
+RmtErrorCode RmtDataCacheReadTimeline(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtProgress* progress, RmtDataTimeline* out_timeline)
+{
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(out_timeline, RMT_ERROR_INVALID_POINTER);
+
+    char cache_file_path[RMT_MAXIMUM_FILE_PATH + sizeof(RMT_DATA_CACHE_FILE_EXTENSION)];
+    GetCacheFilePath(data_set, cache_file_path, sizeof(cache_file_path));
+
+    CacheFileHeader expected_header;
+    BuildFileHeader(data_set, &expected_header);
+
+    CacheFileMapping mapping    = {};
+    RmtErrorCode     error_code = MapCacheFile(cache_file_path, &mapping);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+    const CacheEntryHeader* entry_header = NULL;
+    uint64_t                end_offset   = 0;
+    error_code = FindEntry(&mapping, &expected_header, kCacheEntryTypeTimeline, (uint64_t)timeline_type, &entry_header, &end_offset);
+    if (error_code != RMT_OK)
+    {
+        UnmapCacheFile(&mapping);
+        return error_code;
+    }
+
+    // check the runs fill every series exactly before anything is decoded.
+    const CacheTimelineEntry* entry       = (const CacheTimelineEntry*)entry_header;
+    int32_t                   value_count = 0;
+    bool valid = (entry_header->size >= sizeof(CacheTimelineEntry)) && ValidateSections(entry_header, &entry->runs, 1) &&
+                 ((entry->runs.size % sizeof(CacheTimelineRun)) == 0) && ValidateTimelineSeries(&entry->timeline, &value_count);
+
+    const uint64_t          total_value_count = (uint64_t)value_count * (valid ? entry->timeline.series_count : 0);
+    const CacheTimelineRun* runs              = (const CacheTimelineRun*)((const uint8_t*)entry + entry->runs.base);
+    const uint64_t          run_count         = valid ? (entry->runs.size / sizeof(CacheTimelineRun)) : 0;
+    uint64_t                run_value_count   = 0;
+    for (uint64_t current_run_index = 0; valid && (current_run_index < run_count); ++current_run_index)
+    {
+        valid = (runs[current_run_index].count <= (total_value_count - run_value_count));
+        run_value_count += runs[current_run_index].count;
+    }
+
+    if (!valid || (run_value_count != total_value_count))
+    {
+        UnmapCacheFile(&mapping);
+        return RMT_ERROR_MALFORMED_DATA;
+    }
+
+    const size_t series_memory_buffer_size = (size_t)(total_value_count * sizeof(uint64_t));
+    uint64_t*    series_memory_buffer      = (uint64_t*)PerformAllocation(data_set, series_memory_buffer_size, sizeof(uint64_t));
+    if (series_memory_buffer == NULL)
+    {
+        UnmapCacheFile(&mapping);
+        return RMT_ERROR_OUT_OF_MEMORY;
+    }
+
+    // decode the runs, checking for cancellation every so often.
+    uint64_t current_value_index = 0;
+    for (uint64_t current_run_index = 0; current_run_index < run_count; ++current_run_index)
+    {
+        if (((current_run_index % 1024) == 0) && (RmtProgressUpdate(progress, current_value_index, total_value_count, 0) != RMT_OK))
+        {
+            PerformFree(data_set, series_memory_buffer);
+            UnmapCacheFile(&mapping);
+            return RMT_ERROR_CANCELLED;
+        }
+
+        for (uint64_t current_repeat_index = 0; current_repeat_index < runs[current_run_index].count; ++current_repeat_index)
+        {
+            series_memory_buffer[current_value_index++] = runs[current_run_index].value;
+        }
+    }
+
+    *out_timeline = entry->timeline;
+    UnmapCacheFile(&mapping);
+
+    // lay the series out in the buffer the same way as a generated timeline.
+    for (int32_t current_series_index = 0; current_series_index < out_timeline->series_count; ++current_series_index)
+    {
+        out_timeline->series[current_series_index].levels[0].values = series_memory_buffer + ((uint64_t)current_series_index * value_count);
+    }
+
+    out_timeline->data_set             = data_set;
+    out_timeline->series_memory_buffer = (int32_t*)series_memory_buffer;
+    return RMT_OK;
+}
+
+// get the runs of repeated values in the series of a timeline, one series after the other. The runs are
+// only counted if there is nowhere to write them.
+static uint64_t EncodeTimelineRuns(const RmtDataTimeline* timeline, CacheTimelineRun* out_runs)
+{
+    uint64_t run_count = 0;
+    uint64_t run_value = 0;
+    for (int32_t current_series_index = 0; current_series_index < timeline->series_count; ++current_series_index)
+    {
+        const RmtDataTimelineSeriesLevel* current_level = &timeline->series[current_series_index].levels[0];
+        for (int32_t current_value_index = 0; current_value_index < current_level->value_count; ++current_value_index)
+        {
+            const uint64_t value = current_level->values[current_value_index];
+            if ((run_count == 0) || (value != run_value))
+            {
+                if (out_runs != NULL)
+                {
+                    out_runs[run_count].value = value;
+                    out_runs[run_count].count = 0;
+                }
+                run_value = value;
+                run_count++;
+            }
+
+            if (out_runs != NULL)
+            {
+                out_runs[run_count - 1].count++;
+            }
+        }
+    }
+    return run_count;
+}
+
+RmtErrorCode RmtDataCacheWriteTimeline(RmtDataSet* data_set, const RmtDataTimeline* timeline, RmtProgress* progress)
+{
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(timeline, RMT_ERROR_INVALID_POINTER);
+
+    if (data_set->read_only)
+    {
+        return RMT_OK;
+    }
+
+    int32_t value_count = 0;
+    RMT_RETURN_ON_ERROR(ValidateTimelineSeries(timeline, &value_count), RMT_ERROR_MALFORMED_DATA);
+    RMT_RETURN_ON_ERROR(!RmtProgressIsCancelled(progress), RMT_ERROR_CANCELLED);
+
+    // the series hold long stretches of the same value between the events that change them.
+    const uint64_t    run_count = EncodeTimelineRuns(timeline, NULL);
+    CacheTimelineRun* runs      = (CacheTimelineRun*)PerformAllocation(data_set, (size_t)RMT_MAXIMUM(run_count, 1) * sizeof(CacheTimelineRun), sizeof(uint64_t));
+    RMT_RETURN_ON_ERROR(runs, RMT_ERROR_OUT_OF_MEMORY);
+    EncodeTimelineRuns(timeline, runs);
+    const CacheSection memory_section = {(uintptr_t)runs, run_count * sizeof(CacheTimelineRun)};
+
+    CacheTimelineEntry entry;
+    memset(&entry, 0, sizeof(CacheTimelineEntry));
+    entry.header.type = kCacheEntryTypeTimeline;
+    entry.header.key  = (uint64_t)timeline->timeline_type;
+    entry.header.size = LayoutSections(sizeof(CacheTimelineEntry), &memory_section, &entry.runs, 1);
+    entry.timeline    = *timeline;
+    for (int32_t current_series_index = 0; current_series_index < RMT_MAXIMUM_TIMELINE_DATA_SERIES; ++current_series_index)
+    {
+        for (int32_t current_level_index = 0; current_level_index < RMT_MAXIMUM_TIMELINE_SERIES_LEVELS; ++current_level_index)
+        {
+            entry.timeline.series[current_series_index].levels[current_level_index].values = NULL;
+        }
+    }
+    entry.timeline.data_set             = NULL;
+    entry.timeline.series_memory_buffer = NULL;
+
+    const void*        section_data = runs;
+    const RmtErrorCode error_code   = AppendEntry(data_set, progress, &entry, sizeof(CacheTimelineEntry), &section_data, &entry.runs, 1);
+    PerformFree(data_set, runs);
+    return error_code;
+}
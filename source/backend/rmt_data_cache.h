@@ -0,0 +1,133 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \brief  Definition of the cache file which keeps generated snapshots and timelines between sessions.
+//=============================================================================
+
+#ifndef RMV_BACKEND_RMT_DATA_CACHE_H_
+#define RMV_BACKEND_RMT_DATA_CACHE_H_
+
+#include <rmt_error.h>
+#include "rmt_data_timeline.h"
+
+/// The version of the cache file format. Increment this whenever the layout of the cached data changes.
+#define RMT_DATA_CACHE_VERSION (4)
+
+/// The extension added to the path of an RMV file to give the path of its cache file.
+#define RMT_DATA_CACHE_FILE_EXTENSION ".cache"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // #ifdef __cplusplus
+
+typedef struct RmtDataSet       RmtDataSet;
+typedef struct RmtDataSnapshot  RmtDataSnapshot;
+typedef struct RmtSnapshotPoint RmtSnapshotPoint;
+typedef struct RmtProgress      RmtProgress;
+
+/// Read a snapshot from the cache file of a data set.
+///
+/// The cache file sits next to the RMV file and holds the snapshots and timelines generated
+/// by earlier sessions. Each entry is stored with its pointers written as offsets from the
+/// start of the entry, so the file is mapped and the entry copied in to the snapshot's buffers
+/// rather than the RMT streams being replayed. Only the parts of the snapshot's lists in use
+/// are stored, and the lists are laid out in buffers of their full size again when read. The
+/// cache is ignored if it was written by a different version of RMV, or for a trace with
+/// different RMT streams.
+///
+/// @param [in]  data_set                       A pointer to a <c><i>RmtDataSet</i></c> structure the snapshot belongs to.
+/// @param [in]  snapshot_point                 The snapshot point to read the snapshot for.
+/// @param [in]  progress                       A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for cancellation, or <c><i>NULL</i></c>.
+/// @param [out] out_snapshot                   The address of a <c><i>RmtDataSnapshot</i></c> structure to populate.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed because a parameter was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_FILE_NOT_OPEN                     The operation failed because there is no valid cache file for the data set.
+/// @retval
+/// RMT_ERROR_INDEX_OUT_OF_RANGE                The operation failed because the snapshot isn't in the cache file.
+/// @retval
+/// RMT_ERROR_MALFORMED_DATA                    The operation failed because the cached snapshot doesn't match the data set.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the snapshot's buffers couldn't be allocated.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and nothing was read.
+///
+RmtErrorCode RmtDataCacheReadSnapshot(RmtDataSet* data_set, RmtSnapshotPoint* snapshot_point, RmtProgress* progress, RmtDataSnapshot* out_snapshot);
+
+/// Add a generated snapshot to the cache file of a data set.
+///
+/// Nothing is written if the data set is read only, or the snapshot is already in the cache file.
+///
+/// @param [in]  data_set                       A pointer to a <c><i>RmtDataSet</i></c> structure the snapshot belongs to.
+/// @param [in]  snapshot                       The snapshot to write.
+/// @param [in]  progress                       A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for cancellation, or <c><i>NULL</i></c>.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed because a parameter was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_FILE_NOT_OPEN                     The operation failed because the cache file couldn't be written.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the staging buffers couldn't be allocated.
+/// @retval
+/// RMT_ERROR_MALFORMED_DATA                    The operation failed because the snapshot's resource tree couldn't be stored.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and the entry was not added.
+///
+RmtErrorCode RmtDataCacheWriteSnapshot(RmtDataSet* data_set, const RmtDataSnapshot* snapshot, RmtProgress* progress);
+
+/// Read a timeline from the cache file of a data set.
+///
+/// @param [in]  data_set                       A pointer to a <c><i>RmtDataSet</i></c> structure the timeline belongs to.
+/// @param [in]  timeline_type                  The type of timeline to read.
+/// @param [in]  progress                       A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for cancellation, or <c><i>NULL</i></c>.
+/// @param [out] out_timeline                   The address of a <c><i>RmtDataTimeline</i></c> structure to populate.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed because a parameter was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_FILE_NOT_OPEN                     The operation failed because there is no valid cache file for the data set.
+/// @retval
+/// RMT_ERROR_INDEX_OUT_OF_RANGE                The operation failed because the timeline isn't in the cache file.
+/// @retval
+/// RMT_ERROR_MALFORMED_DATA                    The operation failed because the cached timeline doesn't match the data set.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the series buffer couldn't be allocated.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and nothing was read.
+///
+RmtErrorCode RmtDataCacheReadTimeline(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtProgress* progress, RmtDataTimeline* out_timeline);
+
+/// Add a generated timeline to the cache file of a data set.
+///
+/// Nothing is written if the data set is read only, or a timeline of the same type is already in the cache file.
+///
+/// @param [in]  data_set                       A pointer to a <c><i>RmtDataSet</i></c> structure the timeline belongs to.
+/// @param [in]  timeline                       The timeline to write.
+/// @param [in]  progress                       A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for cancellation, or <c><i>NULL</i></c>.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed because a parameter was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_FILE_NOT_OPEN                     The operation failed because the cache file couldn't be written.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the staging buffer couldn't be allocated.
+/// @retval
+/// RMT_ERROR_MALFORMED_DATA                    The operation failed because the timeline's series aren't laid out as a generated timeline.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and the entry was not added.
+///
+RmtErrorCode RmtDataCacheWriteTimeline(RmtDataSet* data_set, const RmtDataTimeline* timeline, RmtProgress* progress);
+
+#ifdef __cplusplus
+}
+#endif  // #ifdef __cplusplus
+#endif  // #ifndef RMV_BACKEND_RMT_DATA_CACHE_H_
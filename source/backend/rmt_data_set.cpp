@@ -6,6 +6,7 @@
 
 #include "rmt_data_set.h"
 #include "rmt_data_timeline.h"
+#include "rmt_data_cache.h"
 #include <rmt_util.h>
 #include <rmt_assert.h>
 #include <string.h>  // for memcpy()
@@ -13,6 +14,7 @@
 #include "rmt_linear_buffer.h"
 #include "rmt_data_snapshot.h"
 #include "rmt_resource_history.h"
+#include "rmt_resource_trend.h"
 #include <rmt_file_format.h>
 #include <rmt_print.h>
 #include <rmt_address_helper.h>
@@ -35,7 +37,9 @@
 //
 // NOTE: If we new the total stream count ahead of time, we could divide this more intelligently.
 // From very quick tests you probably don't want to go less than 128KB per stream.
-static uint8_t s_file_read_buffer[16 * 1024 * 1024];
+//
+// Each data set owns its buffer, so several data sets can be loaded and replayed at once.
+#define RMT_FILE_READ_BUFFER_SIZE (16 * 1024 * 1024)
 
 // create a stream for the RMT chunk
 static RmtErrorCode ParseRmtDataChunk(RmtDataSet* data_set, RmtFileChunkHeader* file_chunk)
@@ -59,18 +63,19 @@ static RmtErrorCode ParseRmtDataChunk(RmtDataSet* data_set, RmtFileChunkHeader*
     }
 
     // create an RMT parser for this stream with a file handle and offset.
-    RmtParser*         parser     = &data_set->streams[data_set->stream_count];
-    const RmtErrorCode error_code = RmtParserInitialize(parser,
-                                                        (FILE*)data_set->file_handle,
-                                                        offset,
-                                                        size,
-                                                        s_file_read_buffer + (data_set->stream_count * (sizeof(s_file_read_buffer) / RMT_MAXIMUM_STREAMS)),
-                                                        (sizeof(s_file_read_buffer) / RMT_MAXIMUM_STREAMS),
-                                                        file_chunk->version_major,
-                                                        file_chunk->version_minor,
-                                                        data_set->stream_count,
-                                                        data_chunk.process_id,
-                                                        data_chunk.thread_id);
+    const int32_t      stream_buffer_size = RMT_FILE_READ_BUFFER_SIZE / RMT_MAXIMUM_STREAMS;
+    RmtParser*         parser             = &data_set->streams[data_set->stream_count];
+    const RmtErrorCode error_code         = RmtParserInitialize(parser,
+                                                                  (FILE*)data_set->file_handle,
+                                                                  offset,
+                                                                  size,
+                                                                  data_set->file_read_buffer + (data_set->stream_count * stream_buffer_size),
+                                                                  stream_buffer_size,
+                                                                  file_chunk->version_major,
+                                                                  file_chunk->version_minor,
+                                                                  data_set->stream_count,
+                                                                  data_chunk.process_id,
+                                                                  data_chunk.thread_id);
 
     // set the target process.
     if (data_chunk.process_id != 0 && data_set->target_process_id == 0)
@@ -356,7 +361,7 @@ static void BuildDataProfileParseResourceDestroy(RmtDataSet* data_set, const Rmt
 }
 
 // Build a data profile which can be used by all subsequent parsing.
-static RmtErrorCode BuildDataProfile(RmtDataSet* data_set)
+static RmtErrorCode BuildDataProfile(RmtDataSet* data_set, RmtProgress* progress)
 {
     // get the stream count from the loader, and initialize all the counters
     data_set->data_profile.stream_count        = data_set->stream_count;
@@ -372,14 +377,21 @@ static RmtErrorCode BuildDataProfile(RmtDataSet* data_set)
     }
 
     // if the heap has something there, then add it.
+    uint64_t token_count = 0;
     while (!RmtStreamMergerIsEmpty(&data_set->stream_merger))
     {
         // grab the next token from the heap.
-        RmtToken           current_token;
-        const RmtErrorCode error_code = RmtStreamMergerAdvance(&data_set->stream_merger, &current_token);
+        RmtToken     current_token;
+        RmtErrorCode error_code = RmtStreamMergerAdvance(&data_set->stream_merger, &current_token);
         RMT_ASSERT(error_code == RMT_OK);
         RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
 
+        if ((++token_count % RMT_PROGRESS_TOKEN_INTERVAL) == 0)
+        {
+            error_code = RmtProgressUpdateFromStreams(progress, &data_set->stream_merger, token_count);
+            RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+        }
+
         data_set->maximum_timestamp = RMT_MAXIMUM(data_set->maximum_timestamp, current_token.common.timestamp);
 
         // process the token.
@@ -451,6 +463,45 @@ static void PerformFree(RmtDataSet* data_set, void* pointer)
     return (data_set->free_func)(pointer);
 }
 
+// the layout of the values stored with each timeline checkpoint. The state read by every
+// timeline type is recorded, so a timeline of any type can be written from the checkpoints.
+#define CHECKPOINT_MAXIMUM_OFFSET (0)
+#define CHECKPOINT_PROCESS_COUNT_OFFSET (CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeCount)
+#define CHECKPOINT_COMMITTED_OFFSET (CHECKPOINT_PROCESS_COUNT_OFFSET + 1)
+#define CHECKPOINT_RESOURCE_USAGE_COUNT_OFFSET (CHECKPOINT_COMMITTED_OFFSET + kRmtHeapTypeCount)
+#define CHECKPOINT_RESOURCE_USAGE_SIZE_OFFSET (CHECKPOINT_RESOURCE_USAGE_COUNT_OFFSET + kRmtResourceUsageTypeCount)
+#define CHECKPOINT_VIRTUAL_MEMORY_OFFSET (CHECKPOINT_RESOURCE_USAGE_SIZE_OFFSET + kRmtResourceUsageTypeCount)
+#define CHECKPOINT_PROCESS_OFFSET (CHECKPOINT_VIRTUAL_MEMORY_OFFSET + kRmtHeapTypeCount)
+
+// the number of checkpoints allocated up front, this is doubled whenever it runs out.
+#define INITIAL_CHECKPOINT_CAPACITY (4096)
+
+// the state of the data set at the end of each series index which contains RMT tokens.
+struct RmtDataTimelineCheckpoints
+{
+    int32_t*  value_indices;        // the level-0 series index of each checkpoint, in increasing order.
+    uint64_t* values;               // value_stride values for each checkpoint.
+    int32_t   value_stride;         // the number of values stored for each checkpoint.
+    int32_t   process_capacity;     // the number of processes stored for each checkpoint.
+    int32_t   checkpoint_count;     // the number of checkpoints recorded.
+    int32_t   checkpoint_capacity;  // the number of checkpoints there is memory for.
+};
+
+// free the checkpoints recorded for the data set.
+static void DestroyTimelineCheckpoints(RmtDataSet* data_set)
+{
+    RmtDataTimelineCheckpoints* checkpoints = data_set->timeline_checkpoints;
+    if (checkpoints == nullptr)
+    {
+        return;
+    }
+
+    PerformFree(data_set, checkpoints->value_indices);
+    PerformFree(data_set, checkpoints->values);
+    PerformFree(data_set, checkpoints);
+    data_set->timeline_checkpoints = nullptr;
+}
+
 // Allocate memory for a snapshot.
 static RmtErrorCode AllocateMemoryForSnapshot(RmtDataSet* data_set, RmtDataSnapshot* out_snapshot)
 {
@@ -495,6 +546,13 @@ static RmtErrorCode AllocateMemoryForSnapshot(RmtDataSet* data_set, RmtDataSnaps
     out_snapshot->region_stack_buffer = NULL;
     out_snapshot->region_stack_count  = 0;
 
+    // the backing storage of each resource is calculated once the snapshot is complete.
+    out_snapshot->resource_backing_storage       = NULL;
+    out_snapshot->resource_backing_storage_count = 0;
+
+    // the aggregates are also calculated once the snapshot is complete.
+    memset(&out_snapshot->aggregates, 0, sizeof(RmtSnapshotAggregates));
+
     return RMT_OK;
 }
 
@@ -577,7 +635,7 @@ static RmtErrorCode ProcessTokenForSnapshot(RmtDataSet* data_set, RmtToken* curr
                 &out_snapshot->resource_list, current_token->userdata_token.resource_identifer, (const RmtResource**)&found_resource);
             if (error_code == RMT_OK)
             {
-                memcpy(found_resource->name,
+                memcpy(found_resource->details->name,
                        current_token->userdata_token.payload,
                        RMT_MINIMUM(current_token->userdata_token.size_in_bytes, RMT_MAXIMUM_NAME_LENGTH));
             }
@@ -654,7 +712,9 @@ static RmtErrorCode ProcessTokenForSnapshot(RmtDataSet* data_set, RmtToken* curr
                 resource_create_token.commit_type         = matching_resource->commit_type;
                 resource_create_token.resource_type       = kRmtResourceTypeCommandAllocator;
                 memcpy(&resource_create_token.common, &current_token->common, sizeof(RmtTokenCommon));
-                memcpy(&resource_create_token.command_allocator, &matching_resource->command_allocator, sizeof(RmtResourceDescriptionCommandAllocator));
+                memcpy(&resource_create_token.command_allocator,
+                       &matching_resource->details->command_allocator,
+                       sizeof(RmtResourceDescriptionCommandAllocator));
 
                 // Create the resource.
                 error_code = RmtResourceListAddResourceCreate(&out_snapshot->resource_list, &resource_create_token);
@@ -857,7 +917,7 @@ static bool IsFileReadOnly(const char* path)
 }
 
 // initialize the data set by reading the header chunks, and setting up the streams.
-RmtErrorCode RmtDataSetInitialize(const char* path, RmtDataSet* data_set)
+RmtErrorCode RmtDataSetInitialize(const char* path, bool read_only, RmtProgress* progress, RmtDataSet* data_set)
 {
     RMT_ASSERT(path);
     RMT_ASSERT(data_set);
@@ -869,15 +929,19 @@ RmtErrorCode RmtDataSetInitialize(const char* path, RmtDataSet* data_set)
     memcpy(data_set->file_path, path, RMT_MINIMUM(RMT_MAXIMUM_FILE_PATH, path_length));
     memcpy(data_set->temporary_file_path, path, RMT_MINIMUM(RMT_MAXIMUM_FILE_PATH, path_length));
 
-    data_set->file_handle = NULL;
-    data_set->read_only   = false;
+    data_set->file_handle          = NULL;
+    data_set->read_only            = read_only;
+    data_set->file_read_buffer     = NULL;
+    data_set->timeline_checkpoints = NULL;
+    RmtResourceEventIndexInitialize(&data_set->resource_event_index);
     errno_t error_no;
 
-    if (IsFileReadOnly(path))
+    if (!data_set->read_only && IsFileReadOnly(path))
     {
         data_set->read_only = true;
     }
-    else
+
+    if (!data_set->read_only)
     {
         // copy the entire input file to a temporary.
 #ifdef _WIN32
@@ -924,13 +988,37 @@ RmtErrorCode RmtDataSetInitialize(const char* path, RmtDataSet* data_set)
         return RMT_ERROR_FILE_NOT_OPEN;
     }
 
+    // allocate the buffer the stream parsers read chunks of the file into.
+    data_set->file_read_buffer = (uint8_t*)PerformAllocation(data_set, RMT_FILE_READ_BUFFER_SIZE, sizeof(uint64_t));
+    RMT_RETURN_ON_ERROR(data_set->file_read_buffer != NULL, RMT_ERROR_OUT_OF_MEMORY);
+
     // parse all the chunk headers from the file.
     RmtErrorCode error_code = ParseChunks(data_set);
     RMT_ASSERT(error_code == RMT_OK);
     RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
 
     // construct the data profile for subsequent data parsing.
-    error_code = BuildDataProfile(data_set);
+    error_code = BuildDataProfile(data_set, progress);
+    if (error_code == RMT_ERROR_CANCELLED)
+    {
+        // nothing has been edited, so put the file back as it was.
+        fclose((FILE*)data_set->file_handle);
+        data_set->file_handle = NULL;
+        CommitTemporaryFileEdits(data_set, true);
+        PerformFree(data_set, data_set->file_read_buffer);
+        data_set->file_read_buffer = NULL;
+        return error_code;
+    }
+    RMT_ASSERT(error_code == RMT_OK);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+    // the streams are replayed by several operations, which may run on different threads.
+    error_code = RmtMutexCreate(&data_set->stream_mutex, "RMT Stream Mutex");
+    RMT_ASSERT(error_code == RMT_OK);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+    // the cache file is read and written separately from the replays.
+    error_code = RmtMutexCreate(&data_set->cache_mutex, "RMT Cache Mutex");
     RMT_ASSERT(error_code == RMT_OK);
     RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
 
@@ -947,6 +1035,14 @@ RmtErrorCode RmtDataSetDestroy(RmtDataSet* data_set)
 
     CommitTemporaryFileEdits(data_set, true);
 
+    DestroyTimelineCheckpoints(data_set);
+    RmtResourceEventIndexDestroy(&data_set->resource_event_index);
+    RmtMutexDestroy(&data_set->stream_mutex);
+    RmtMutexDestroy(&data_set->cache_mutex);
+
+    PerformFree(data_set, data_set->file_read_buffer);
+    data_set->file_read_buffer = NULL;
+
     data_set->file_handle = NULL;
     return RMT_OK;
 }
@@ -989,114 +1085,215 @@ static int32_t GetSeriesCountFromTimelineType(const RmtDataSet* data_set, RmtDat
     }
 }
 
-// calculate the grouping value for a collection
-static int32_t UpdateSeriesValuesFromCurrentSnapshot(const RmtDataSnapshot* current_snapshot,
-                                                     RmtDataTimelineType    timeline_type,
-                                                     int32_t                last_value_index,
-                                                     RmtDataTimeline*       out_timeline)
+// get the committed memory at the start of each process, indexed the same as the process series.
+static void GetProcessStartValues(const RmtDataSet* data_set, uint64_t* out_values, int32_t value_count)
 {
-    // calculate the index within the level-0 series for the value
-    const int32_t value_index = RmtDataSetGetSeriesIndexForTimestamp(current_snapshot->data_set, current_snapshot->timestamp);
+    memset(out_values, 0, value_count * sizeof(uint64_t));
 
-    // Smeer from lastValueIndex until valueIndex if its >1 step away.
-    if (last_value_index > 0)
+    for (int32_t current_process_start_index = 0; current_process_start_index < data_set->process_start_info_count; ++current_process_start_index)
     {
-        for (int32_t current_value_index = last_value_index + 1; current_value_index < value_index; ++current_value_index)
+        int32_t series_index = -1;
+        RmtProcessMapGetIndexFromProcessId(&data_set->process_map, data_set->process_start_info[current_process_start_index].process_id, &series_index);
+        RMT_ASSERT(series_index >= 0);
+
+        if ((series_index >= 0) && (series_index < value_count))
         {
-            for (int32_t current_series_index = 0; current_series_index < out_timeline->series_count; ++current_series_index)
-            {
-                const uint64_t value = out_timeline->series[current_series_index].levels[0].values[last_value_index];
-                out_timeline->series[current_series_index].levels[0].values[current_value_index] = value;
-            }
+            out_values[series_index] = data_set->process_start_info[current_process_start_index].physical_memory_allocated;
         }
     }
+}
 
-    // handle the values for this timeline type.
-    switch (timeline_type)
+// double the number of checkpoints that can be recorded.
+static RmtErrorCode GrowTimelineCheckpoints(RmtDataSet* data_set, RmtDataTimelineCheckpoints* checkpoints)
+{
+    const int32_t new_capacity = (checkpoints->checkpoint_capacity == 0) ? INITIAL_CHECKPOINT_CAPACITY : checkpoints->checkpoint_capacity * 2;
+    RMT_RETURN_ON_ERROR(new_capacity > checkpoints->checkpoint_capacity, RMT_ERROR_OUT_OF_MEMORY);
+
+    const size_t values_size  = (size_t)checkpoints->value_stride * sizeof(uint64_t);
+    int32_t*     value_indices = (int32_t*)PerformAllocation(data_set, new_capacity * sizeof(int32_t), sizeof(int32_t));
+    uint64_t*    values        = (uint64_t*)PerformAllocation(data_set, new_capacity * values_size, sizeof(uint64_t));
+    if ((value_indices == nullptr) || (values == nullptr))
     {
-    case kRmtDataTimelineTypeProcess:
+        PerformFree(data_set, value_indices);
+        PerformFree(data_set, values);
+        return RMT_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (checkpoints->checkpoint_count > 0)
     {
-        for (int32_t current_process_index = 0; current_process_index < current_snapshot->process_map.process_count; ++current_process_index)
-        {
-            const uint64_t comitted_memory_for_process = current_snapshot->process_map.process_committed_memory[current_process_index];
-            out_timeline->series[current_process_index].levels[0].values[value_index] = comitted_memory_for_process;
-        }
+        memcpy(value_indices, checkpoints->value_indices, checkpoints->checkpoint_count * sizeof(int32_t));
+        memcpy(values, checkpoints->values, checkpoints->checkpoint_count * values_size);
     }
-    break;
 
-    case kRmtDataTimelineTypeCommitted:
+    PerformFree(data_set, checkpoints->value_indices);
+    PerformFree(data_set, checkpoints->values);
+    checkpoints->value_indices       = value_indices;
+    checkpoints->values              = values;
+    checkpoints->checkpoint_capacity = new_capacity;
+    return RMT_OK;
+}
+
+// record the state the timelines are generated from into the checkpoint for the current series index.
+static RmtErrorCode RecordTimelineCheckpoint(RmtDataSet* data_set, const RmtDataSnapshot* current_snapshot, const uint64_t* process_start_values)
+{
+    RmtDataTimelineCheckpoints* checkpoints = data_set->timeline_checkpoints;
+
+    // calculate the index within the level-0 series for the value
+    const int32_t value_index = RmtDataSetGetSeriesIndexForTimestamp(data_set, current_snapshot->timestamp);
+
+    // start a new checkpoint when the token is in the next series index, otherwise the
+    // checkpoint is overwritten so it holds the state after the last token in the index.
+    if ((checkpoints->checkpoint_count == 0) || (checkpoints->value_indices[checkpoints->checkpoint_count - 1] != value_index))
     {
-        for (int32_t current_heap_type_index = 0; current_heap_type_index < kRmtHeapTypeCount; ++current_heap_type_index)
+        if (checkpoints->checkpoint_count == checkpoints->checkpoint_capacity)
         {
-            const uint64_t heap_type_count                                              = current_snapshot->page_table.mapped_per_heap[current_heap_type_index];
-            out_timeline->series[current_heap_type_index].levels[0].values[value_index] = heap_type_count;
+            const RmtErrorCode error_code = GrowTimelineCheckpoints(data_set, checkpoints);
+            RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
         }
+
+        const int32_t checkpoint_index              = checkpoints->checkpoint_count++;
+        checkpoints->value_indices[checkpoint_index] = value_index;
+        memset(&checkpoints->values[(size_t)checkpoint_index * checkpoints->value_stride], 0, checkpoints->value_stride * sizeof(uint64_t));
     }
-    break;
 
-    case kRmtDataTimelineTypeResourceUsageCount:
+    uint64_t* values = &checkpoints->values[(size_t)(checkpoints->checkpoint_count - 1) * checkpoints->value_stride];
+    uint64_t  total  = 0;
+
+    // committed memory per process. Processes not seen yet still hold their start value in the 0th series index.
+    const int32_t process_count = RMT_MINIMUM(current_snapshot->process_map.process_count, checkpoints->process_capacity);
+    for (int32_t current_process_index = 0; current_process_index < process_count; ++current_process_index)
+    {
+        values[CHECKPOINT_PROCESS_OFFSET + current_process_index] = current_snapshot->process_map.process_committed_memory[current_process_index];
+        total += values[CHECKPOINT_PROCESS_OFFSET + current_process_index];
+    }
+    if (value_index == 0)
     {
-        for (int32_t current_resource_index = 0; current_resource_index < kRmtResourceUsageTypeCount; ++current_resource_index)
+        for (int32_t current_process_index = process_count; current_process_index < checkpoints->process_capacity; ++current_process_index)
         {
-            const int32_t resource_count_for_usage_type = current_snapshot->resource_list.resource_usage_count[current_resource_index];
-
-            // Write this to the correct slot in the series.
-            if (current_resource_index == kRmtResourceUsageTypeHeap)
-            {
-                out_timeline->series[current_resource_index].levels[0].values[value_index] = 0;
-            }
-            else
-            {
-                out_timeline->series[current_resource_index].levels[0].values[value_index] = resource_count_for_usage_type;
-            }
+            total += process_start_values[current_process_index];
         }
     }
-    break;
+    values[CHECKPOINT_PROCESS_COUNT_OFFSET] = process_count;
+    values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeProcess] =
+        RMT_MAXIMUM(values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeProcess], total);
 
-    case kRmtDataTimelineTypeResourceUsageVirtualSize:
+    // committed memory per heap.
+    total = 0;
+    for (int32_t current_heap_type_index = 0; current_heap_type_index < kRmtHeapTypeCount; ++current_heap_type_index)
     {
-        for (int32_t current_resource_index = 0; current_resource_index < kRmtResourceUsageTypeCount; ++current_resource_index)
-        {
-            const uint64_t resource_size_for_usage_type = current_snapshot->resource_list.resource_usage_size[current_resource_index];
-
-            // Write this to the correct slot in the series.
-            if (current_resource_index == kRmtResourceUsageTypeHeap)
-            {
-                out_timeline->series[current_resource_index].levels[0].values[value_index] = 0;
-            }
-            else
-            {
-                out_timeline->series[current_resource_index].levels[0].values[value_index] = resource_size_for_usage_type;
-            }
-        }
+        values[CHECKPOINT_COMMITTED_OFFSET + current_heap_type_index] = current_snapshot->page_table.mapped_per_heap[current_heap_type_index];
+        total += values[CHECKPOINT_COMMITTED_OFFSET + current_heap_type_index];
     }
-    break;
+    values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeCommitted] =
+        RMT_MAXIMUM(values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeCommitted], total);
 
-    case kRmtDataTimelineTypeVirtualMemory:
+    // resource count and size per usage type, heaps are not shown.
+    total                   = 0;
+    uint64_t total_size     = 0;
+    for (int32_t current_resource_index = 0; current_resource_index < kRmtResourceUsageTypeCount; ++current_resource_index)
     {
-        for (int32_t current_heap_type_index = 0; current_heap_type_index < kRmtHeapTypeCount; ++current_heap_type_index)
+        if (current_resource_index == kRmtResourceUsageTypeHeap)
         {
-            const uint64_t heap_type_count = current_snapshot->virtual_allocation_list.allocations_per_preferred_heap[current_heap_type_index];
-            out_timeline->series[current_heap_type_index].levels[0].values[value_index] = heap_type_count;
+            values[CHECKPOINT_RESOURCE_USAGE_COUNT_OFFSET + current_resource_index] = 0;
+            values[CHECKPOINT_RESOURCE_USAGE_SIZE_OFFSET + current_resource_index]  = 0;
+            continue;
         }
+
+        values[CHECKPOINT_RESOURCE_USAGE_COUNT_OFFSET + current_resource_index] = current_snapshot->resource_list.resource_usage_count[current_resource_index];
+        values[CHECKPOINT_RESOURCE_USAGE_SIZE_OFFSET + current_resource_index]  = current_snapshot->resource_list.resource_usage_size[current_resource_index];
+        total += values[CHECKPOINT_RESOURCE_USAGE_COUNT_OFFSET + current_resource_index];
+        total_size += values[CHECKPOINT_RESOURCE_USAGE_SIZE_OFFSET + current_resource_index];
     }
-    break;
+    values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeResourceUsageCount] =
+        RMT_MAXIMUM(values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeResourceUsageCount], total);
+    values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeResourceUsageVirtualSize] =
+        RMT_MAXIMUM(values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeResourceUsageVirtualSize], total_size);
+
+    // virtual memory per preferred heap.
+    total = 0;
+    for (int32_t current_heap_type_index = 0; current_heap_type_index < kRmtHeapTypeCount; ++current_heap_type_index)
+    {
+        values[CHECKPOINT_VIRTUAL_MEMORY_OFFSET + current_heap_type_index] =
+            current_snapshot->virtual_allocation_list.allocations_per_preferred_heap[current_heap_type_index];
+        total += values[CHECKPOINT_VIRTUAL_MEMORY_OFFSET + current_heap_type_index];
+    }
+    values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeVirtualMemory] =
+        RMT_MAXIMUM(values[CHECKPOINT_MAXIMUM_OFFSET + kRmtDataTimelineTypeVirtualMemory], total);
+
+    return RMT_OK;
+}
+
+// write the series values for a timeline type from a checkpoint.
+static void WriteSeriesValuesFromCheckpoint(const uint64_t* values, RmtDataTimelineType timeline_type, int32_t value_index, RmtDataTimeline* out_timeline)
+{
+    int32_t value_offset = 0;
+    int32_t value_count  = 0;
+
+    switch (timeline_type)
+    {
+    case kRmtDataTimelineTypeProcess:
+        value_offset = CHECKPOINT_PROCESS_OFFSET;
+        value_count  = RMT_MINIMUM((int32_t)values[CHECKPOINT_PROCESS_COUNT_OFFSET], out_timeline->series_count);
+        break;
+
+    case kRmtDataTimelineTypeCommitted:
+        value_offset = CHECKPOINT_COMMITTED_OFFSET;
+        value_count  = kRmtHeapTypeCount;
+        break;
+
+    case kRmtDataTimelineTypeResourceUsageCount:
+        value_offset = CHECKPOINT_RESOURCE_USAGE_COUNT_OFFSET;
+        value_count  = kRmtResourceUsageTypeCount;
+        break;
+
+    case kRmtDataTimelineTypeResourceUsageVirtualSize:
+        value_offset = CHECKPOINT_RESOURCE_USAGE_SIZE_OFFSET;
+        value_count  = kRmtResourceUsageTypeCount;
+        break;
+
+    case kRmtDataTimelineTypeVirtualMemory:
+        value_offset = CHECKPOINT_VIRTUAL_MEMORY_OFFSET;
+        value_count  = kRmtHeapTypeCount;
+        break;
 
     default:
         break;
     }
 
-    // Sum the values in each series, and take the max against maximumValueInAllSeries
-    uint64_t total_for_all_series = 0;
-    for (int32_t current_series_index = 0; current_series_index < out_timeline->series_count; ++current_series_index)
+    for (int32_t current_series_index = 0; current_series_index < value_count; ++current_series_index)
     {
-        total_for_all_series += out_timeline->series[current_series_index].levels[0].values[value_index];
+        out_timeline->series[current_series_index].levels[0].values[value_index] = values[value_offset + current_series_index];
     }
+}
 
-    // track the max.
-    out_timeline->maximum_value_in_all_series = RMT_MAXIMUM(out_timeline->maximum_value_in_all_series, total_for_all_series);
+// write the series values for every checkpoint, smearing each one forward to the next.
+static void WriteSeriesValuesFromCheckpoints(const RmtDataTimelineCheckpoints* checkpoints, RmtDataTimelineType timeline_type, RmtDataTimeline* out_timeline)
+{
+    for (int32_t current_checkpoint_index = 0; current_checkpoint_index < checkpoints->checkpoint_count; ++current_checkpoint_index)
+    {
+        const uint64_t* values      = &checkpoints->values[(size_t)current_checkpoint_index * checkpoints->value_stride];
+        const int32_t   value_index = checkpoints->value_indices[current_checkpoint_index];
+        WriteSeriesValuesFromCheckpoint(values, timeline_type, value_index, out_timeline);
+
+        // Smeer until the next checkpoint if its >1 step away. Nothing after the
+        // last checkpoint or after the 0th series index is smeered.
+        if ((value_index > 0) && ((current_checkpoint_index + 1) < checkpoints->checkpoint_count))
+        {
+            const int32_t next_value_index = checkpoints->value_indices[current_checkpoint_index + 1];
+            for (int32_t current_value_index = value_index + 1; current_value_index < next_value_index; ++current_value_index)
+            {
+                for (int32_t current_series_index = 0; current_series_index < out_timeline->series_count; ++current_series_index)
+                {
+                    const uint64_t value = out_timeline->series[current_series_index].levels[0].values[value_index];
+                    out_timeline->series[current_series_index].levels[0].values[current_value_index] = value;
+                }
+            }
+        }
 
-    return value_index;
+        // track the max.
+        out_timeline->maximum_value_in_all_series =
+            RMT_MAXIMUM(out_timeline->maximum_value_in_all_series, values[CHECKPOINT_MAXIMUM_OFFSET + timeline_type]);
+    }
 }
 
 //  Allocate memory for the stuff we counted in the RmtDataProfile.
@@ -1131,15 +1328,31 @@ static RmtErrorCode TimelineGeneratorAllocateMemory(RmtDataSet* data_set, RmtDat
     return RMT_OK;
 }
 
-// Load the data into the structures we have allocated.
-static RmtErrorCode TimelineGeneratorParseData(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtDataTimeline* out_timeline)
+// Replay the RMT streams once, recording a checkpoint of the state at the end of every series index.
+static RmtErrorCode TimelineGeneratorRecordCheckpoints(RmtDataSet* data_set, RmtProgress* progress)
 {
     RMT_ASSERT(data_set);
+    RMT_ASSERT(data_set->timeline_checkpoints == nullptr);
+
+    RmtDataTimelineCheckpoints* checkpoints =
+        (RmtDataTimelineCheckpoints*)PerformAllocation(data_set, sizeof(RmtDataTimelineCheckpoints), alignof(RmtDataTimelineCheckpoints));
+    RMT_ASSERT(checkpoints);
+    RMT_RETURN_ON_ERROR(checkpoints, RMT_ERROR_OUT_OF_MEMORY);
+    memset(checkpoints, 0, sizeof(RmtDataTimelineCheckpoints));
+    checkpoints->process_capacity  = RMT_MINIMUM(data_set->process_map.process_count, RMT_MAXIMUM_TIMELINE_DATA_SERIES);
+    checkpoints->value_stride      = CHECKPOINT_PROCESS_OFFSET + checkpoints->process_capacity;
+    data_set->timeline_checkpoints = checkpoints;
+
+    // the committed memory from the process start information is counted in the 0th series index
+    // for processes which have no tokens there.
+    uint64_t process_start_values[RMT_MAXIMUM_TIMELINE_DATA_SERIES];
+    GetProcessStartValues(data_set, process_start_values, checkpoints->process_capacity);
 
     // Allocate temporary snapshot.
     RmtDataSnapshot* temp_snapshot = (RmtDataSnapshot*)PerformAllocation(data_set, sizeof(RmtDataSnapshot), alignof(RmtDataSnapshot));
     RMT_ASSERT(temp_snapshot);
     RMT_RETURN_ON_ERROR(temp_snapshot, RMT_ERROR_OUT_OF_MEMORY);
+
     RmtErrorCode error_code = AllocateMemoryForSnapshot(data_set, temp_snapshot);
     RMT_ASSERT(error_code == RMT_OK);
     RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
@@ -1155,53 +1368,120 @@ static RmtErrorCode TimelineGeneratorParseData(RmtDataSet* data_set, RmtDataTime
     error_code = RmtProcessMapInitialize(&temp_snapshot->process_map);
     RMT_ASSERT(error_code == RMT_OK);
 
-    // Special case:
-    // for timeline type of process, we have to first fill the 0th value of level 0
-    // of each series with the total amount of committed memory from the process start
-    // information.
-    if (timeline_type == kRmtDataTimelineTypeProcess)
+    // the resource history index is built from the same replay, unless it has been built already.
+    const bool build_resource_event_index = !data_set->resource_event_index.is_complete;
+    if (build_resource_event_index)
     {
-        for (int32_t current_process_start_index = 0; current_process_start_index < data_set->process_start_info_count; ++current_process_start_index)
-        {
-            int32_t series_index = -1;
-            RmtProcessMapGetIndexFromProcessId(&data_set->process_map, data_set->process_start_info[current_process_start_index].process_id, &series_index);
-            RMT_ASSERT(series_index >= 0);
-
-            const uint64_t value = data_set->process_start_info[current_process_start_index].physical_memory_allocated;
-
-            // Write the value for the process start to 0th value of 0th level each series.
-            out_timeline->series[current_process_start_index].levels[0].values[0] = value;
-        }
+        RmtResourceEventIndexDestroy(&data_set->resource_event_index);
     }
 
     RmtStreamMergerReset(&data_set->stream_merger);
 
     // if the heap has something there, then add it.
-    int32_t last_value_index = -1;
+    uint64_t token_count = 0;
     while (!RmtStreamMergerIsEmpty(&data_set->stream_merger))
     {
         // grab the next token from the heap.
         RmtToken current_token;
         error_code = RmtStreamMergerAdvance(&data_set->stream_merger, &current_token);
         RMT_ASSERT(error_code == RMT_OK);
-        RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+        if (error_code != RMT_OK)
+        {
+            break;
+        }
+
+        if ((++token_count % RMT_PROGRESS_TOKEN_INTERVAL) == 0)
+        {
+            error_code = RmtProgressUpdateFromStreams(progress, &data_set->stream_merger, token_count);
+            if (error_code != RMT_OK)
+            {
+                break;
+            }
+        }
+
+        if (build_resource_event_index)
+        {
+            error_code = RmtResourceEventIndexAddToken(&data_set->resource_event_index, &current_token);
+            RMT_ASSERT(error_code == RMT_OK);
+            if (error_code != RMT_OK)
+            {
+                break;
+            }
+        }
 
         // Update the temporary snapshot with the RMT token.
         error_code = ProcessTokenForSnapshot(data_set, &current_token, temp_snapshot);
         RMT_ASSERT(error_code == RMT_OK);
-        RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+        if (error_code != RMT_OK)
+        {
+            break;
+        }
 
         // set the timestamp for the current snapshot
         temp_snapshot->timestamp = current_token.common.timestamp;
 
-        // Generate whatever series values we need for current timeline type from the snapshot.
-        last_value_index = UpdateSeriesValuesFromCurrentSnapshot(temp_snapshot, timeline_type, last_value_index, out_timeline);
+        // Record the values every timeline type needs from the snapshot.
+        error_code = RecordTimelineCheckpoint(data_set, temp_snapshot, process_start_values);
+        RMT_ASSERT(error_code == RMT_OK);
+        if (error_code != RMT_OK)
+        {
+            break;
+        }
     }
 
     // clean up temporary structures we allocated to construct the timeline.
     RmtDataSnapshotDestroy(temp_snapshot);
     PerformFree(data_set, temp_snapshot);
 
+    if ((error_code == RMT_OK) && build_resource_event_index)
+    {
+        error_code = RmtResourceEventIndexFinalize(&data_set->resource_event_index);
+        RMT_ASSERT(error_code == RMT_OK);
+    }
+
+    if (error_code != RMT_OK)
+    {
+        DestroyTimelineCheckpoints(data_set);
+        if (build_resource_event_index)
+        {
+            RmtResourceEventIndexDestroy(&data_set->resource_event_index);
+        }
+    }
+
+    return error_code;
+}
+
+// Load the data into the structures we have allocated.
+static RmtErrorCode TimelineGeneratorParseData(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtProgress* progress, RmtDataTimeline* out_timeline)
+{
+    RMT_ASSERT(data_set);
+
+    // The RMT streams are only replayed for the first timeline, the checkpoints are kept
+    // for generating any other timeline type from the same data set. They are checked for
+    // under the stream mutex, so two timelines generated at once don't both record them.
+    RmtMutexLock(&data_set->stream_mutex);
+    const RmtErrorCode record_error_code = (data_set->timeline_checkpoints == nullptr) ? TimelineGeneratorRecordCheckpoints(data_set, progress) : RMT_OK;
+    RmtMutexUnlock(&data_set->stream_mutex);
+    RMT_RETURN_ON_ERROR(record_error_code == RMT_OK, record_error_code);
+
+    const RmtDataTimelineCheckpoints* checkpoints = data_set->timeline_checkpoints;
+
+    // Special case:
+    // for timeline type of process, we have to first fill the 0th value of level 0
+    // of each series with the total amount of committed memory from the process start
+    // information.
+    if (timeline_type == kRmtDataTimelineTypeProcess)
+    {
+        uint64_t process_start_values[RMT_MAXIMUM_TIMELINE_DATA_SERIES];
+        GetProcessStartValues(data_set, process_start_values, out_timeline->series_count);
+
+        for (int32_t current_series_index = 0; current_series_index < out_timeline->series_count; ++current_series_index)
+        {
+            out_timeline->series[current_series_index].levels[0].values[0] = process_start_values[current_series_index];
+        }
+    }
+
+    WriteSeriesValuesFromCheckpoints(checkpoints, timeline_type, out_timeline);
     return RMT_OK;
 }
 
@@ -1214,7 +1494,7 @@ static RmtErrorCode TimelineGeneratorCalculateSeriesLevels(RmtDataTimeline* out_
 }
 
 // function to generate a timeline.
-RmtErrorCode RmtDataSetGenerateTimeline(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtDataTimeline* out_timeline)
+RmtErrorCode RmtDataSetGenerateTimeline(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtProgress* progress, RmtDataTimeline* out_timeline)
 {
     RMT_ASSERT(data_set);
     RMT_ASSERT(out_timeline);
@@ -1227,15 +1507,34 @@ RmtErrorCode RmtDataSetGenerateTimeline(RmtDataSet* data_set, RmtDataTimelineTyp
     out_timeline->timeline_type               = timeline_type;
     out_timeline->maximum_value_in_all_series = 0;  // this will be calculated as we populate the data/generate mipmaps.
 
+    // a timeline generated by an earlier session is read back instead of parsing the streams again.
+    RmtMutexLock(&data_set->cache_mutex);
+    RmtErrorCode error_code = RmtDataCacheReadTimeline(data_set, timeline_type, progress, out_timeline);
+    RmtMutexUnlock(&data_set->cache_mutex);
+    if ((error_code == RMT_OK) || (error_code == RMT_ERROR_CANCELLED))
+    {
+        return error_code;
+    }
+
     // Allocate the memory we care about for the timeline.
     TimelineGeneratorAllocateMemory(data_set, timeline_type, out_timeline);
 
     // Do the parsing for generating a timeline.
-    TimelineGeneratorParseData(data_set, timeline_type, out_timeline);
+    error_code = TimelineGeneratorParseData(data_set, timeline_type, progress, out_timeline);
+    if (error_code == RMT_ERROR_CANCELLED)
+    {
+        RmtDataTimelineDestroy(out_timeline);
+        return error_code;
+    }
 
     // Generate mip-map data.
     TimelineGeneratorCalculateSeriesLevels(out_timeline);
 
+    // failing to write the cache only means the timeline is generated again next time.
+    RmtMutexLock(&data_set->cache_mutex);
+    RmtDataCacheWriteTimeline(data_set, out_timeline, progress);
+    RmtMutexUnlock(&data_set->cache_mutex);
+
     return RMT_OK;
 }
 
@@ -1261,10 +1560,11 @@ static RmtErrorCode SnapshotGeneratorConvertHeapsToBuffers(RmtDataSnapshot* snap
         }
 
         // NOTE: read things out into temporaries as heap and buffer structures are unioned.
-        const size_t heap_size_in_bytes        = current_resource->heap.size;
-        current_resource->buffer.create_flags  = 0;
-        current_resource->buffer.usage_flags   = 0;
-        current_resource->buffer.size_in_bytes = heap_size_in_bytes;
+        RmtResourceDetails* details            = current_resource->details;
+        const size_t        heap_size_in_bytes = details->heap.size;
+        details->buffer.create_flags           = 0;
+        details->buffer.usage_flags            = 0;
+        details->buffer.size_in_bytes          = heap_size_in_bytes;
         current_resource->resource_type        = kRmtResourceTypeBuffer;
     }
 
@@ -1422,6 +1722,68 @@ static RmtErrorCode SnapshotGeneratorCompactVirtualAllocations(RmtDataSnapshot*
     return RMT_OK;
 }
 
+// calculate how many other resources alias each resource, one allocation at a time.
+static RmtErrorCode SnapshotGeneratorCalculateAliasCounts(RmtDataSnapshot* snapshot)
+{
+    RMT_ASSERT(snapshot);
+
+    int32_t maximum_resource_count = 0;
+    for (int32_t current_virtual_allocation_index = 0; current_virtual_allocation_index < snapshot->virtual_allocation_list.allocation_count;
+         ++current_virtual_allocation_index)
+    {
+        const RmtVirtualAllocation* current_virtual_allocation = &snapshot->virtual_allocation_list.allocation_details[current_virtual_allocation_index];
+        maximum_resource_count                                 = RMT_MAXIMUM(maximum_resource_count, current_virtual_allocation->resource_count);
+    }
+
+    if (maximum_resource_count == 0)
+    {
+        return RMT_OK;
+    }
+
+    const size_t   address_buffer_size = (size_t)maximum_resource_count * 3 * sizeof(RmtGpuAddress);
+    RmtGpuAddress* scratch_addresses   = (RmtGpuAddress*)PerformAllocation(snapshot->data_set, address_buffer_size, sizeof(RmtGpuAddress));
+    RMT_ASSERT(scratch_addresses);
+    RMT_RETURN_ON_ERROR(scratch_addresses, RMT_ERROR_OUT_OF_MEMORY);
+
+    for (int32_t current_virtual_allocation_index = 0; current_virtual_allocation_index < snapshot->virtual_allocation_list.allocation_count;
+         ++current_virtual_allocation_index)
+    {
+        RmtVirtualAllocationCalculateAliasCounts(&snapshot->virtual_allocation_list.allocation_details[current_virtual_allocation_index], scratch_addresses);
+    }
+
+    PerformFree(snapshot->data_set, scratch_addresses);
+    return RMT_OK;
+}
+
+// calculate the backing storage of every resource in one pass, so the page table isn't walked again each time it is needed.
+static RmtErrorCode SnapshotGeneratorCalculateResourceBackingStorage(RmtDataSnapshot* snapshot)
+{
+    RMT_ASSERT(snapshot);
+
+    const int32_t resource_count = snapshot->resource_list.resource_count;
+    if (resource_count == 0)
+    {
+        return RMT_OK;
+    }
+
+    const size_t buffer_size     = (size_t)resource_count * kRmtResourceBackingStorageCount * sizeof(uint64_t);
+    uint64_t*    backing_storage = (uint64_t*)PerformAllocation(snapshot->data_set, buffer_size, sizeof(uint64_t));
+    RMT_ASSERT(backing_storage);
+    RMT_RETURN_ON_ERROR(backing_storage, RMT_ERROR_OUT_OF_MEMORY);
+    memset(backing_storage, 0, buffer_size);
+
+    for (int32_t current_resource_index = 0; current_resource_index < resource_count; ++current_resource_index)
+    {
+        const RmtResource* current_resource = &snapshot->resource_list.resources[current_resource_index];
+        RmtResourceGetBackingStorageHistogram(snapshot, current_resource, &backing_storage[current_resource_index * kRmtResourceBackingStorageCount]);
+    }
+
+    // only publish the array once it is complete, the histograms above are calculated from the page table.
+    snapshot->resource_backing_storage       = backing_storage;
+    snapshot->resource_backing_storage_count = resource_count;
+    return RMT_OK;
+}
+
 // calculate summary data for snapshot
 static RmtErrorCode SnapshotGeneratorCalculateSummary(RmtDataSnapshot* snapshot)
 {
@@ -1511,6 +1873,91 @@ static RmtErrorCode SnapshotGeneratorAllocateRegionStack(RmtDataSnapshot* snapsh
     return RMT_OK;
 }
 
+// add a virtual allocation to the totals of a group of allocations.
+static void AddAllocationToAggregate(RmtSnapshotAllocationAggregate* aggregate,
+                                     const RmtVirtualAllocation*     virtual_allocation,
+                                     uint64_t                        size_in_bytes,
+                                     uint64_t                        bound_size,
+                                     uint64_t                        unbound_size)
+{
+    if (aggregate->allocation_count == 0)
+    {
+        aggregate->minimum_allocation_size = size_in_bytes;
+    }
+
+    aggregate->allocation_count++;
+    aggregate->resource_count += virtual_allocation->resource_count;
+    aggregate->allocated_size += size_in_bytes;
+    aggregate->bound_size += bound_size;
+    aggregate->unbound_size += unbound_size;
+    aggregate->minimum_allocation_size = RMT_MINIMUM(aggregate->minimum_allocation_size, size_in_bytes);
+    aggregate->maximum_allocation_size = RMT_MAXIMUM(aggregate->maximum_allocation_size, size_in_bytes);
+}
+
+// calculate the totals of the snapshot, so the breakdowns by heap, usage, commit type and owner don't need to walk the allocations.
+static RmtErrorCode SnapshotGeneratorCalculateAggregates(RmtDataSnapshot* snapshot)
+{
+    RMT_ASSERT(snapshot);
+
+    RmtSnapshotAggregates* aggregates = &snapshot->aggregates;
+    memset(aggregates, 0, sizeof(RmtSnapshotAggregates));
+
+    const RmtResourceListColumns* columns = &snapshot->resource_list.columns;
+    RMT_ASSERT(columns->count == snapshot->resource_list.resource_count);
+
+    for (int32_t current_virtual_allocation_index = 0; current_virtual_allocation_index < snapshot->virtual_allocation_list.allocation_count;
+         ++current_virtual_allocation_index)
+    {
+        const RmtVirtualAllocation* current_virtual_allocation = &snapshot->virtual_allocation_list.allocation_details[current_virtual_allocation_index];
+
+        const uint64_t size_in_bytes = RmtGetAllocationSizeInBytes(current_virtual_allocation->size_in_4kb_page, kRmtPageSize4Kb);
+        const uint64_t bound_size    = RmtVirtualAllocationGetTotalResourceMemoryInBytes(snapshot, current_virtual_allocation);
+        const uint64_t unbound_size  = RmtVirtualAllocationGetTotalUnboundSpaceInAllocation(snapshot, current_virtual_allocation);
+        AddAllocationToAggregate(&aggregates->all_allocations, current_virtual_allocation, size_in_bytes, bound_size, unbound_size);
+
+        // resources in allocations without a known preferred heap are still counted, in their own slice of the cube.
+        int32_t           aggregate_heap = kRmtSnapshotAggregateHeapUnknown;
+        const RmtHeapType heap_type      = current_virtual_allocation->heap_preferences[0];
+        if ((heap_type >= 0) && (heap_type < kRmtHeapTypeCount))
+        {
+            aggregate_heap = heap_type;
+            AddAllocationToAggregate(&aggregates->allocations_per_heap[heap_type], current_virtual_allocation, size_in_bytes, bound_size, unbound_size);
+        }
+
+        // add each resource to the cell for its usage, commit type and owner.
+        for (int32_t current_resource_index = 0; current_resource_index < current_virtual_allocation->resource_count; ++current_resource_index)
+        {
+            const RmtResource* current_resource = current_virtual_allocation->resources[current_resource_index];
+            const int32_t      column_index     = RmtResourceListGetResourceIndex(&snapshot->resource_list, current_resource);
+            RMT_ASSERT(column_index >= 0);
+            if (column_index < 0)
+            {
+                continue;
+            }
+
+            const int32_t usage_type  = columns->usage_types[column_index];
+            const int32_t commit_type = columns->commit_types[column_index];
+            const int32_t owner_type  = columns->owner_types[column_index];
+            RMT_ASSERT(usage_type < kRmtResourceUsageTypeCount);
+            RMT_ASSERT(commit_type < kRmtCommitTypeCount);
+            RMT_ASSERT(owner_type < kRmtOwnerTypeCount);
+
+            RmtSnapshotResourceAggregate* cell = &aggregates->resources[aggregate_heap][usage_type][commit_type][owner_type];
+            cell->resource_count++;
+            cell->size_in_bytes += columns->sizes_in_bytes[column_index];
+
+            uint64_t resource_histogram[kRmtResourceBackingStorageCount] = {0};
+            RmtResourceGetBackingStorageHistogram(snapshot, current_resource, resource_histogram);
+            for (int32_t current_backing_storage_index = 0; current_backing_storage_index < kRmtResourceBackingStorageCount; ++current_backing_storage_index)
+            {
+                cell->bytes_per_backing_storage[current_backing_storage_index] += resource_histogram[current_backing_storage_index];
+            }
+        }
+    }
+
+    return RMT_OK;
+}
+
 static RmtErrorCode SnapshotGeneratorCalculateSnapshotPointSummary(RmtDataSnapshot* snapshot, RmtSnapshotPoint* out_snapshot_point)
 {
     RMT_ASSERT(snapshot);
@@ -1519,8 +1966,8 @@ static RmtErrorCode SnapshotGeneratorCalculateSnapshotPointSummary(RmtDataSnapsh
     out_snapshot_point->virtual_allocations    = snapshot->virtual_allocation_list.allocation_count;
     out_snapshot_point->resource_count         = snapshot->resource_list.resource_count;
     out_snapshot_point->total_virtual_memory   = RmtVirtualAllocationListGetTotalSizeInBytes(&snapshot->virtual_allocation_list);
-    out_snapshot_point->bound_virtual_memory   = RmtVirtualAllocationListGetBoundTotalSizeInBytes(snapshot, &snapshot->virtual_allocation_list);
-    out_snapshot_point->unbound_virtual_memory = RmtVirtualAllocationListGetUnboundTotalSizeInBytes(snapshot, &snapshot->virtual_allocation_list);
+    out_snapshot_point->bound_virtual_memory   = snapshot->aggregates.all_allocations.bound_size;
+    out_snapshot_point->unbound_virtual_memory = snapshot->aggregates.all_allocations.unbound_size;
 
     RmtSegmentStatus heap_status[kRmtHeapTypeCount];
     for (int32_t current_heap_type_index = 0; current_heap_type_index < kRmtHeapTypeCount; ++current_heap_type_index)
@@ -1533,7 +1980,7 @@ static RmtErrorCode SnapshotGeneratorCalculateSnapshotPointSummary(RmtDataSnapsh
 }
 
 // function to generate a snapshot.
-RmtErrorCode RmtDataSetGenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint* snapshot_point, RmtDataSnapshot* out_snapshot)
+static RmtErrorCode GenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint* snapshot_point, RmtProgress* progress, RmtDataSnapshot* out_snapshot)
 {
     RMT_ASSERT(data_set);
     RMT_ASSERT(out_snapshot);
@@ -1559,6 +2006,7 @@ RmtErrorCode RmtDataSetGenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint*
     RmtStreamMergerReset(&data_set->stream_merger);
 
     // process all the tokens
+    uint64_t token_count = 0;
     while (!RmtStreamMergerIsEmpty(&data_set->stream_merger))
     {
         // grab the next token from the heap.
@@ -1573,6 +2021,17 @@ RmtErrorCode RmtDataSetGenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint*
             break;
         }
 
+        // the replay stops at the snapshot, so the progress is measured in time rather than through the streams.
+        if ((++token_count % RMT_PROGRESS_TOKEN_INTERVAL) == 0)
+        {
+            error_code = RmtProgressUpdate(progress, current_token.common.timestamp, snapshot_point->timestamp, token_count);
+            if (error_code != RMT_OK)
+            {
+                RmtDataSnapshotDestroy(out_snapshot);
+                return error_code;
+            }
+        }
+
         // handle the token.
         error_code = ProcessTokenForSnapshot(data_set, &current_token, out_snapshot);
         RMT_ASSERT(error_code == RMT_OK);
@@ -1582,13 +2041,471 @@ RmtErrorCode RmtDataSetGenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint*
     SnapshotGeneratorAddResourcePointers(out_snapshot);
     SnapshotGeneratorCompactVirtualAllocations(out_snapshot);
     SnapshotGeneratorAddUnboundResources(out_snapshot);
+    SnapshotGeneratorCalculateResourceBackingStorage(out_snapshot);
+    SnapshotGeneratorCalculateAliasCounts(out_snapshot);
     SnapshotGeneratorCalculateSummary(out_snapshot);
     SnapshotGeneratorCalculateCommitType(out_snapshot);
+    RmtResourceListUpdateColumns(&out_snapshot->resource_list);
     SnapshotGeneratorAllocateRegionStack(out_snapshot);
+    SnapshotGeneratorCalculateAggregates(out_snapshot);
     SnapshotGeneratorCalculateSnapshotPointSummary(out_snapshot, snapshot_point);
     return RMT_OK;
 }
 
+// generate a snapshot, holding the stream mutex as the streams are replayed.
+RmtErrorCode RmtDataSetGenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint* snapshot_point, RmtProgress* progress, RmtDataSnapshot* out_snapshot)
+{
+    RMT_ASSERT(data_set);
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+
+    // a snapshot generated by an earlier session is read back instead of replaying the streams again.
+    RmtMutexLock(&data_set->cache_mutex);
+    RmtErrorCode error_code = RmtDataCacheReadSnapshot(data_set, snapshot_point, progress, out_snapshot);
+    if (error_code == RMT_OK)
+    {
+        SnapshotGeneratorCalculateSnapshotPointSummary(out_snapshot, snapshot_point);
+    }
+    RmtMutexUnlock(&data_set->cache_mutex);
+    if ((error_code == RMT_OK) || (error_code == RMT_ERROR_CANCELLED))
+    {
+        return error_code;
+    }
+
+    RmtMutexLock(&data_set->stream_mutex);
+    error_code = GenerateSnapshot(data_set, snapshot_point, progress, out_snapshot);
+    RmtMutexUnlock(&data_set->stream_mutex);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+    // failing to write the cache only means the snapshot is generated again next time.
+    RmtMutexLock(&data_set->cache_mutex);
+    RmtDataCacheWriteSnapshot(data_set, out_snapshot, progress);
+    RmtMutexUnlock(&data_set->cache_mutex);
+    return RMT_OK;
+}
+
+// replay the RMT streams to build the index of resource history events, must be called with the stream mutex held.
+static RmtErrorCode ReplayResourceEventIndex(RmtDataSet* data_set, RmtProgress* progress)
+{
+    RmtResourceEventIndexDestroy(&data_set->resource_event_index);
+
+    // Reset the RMT stream parsers ready to load the data.
+    RmtStreamMergerReset(&data_set->stream_merger);
+
+    uint64_t token_count = 0;
+    while (!RmtStreamMergerIsEmpty(&data_set->stream_merger))
+    {
+        // grab the next token from the heap.
+        RmtToken     current_token;
+        RmtErrorCode error_code = RmtStreamMergerAdvance(&data_set->stream_merger, &current_token);
+        RMT_ASSERT(error_code == RMT_OK);
+        RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+        if ((++token_count % RMT_PROGRESS_TOKEN_INTERVAL) == 0)
+        {
+            error_code = RmtProgressUpdateFromStreams(progress, &data_set->stream_merger, token_count);
+            if (error_code != RMT_OK)
+            {
+                // throw away the partial index, so it is built again next time.
+                RmtResourceEventIndexDestroy(&data_set->resource_event_index);
+                return error_code;
+            }
+        }
+
+        error_code = RmtResourceEventIndexAddToken(&data_set->resource_event_index, &current_token);
+        RMT_ASSERT(error_code == RMT_OK);
+        RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+    }
+
+    return RmtResourceEventIndexFinalize(&data_set->resource_event_index);
+}
+
+// build the resource event index, holding the stream mutex as the streams are replayed.
+RmtErrorCode RmtDataSetBuildResourceEventIndex(RmtDataSet* data_set, RmtProgress* progress)
+{
+    RMT_ASSERT(data_set);
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+
+    // requests made at the same time may both find the index missing, so it is checked once the mutex is held.
+    RmtMutexLock(&data_set->stream_mutex);
+    const RmtErrorCode error_code = data_set->resource_event_index.is_complete ? RMT_OK : ReplayResourceEventIndex(data_set, progress);
+    RmtMutexUnlock(&data_set->stream_mutex);
+    return error_code;
+}
+
+// the number of events allocated the first time the resource trend event list grows.
+#define INITIAL_TREND_EVENT_CAPACITY (4096)
+
+// a resource create, bind or destroy token recorded for a resource trend.
+typedef struct ResourceTrendEvent
+{
+    RmtResourceIdentifier identifier;     // the identifier of the resource.
+    uint64_t              timestamp;      // the time of the token.
+    uint64_t              size_in_bytes;  // the size bound to the resource, for bind tokens.
+    uint32_t              sequence;       // the position of the token in the RMT streams.
+    RmtTokenType          type;           // the type of the token.
+    RmtResourceType       resource_type;  // the type of the resource, for create tokens.
+    bool                  is_unmapped;    // set to true for bind tokens to system memory without a virtual address.
+} ResourceTrendEvent;
+
+// the per-point deltas accumulated for each resource lifetime, turned into the trend points with a prefix sum.
+typedef struct ResourceTrendDeltas
+{
+    int64_t* live_resource_counts;       // the change in the live resource count at each point.
+    int64_t* live_resource_sizes;        // the change in the live resource size at each point.
+    int64_t* surviving_resource_counts;  // the number of surviving resources first alive at each point.
+    int64_t* surviving_resource_sizes;   // the change in the size of the surviving resources at each point.
+} ResourceTrendDeltas;
+
+static int32_t ResourceTrendEventComparator(const void* a, const void* b)
+{
+    const ResourceTrendEvent* event_a = (const ResourceTrendEvent*)a;
+    const ResourceTrendEvent* event_b = (const ResourceTrendEvent*)b;
+    if (event_a->identifier != event_b->identifier)
+    {
+        return (event_a->identifier > event_b->identifier) ? 1 : -1;
+    }
+    if (event_a->sequence != event_b->sequence)
+    {
+        return (event_a->sequence > event_b->sequence) ? 1 : -1;
+    }
+    return 0;
+}
+
+// find the index of the first timestamp at or after a time, or the timestamp count if there isn't one.
+static int32_t FindFirstTimestampAtOrAfter(const uint64_t* timestamps, int32_t timestamp_count, uint64_t timestamp)
+{
+    int32_t first = 0;
+    int32_t last  = timestamp_count;
+    while (first < last)
+    {
+        const int32_t middle = first + ((last - first) / 2);
+        if (timestamps[middle] < timestamp)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+// record a resource token for a resource trend, growing the event list if required.
+static RmtErrorCode RecordResourceTrendEvent(const RmtToken*      token,
+                                             uint32_t             sequence,
+                                             ResourceTrendEvent** events,
+                                             int32_t*             event_count,
+                                             int32_t*             event_capacity)
+{
+    if (*event_count == *event_capacity)
+    {
+        const int32_t       new_capacity = (*event_capacity == 0) ? INITIAL_TREND_EVENT_CAPACITY : (*event_capacity * 2);
+        ResourceTrendEvent* new_events   = (ResourceTrendEvent*)realloc(*events, new_capacity * sizeof(ResourceTrendEvent));
+        RMT_RETURN_ON_ERROR(new_events, RMT_ERROR_OUT_OF_MEMORY);
+        *events         = new_events;
+        *event_capacity = new_capacity;
+    }
+
+    ResourceTrendEvent* event = &(*events)[(*event_count)++];
+    event->timestamp          = token->common.timestamp;
+    event->size_in_bytes      = 0;
+    event->sequence           = sequence;
+    event->type               = token->type;
+    event->resource_type      = kRmtResourceTypeCount;
+    event->is_unmapped        = false;
+
+    switch (token->type)
+    {
+    case kRmtTokenTypeResourceCreate:
+        event->identifier    = token->resource_create_token.resource_identifier;
+        event->resource_type = token->resource_create_token.resource_type;
+        break;
+
+    case kRmtTokenTypeResourceBind:
+        event->identifier    = token->resource_bind_token.resource_identifier;
+        event->size_in_bytes = token->resource_bind_token.size_in_bytes;
+        event->is_unmapped   = token->resource_bind_token.is_system_memory && (token->resource_bind_token.virtual_address == 0);
+        break;
+
+    default:
+        event->identifier = token->resource_destroy_token.resource_identifier;
+        break;
+    }
+
+    return RMT_OK;
+}
+
+// add a resource lifetime to a resource trend. the lifetime starts at a create event, is sized by the bind
+// events before the end event, and lasts until the end timestamp. like a snapshot, the resource is alive at a
+// point if it was created at or before the point and not ended at or before it, only the first bind sizes
+// the resource, and command allocators take the size of each bind as the snapshot duplicates them.
+static void AddResourceTrendLifetime(const ResourceTrendEvent* events,
+                                     int32_t                   create_event_index,
+                                     int32_t                   end_event_index,
+                                     uint64_t                  end_timestamp,
+                                     const uint64_t*           timestamps,
+                                     int32_t                   timestamp_count,
+                                     ResourceTrendDeltas*      deltas,
+                                     RmtResourceTrend*         out_resource_trend)
+{
+    const ResourceTrendEvent* create_event = &events[create_event_index];
+    const int32_t             first_point  = FindFirstTimestampAtOrAfter(timestamps, timestamp_count, create_event->timestamp);
+    const int32_t             end_point    = FindFirstTimestampAtOrAfter(timestamps, timestamp_count, end_timestamp);
+    const int32_t             last_point   = end_point - 1;
+    const bool                is_surviving = (end_point == timestamp_count);
+    if (first_point >= end_point)
+    {
+        return;
+    }
+
+    RmtResourceTrendResource* resource = &out_resource_trend->resources[out_resource_trend->resource_count++];
+    resource->identifier               = create_event->identifier;
+    resource->resource_type            = create_event->resource_type;
+    resource->create_time              = create_event->timestamp;
+    resource->first_point_index        = first_point;
+    resource->last_point_index         = last_point;
+    resource->first_size_in_bytes      = 0;
+    resource->last_size_in_bytes       = 0;
+
+    deltas->live_resource_counts[first_point]++;
+    deltas->live_resource_counts[end_point]--;
+    if (is_surviving)
+    {
+        deltas->surviving_resource_counts[first_point]++;
+    }
+
+    // each bind that sizes the resource changes its size from the bind onwards.
+    uint64_t segment_size      = 0;
+    uint64_t segment_timestamp = create_event->timestamp;
+    bool     is_bound          = false;
+    for (int32_t current_event_index = create_event_index + 1; current_event_index <= end_event_index; ++current_event_index)
+    {
+        const bool is_last_segment = (current_event_index == end_event_index);
+        if (!is_last_segment && is_bound && (create_event->resource_type != kRmtResourceTypeCommandAllocator))
+        {
+            continue;
+        }
+
+        const uint64_t next_timestamp      = is_last_segment ? end_timestamp : events[current_event_index].timestamp;
+        const int32_t  segment_first_point = FindFirstTimestampAtOrAfter(timestamps, timestamp_count, segment_timestamp);
+        const int32_t  segment_end_point   = FindFirstTimestampAtOrAfter(timestamps, timestamp_count, next_timestamp);
+
+        if ((segment_first_point < segment_end_point) && (segment_size > 0))
+        {
+            deltas->live_resource_sizes[segment_first_point] += segment_size;
+            deltas->live_resource_sizes[segment_end_point] -= segment_size;
+            if (is_surviving)
+            {
+                deltas->surviving_resource_sizes[segment_first_point] += segment_size;
+                deltas->surviving_resource_sizes[segment_end_point] -= segment_size;
+            }
+        }
+
+        if ((segment_first_point <= first_point) && (first_point < segment_end_point))
+        {
+            resource->first_size_in_bytes = segment_size;
+        }
+        if ((segment_first_point <= last_point) && (last_point < segment_end_point))
+        {
+            resource->last_size_in_bytes = segment_size;
+        }
+
+        if (is_last_segment)
+        {
+            break;
+        }
+
+        const ResourceTrendEvent* bind_event = &events[current_event_index];
+        segment_size                         = (is_bound && bind_event->is_unmapped) ? 0 : bind_event->size_in_bytes;
+        segment_timestamp                    = next_timestamp;
+        is_bound                             = true;
+    }
+}
+
+// replay the streams once to build a resource trend.
+static RmtErrorCode GenerateResourceTrend(RmtDataSet*       data_set,
+                                          const uint64_t*   timestamps,
+                                          int32_t           timestamp_count,
+                                          RmtProgress*      progress,
+                                          RmtResourceTrend* out_resource_trend)
+{
+    RMT_ASSERT(data_set);
+    RMT_ASSERT(timestamps);
+    RMT_ASSERT(out_resource_trend);
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(timestamps, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(out_resource_trend, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(timestamp_count > 0, RMT_ERROR_INVALID_SIZE);
+
+    for (int32_t current_timestamp_index = 1; current_timestamp_index < timestamp_count; ++current_timestamp_index)
+    {
+        RMT_RETURN_ON_ERROR(timestamps[current_timestamp_index - 1] <= timestamps[current_timestamp_index], RMT_ERROR_INVALID_SIZE);
+    }
+
+    memset(out_resource_trend, 0, sizeof(RmtResourceTrend));
+
+    // record the resource tokens up to the last snapshot point in one pass over the streams.
+    ResourceTrendEvent* events         = NULL;
+    int32_t             event_count    = 0;
+    int32_t             event_capacity = 0;
+    int32_t             create_count   = 0;
+    uint32_t            sequence       = 0;
+    uint64_t            token_count    = 0;
+    RmtErrorCode        error_code     = RMT_OK;
+
+    RmtStreamMergerReset(&data_set->stream_merger);
+    while (!RmtStreamMergerIsEmpty(&data_set->stream_merger))
+    {
+        RmtToken current_token;
+        error_code = RmtStreamMergerAdvance(&data_set->stream_merger, &current_token);
+        RMT_ASSERT(error_code == RMT_OK);
+        if (error_code != RMT_OK)
+        {
+            break;
+        }
+
+        if (current_token.common.timestamp > timestamps[timestamp_count - 1])
+        {
+            break;
+        }
+
+        // the replay stops at the last snapshot point, so the progress is measured in time rather than through the streams.
+        if ((++token_count % RMT_PROGRESS_TOKEN_INTERVAL) == 0)
+        {
+            error_code = RmtProgressUpdate(progress, current_token.common.timestamp, timestamps[timestamp_count - 1], token_count);
+            if (error_code != RMT_OK)
+            {
+                break;
+            }
+        }
+
+        if ((current_token.type == kRmtTokenTypeResourceCreate) || (current_token.type == kRmtTokenTypeResourceBind) ||
+            (current_token.type == kRmtTokenTypeResourceDestroy))
+        {
+            error_code = RecordResourceTrendEvent(&current_token, sequence++, &events, &event_count, &event_capacity);
+            if (error_code != RMT_OK)
+            {
+                break;
+            }
+
+            if (current_token.type == kRmtTokenTypeResourceCreate)
+            {
+                create_count++;
+            }
+        }
+    }
+
+    int64_t* delta_values             = (int64_t*)calloc((timestamp_count + 1) * 4, sizeof(int64_t));
+    out_resource_trend->points        = (RmtResourceTrendPoint*)malloc(timestamp_count * sizeof(RmtResourceTrendPoint));
+    out_resource_trend->point_count   = timestamp_count;
+    out_resource_trend->resources     = (RmtResourceTrendResource*)malloc(RMT_MAXIMUM(create_count, 1) * sizeof(RmtResourceTrendResource));
+    if ((error_code == RMT_OK) && ((delta_values == NULL) || (out_resource_trend->points == NULL) || (out_resource_trend->resources == NULL)))
+    {
+        error_code = RMT_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (error_code != RMT_OK)
+    {
+        free(events);
+        free(delta_values);
+        RmtResourceTrendDestroy(out_resource_trend);
+        return error_code;
+    }
+
+    ResourceTrendDeltas deltas;
+    deltas.live_resource_counts      = delta_values;
+    deltas.live_resource_sizes       = delta_values + (timestamp_count + 1);
+    deltas.surviving_resource_counts = delta_values + ((timestamp_count + 1) * 2);
+    deltas.surviving_resource_sizes  = delta_values + ((timestamp_count + 1) * 3);
+
+    // group the tokens by resource, in stream order, and split each resource into lifetimes. a lifetime
+    // ends when the resource is destroyed or created again with the same identifier.
+    qsort(events, event_count, sizeof(ResourceTrendEvent), ResourceTrendEventComparator);
+
+    int32_t create_event_index = -1;
+    for (int32_t current_event_index = 0; current_event_index < event_count; ++current_event_index)
+    {
+        const ResourceTrendEvent* current_event = &events[current_event_index];
+        if ((create_event_index >= 0) && (events[create_event_index].identifier != current_event->identifier))
+        {
+            AddResourceTrendLifetime(
+                events, create_event_index, current_event_index, UINT64_MAX, timestamps, timestamp_count, &deltas, out_resource_trend);
+            create_event_index = -1;
+        }
+
+        if (current_event->type == kRmtTokenTypeResourceCreate)
+        {
+            if (create_event_index >= 0)
+            {
+                AddResourceTrendLifetime(
+                    events, create_event_index, current_event_index, current_event->timestamp, timestamps, timestamp_count, &deltas, out_resource_trend);
+            }
+            create_event_index = current_event_index;
+        }
+        else if ((current_event->type == kRmtTokenTypeResourceDestroy) && (create_event_index >= 0))
+        {
+            AddResourceTrendLifetime(
+                events, create_event_index, current_event_index, current_event->timestamp, timestamps, timestamp_count, &deltas, out_resource_trend);
+            create_event_index = -1;
+        }
+    }
+
+    if (create_event_index >= 0)
+    {
+        AddResourceTrendLifetime(events, create_event_index, event_count, UINT64_MAX, timestamps, timestamp_count, &deltas, out_resource_trend);
+    }
+
+    // turn the deltas into the values at each point.
+    int64_t live_resource_count      = 0;
+    int64_t live_resource_size       = 0;
+    int64_t surviving_resource_count = 0;
+    int64_t surviving_resource_size  = 0;
+    for (int32_t current_point_index = 0; current_point_index < timestamp_count; ++current_point_index)
+    {
+        live_resource_count += deltas.live_resource_counts[current_point_index];
+        live_resource_size += deltas.live_resource_sizes[current_point_index];
+        surviving_resource_count += deltas.surviving_resource_counts[current_point_index];
+        surviving_resource_size += deltas.surviving_resource_sizes[current_point_index];
+
+        RmtResourceTrendPoint* point    = &out_resource_trend->points[current_point_index];
+        point->timestamp                = timestamps[current_point_index];
+        point->live_resource_count      = (int32_t)live_resource_count;
+        point->live_resource_size       = (uint64_t)live_resource_size;
+        point->surviving_resource_count = (int32_t)surviving_resource_count;
+        point->surviving_resource_size  = (uint64_t)surviving_resource_size;
+    }
+
+    out_resource_trend->points[timestamp_count - 1].is_growing = true;
+    for (int32_t current_point_index = timestamp_count - 2; current_point_index >= 0; --current_point_index)
+    {
+        const RmtResourceTrendPoint* next_point = &out_resource_trend->points[current_point_index + 1];
+        RmtResourceTrendPoint*       point      = &out_resource_trend->points[current_point_index];
+        point->is_growing                       = next_point->is_growing && (point->live_resource_size <= next_point->live_resource_size);
+    }
+
+    free(events);
+    free(delta_values);
+    return RMT_OK;
+}
+
+// generate a resource trend, holding the stream mutex as the streams are replayed.
+RmtErrorCode RmtDataSetGenerateResourceTrend(RmtDataSet*       data_set,
+                                             const uint64_t*   timestamps,
+                                             int32_t           timestamp_count,
+                                             RmtProgress*      progress,
+                                             RmtResourceTrend* out_resource_trend)
+{
+    RMT_ASSERT(data_set);
+    RMT_RETURN_ON_ERROR(data_set, RMT_ERROR_INVALID_POINTER);
+
+    RmtMutexLock(&data_set->stream_mutex);
+    const RmtErrorCode error_code = GenerateResourceTrend(data_set, timestamps, timestamp_count, progress, out_resource_trend);
+    RmtMutexUnlock(&data_set->stream_mutex);
+    return error_code;
+}
+
 // get the segment info for a physical address
 RmtErrorCode RmtDataSetGetSegmentForPhysicalAddress(const RmtDataSet* data_set, RmtGpuAddress physical_address, const RmtSegmentInfo** out_segment_info)
 {
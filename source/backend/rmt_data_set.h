@@ -16,8 +16,11 @@
 #include "rmt_process_map.h"
 #include "rmt_data_profile.h"
 #include "rmt_data_timeline.h"
+#include "rmt_mutex.h"
+#include "rmt_progress.h"
 #include "rmt_virtual_allocation_list.h"
 #include "rmt_physical_allocation_list.h"
+#include "rmt_resource_event_index.h"
 #include <rmt_token_heap.h>
 #include <rmt_file_format.h>
 #include <rmt_parser.h>
@@ -29,6 +32,9 @@ extern "C" {
 typedef struct RmtDataSnapshot    RmtDataSnapshot;
 typedef struct RmtResource        RmtResource;
 typedef struct RmtResourceHistory RmtResourceHistory;
+typedef struct RmtResourceTrend   RmtResourceTrend;
+
+typedef struct RmtDataTimelineCheckpoints RmtDataTimelineCheckpoints;
 
 /// Callback function prototype for allocating memory.
 typedef void* (*RmtDataSetAllocationFunc)(size_t size_in_bytes, size_t alignment);
@@ -63,9 +69,12 @@ typedef struct RmtDataSet
     RmtDataSetAllocationFunc allocate_func;  ///< Allocate memory function pointer.
     RmtDataSetFreeFunc       free_func;      ///< Free memory function pointer.
 
+    uint8_t*        file_read_buffer;              ///< The buffer the stream parsers read chunks of the file into, split evenly between the streams.
     RmtParser       streams[RMT_MAXIMUM_STREAMS];  ///< An <c><i>RmtParser</i></c> structure for each stream in the file.
     int32_t         stream_count;                  ///< The number of RMT streams in the file.
     RmtStreamMerger stream_merger;                 ///< Token heap.
+    RmtMutex        stream_mutex;                  ///< Held while the streams are replayed, as every replay shares the token heap.
+    RmtMutex        cache_mutex;                   ///< Held while the cache file is read or written, so cache reads don't wait on a replay.
 
     RmtAdapterInfo adapter_info;  ///< The adapter info.
 
@@ -90,6 +99,9 @@ typedef struct RmtDataSet
 
     ResourceIdMapAllocator* p_resource_id_map_allocator;  ///< Allocator buffer/struct used to do lookup of unique resource ID.
 
+    RmtDataTimelineCheckpoints* timeline_checkpoints;  ///< The state at each series index, recorded by the first timeline generated and shared by all timeline types.
+    RmtResourceEventIndex       resource_event_index;  ///< The events used to build resource histories, recorded with the timeline checkpoints.
+
 } RmtDataSet;
 
 /// Initialize the RMT data set from a file path.
@@ -108,14 +120,20 @@ typedef struct RmtDataSet
 /// file was. Then even if the system were to crash, the integrity of the original
 /// RMV file is always preserved.
 ///
+/// A data set opened read only never writes to the RMV file, or to the cache file next to it.
+///
 /// @param [in]  path                                       A pointer to a string containing the path to the RMT file that we would like to load to initialize the data set.
+/// @param [in]  read_only                                  If true, open the file read only. The file is also opened read only if it can't be written.
+/// @param [in]  progress                                   A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for cancellation, or <c><i>NULL</i></c>.
 /// @param [in]  data_set                                   A pointer to a <c><i>RmtDataSet</i></c> structure that will contain the data set.
 ///
 /// @retval
 /// RMT_OK                                      The operation completed successfully.
 /// @retval
 /// RMT_ERROR_INVALID_POINTER                   The operation failed due to <c><i>data_set</i></c> being set to <c><i>NULL</i></c>.
-RmtErrorCode RmtDataSetInitialize(const char* path, RmtDataSet* data_set);
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and the file was closed.
+RmtErrorCode RmtDataSetInitialize(const char* path, bool read_only, RmtProgress* progress, RmtDataSet* data_set);
 
 /// Destroy the data set.
 ///
@@ -128,8 +146,14 @@ RmtErrorCode RmtDataSetDestroy(RmtDataSet* data_set);
 
 /// Generate a timeline from the data set.
 ///
+/// The first timeline generated replays the RMT streams on the calling thread and records
+/// a checkpoint of the state at the end of each series index. The checkpoints are kept on
+/// the data set, so later timelines of any type are written from them without replaying
+/// the streams again.
+///
 /// @param [in]  data_set                                   A pointer to a <c><i>RmtDataSet</i></c> structure to used to generate the timeline.
 /// @param [in]  timeline_type                              The type of timeline to generate.
+/// @param [in]  progress                                   A pointer to a <c><i>RmtProgress</i></c> structure to report the replay of the streams to and check for cancellation, or <c><i>NULL</i></c>.
 /// @param [out] out_timeline                               The address of a <c><i>RmtDataTimeline</i></c> structure to populate.
 ///
 /// @retval
@@ -138,13 +162,16 @@ RmtErrorCode RmtDataSetDestroy(RmtDataSet* data_set);
 /// RMT_ERROR_INVALID_POINTER                   The operation failed due to <c><i>data_set</i></c> being set to <c><i>NULL</i></c>.
 /// @retval
 /// RMT_ERROR_OUT_OF_MEMORY                     The operation failed due as memory could not be allocated to create the timeline.
-RmtErrorCode RmtDataSetGenerateTimeline(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtDataTimeline* out_timeline);
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and the timeline was destroyed.
+RmtErrorCode RmtDataSetGenerateTimeline(RmtDataSet* data_set, RmtDataTimelineType timeline_type, RmtProgress* progress, RmtDataTimeline* out_timeline);
 
 /// Genereate a snapshot from a data set at a specific time.
 ///
 /// @param [in]  data_set                                   A pointer to a <c><i>RmtDataSet</i></c> structure to used to generate the timeline.
 /// @param [in]  timestamp                                  The timestamp to generate the snapshot for.
 /// @param [in]  name                                       The name of the snapshot.
+/// @param [in]  progress                                   A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for cancellation, or <c><i>NULL</i></c>.
 /// @param [out] out_snapshot                               The address of a <c><i>RmtDataSnapshot</i></c> structure to populate.
 ///
 /// @retval
@@ -153,7 +180,56 @@ RmtErrorCode RmtDataSetGenerateTimeline(RmtDataSet* data_set, RmtDataTimelineTyp
 /// RMT_ERROR_INVALID_POINTER                   The operation failed due to <c><i>data_set</i></c> being set to <c><i>NULL</i></c>.
 /// @retval
 /// RMT_ERROR_OUT_OF_MEMORY                     The operation failed due as memory could not be allocated to create the snapshot.
-RmtErrorCode RmtDataSetGenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint* snapshot_point, RmtDataSnapshot* out_snapshot);
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and the snapshot was destroyed.
+RmtErrorCode RmtDataSetGenerateSnapshot(RmtDataSet* data_set, RmtSnapshotPoint* snapshot_point, RmtProgress* progress, RmtDataSnapshot* out_snapshot);
+
+/// Build the index of resource history events for a data set, if it hasn't been built already.
+///
+/// The index is normally recorded by the replay which generates the first timeline. This replays the
+/// RMT streams for the index alone, so it can be built ahead of the first resource history request
+/// when the timeline was read from the cache file instead. Once built, the index doesn't change until
+/// the data set is destroyed.
+///
+/// @param [in]  data_set                                   A pointer to a <c><i>RmtDataSet</i></c> structure.
+/// @param [in]  progress                                   A pointer to a <c><i>RmtProgress</i></c> structure to report the replay of the streams to and check for cancellation, or <c><i>NULL</i></c>.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed due to <c><i>data_set</i></c> being set to <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed due as memory could not be allocated for the index.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and the partial index was discarded.
+RmtErrorCode RmtDataSetBuildResourceEventIndex(RmtDataSet* data_set, RmtProgress* progress);
+
+/// Generate the survival and growth of resources across a set of snapshot points.
+///
+/// The RMT streams are replayed once, recording only the resource create, bind and destroy
+/// tokens, so no snapshots need to be generated for the snapshot points.
+///
+/// @param [in]  data_set                                   A pointer to a <c><i>RmtDataSet</i></c> structure.
+/// @param [in]  timestamps                                 A pointer to an array of snapshot point timestamps in ascending order.
+/// @param [in]  timestamp_count                            The number of timestamps in <c><i>timestamps</i></c>.
+/// @param [in]  progress                                   A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for cancellation, or <c><i>NULL</i></c>.
+/// @param [out] out_resource_trend                         The address of a <c><i>RmtResourceTrend</i></c> structure to populate.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed due to <c><i>data_set</i></c>, <c><i>timestamps</i></c> or <c><i>out_resource_trend</i></c> being set to <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_INVALID_SIZE                      The operation failed because there were no timestamps, or they were not in ascending order.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed due as memory could not be allocated to create the trend.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>, and the partial trend was destroyed.
+RmtErrorCode RmtDataSetGenerateResourceTrend(RmtDataSet*       data_set,
+                                             const uint64_t*   timestamps,
+                                             int32_t           timestamp_count,
+                                             RmtProgress*      progress,
+                                             RmtResourceTrend* out_resource_trend);
 
 /// Find a segment from a physical address.
 ///
@@ -96,188 +96,6 @@ RmtErrorCode RmtDataSnapshotDumpJsonToFile(const RmtDataSnapshot* snapshot, cons
     return RMT_OK;
 }
 
-// do the first pass over the RMT data, figure out the resource-based events, and
-// virtual memory-based events, and also build a list of physical address ranges
-// that the resource interacts with during its life. This list will be used in the
-// 2nd pass of the algorithm.
-static RmtErrorCode ProcessTokensIntoResourceHistory(RmtDataSet* data_set, const RmtResource* resource, RmtResourceHistory* out_resource_history)
-{
-    // Reset the RMT stream parsers ready to load the data.
-    RmtStreamMergerReset(&data_set->stream_merger);
-
-    while (!RmtStreamMergerIsEmpty(&data_set->stream_merger))
-    {
-        // grab the next token from the heap.
-        RmtToken     current_token;
-        RmtErrorCode error_code = RmtStreamMergerAdvance(&data_set->stream_merger, &current_token);
-        RMT_ASSERT(error_code == RMT_OK);
-
-        // interested in tokens that directly reference resources.
-        switch (current_token.type)
-        {
-        case kRmtTokenTypeResourceCreate:
-            if (current_token.resource_create_token.resource_identifier != resource->identifier)
-            {
-                break;
-            }
-
-            RmtResourceHistoryAddEvent(
-                out_resource_history, kRmtResourceHistoryEventResourceCreated, current_token.common.thread_id, current_token.common.timestamp, false);
-            break;
-
-        case kRmtTokenTypeResourceDestroy:
-            if (current_token.resource_destroy_token.resource_identifier != resource->identifier)
-            {
-                break;
-            }
-
-            RmtResourceHistoryAddEvent(
-                out_resource_history, kRmtResourceHistoryEventResourceDestroyed, current_token.common.thread_id, current_token.common.timestamp, false);
-            break;
-
-        case kRmtTokenTypeResourceBind:
-            if (current_token.resource_bind_token.resource_identifier != resource->identifier)
-            {
-                break;
-            }
-
-            RmtResourceHistoryAddEvent(
-                out_resource_history, kRmtResourceHistoryEventResourceBound, current_token.common.thread_id, current_token.common.timestamp, false);
-            break;
-
-        case kRmtTokenTypeVirtualAllocate:
-        {
-            const RmtGpuAddress address_of_last_byte_allocation =
-                (current_token.virtual_allocate_token.virtual_address + current_token.virtual_allocate_token.size_in_bytes) - 1;
-            if (!RmtResourceOverlapsVirtualAddressRange(resource, current_token.virtual_allocate_token.virtual_address, address_of_last_byte_allocation))
-            {
-                break;
-            }
-
-            RmtResourceHistoryAddEvent(
-                out_resource_history, kRmtResourceHistoryEventVirtualMemoryAllocated, current_token.common.thread_id, current_token.common.timestamp, false);
-        }
-        break;
-
-        case kRmtTokenTypeResourceReference:
-
-            if (out_resource_history->base_allocation == nullptr)
-            {
-                break;
-            }
-
-            // NOTE: PAL can only make resident/evict a full virtual allocation on CPU, not just a single resource.
-            if (current_token.cpu_map_token.virtual_address != out_resource_history->base_allocation->base_address)
-            {
-                break;
-            }
-
-            if (current_token.resource_reference.residency_update_type == kRmtResidencyUpdateTypeAdd)
-            {
-                RmtResourceHistoryAddEvent(out_resource_history,
-                                           kRmtResourceHistoryEventVirtualMemoryMakeResident,
-                                           current_token.common.thread_id,
-                                           current_token.common.timestamp,
-                                           false);
-            }
-            else
-            {
-                RmtResourceHistoryAddEvent(
-                    out_resource_history, kRmtResourceHistoryEventVirtualMemoryEvict, current_token.common.thread_id, current_token.common.timestamp, false);
-            }
-            break;
-
-        case kRmtTokenTypeCpuMap:
-
-            if (out_resource_history->base_allocation == nullptr)
-            {
-                break;
-            }
-
-            // NOTE: PAL can only map/unmap a full virtual allocation on CPU, not just a resource.
-            if (current_token.cpu_map_token.virtual_address != out_resource_history->base_allocation->base_address)
-            {
-                break;
-            }
-
-            if (current_token.cpu_map_token.is_unmap)
-            {
-                RmtResourceHistoryAddEvent(
-                    out_resource_history, kRmtResourceHistoryEventVirtualMemoryUnmapped, current_token.common.thread_id, current_token.common.timestamp, false);
-            }
-            else
-            {
-                RmtResourceHistoryAddEvent(
-                    out_resource_history, kRmtResourceHistoryEventVirtualMemoryMapped, current_token.common.thread_id, current_token.common.timestamp, false);
-            }
-            break;
-
-        case kRmtTokenTypeVirtualFree:
-        {
-            if (out_resource_history->base_allocation == nullptr)
-            {
-                break;
-            }
-
-            if (!RmtResourceOverlapsVirtualAddressRange(
-                    resource, current_token.virtual_free_token.virtual_address, (current_token.virtual_free_token.virtual_address + 1)))
-            {
-                break;
-            }
-
-            RmtResourceHistoryAddEvent(
-                out_resource_history, kRmtResourceHistoryEventVirtualMemoryFree, current_token.common.thread_id, current_token.common.timestamp, false);
-        }
-        break;
-
-        case kRmtTokenTypePageTableUpdate:
-        {
-            if (out_resource_history->base_allocation == nullptr)
-            {
-                break;
-            }
-
-            // check for overlap between the resource VA range and this change to the PA mappings.
-            const uint64_t size_in_bytes =
-                RmtGetAllocationSizeInBytes(current_token.page_table_update_token.size_in_pages, current_token.page_table_update_token.page_size);
-
-            if (!RmtAllocationsOverlap(current_token.page_table_update_token.virtual_address,
-                                       size_in_bytes,
-                                       out_resource_history->resource->address,
-                                       out_resource_history->resource->size_in_bytes))
-            {
-                break;
-            }
-
-            if (current_token.page_table_update_token.is_unmapping)
-            {
-                RmtResourceHistoryAddEvent(
-                    out_resource_history, kRmtResourceHistoryEventPhysicalUnmap, current_token.common.thread_id, current_token.common.timestamp, true);
-            }
-            else
-            {
-                if (current_token.page_table_update_token.physical_address == 0)
-                {
-                    RmtResourceHistoryAddEvent(
-                        out_resource_history, kRmtResourceHistoryEventPhysicalMapToHost, current_token.common.thread_id, current_token.common.timestamp, true);
-                }
-                else
-                {
-                    RmtResourceHistoryAddEvent(
-                        out_resource_history, kRmtResourceHistoryEventPhysicalMapToLocal, current_token.common.thread_id, current_token.common.timestamp, true);
-                }
-            }
-        }
-        break;
-
-        default:
-            break;
-        }
-    }
-
-    return RMT_OK;
-}
-
 // Helper functo call the correct free function.
 static void PerformFree(RmtDataSet* data_set, void* pointer)
 {
@@ -289,7 +107,10 @@ static void PerformFree(RmtDataSet* data_set, void* pointer)
     return (data_set->free_func)(pointer);
 }
 
-RmtErrorCode RmtDataSnapshotGenerateResourceHistory(RmtDataSnapshot* snapshot, const RmtResource* resource, RmtResourceHistory* out_resource_history)
+RmtErrorCode RmtDataSnapshotGenerateResourceHistory(RmtDataSnapshot*    snapshot,
+                                                    const RmtResource*  resource,
+                                                    RmtProgress*        progress,
+                                                    RmtResourceHistory* out_resource_history)
 {
     RMT_ASSERT(snapshot);
     RMT_ASSERT(resource);
@@ -303,9 +124,15 @@ RmtErrorCode RmtDataSnapshotGenerateResourceHistory(RmtDataSnapshot* snapshot, c
     out_resource_history->base_allocation = resource->bound_allocation;
     out_resource_history->event_count     = 0;
 
-    RmtErrorCode error_code = RMT_OK;
+    // build the index if it wasn't built while loading.
+    RmtErrorCode error_code = RmtDataSetBuildResourceEventIndex(snapshot->data_set, progress);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
 
-    error_code = ProcessTokensIntoResourceHistory(snapshot->data_set, resource, out_resource_history);
+    // only the events in the index which reference the resource, or overlap its virtual address range, are visited.
+    // the index is read under the stream mutex, which every replay that writes it holds.
+    RmtMutexLock(&snapshot->data_set->stream_mutex);
+    error_code = RmtResourceEventIndexGenerateResourceHistory(&snapshot->data_set->resource_event_index, resource, out_resource_history);
+    RmtMutexUnlock(&snapshot->data_set->stream_mutex);
     RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
 
     return RMT_OK;
@@ -320,44 +147,84 @@ RmtErrorCode RmtDataSnapshotDestroy(RmtDataSnapshot* snapshot)
     PerformFree(snapshot->data_set, snapshot->virtual_allocation_buffer);
     PerformFree(snapshot->data_set, snapshot->resource_list_buffer);
     PerformFree(snapshot->data_set, snapshot->region_stack_buffer);
+    PerformFree(snapshot->data_set, snapshot->resource_backing_storage);
 
     return RMT_OK;
 }
 
-uint64_t RmtDataSnapshotGetLargestResourceSize(const RmtDataSnapshot* snapshot)
+uint64_t RmtDataSnapshotGetMemorySizeInBytes(const RmtDataSnapshot* snapshot)
 {
     RMT_RETURN_ON_ERROR(snapshot, 0);
+    RMT_RETURN_ON_ERROR(snapshot->data_set, sizeof(RmtDataSnapshot));
 
-    uint64_t latest_resource_size_in_bytes = 0;
-
-    for (int32_t current_resource_index = 0; current_resource_index < snapshot->resource_list.resource_count; ++current_resource_index)
+    // the list buffers are sized from the data profile when the snapshot is allocated, the rest once it is complete.
+    const RmtDataProfile* data_profile = &snapshot->data_set->data_profile;
+    uint64_t              size         = sizeof(RmtDataSnapshot);
+    if (snapshot->virtual_allocation_buffer != nullptr)
     {
-        const RmtResource* current_resource = &snapshot->resource_list.resources[current_resource_index];
-        latest_resource_size_in_bytes       = RMT_MAXIMUM(latest_resource_size_in_bytes, current_resource->size_in_bytes);
+        size += RmtVirtualAllocationListGetBufferSize(data_profile->total_virtual_allocation_count, data_profile->max_concurrent_resources + 200);
     }
+    if (snapshot->resource_list_buffer != nullptr)
+    {
+        size += RmtResourceListGetBufferSize(data_profile->max_concurrent_resources + 200);
+    }
+    size += (uint64_t)snapshot->region_stack_count * sizeof(RmtMemoryRegion);
+    size += (uint64_t)snapshot->resource_backing_storage_count * kRmtResourceBackingStorageCount * sizeof(uint64_t);
+    return size;
+}
 
-    return latest_resource_size_in_bytes;
+const RmtSnapshotResourceAggregate* RmtDataSnapshotGetResourceAggregate(const RmtDataSnapshot* snapshot,
+                                                                        RmtHeapType            heap_type,
+                                                                        RmtResourceUsageType   usage_type,
+                                                                        RmtCommitType          commit_type,
+                                                                        RmtOwnerType           owner_type)
+{
+    RMT_RETURN_ON_ERROR(snapshot, nullptr);
+    RMT_RETURN_ON_ERROR((heap_type >= kRmtHeapTypeUnknown) && (heap_type < kRmtHeapTypeCount), nullptr);
+    RMT_RETURN_ON_ERROR((usage_type >= 0) && (usage_type < kRmtResourceUsageTypeCount), nullptr);
+    RMT_RETURN_ON_ERROR((commit_type >= 0) && (commit_type < kRmtCommitTypeCount), nullptr);
+    RMT_RETURN_ON_ERROR((owner_type >= 0) && (owner_type < kRmtOwnerTypeCount), nullptr);
+
+    const int32_t aggregate_heap = (heap_type == kRmtHeapTypeUnknown) ? (int32_t)kRmtSnapshotAggregateHeapUnknown : (int32_t)heap_type;
+    return &snapshot->aggregates.resources[aggregate_heap][usage_type][commit_type][owner_type];
 }
 
-/// Get the smallest resource size (in bytes) seen in a snapshot.
-uint64_t RmtDataSnapshotGetSmallestResourceSize(const RmtDataSnapshot* snapshot)
+int32_t RmtDataSnapshotGetResourceUsageCount(const RmtDataSnapshot* snapshot, RmtResourceUsageType usage_type)
 {
     RMT_RETURN_ON_ERROR(snapshot, 0);
+    RMT_RETURN_ON_ERROR((usage_type >= 0) && (usage_type < kRmtResourceUsageTypeCount), 0);
 
-    uint64_t smallest_resource_size_in_bytes = UINT64_MAX;
-
-    for (int32_t current_resource_index = 0; current_resource_index < snapshot->resource_list.resource_count; ++current_resource_index)
+    // include the slice of resources in allocations without a known preferred heap.
+    int32_t resource_count = 0;
+    for (int32_t current_heap_index = 0; current_heap_index < kRmtSnapshotAggregateHeapCount; ++current_heap_index)
     {
-        const RmtResource* current_resource = &snapshot->resource_list.resources[current_resource_index];
-        smallest_resource_size_in_bytes     = RMT_MINIMUM(smallest_resource_size_in_bytes, current_resource->size_in_bytes);
+        for (int32_t current_commit_type_index = 0; current_commit_type_index < kRmtCommitTypeCount; ++current_commit_type_index)
+        {
+            for (int32_t current_owner_type_index = 0; current_owner_type_index < kRmtOwnerTypeCount; ++current_owner_type_index)
+            {
+                const RmtSnapshotResourceAggregate* cell =
+                    &snapshot->aggregates.resources[current_heap_index][usage_type][current_commit_type_index][current_owner_type_index];
+                resource_count += cell->resource_count;
+            }
+        }
     }
 
-    if (smallest_resource_size_in_bytes == UINT64_MAX)
-    {
-        return 0;
-    }
+    return resource_count;
+}
+
+uint64_t RmtDataSnapshotGetLargestResourceSize(const RmtDataSnapshot* snapshot)
+{
+    RMT_RETURN_ON_ERROR(snapshot, 0);
 
-    return smallest_resource_size_in_bytes;
+    return RmtResourceListGetLargestResourceSize(&snapshot->resource_list);
+}
+
+/// Get the smallest resource size (in bytes) seen in a snapshot.
+uint64_t RmtDataSnapshotGetSmallestResourceSize(const RmtDataSnapshot* snapshot)
+{
+    RMT_RETURN_ON_ERROR(snapshot, 0);
+
+    return RmtResourceListGetSmallestResourceSize(&snapshot->resource_list);
 }
 
 RmtErrorCode RmtDataSnapshotGetSegmentStatus(const RmtDataSnapshot* snapshot, RmtHeapType heap_type, RmtSegmentStatus* out_segment_status)
@@ -396,74 +263,56 @@ RmtErrorCode RmtDataSnapshotGetSegmentStatus(const RmtDataSnapshot* snapshot, Rm
     out_segment_status->total_physical_size        = snapshot->data_set->segment_info[heap_type].size;
     out_segment_status->total_bound_virtual_memory = 0;
 
-    // calculate data for the segment info fields.
-    uint64_t max_virtual_allocation_size      = 0;
-    uint64_t min_virtual_allocation_size      = UINT64_MAX;
-    uint64_t total_virtual_memory_requested   = 0;
-    uint64_t total_physical_mapped_by_process = snapshot->page_table.mapped_per_heap[heap_type];
-    ;
-    uint64_t allocation_count = 0;
-
     // set the resource committed memory values.
     for (int32_t current_resource_usage_index = 0; current_resource_usage_index < kRmtResourceUsageTypeCount; ++current_resource_usage_index)
     {
         out_segment_status->physical_bytes_per_resource_usage[current_resource_usage_index] = 0;
     }
 
-    for (int32_t current_virtual_allocation_index = 0; current_virtual_allocation_index < snapshot->virtual_allocation_list.allocation_count;
-         ++current_virtual_allocation_index)
+    // sum the cells of the aggregate cube, skipping the heap resources as they alias the resources inside them. resources
+    // in allocations without a known preferred heap may still have memory committed in this heap.
+    for (int32_t current_preferred_heap_index = 0; current_preferred_heap_index < kRmtSnapshotAggregateHeapCount; ++current_preferred_heap_index)
     {
-        const RmtVirtualAllocation* current_virtual_allocation = &snapshot->virtual_allocation_list.allocation_details[current_virtual_allocation_index];
-
-        const uint64_t size_in_bytes = RmtGetAllocationSizeInBytes(current_virtual_allocation->size_in_4kb_page, kRmtPageSize4Kb);
-
-        if (current_virtual_allocation->heap_preferences[0] == heap_type)
+        for (int32_t current_resource_usage_index = 0; current_resource_usage_index < kRmtResourceUsageTypeCount; ++current_resource_usage_index)
         {
-            total_virtual_memory_requested += size_in_bytes;
-            max_virtual_allocation_size = RMT_MAXIMUM(max_virtual_allocation_size, size_in_bytes);
-            min_virtual_allocation_size = RMT_MINIMUM(min_virtual_allocation_size, size_in_bytes);
-            allocation_count++;
-        }
-
-        // walk each resource in the allocation and work out what heap each resource is in.
-        for (int32_t current_resource_index = 0; current_resource_index < current_virtual_allocation->resource_count; ++current_resource_index)
-        {
-            const RmtResource* current_resource = current_virtual_allocation->resources[current_resource_index];
-
-            if (current_resource->resource_type == kRmtResourceTypeHeap)
+            if (current_resource_usage_index == kRmtResourceUsageTypeHeap)
             {
                 continue;
             }
 
-            // process the resource
-            const RmtResourceUsageType current_resource_usage = RmtResourceGetUsageType(current_resource);
-
-            if (current_virtual_allocation->heap_preferences[0] == heap_type)
+            for (int32_t current_commit_type_index = 0; current_commit_type_index < kRmtCommitTypeCount; ++current_commit_type_index)
             {
-                out_segment_status->total_bound_virtual_memory += current_resource->size_in_bytes;
+                for (int32_t current_owner_type_index = 0; current_owner_type_index < kRmtOwnerTypeCount; ++current_owner_type_index)
+                {
+                    const RmtSnapshotResourceAggregate* cell =
+                        &snapshot->aggregates
+                             .resources[current_preferred_heap_index][current_resource_usage_index][current_commit_type_index][current_owner_type_index];
+
+                    if (current_preferred_heap_index == heap_type)
+                    {
+                        out_segment_status->total_bound_virtual_memory += cell->size_in_bytes;
+                    }
+
+                    // the histogram of where each resource has its memory committed.
+                    if ((heap_type >= 0) && (heap_type < kRmtHeapTypeCount))
+                    {
+                        out_segment_status->physical_bytes_per_resource_usage[current_resource_usage_index] += cell->bytes_per_backing_storage[heap_type];
+                    }
+                }
             }
-
-            // caculate the histogram of where each resource has its memory committed.
-            uint64_t resource_histogram[kRmtResourceBackingStorageCount] = {0};
-            RmtResourceGetBackingStorageHistogram(snapshot, current_resource, resource_histogram);
-            out_segment_status->physical_bytes_per_resource_usage[current_resource_usage] += resource_histogram[heap_type];
         }
     }
 
-    if (min_virtual_allocation_size == UINT64_MAX)
-    {
-        min_virtual_allocation_size = 0;
-    }
-
     // fill out the structure fields.
-    out_segment_status->total_virtual_memory_requested           = total_virtual_memory_requested;
-    out_segment_status->total_physical_mapped_by_process         = total_physical_mapped_by_process;
+    const RmtSnapshotAllocationAggregate* allocations = &snapshot->aggregates.allocations_per_heap[heap_type];
+    out_segment_status->total_virtual_memory_requested           = allocations->allocated_size;
+    out_segment_status->total_physical_mapped_by_process         = snapshot->page_table.mapped_per_heap[heap_type];
     out_segment_status->total_physical_mapped_by_other_processes = 0;
-    out_segment_status->max_allocation_size                      = max_virtual_allocation_size;
-    out_segment_status->min_allocation_size                      = min_virtual_allocation_size;
-    if (allocation_count > 0)
+    out_segment_status->max_allocation_size                      = allocations->maximum_allocation_size;
+    out_segment_status->min_allocation_size                      = allocations->minimum_allocation_size;
+    if (allocations->allocation_count > 0)
     {
-        out_segment_status->mean_allocation_size = total_virtual_memory_requested / allocation_count;
+        out_segment_status->mean_allocation_size = allocations->allocated_size / allocations->allocation_count;
     }
     else
     {
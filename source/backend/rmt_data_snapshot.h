@@ -14,6 +14,7 @@
 #include "rmt_physical_allocation_list.h"
 #include "rmt_configuration.h"
 #include "rmt_process_map.h"
+#include "rmt_progress.h"
 
 #ifdef __cpluplus
 extern "C" {
@@ -68,6 +69,51 @@ typedef struct RmtSegmentStatus
 /// The segment subscription status value.
 RmtSegmentSubscriptionStatus RmtSegmentStatusGetOversubscribed(const RmtSegmentStatus* segment_status);
 
+/// An enumeration of the heap slices of a snapshot's aggregate cube.
+///
+/// The first <c><i>kRmtHeapTypeCount</i></c> slices are indexed by <c><i>RmtHeapType</i></c>. They are
+/// followed by a slice for the resources bound to allocations whose preferred heap is unknown.
+typedef enum RmtSnapshotAggregateHeap
+{
+    kRmtSnapshotAggregateHeapUnknown = kRmtHeapTypeCount,  ///< The slice for allocations whose preferred heap is unknown.
+
+    // Add above this.
+    kRmtSnapshotAggregateHeapCount
+} RmtSnapshotAggregateHeap;
+
+/// A structure encapsulating the totals of the resources in one cell of a snapshot's aggregate cube.
+typedef struct RmtSnapshotResourceAggregate
+{
+    int32_t  resource_count;                                              ///< The number of resources in the cell.
+    uint64_t size_in_bytes;                                               ///< The total size (in bytes) of the resources in the cell.
+    uint64_t bytes_per_backing_storage[kRmtResourceBackingStorageCount];  ///< The bytes of the resources in each backing storage type.
+} RmtSnapshotResourceAggregate;
+
+/// A structure encapsulating the totals of a group of virtual allocations in a snapshot.
+typedef struct RmtSnapshotAllocationAggregate
+{
+    int32_t  allocation_count;         ///< The number of allocations.
+    int32_t  resource_count;           ///< The number of resources bound to the allocations, including heaps.
+    uint64_t allocated_size;           ///< The total size (in bytes) of the allocations.
+    uint64_t bound_size;               ///< The total size (in bytes) of the allocations that has resources bound to it.
+    uint64_t unbound_size;             ///< The total size (in bytes) of the allocations that has no resources bound to it.
+    uint64_t minimum_allocation_size;  ///< The size (in bytes) of the smallest allocation, or 0 if there are no allocations.
+    uint64_t maximum_allocation_size;  ///< The size (in bytes) of the largest allocation.
+} RmtSnapshotAllocationAggregate;
+
+/// A structure encapsulating the totals of a snapshot, calculated once when the snapshot is generated.
+///
+/// The resources bound to virtual allocations are counted in a cube of cells, indexed by the preferred
+/// heap of their allocation, their usage type, their commit type and their owner, so breakdowns of the
+/// snapshot sum a fixed number of cells rather than walking the allocations and resources.
+typedef struct RmtSnapshotAggregates
+{
+    RmtSnapshotAllocationAggregate all_allocations;                          ///< The totals of all the virtual allocations.
+    RmtSnapshotAllocationAggregate allocations_per_heap[kRmtHeapTypeCount];  ///< The totals of the virtual allocations with each preferred heap.
+    RmtSnapshotResourceAggregate
+        resources[kRmtSnapshotAggregateHeapCount][kRmtResourceUsageTypeCount][kRmtCommitTypeCount][kRmtOwnerTypeCount];  ///< The cube of bound resource totals.
+} RmtSnapshotAggregates;
+
 /// A structure encapsulating a single snapshot at a specific point in time.
 typedef struct RmtDataSnapshot
 {
@@ -96,6 +142,11 @@ typedef struct RmtDataSnapshot
     RmtMemoryRegion* region_stack_buffer;
     int32_t          region_stack_count;
 
+    uint64_t* resource_backing_storage;        ///< The bytes of each resource in each backing storage type, <c><i>kRmtResourceBackingStorageCount</i></c> values per resource in the resource list.
+    int32_t   resource_backing_storage_count;  ///< The number of resources in <c><i>resource_backing_storage</i></c>.
+
+    RmtSnapshotAggregates aggregates;  ///< The totals of the snapshot, calculated when the snapshot is generated.
+
 } RmtDataSnapshot;
 
 /// Destroy a snapshot.
@@ -110,6 +161,14 @@ typedef struct RmtDataSnapshot
 /// RMT_ERROR_MALFORMED_DATA                    The operation failed due to the <c><i>snapshot</i></c> data set being <c><i>NULL</i></c>.
 RmtErrorCode RmtDataSnapshotDestroy(RmtDataSnapshot* snapshot);
 
+/// Get the amount of memory used by a snapshot, including the <c><i>RmtDataSnapshot</i></c> structure itself.
+///
+/// @param [in]  snapshot                       The snapshot.
+///
+/// @returns
+/// The size of the snapshot in bytes, or 0 if <c><i>snapshot</i></c> is <c><i>NULL</i></c>.
+uint64_t RmtDataSnapshotGetMemorySizeInBytes(const RmtDataSnapshot* snapshot);
+
 /// Debugging function.
 RmtErrorCode RmtSnapshotDumpStateToConsole(const RmtDataSnapshot* snapshot);
 
@@ -117,6 +176,8 @@ RmtErrorCode RmtSnapshotDumpStateToConsole(const RmtDataSnapshot* snapshot);
 ///
 /// @param [in]  snapshot                       The snapshot containing the resource.
 /// @param [in]  resource                       The resource to retrieve the history from.
+/// @param [in]  progress                       A pointer to a <c><i>RmtProgress</i></c> structure to report progress to and check for
+///                                             cancellation, or <c><i>NULL</i></c>. Only used if the streams have to be replayed.
 /// @param [out] out_resource_history           Pointer to an <c><i>RmtResourceHistory</i></c> structure to fill.
 ///
 /// @retval
@@ -124,7 +185,37 @@ RmtErrorCode RmtSnapshotDumpStateToConsole(const RmtDataSnapshot* snapshot);
 /// @retval
 /// RMT_ERROR_INVALID_POINTER                   The operation failed due to <c><i>snapshot</i></c> , <c><i>resource</i></c> or
 ///                                             <c><i>out_resource_history</i></c> being set to <c><i>NULL</i></c>.
-RmtErrorCode RmtDataSnapshotGenerateResourceHistory(RmtDataSnapshot* snapshot, const RmtResource* resource, RmtResourceHistory* out_resource_history);
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation was cancelled through <c><i>progress</i></c>.
+RmtErrorCode RmtDataSnapshotGenerateResourceHistory(RmtDataSnapshot*    snapshot,
+                                                    const RmtResource*  resource,
+                                                    RmtProgress*        progress,
+                                                    RmtResourceHistory* out_resource_history);
+
+/// Get one cell of the aggregate cube of a snapshot.
+///
+/// @param [in]  snapshot                           The snapshot to retrieve the cell from.
+/// @param [in]  heap_type                          The preferred heap of the allocations the resources are bound to, or <c><i>kRmtHeapTypeUnknown</i></c>.
+/// @param [in]  usage_type                         The usage type of the resources.
+/// @param [in]  commit_type                        The commit type of the resources.
+/// @param [in]  owner_type                         The owner of the resources.
+///
+/// @returns
+/// A pointer to the cell, or NULL if the snapshot is NULL or an index is out of range.
+const RmtSnapshotResourceAggregate* RmtDataSnapshotGetResourceAggregate(const RmtDataSnapshot* snapshot,
+                                                                        RmtHeapType            heap_type,
+                                                                        RmtResourceUsageType   usage_type,
+                                                                        RmtCommitType          commit_type,
+                                                                        RmtOwnerType           owner_type);
+
+/// Get the number of resources of a usage type bound to the virtual allocations of a snapshot.
+///
+/// @param [in]  snapshot                           The snapshot to count the resources in.
+/// @param [in]  usage_type                         The usage type of the resources.
+///
+/// @returns
+/// The number of resources.
+int32_t RmtDataSnapshotGetResourceUsageCount(const RmtDataSnapshot* snapshot, RmtResourceUsageType usage_type);
 
 /// Get the largest resource size (in bytes) seen in a snapshot.
 ///
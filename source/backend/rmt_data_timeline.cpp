@@ -10,7 +10,7 @@
 #include <rmt_file_format.h>
 #include "rmt_job_system.h"
 #include <rmt_assert.h>
-#include <string.h>  // for memcpy()
+#include <string.h>  // for memcpy(), memmove()
 #include <stdlib.h>  // for malloc(), free()
 
 // Helper function to call the correct free function.
@@ -94,6 +94,36 @@ static void CreateHistogramJob(int32_t thread_id, int32_t index, void* input)
     }
 }
 
+// generate a range of buckets in the histogram from the timeline.
+static RmtErrorCode GenerateHistogramBuckets(RmtDataTimelineHistogram* timeline_histogram,
+                                             RmtJobQueue*              job_queue,
+                                             uint64_t                  end_timestamp,
+                                             int32_t                   first_bucket_index,
+                                             int32_t                   bucket_count)
+{
+    // Setup the inputs to our job in the scratch memory.
+    HistogramJobInput* input_parameters = (HistogramJobInput*)timeline_histogram->scratch_buffer;
+    RMT_STATIC_ASSERT(sizeof(HistogramJobInput) <= sizeof(timeline_histogram->scratch_buffer));
+    input_parameters->bucket_count           = timeline_histogram->bucket_count;
+    input_parameters->bucket_width_in_cycles = timeline_histogram->bucket_width_in_cycles;
+    input_parameters->end_timestamp          = end_timestamp;
+    input_parameters->start_timestamp        = timeline_histogram->start_timestamp;
+    input_parameters->out_timeline_histogram = timeline_histogram;
+    input_parameters->timeline               = timeline_histogram->timeline;
+
+    // Kick the jobs off to the worker threads.
+    // NOTE: This can be done as one per bucket (or range of buckets).
+    RmtJobHandle       job_handle = 0;
+    const RmtErrorCode error_code = RmtJobQueueAddMultiple(job_queue, CreateHistogramJob, input_parameters, first_bucket_index, bucket_count, &job_handle);
+    RMT_ASSERT(error_code == RMT_OK);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+    // Wait for job to complete.
+    RmtJobQueueWaitForCompletion(job_queue, job_handle);
+
+    return RMT_OK;
+}
+
 // create the historgram.
 RmtErrorCode RmtDataTimelineCreateHistogram(const RmtDataTimeline*    timeline,
                                             RmtJobQueue*              job_queue,
@@ -123,6 +153,7 @@ RmtErrorCode RmtDataTimelineCreateHistogram(const RmtDataTimeline*    timeline,
 
     // Fill out the initial fields of the data set.
     out_timeline_histogram->timeline               = timeline;
+    out_timeline_histogram->start_timestamp        = start_timestamp;
     out_timeline_histogram->bucket_width_in_cycles = bucket_width_in_rmt_cycles;
     out_timeline_histogram->bucket_count           = bucket_count;
 
@@ -134,27 +165,55 @@ RmtErrorCode RmtDataTimelineCreateHistogram(const RmtDataTimeline*    timeline,
     RMT_RETURN_ON_ERROR(out_timeline_histogram->bucket_data, RMT_ERROR_OUT_OF_MEMORY);
     memset(out_timeline_histogram->bucket_data, 0, size_in_bytes);
 
-    // Setup the inputs to our job in the scratch memory.
-    HistogramJobInput* input_parameters = (HistogramJobInput*)out_timeline_histogram->scratch_buffer;
-    RMT_STATIC_ASSERT(sizeof(HistogramJobInput) <= sizeof(out_timeline_histogram->scratch_buffer));
-    input_parameters->bucket_count           = out_timeline_histogram->bucket_count;
-    input_parameters->bucket_width_in_cycles = out_timeline_histogram->bucket_width_in_cycles;
-    input_parameters->end_timestamp          = end_timestamp;
-    input_parameters->start_timestamp        = start_timestamp;
-    input_parameters->out_timeline_histogram = out_timeline_histogram;
-    input_parameters->timeline               = out_timeline_histogram->timeline;
+    return GenerateHistogramBuckets(out_timeline_histogram, job_queue, end_timestamp, 0, bucket_count);
+}
 
-    // Kick the jobs off to the worker threads.
-    // NOTE: This can be done as one per bucket (or range of buckets).
-    RmtJobHandle       job_handle = 0;
-    const RmtErrorCode error_code = RmtJobQueueAddMultiple(job_queue, CreateHistogramJob, input_parameters, 0, bucket_count, &job_handle);
-    RMT_ASSERT(error_code == RMT_OK);
-    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+// scroll the histogram.
+RmtErrorCode RmtDataTimelineHistogramScroll(RmtDataTimelineHistogram* timeline_histogram, RmtJobQueue* job_queue, int32_t bucket_offset)
+{
+    RMT_ASSERT_MESSAGE(timeline_histogram, "Parameter timelineHistogram is NULL.");
+    RMT_ASSERT_MESSAGE(job_queue, "Parameter jobQueue is NULL.");
+    RMT_RETURN_ON_ERROR(timeline_histogram, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(job_queue, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(timeline_histogram->timeline, RMT_ERROR_MALFORMED_DATA);
+    RMT_RETURN_ON_ERROR(timeline_histogram->bucket_data, RMT_ERROR_MALFORMED_DATA);
 
-    // Wait for job to complete.
-    RmtJobQueueWaitForCompletion(job_queue, job_handle);
+    const int64_t offset_in_cycles = (int64_t)bucket_offset * (int64_t)timeline_histogram->bucket_width_in_cycles;
+    const int64_t start_timestamp  = (int64_t)timeline_histogram->start_timestamp + offset_in_cycles;
+    RMT_RETURN_ON_ERROR(start_timestamp >= 0, RMT_ERROR_INVALID_SIZE);
 
-    return RMT_OK;
+    if (bucket_offset == 0)
+    {
+        return RMT_OK;
+    }
+
+    // Move the buckets that are still in range, like a ring buffer being rotated, and work out which buckets are new.
+    const int32_t bucket_count       = timeline_histogram->bucket_count;
+    const int32_t bucket_group_count = timeline_histogram->bucket_group_count;
+    int32_t       first_new_bucket   = 0;
+    int32_t       new_bucket_count   = bucket_count;
+    if ((bucket_offset > 0) && (bucket_offset < bucket_count))
+    {
+        const int32_t kept_bucket_count = bucket_count - bucket_offset;
+        memmove(timeline_histogram->bucket_data,
+                timeline_histogram->bucket_data + ((size_t)bucket_offset * bucket_group_count),
+                (size_t)kept_bucket_count * bucket_group_count * sizeof(uint64_t));
+        first_new_bucket = kept_bucket_count;
+        new_bucket_count = bucket_offset;
+    }
+    else if ((bucket_offset < 0) && (-bucket_offset < bucket_count))
+    {
+        const int32_t kept_bucket_count = bucket_count + bucket_offset;
+        memmove(timeline_histogram->bucket_data + ((size_t)-bucket_offset * bucket_group_count),
+                timeline_histogram->bucket_data,
+                (size_t)kept_bucket_count * bucket_group_count * sizeof(uint64_t));
+        first_new_bucket = 0;
+        new_bucket_count = -bucket_offset;
+    }
+
+    timeline_histogram->start_timestamp = (uint64_t)start_timestamp;
+    const uint64_t end_timestamp        = timeline_histogram->start_timestamp + (bucket_count * timeline_histogram->bucket_width_in_cycles);
+    return GenerateHistogramBuckets(timeline_histogram, job_queue, end_timestamp, first_new_bucket, new_bucket_count);
 }
 
 // destroy the histogram.
@@ -166,6 +225,7 @@ RmtErrorCode RmtDataTimelineHistogramDestroy(RmtDataTimelineHistogram* timeline_
 
     timeline_histogram->timeline               = NULL;
     timeline_histogram->bucket_data            = NULL;
+    timeline_histogram->start_timestamp        = 0;
     timeline_histogram->bucket_width_in_cycles = 0;
     timeline_histogram->bucket_count           = 0;
     timeline_histogram->bucket_group_count     = 0;
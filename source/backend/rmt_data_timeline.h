@@ -98,6 +98,7 @@ typedef struct RmtDataTimelineHistogram
 {
     const RmtDataTimeline* timeline;                               ///< A pointer to the <c><i>RmtDataTimeline</i></c> that was used to generate the histogram.
     uint64_t*              bucket_data;                            ///< A pointer to the memory allocated to contain the data.
+    uint64_t               start_timestamp;                        ///< The timestamp of the start of the first bucket.
     uint64_t               bucket_width_in_cycles;                 ///< The width of each bucket in cycles.
     int32_t                bucket_count;                           ///< The number of buckets.
     int32_t                bucket_group_count;                     ///< The number of groups that are inside each bucket.
@@ -131,6 +132,25 @@ RmtErrorCode RmtDataTimelineCreateHistogram(const RmtDataTimeline*    timeline,
                                             uint64_t                  end_timestamp,
                                             RmtDataTimelineHistogram* out_timeline_histogram);
 
+/// Scroll a <c><i>RmtDataTimelineHistogram</i></c> by a whole number of buckets.
+///
+/// The bucket width and count stay the same. Buckets that are in both the old and the new range are moved
+/// rather than generated again, so only the buckets scrolled into view are generated from the timeline.
+///
+/// @param [in,out] timeline_histogram                  A pointer to a <c><i>RmtDataTimelineHistogram</i></c> structure to scroll.
+/// @param [in]     job_queue                           The job queue responsible for allocating work to worker threads.
+/// @param [in]     bucket_offset                       The number of buckets to scroll by. Negative values scroll towards the start of the timeline.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because <c><i>timeline_histogram</i></c> or <c><i>job_queue</i></c> was NULL.
+/// @retval
+/// RMT_ERROR_MALFORMED_DATA                        The operation failed because <c><i>timeline_histogram</i></c> was not correctly initialized.
+/// @retval
+/// RMT_ERROR_INVALID_SIZE                          The operation failed because the histogram would start before the start of the timeline.
+RmtErrorCode RmtDataTimelineHistogramScroll(RmtDataTimelineHistogram* timeline_histogram, RmtJobQueue* job_queue, int32_t bucket_offset);
+
 /// Destroy a <c><i>RmtDataTimelineHistogram</i></c>.
 ///
 /// @param [in,out]     timeline_histogram                   A pointer to a <c><i>RmtDataTimelineHistogram</i></c> structure to destroy.
@@ -8,10 +8,498 @@
 #include "rmt_platform.h"
 #include <rmt_assert.h>
 #include <string.h>  // for memset()
+#include <stdlib.h>  // for malloc(), free()
 
 // flag to signal worker thread should terminate
 #define WORKER_THREAD_FLAGS_TERMINATE (1 << 0)
 
+// the initial number of entries in each worker's deque.
+#define INITIAL_DEQUE_CAPACITY (256)
+
+// the number of batches each worker should get from a job, on average. More batches
+// give better load balancing for uneven jobs at the cost of more atomic operations.
+#define BATCHES_PER_WORKER (4)
+
+// a thread asleep in RmtJobQueueWaitForCompletion, linked in to the queue's waiter list.
+typedef struct JobQueueWaiter
+{
+    RmtJobHandle    handle;       // the handle of the job being waited on.
+    RmtJobHandle    root_handle;  // the root job the thread takes work from while waiting.
+    RmtThreadEvent* wake;         // the event to signal to wake the thread.
+    JobQueueWaiter* next;         // the next waiter in the list.
+} JobQueueWaiter;
+
+// an auto-reset event for a thread that isn't a worker thread to sleep on while waiting.
+struct ExternalThreadEvent
+{
+    ExternalThreadEvent()
+    {
+        RmtThreadEventCreate(&event, false, false, "");
+    }
+
+    ~ExternalThreadEvent()
+    {
+        RmtThreadEventDestroy(&event);
+    }
+
+    RmtThreadEvent event;
+};
+
+// get the calling thread's event, created the first time the thread waits on a queue.
+static RmtThreadEvent* GetExternalThreadEvent()
+{
+    static thread_local ExternalThreadEvent external_thread_event;
+    return &external_thread_event.event;
+}
+
+// the worker thread input of the calling thread, or NULL if it isn't a worker thread.
+static thread_local RmtJobQueueWorkerThreadInput* s_current_worker = NULL;
+
+// the root handle of the job the calling thread is running, or 0 if it isn't running one.
+static thread_local RmtJobHandle s_current_root_handle = 0;
+
+// get the index of the calling thread's worker in a queue, or RMT_JOB_QUEUE_EXTERNAL_THREAD_ID if it isn't one of its workers.
+static int32_t GetCurrentWorkerIndex(const RmtJobQueue* job_queue)
+{
+    if ((s_current_worker != NULL) && (s_current_worker->job_queue == job_queue))
+    {
+        return (int32_t)s_current_worker->thread_id;
+    }
+
+    return RMT_JOB_QUEUE_EXTERNAL_THREAD_ID;
+}
+
+// extract the slot index from a job handle.
+static int32_t GetSlotIndexFromHandle(RmtJobHandle handle)
+{
+    return (int32_t)(handle & 0xffffffff);
+}
+
+// get the job in a slot.
+static RmtJobQueueJob* GetJob(RmtJobQueue* job_queue, int32_t slot_index)
+{
+    return &job_queue->job_blocks[slot_index / RMT_JOB_QUEUE_JOB_BLOCK_SIZE][slot_index % RMT_JOB_QUEUE_JOB_BLOCK_SIZE];
+}
+
+// check a handle refers to a slot that has been allocated, must be called with the queue mutex held.
+static bool IsValidSlotIndex(const RmtJobQueue* job_queue, int32_t slot_index)
+{
+    return (slot_index >= 0) && (slot_index < (job_queue->job_block_count * RMT_JOB_QUEUE_JOB_BLOCK_SIZE));
+}
+
+// add another block of slots to the pool and put them on the free list, must be called with the queue mutex held.
+static bool GrowJobPool(RmtJobQueue* job_queue)
+{
+    if (job_queue->job_block_count == RMT_JOB_QUEUE_MAXIMUM_JOB_BLOCKS)
+    {
+        return false;
+    }
+
+    // every slot is either in use or on the free list, so the free list needs room for all of them.
+    const int32_t slot_count = (job_queue->job_block_count + 1) * RMT_JOB_QUEUE_JOB_BLOCK_SIZE;
+    int32_t*      free_slots = (int32_t*)realloc(job_queue->free_slots, slot_count * sizeof(int32_t));
+    if (free_slots == NULL)
+    {
+        return false;
+    }
+    job_queue->free_slots = free_slots;
+
+    RmtJobQueueJob* job_block = (RmtJobQueueJob*)calloc(RMT_JOB_QUEUE_JOB_BLOCK_SIZE, sizeof(RmtJobQueueJob));
+    if (job_block == NULL)
+    {
+        return false;
+    }
+
+    // push the new slots so the lowest index is popped first.
+    const int32_t first_slot_index = job_queue->job_block_count * RMT_JOB_QUEUE_JOB_BLOCK_SIZE;
+    for (int32_t slot_index = slot_count - 1; slot_index >= first_slot_index; --slot_index)
+    {
+        job_queue->free_slots[job_queue->free_slot_count++] = slot_index;
+    }
+
+    job_queue->job_blocks[job_queue->job_block_count] = job_block;
+    job_queue->job_block_count++;
+    return true;
+}
+
+// build a new handle for a slot, advancing the generation of the previous handle in that slot.
+static RmtJobHandle GetNextHandleForSlot(RmtJobHandle previous_handle, int32_t slot_index)
+{
+    const uint64_t generation = (previous_handle >> 32) + 1;
+    return (generation << 32) | (uint64_t)slot_index;
+}
+
+// push a job handle onto the bottom of a worker's deque.
+static void DequePush(RmtJobQueueWorkerDeque* deque, RmtJobHandle handle)
+{
+    RmtMutexLock(&deque->mutex);
+
+    // double the ring when it fills up, unwrapping the live entries in to the new one.
+    if ((deque->bottom - deque->top) == deque->capacity)
+    {
+        const int64_t new_capacity = deque->capacity * 2;
+        RmtJobHandle* new_entries  = (RmtJobHandle*)malloc(new_capacity * sizeof(RmtJobHandle));
+        RMT_ASSERT(new_entries);
+        for (int64_t index = deque->top; index < deque->bottom; ++index)
+        {
+            new_entries[index % new_capacity] = deque->entries[index % deque->capacity];
+        }
+        free(deque->entries);
+        deque->entries  = new_entries;
+        deque->capacity = new_capacity;
+    }
+
+    // top and bottom are only changed with the mutex held, but are stored atomically for the unlocked checks in the steals.
+    deque->entries[deque->bottom % deque->capacity] = handle;
+    RmtThreadAtomicStore64(&deque->bottom, deque->bottom + 1);
+
+    RmtMutexUnlock(&deque->mutex);
+}
+
+// pop the newest job handle from the bottom of the owning worker's deque.
+static bool DequePop(RmtJobQueueWorkerDeque* deque, RmtJobHandle* out_handle)
+{
+    bool result = false;
+    RmtMutexLock(&deque->mutex);
+
+    if (deque->bottom > deque->top)
+    {
+        RmtThreadAtomicStore64(&deque->bottom, deque->bottom - 1);
+        *out_handle = deque->entries[deque->bottom % deque->capacity];
+        result      = true;
+    }
+
+    RmtMutexUnlock(&deque->mutex);
+    return result;
+}
+
+// steal the oldest job handle from the top of another worker's deque.
+static bool DequeSteal(RmtJobQueueWorkerDeque* deque, RmtJobHandle* out_handle)
+{
+    // cheap unlocked check so idle workers don't contend on empty deques. Loads rather than atomic adds,
+    // so polling an empty deque doesn't pull its cache line away from the owning worker.
+    if (RmtThreadAtomicLoad64(&deque->bottom) <= RmtThreadAtomicLoad64(&deque->top))
+    {
+        return false;
+    }
+
+    bool result = false;
+    RmtMutexLock(&deque->mutex);
+
+    if (deque->bottom > deque->top)
+    {
+        *out_handle = deque->entries[deque->top % deque->capacity];
+        RmtThreadAtomicStore64(&deque->top, deque->top + 1);
+        result = true;
+    }
+
+    RmtMutexUnlock(&deque->mutex);
+    return result;
+}
+
+// take the oldest job handle belonging to a root job from anywhere in a deque.
+static bool DequeStealFromRoot(RmtJobQueue* job_queue, RmtJobQueueWorkerDeque* deque, RmtJobHandle root_handle, RmtJobHandle* out_handle)
+{
+    if (RmtThreadAtomicLoad64(&deque->bottom) <= RmtThreadAtomicLoad64(&deque->top))
+    {
+        return false;
+    }
+
+    bool result = false;
+    RmtMutexLock(&deque->mutex);
+
+    // each entry holds a reference to its slot, so the root handle can be read without the queue mutex.
+    for (int64_t index = deque->top; index < deque->bottom; ++index)
+    {
+        const RmtJobHandle handle = deque->entries[index % deque->capacity];
+        if (GetJob(job_queue, GetSlotIndexFromHandle(handle))->root_handle != root_handle)
+        {
+            continue;
+        }
+
+        // close the gap by moving the older entries down one place.
+        for (int64_t move_index = index; move_index > deque->top; --move_index)
+        {
+            deque->entries[move_index % deque->capacity] = deque->entries[(move_index - 1) % deque->capacity];
+        }
+        RmtThreadAtomicStore64(&deque->top, deque->top + 1);
+
+        *out_handle = handle;
+        result      = true;
+        break;
+    }
+
+    RmtMutexUnlock(&deque->mutex);
+    return result;
+}
+
+// add to one of a worker's statistics counters. Only the worker itself writes its counters, but they
+// are stored atomically as other threads may read them through RmtJobQueueGetWorkerStatistics.
+static void AddToWorkerStatistic(uint64_t* counter, uint64_t value)
+{
+    RmtThreadAtomicStore64((volatile int64_t*)counter, (int64_t)(*counter + value));
+}
+
+// read one of a worker's statistics counters while the worker may be updating it.
+static uint64_t ReadWorkerStatistic(const uint64_t* counter)
+{
+    return (uint64_t)RmtThreadAtomicLoad64((volatile int64_t*)counter);
+}
+
+// find a job to work on, first from the worker's own deque, then by stealing from the others.
+// a thread waiting on a job passes the job's root, and only takes work belonging to that root.
+// that keeps threads that aren't workers from being held up by unrelated jobs, and keeps a worker
+// waiting inside a job from running an unrelated job on top of it, which could wait on something
+// that can't finish until the suspended job underneath it returns.
+static bool FindWork(RmtJobQueue* job_queue, int32_t thread_id, RmtJobHandle root_handle, RmtJobHandle* out_handle)
+{
+    if (RmtThreadAtomicLoad(&job_queue->pending_count) <= 0)
+    {
+        return false;
+    }
+
+    bool found = false;
+    if (thread_id != RMT_JOB_QUEUE_EXTERNAL_THREAD_ID)
+    {
+        RmtJobQueueWorkerDeque* deque = &job_queue->worker_deques[thread_id];
+        found                         = (root_handle == 0) ? DequePop(deque, out_handle) : DequeStealFromRoot(job_queue, deque, root_handle, out_handle);
+    }
+    const bool own_deque = found;
+
+    const int32_t first_victim_index = (thread_id != RMT_JOB_QUEUE_EXTERNAL_THREAD_ID) ? (thread_id + 1) : 0;
+    for (int32_t offset = 0; !found && offset < job_queue->worker_thread_count; ++offset)
+    {
+        const int32_t victim_index = (first_victim_index + offset) % job_queue->worker_thread_count;
+        if (victim_index == thread_id)
+        {
+            continue;
+        }
+
+        if (root_handle != 0)
+        {
+            found = DequeStealFromRoot(job_queue, &job_queue->worker_deques[victim_index], root_handle, out_handle);
+        }
+        else
+        {
+            found = DequeSteal(&job_queue->worker_deques[victim_index], out_handle);
+        }
+    }
+
+    if (found)
+    {
+        RmtThreadAtomicAdd(&job_queue->pending_count, -1);
+
+        if (thread_id != RMT_JOB_QUEUE_EXTERNAL_THREAD_ID)
+        {
+            RmtJobQueueWorkerStatistics* statistics = &job_queue->worker_thread_inputs[thread_id].statistics;
+            AddToWorkerStatistic(&statistics->job_count, 1);
+            AddToWorkerStatistic(&statistics->steal_count, own_deque ? 0 : 1);
+        }
+    }
+
+    return found;
+}
+
+// return a job slot to the free list once nothing references it.
+static void ReleaseJobSlot(RmtJobQueue* job_queue, int32_t slot_index)
+{
+    RmtMutexLock(&job_queue->queue_mutex);
+    job_queue->free_slots[job_queue->free_slot_count++] = slot_index;
+    RmtMutexUnlock(&job_queue->queue_mutex);
+}
+
+// push references to a job whose dependencies have all completed onto the worker deques, and wake workers for it.
+static void ScheduleJob(RmtJobQueue* job_queue, int32_t slot_index)
+{
+    RmtJobQueueJob*    job          = GetJob(job_queue, slot_index);
+    const RmtJobHandle job_handle   = RmtThreadAtomicRead(&job->handle);
+    const int32_t      worker_count = job_queue->worker_thread_count;
+
+    // hand out one reference per worker that can usefully help.
+    const int32_t batch_count     = (job->count + job->batch_size - 1) / job->batch_size;
+    const int32_t reference_count = (batch_count < worker_count) ? batch_count : worker_count;
+    job->reference_count          = reference_count;
+
+    // distribute the references round-robin across the worker deques. Jobs added from inside
+    // a job start with the worker's own deque, so it picks them up first if it waits on them.
+    const int32_t current_worker_index = GetCurrentWorkerIndex(job_queue);
+    const int32_t first_worker_index   = (current_worker_index != RMT_JOB_QUEUE_EXTERNAL_THREAD_ID)
+                                             ? current_worker_index
+                                             : (RmtThreadAtomicAdd(&job_queue->worker_next, 1) - 1) % worker_count;
+    for (int32_t reference_index = 0; reference_index < reference_count; ++reference_index)
+    {
+        const int32_t worker_index = (first_worker_index + reference_index) % worker_count;
+        DequePush(&job_queue->worker_deques[worker_index], job_handle);
+    }
+    RmtThreadAtomicAdd(&job_queue->pending_count, reference_count);
+
+    // wake up parked workers to pick up the new work.
+    int32_t woken_count = 0;
+    for (int32_t worker_index = 0; worker_index < worker_count && woken_count < reference_count; ++worker_index)
+    {
+        RmtJobQueueWorkerThreadInput* worker_input = &job_queue->worker_thread_inputs[worker_index];
+        if (RmtThreadAtomicRead(&worker_input->parked) != 0)
+        {
+            RmtThreadEventSignal(&worker_input->wake);
+            woken_count++;
+        }
+    }
+
+    // threads asleep waiting on a job can help with the new work too, if they are allowed to run it.
+    if (RmtThreadAtomicAdd(&job_queue->waiter_count, 0) > 0)
+    {
+        RmtMutexLock(&job_queue->queue_mutex);
+        for (JobQueueWaiter* waiter = (JobQueueWaiter*)job_queue->waiter_list; waiter != NULL; waiter = waiter->next)
+        {
+            if (waiter->root_handle == job->root_handle)
+            {
+                RmtThreadEventSignal(waiter->wake);
+            }
+        }
+        RmtMutexUnlock(&job_queue->queue_mutex);
+    }
+}
+
+// drop one unresolved dependency from a job, scheduling it if that was the last.
+static void ResolveDependency(RmtJobQueue* job_queue, int32_t slot_index)
+{
+    if (RmtThreadAtomicAdd(&GetJob(job_queue, slot_index)->dependency_count, -1) == 0)
+    {
+        ScheduleJob(job_queue, slot_index);
+    }
+}
+
+// called once all indices of a job have run, releases any jobs that were waiting on it.
+static void CompleteJob(RmtJobQueue* job_queue, RmtJobQueueJob* job)
+{
+    int32_t continuations[RMT_MAXIMUM_JOB_CONTINUATIONS];
+
+    // seal the continuation list so no more jobs can be added to it, and wake anything waiting on the job.
+    RmtMutexLock(&job_queue->queue_mutex);
+    const int32_t continuation_count = job->continuation_count;
+    memcpy(continuations, job->continuations, continuation_count * sizeof(int32_t));
+    job->continuation_count = -1;
+
+    for (JobQueueWaiter* waiter = (JobQueueWaiter*)job_queue->waiter_list; waiter != NULL; waiter = waiter->next)
+    {
+        if (waiter->handle == job->handle)
+        {
+            RmtThreadEventSignal(waiter->wake);
+        }
+    }
+    RmtMutexUnlock(&job_queue->queue_mutex);
+
+    for (int32_t continuation_index = 0; continuation_index < continuation_count; ++continuation_index)
+    {
+        ResolveDependency(job_queue, continuations[continuation_index]);
+    }
+}
+
+// claim and run batches of a job until all of its indices have been claimed.
+static void RunJob(RmtJobQueue* job_queue, int32_t thread_id, RmtJobHandle handle)
+{
+    const int32_t   slot_index = GetSlotIndexFromHandle(handle);
+    RmtJobQueueJob* job        = GetJob(job_queue, slot_index);
+
+    // the deque entry holds a reference so the slot can't be recycled underneath us.
+    const int64_t count      = job->count;
+    const int64_t batch_size = job->batch_size;
+
+    // jobs added by this one belong to the same root, restored afterwards for nested waits.
+    const RmtJobHandle previous_root_handle = s_current_root_handle;
+    s_current_root_handle                   = job->root_handle;
+
+    while (true)
+    {
+        const int64_t start_index = RmtThreadAtomicAdd64(&job->next_index, batch_size) - batch_size;
+        if (start_index >= count)
+        {
+            break;
+        }
+
+        const int64_t end_index = (start_index + batch_size) < count ? (start_index + batch_size) : count;
+        for (int64_t index = start_index; index < end_index; ++index)
+        {
+            (*job->function)(thread_id, job->base_index + (int32_t)index, job->input);
+        }
+
+        if (thread_id != RMT_JOB_QUEUE_EXTERNAL_THREAD_ID)
+        {
+            RmtJobQueueWorkerStatistics* statistics = &job_queue->worker_thread_inputs[thread_id].statistics;
+            AddToWorkerStatistic(&statistics->batch_count, 1);
+            AddToWorkerStatistic(&statistics->index_count, end_index - start_index);
+        }
+
+        // signal that the batch is done, whoever finishes the last batch releases the job's continuations.
+        if (RmtThreadAtomicAdd64(&job->completed_count, end_index - start_index) == count)
+        {
+            CompleteJob(job_queue, job);
+        }
+    }
+
+    s_current_root_handle = previous_root_handle;
+
+    // drop this deque entry's reference, the last one out recycles the slot.
+    if (RmtThreadAtomicAdd(&job->reference_count, -1) == 0)
+    {
+        ReleaseJobSlot(job_queue, slot_index);
+    }
+}
+
+// split the workers between the numa nodes in proportion to the number of processors in each node the process
+// may run on, writing one past the index of the last worker for each node. Nodes with no usable processors get
+// no workers, and if fewer than two nodes are usable every node is left empty, so no workers are pinned.
+static void AssignWorkersToNumaNodes(int32_t worker_thread_count, int32_t numa_node_count, int32_t* out_worker_ends)
+{
+    int64_t total_processor_count  = 0;
+    int32_t usable_numa_node_count = 0;
+    for (int32_t node_index = 0; node_index < numa_node_count; ++node_index)
+    {
+        const int32_t processor_count = RmtThreadGetNumaNodeProcessorCount(node_index);
+        out_worker_ends[node_index]   = processor_count;
+
+        total_processor_count += processor_count;
+        if (processor_count > 0)
+        {
+            usable_numa_node_count++;
+        }
+    }
+
+    if (usable_numa_node_count < 2)
+    {
+        memset(out_worker_ends, 0, numa_node_count * sizeof(int32_t));
+        return;
+    }
+
+    // round the running total of processors, so the workers add up to the total with no node more than one out.
+    int64_t processor_end = 0;
+    for (int32_t node_index = 0; node_index < numa_node_count; ++node_index)
+    {
+        processor_end += out_worker_ends[node_index];
+
+        out_worker_ends[node_index] = (int32_t)((processor_end * worker_thread_count + total_processor_count / 2) / total_processor_count);
+    }
+}
+
+// get the numa node a worker is assigned to, or -1 if it isn't pinned to one.
+static int32_t GetWorkerNumaNode(const int32_t* worker_ends, int32_t numa_node_count, int32_t worker_index)
+{
+    if (worker_ends == NULL)
+    {
+        return -1;
+    }
+
+    for (int32_t node_index = 0; node_index < numa_node_count; ++node_index)
+    {
+        if (worker_index < worker_ends[node_index])
+        {
+            return node_index;
+        }
+    }
+
+    return -1;
+}
+
 // job system main function
 static uint32_t RMT_THREAD_FUNC JobSystemThreadFunc(void* input_data)
 {
@@ -25,12 +513,19 @@ static uint32_t RMT_THREAD_FUNC JobSystemThreadFunc(void* input_data)
         return 0;
     }
 
+    RmtJobQueue*                 job_queue  = thread_input->job_queue;
+    RmtJobQueueWorkerStatistics* statistics = &thread_input->statistics;
+    s_current_worker                        = thread_input;
+
+    // keep the worker on its NUMA node, so the memory its jobs touch stays local.
+    if ((statistics->numa_node >= 0) && (RmtThreadSetCurrentThreadNumaNode(statistics->numa_node) != RMT_OK))
+    {
+        RmtThreadAtomicStore(&statistics->numa_node, -1);
+    }
+
     // run until the thread terminate signal is set
     while (true)
     {
-        // sleep the thread until work is available
-        RmtThreadEventWait(&thread_input->job_queue->signal);
-
         // check if we should quit
         const uint64_t flags = RmtThreadAtomicRead((volatile uint64_t*)&thread_input->flags);
 
@@ -39,44 +534,28 @@ static uint32_t RMT_THREAD_FUNC JobSystemThreadFunc(void* input_data)
             break;
         }
 
-        // acquire the mutex.
-        const RmtErrorCode error_code = RmtMutexLock(&thread_input->job_queue->queue_mutex);
-        RMT_ASSERT(error_code == RMT_OK);
-
-        // if there is no work then reset the signal and release the mutex
-        if (thread_input->job_queue->queue_size == 0)
+        RmtJobHandle handle = 0;
+        if (FindWork(job_queue, thread_input->thread_id, 0, &handle))
         {
-            RmtThreadEventReset(&thread_input->job_queue->signal);
-            RmtMutexUnlock(&thread_input->job_queue->queue_mutex);
+            const uint64_t start_timestamp = RmtGetCurrentTimestamp();
+            RunJob(job_queue, thread_input->thread_id, handle);
+            AddToWorkerStatistic(&statistics->busy_time, RmtGetCurrentTimestamp() - start_timestamp);
+            continue;
         }
-        else
-        {
-            // there is some work in the queue grab the job from the head
-            const int32_t job_index = thread_input->job_queue->queue_head_index;
-
-            RmtJobQueueJob*   current_job    = &thread_input->job_queue->queue_items[job_index];
-            const int32_t     index          = current_job->run_count++;
-            const int32_t     adjusted_index = current_job->base_index + index;
-            void*             job_input      = current_job->input;
-            RmtJobFunction    func           = current_job->function;
-            volatile int64_t* addr           = &current_job->completed_count;
-
-            // if we ran the last instance, then remove it from the queue
-            if (current_job->run_count == current_job->count)
-            {
-                thread_input->job_queue->queue_head_index = (thread_input->job_queue->queue_head_index + 1) % RMT_MAXIMUM_JOB_COUNT;
-                thread_input->job_queue->queue_size--;
-            }
-
-            // release queue access
-            RmtMutexUnlock(&thread_input->job_queue->queue_mutex);
 
-            // run the job
-            (*func)(thread_input->thread_id, adjusted_index, job_input);
+        // no work anywhere, so park. Publish that we are parked before re-checking for work, the
+        // submitter does the opposite so one of us is guaranteed to see the other.
+        RmtThreadAtomicWrite(&thread_input->parked, 1);
 
-            // signal that it is done.
-            RmtThreadAtomicAdd64(addr, 1);
+        const bool has_work  = RmtThreadAtomicAdd(&job_queue->pending_count, 0) > 0;
+        const bool terminate = (RmtThreadAtomicRead(&thread_input->flags) & WORKER_THREAD_FLAGS_TERMINATE) != 0;
+        if (!has_work && !terminate)
+        {
+            AddToWorkerStatistic(&statistics->park_count, 1);
+            RmtThreadEventWait(&thread_input->wake);
         }
+
+        RmtThreadAtomicWrite(&thread_input->parked, 0);
     }
 
     return 0;
@@ -87,40 +566,64 @@ RmtErrorCode RmtJobQueueInitialize(RmtJobQueue* job_queue, int32_t worker_thread
 {
     RMT_ASSERT_MESSAGE(job_queue, "Parameter jobQueue is NULL.");
     RMT_RETURN_ON_ERROR(job_queue, RMT_ERROR_INVALID_POINTER);
-    RMT_RETURN_ON_ERROR(worker_thread_count > 0 && worker_thread_count <= RMT_MAXIMUM_WORKER_THREADS, RMT_ERROR_INDEX_OUT_OF_RANGE);
+    RMT_RETURN_ON_ERROR(worker_thread_count >= 0, RMT_ERROR_INDEX_OUT_OF_RANGE);
+
+    if (worker_thread_count == RMT_JOB_QUEUE_DEFAULT_WORKER_THREAD_COUNT)
+    {
+        worker_thread_count = RmtThreadGetHardwareThreadCount();
+    }
 
     // stash anything we need in the structure
+    memset(job_queue, 0, sizeof(RmtJobQueue));
     job_queue->worker_thread_count = worker_thread_count;
-    job_queue->handle_next         = 0;
 
-    // clear the queue contents
-    memset(job_queue->queue_items, 0, sizeof(job_queue->queue_items));
+    // allocate the per-worker state.
+    job_queue->worker_threads       = (RmtThread*)calloc(worker_thread_count, sizeof(RmtThread));
+    job_queue->worker_thread_inputs = (RmtJobQueueWorkerThreadInput*)calloc(worker_thread_count, sizeof(RmtJobQueueWorkerThreadInput));
+    job_queue->worker_deques        = (RmtJobQueueWorkerDeque*)calloc(worker_thread_count, sizeof(RmtJobQueueWorkerDeque));
+    RMT_RETURN_ON_ERROR(job_queue->worker_threads && job_queue->worker_thread_inputs && job_queue->worker_deques, RMT_ERROR_OUT_OF_MEMORY);
 
-    // create the event to signal when queue has work
-    RmtErrorCode error_code = RMT_OK;
-    error_code              = RmtThreadEventCreate(&job_queue->signal, false, true, "");
+    // create the mutex for allocating job slots, and the first block of them.
+    RmtErrorCode error_code = RmtMutexCreate(&job_queue->queue_mutex, "RMT Job Queue Mutex");
     RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+    RMT_RETURN_ON_ERROR(GrowJobPool(job_queue), RMT_ERROR_OUT_OF_MEMORY);
 
-    // create the mutex for altering the job queue
-    error_code = RmtMutexCreate(&job_queue->queue_mutex, "RMT Job Queue Mutex");
-    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
-
-    // set up the queue
-    job_queue->queue_tail_index = 0;
-    job_queue->queue_head_index = 0;
-    job_queue->queue_size       = 0;
+    // on NUMA systems give each node a contiguous range of workers, so stealing tries neighbours on the same node first.
+    int32_t*      numa_node_worker_ends = NULL;
+    const int32_t numa_node_count       = RmtThreadGetNumaNodeCount();
+    if (numa_node_count > 1)
+    {
+        numa_node_worker_ends = (int32_t*)calloc(numa_node_count, sizeof(int32_t));
+        RMT_RETURN_ON_ERROR(numa_node_worker_ends, RMT_ERROR_OUT_OF_MEMORY);
+        AssignWorkersToNumaNodes(worker_thread_count, numa_node_count, numa_node_worker_ends);
+    }
 
-    // create our worker threads.
+    // set up the per-worker deques and parking events.
     for (int32_t current_worker_thread_index = 0; current_worker_thread_index < worker_thread_count; ++current_worker_thread_index)
     {
-        // set up the inputs
+        RmtJobQueueWorkerDeque* deque = &job_queue->worker_deques[current_worker_thread_index];
+        deque->capacity               = INITIAL_DEQUE_CAPACITY;
+        deque->entries                = (RmtJobHandle*)malloc(deque->capacity * sizeof(RmtJobHandle));
+        RMT_RETURN_ON_ERROR(deque->entries, RMT_ERROR_OUT_OF_MEMORY);
+        error_code = RmtMutexCreate(&deque->mutex, "RMT Job Queue Worker Deque Mutex");
+        RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
         RmtJobQueueWorkerThreadInput* input = &job_queue->worker_thread_inputs[current_worker_thread_index];
         input->thread_id                    = current_worker_thread_index;
         input->job_queue                    = job_queue;
-        input->flags                        = 0;
+        input->start_timestamp              = RmtGetCurrentTimestamp();
+        input->statistics.numa_node         = GetWorkerNumaNode(numa_node_worker_ends, numa_node_count, current_worker_thread_index);
+        error_code                          = RmtThreadEventCreate(&input->wake, false, false, "");
+        RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+    }
+
+    free(numa_node_worker_ends);
 
-        // create the thread
-        error_code = RmtThreadCreate(&job_queue->worker_threads[current_worker_thread_index], JobSystemThreadFunc, input);
+    // create our worker threads.
+    for (int32_t current_worker_thread_index = 0; current_worker_thread_index < worker_thread_count; ++current_worker_thread_index)
+    {
+        RmtJobQueueWorkerThreadInput* input = &job_queue->worker_thread_inputs[current_worker_thread_index];
+        error_code                          = RmtThreadCreate(&job_queue->worker_threads[current_worker_thread_index], JobSystemThreadFunc, input);
 
         RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
     }
@@ -134,16 +637,14 @@ RmtErrorCode RmtJobQueueShutdown(RmtJobQueue* job_queue)
     RMT_ASSERT_MESSAGE(job_queue, "Parameter jobQueue is NULL.");
     RMT_RETURN_ON_ERROR(job_queue, RMT_ERROR_INVALID_POINTER);
 
-    // singal to terminate all the threads
+    // singal to terminate all the threads, and wake them so they see it.
     for (int32_t current_worker_thread_index = 0; current_worker_thread_index < job_queue->worker_thread_count; ++current_worker_thread_index)
     {
         RmtJobQueueWorkerThreadInput* input = &job_queue->worker_thread_inputs[current_worker_thread_index];
         RmtThreadAtomicOr((volatile uint64_t*)&input->flags, WORKER_THREAD_FLAGS_TERMINATE);
+        RmtThreadEventSignal(&input->wake);
     }
 
-    // signal all threads that there is work
-    RmtThreadEventSignal(&job_queue->signal);
-
     // wait for all the threads to finish
     for (int32_t current_worker_thread_index = 0; current_worker_thread_index < job_queue->worker_thread_count; ++current_worker_thread_index)
     {
@@ -151,9 +652,25 @@ RmtErrorCode RmtJobQueueShutdown(RmtJobQueue* job_queue)
         RMT_ASSERT(error_code == RMT_OK);
     }
 
-    RmtThreadEventDestroy(&job_queue->signal);
+    for (int32_t current_worker_thread_index = 0; current_worker_thread_index < job_queue->worker_thread_count; ++current_worker_thread_index)
+    {
+        RmtThreadEventDestroy(&job_queue->worker_thread_inputs[current_worker_thread_index].wake);
+        RmtMutexDestroy(&job_queue->worker_deques[current_worker_thread_index].mutex);
+        free(job_queue->worker_deques[current_worker_thread_index].entries);
+    }
+
+    for (int32_t job_block_index = 0; job_block_index < job_queue->job_block_count; ++job_block_index)
+    {
+        free(job_queue->job_blocks[job_block_index]);
+    }
+
+    free(job_queue->free_slots);
+    free(job_queue->worker_deques);
+    free(job_queue->worker_thread_inputs);
+    free(job_queue->worker_threads);
     RmtMutexDestroy(&job_queue->queue_mutex);
 
+    memset(job_queue, 0, sizeof(RmtJobQueue));
     return RMT_OK;
 }
 
@@ -165,48 +682,117 @@ RmtErrorCode RmtJobQueueAddSingle(RmtJobQueue* job_queue, RmtJobFunction func, v
 
 // add a job to the queue
 RmtErrorCode RmtJobQueueAddMultiple(RmtJobQueue* job_queue, RmtJobFunction func, void* input, int32_t base_index, int32_t count, RmtJobHandle* out_handle)
+{
+    return RmtJobQueueAddMultipleWithDependencies(job_queue, func, input, base_index, count, NULL, 0, out_handle);
+}
+
+// add a job to the queue that runs once its dependencies have completed
+RmtErrorCode RmtJobQueueAddMultipleWithDependencies(RmtJobQueue*        job_queue,
+                                                    RmtJobFunction      func,
+                                                    void*               input,
+                                                    int32_t             base_index,
+                                                    int32_t             count,
+                                                    const RmtJobHandle* dependencies,
+                                                    int32_t             dependency_count,
+                                                    RmtJobHandle*       out_handle)
 {
     RMT_ASSERT_MESSAGE(job_queue, "Parameter jobQueue is NULL.");
     RMT_ASSERT_MESSAGE(func, "Parameter func is NULL.");
     RMT_RETURN_ON_ERROR(job_queue, RMT_ERROR_INVALID_POINTER);
     RMT_RETURN_ON_ERROR(func, RMT_ERROR_INVALID_POINTER);
-    RMT_RETURN_ON_ERROR(count, RMT_ERROR_INVALID_SIZE);
-
-    // add work to the queue.
-    const RmtErrorCode error_code = RmtMutexLock(&job_queue->queue_mutex);
-    RMT_ASSERT(error_code == RMT_OK);
+    RMT_RETURN_ON_ERROR(count > 0, RMT_ERROR_INVALID_SIZE);
+    RMT_RETURN_ON_ERROR(dependency_count == 0 || dependencies != NULL, RMT_ERROR_INVALID_POINTER);
+
+    // split the job in to batches.
+    int32_t batch_size = count / (job_queue->worker_thread_count * BATCHES_PER_WORKER);
+    batch_size         = (batch_size > 0) ? batch_size : 1;
+
+    // the slot is claimed, reset and given its new handle in one critical section, so a thread holding a handle
+    // from the slot's previous job or registering a continuation never sees the slot half way through being reused.
+    // The lock is never held while waiting on work.
+    RmtMutexLock(&job_queue->queue_mutex);
+    for (int32_t dependency_index = 0; dependency_index < dependency_count; ++dependency_index)
+    {
+        if (!IsValidSlotIndex(job_queue, GetSlotIndexFromHandle(dependencies[dependency_index])))
+        {
+            RmtMutexUnlock(&job_queue->queue_mutex);
+            return RMT_ERROR_INDEX_OUT_OF_RANGE;
+        }
+    }
 
-    // check the size of the queue
-    if (job_queue->queue_size == RMT_MAXIMUM_JOB_COUNT)
+    // grab a free slot, growing the pool if they are all in use.
+    if ((job_queue->free_slot_count == 0) && !GrowJobPool(job_queue))
     {
         RmtMutexUnlock(&job_queue->queue_mutex);
         return RMT_ERROR_OUT_OF_MEMORY;
     }
+    const int32_t slot_index = job_queue->free_slots[--job_queue->free_slot_count];
+
+    // the extra dependency is held by this function until every real dependency is registered,
+    // so the job can't be scheduled by a dependency completing part way through.
+    RmtJobQueueJob* job     = GetJob(job_queue, slot_index);
+    job->function           = func;
+    job->input              = input;
+    job->base_index         = base_index;
+    job->count              = count;
+    job->batch_size         = batch_size;
+    job->reference_count    = 0;
+    job->next_index         = 0;
+    job->completed_count    = 0;
+    job->dependency_count   = 1;
+    job->continuation_count = 0;
+
+    // publishing the new handle makes waiters on the slot's previous job see it as completed.
+    const RmtJobHandle job_handle = GetNextHandleForSlot(RmtThreadAtomicRead(&job->handle), slot_index);
+    job->root_handle              = (s_current_root_handle != 0) ? s_current_root_handle : job_handle;
+    RmtThreadAtomicWrite(&job->handle, job_handle);
+
+    // register with each dependency that hasn't completed yet.
+    int32_t registered_count = 0;
+    for (; registered_count < dependency_count; ++registered_count)
+    {
+        const RmtJobHandle dependency_handle = dependencies[registered_count];
+        RmtJobQueueJob*    dependency        = GetJob(job_queue, GetSlotIndexFromHandle(dependency_handle));
 
-    // work out the handle
-    const RmtJobHandle job_handle = job_queue->handle_next++;
+        // a recycled slot or sealed continuation list means the dependency has already completed.
+        if (RmtThreadAtomicRead(&dependency->handle) != dependency_handle || dependency->continuation_count < 0)
+        {
+            continue;
+        }
 
-    // block until this item in the queue is available
-    RmtJobQueueWaitForCompletion(job_queue, job_handle);
+        if (dependency->continuation_count == RMT_MAXIMUM_JOB_CONTINUATIONS)
+        {
+            break;
+        }
 
-    // work out the location in the queue and write the data
-    const int32_t job_index                           = job_queue->queue_tail_index;
-    job_queue->queue_items[job_index].function        = func;
-    job_queue->queue_items[job_index].input           = input;
-    job_queue->queue_items[job_index].base_index      = base_index;
-    job_queue->queue_items[job_index].count           = count;
-    job_queue->queue_items[job_index].run_count       = 0;
-    job_queue->queue_items[job_index].handle          = job_handle;
-    job_queue->queue_items[job_index].completed_count = 0;
+        dependency->continuations[dependency->continuation_count++] = slot_index;
+        RmtThreadAtomicAdd(&job->dependency_count, 1);
+    }
 
-    // advance the tail and size
-    job_queue->queue_tail_index = (job_queue->queue_tail_index + 1) % RMT_MAXIMUM_JOB_COUNT;
-    job_queue->queue_size++;
+    if (registered_count < dependency_count)
+    {
+        // undo the registrations made so far, they are always the last entries of each list.
+        for (int32_t dependency_index = registered_count - 1; dependency_index >= 0; --dependency_index)
+        {
+            const RmtJobHandle dependency_handle = dependencies[dependency_index];
+            RmtJobQueueJob*    dependency        = GetJob(job_queue, GetSlotIndexFromHandle(dependency_handle));
+            if (RmtThreadAtomicRead(&dependency->handle) == dependency_handle && dependency->continuation_count > 0 &&
+                dependency->continuations[dependency->continuation_count - 1] == slot_index)
+            {
+                dependency->continuation_count--;
+            }
+        }
 
+        job->completed_count                                = count;
+        job->continuation_count                             = -1;
+        job_queue->free_slots[job_queue->free_slot_count++] = slot_index;
+        RmtMutexUnlock(&job_queue->queue_mutex);
+        return RMT_ERROR_OUT_OF_MEMORY;
+    }
     RmtMutexUnlock(&job_queue->queue_mutex);
 
-    // signal all threads that there is work to do
-    RmtThreadEventSignal(&job_queue->signal);
+    // drop the registration hold, scheduling the job now if nothing is left to wait on.
+    ResolveDependency(job_queue, slot_index);
 
     // write the handle back if the pointer is not NULL
     if (out_handle != nullptr)
@@ -217,25 +803,130 @@ RmtErrorCode RmtJobQueueAddMultiple(RmtJobQueue* job_queue, RmtJobFunction func,
     return RMT_OK;
 }
 
-// check if a job has completed
+// check if a job has completed, must be called with the queue mutex held.
+static bool IsJobCompleted(RmtJobQueueJob* job, RmtJobHandle handle)
+{
+    // a handle with no generation was never returned by the queue, so there is nothing to wait on.
+    if ((handle >> 32) == 0)
+    {
+        return true;
+    }
+
+    // a recycled slot or sealed continuation list means the job has completed.
+    return (RmtThreadAtomicRead(&job->handle) != handle) || (job->continuation_count < 0);
+}
+
+// remove a waiter from the queue's waiter list.
+static void RemoveWaiter(RmtJobQueue* job_queue, JobQueueWaiter* waiter)
+{
+    RmtMutexLock(&job_queue->queue_mutex);
+
+    JobQueueWaiter** link = (JobQueueWaiter**)&job_queue->waiter_list;
+    while (*link != waiter)
+    {
+        link = &(*link)->next;
+    }
+    *link = waiter->next;
+    RmtThreadAtomicAdd(&job_queue->waiter_count, -1);
+
+    RmtMutexUnlock(&job_queue->queue_mutex);
+}
+
+// wait for a job to complete, running other jobs in the meantime
 RmtErrorCode RmtJobQueueWaitForCompletion(RmtJobQueue* job_queue, RmtJobHandle handle)
 {
     RMT_ASSERT_MESSAGE(job_queue, "Parameter jobQueue is NULL.");
     RMT_RETURN_ON_ERROR(job_queue, RMT_ERROR_INVALID_POINTER);
 
-    do
+    // the pool only grows under the queue mutex, so check the slot exists while holding it.
+    const int32_t slot_index = GetSlotIndexFromHandle(handle);
+    RmtMutexLock(&job_queue->queue_mutex);
+    const bool valid_slot_index = IsValidSlotIndex(job_queue, slot_index);
+    RmtMutexUnlock(&job_queue->queue_mutex);
+    RMT_RETURN_ON_ERROR(valid_slot_index, RMT_ERROR_INDEX_OUT_OF_RANGE);
+    RmtJobQueueJob* job = GetJob(job_queue, slot_index);
+
+    // workers sleep on their own wake event, other threads need one of their own.
+    const int32_t   thread_id = GetCurrentWorkerIndex(job_queue);
+    RmtThreadEvent* wake      = (thread_id != RMT_JOB_QUEUE_EXTERNAL_THREAD_ID) ? &job_queue->worker_thread_inputs[thread_id].wake : GetExternalThreadEvent();
+
+    // only help with the job's own root, which is read while the handle is known to be current.
+    RmtJobHandle root_handle = 0;
+    RmtMutexLock(&job_queue->queue_mutex);
+    bool completed = IsJobCompleted(job, handle);
+    if (!completed)
     {
-        const uint64_t completed_jobs = RmtThreadAtomicRead((volatile uint64_t*)&job_queue->queue_items[handle % RMT_MAXIMUM_JOB_COUNT].completed_count);
+        root_handle = job->root_handle;
+    }
+    RmtMutexUnlock(&job_queue->queue_mutex);
 
-        if ((int32_t)completed_jobs == job_queue->queue_items[handle % RMT_MAXIMUM_JOB_COUNT].count)
+    while (!completed)
+    {
+        // run pending work while the job is still going.
+        RmtJobHandle work_handle = 0;
+        if (FindWork(job_queue, thread_id, root_handle, &work_handle))
         {
-            break;
+            RunJob(job_queue, thread_id, work_handle);
         }
+        else
+        {
+            // nothing to run, so register to be woken when the job completes or new work arrives.
+            JobQueueWaiter waiter = {handle, root_handle, wake, NULL};
+
+            RmtMutexLock(&job_queue->queue_mutex);
+            if (IsJobCompleted(job, handle))
+            {
+                RmtMutexUnlock(&job_queue->queue_mutex);
+                break;
+            }
+            waiter.next            = (JobQueueWaiter*)job_queue->waiter_list;
+            job_queue->waiter_list = &waiter;
+            RmtThreadAtomicAdd(&job_queue->waiter_count, 1);
+            RmtMutexUnlock(&job_queue->queue_mutex);
+
+            // look for work again after registering, anything added from now on will wake us.
+            const bool found = FindWork(job_queue, thread_id, root_handle, &work_handle);
+            if (!found)
+            {
+                RmtThreadEventWait(wake);
+            }
+
+            RemoveWaiter(job_queue, &waiter);
 
-        // sleep for 1ms to reduce spin-lock.
-        RmtSleep(1);
+            if (found)
+            {
+                RunJob(job_queue, thread_id, work_handle);
+            }
+        }
 
-    } while (true);
+        // stop as soon as the job completes, rather than carrying on with whatever else is queued.
+        RmtMutexLock(&job_queue->queue_mutex);
+        completed = IsJobCompleted(job, handle);
+        RmtMutexUnlock(&job_queue->queue_mutex);
+    }
+
+    return RMT_OK;
+}
+
+// get the utilization counters of a worker thread
+RmtErrorCode RmtJobQueueGetWorkerStatistics(const RmtJobQueue* job_queue, int32_t worker_index, RmtJobQueueWorkerStatistics* out_statistics)
+{
+    RMT_ASSERT_MESSAGE(job_queue, "Parameter jobQueue is NULL.");
+    RMT_ASSERT_MESSAGE(out_statistics, "Parameter outStatistics is NULL.");
+    RMT_RETURN_ON_ERROR(job_queue, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(out_statistics, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(worker_index >= 0 && worker_index < job_queue->worker_thread_count, RMT_ERROR_INDEX_OUT_OF_RANGE);
+
+    // the counters are only written by the worker itself, so this is a snapshot that may be slightly behind.
+    RmtJobQueueWorkerThreadInput* input = &job_queue->worker_thread_inputs[worker_index];
+    out_statistics->busy_time           = ReadWorkerStatistic(&input->statistics.busy_time);
+    out_statistics->elapsed_time        = RmtGetCurrentTimestamp() - input->start_timestamp;
+    out_statistics->job_count           = ReadWorkerStatistic(&input->statistics.job_count);
+    out_statistics->steal_count         = ReadWorkerStatistic(&input->statistics.steal_count);
+    out_statistics->batch_count         = ReadWorkerStatistic(&input->statistics.batch_count);
+    out_statistics->index_count         = ReadWorkerStatistic(&input->statistics.index_count);
+    out_statistics->park_count          = ReadWorkerStatistic(&input->statistics.park_count);
+    out_statistics->numa_node           = RmtThreadAtomicLoad(&input->statistics.numa_node);
 
     return RMT_OK;
 }
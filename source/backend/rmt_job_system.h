@@ -13,11 +13,20 @@
 #include "rmt_thread_event.h"
 #include "rmt_thread.h"
 
-/// The maximum number of worker threads that <c><i>RmtJobQueue</i></c> supports.
-#define RMT_MAXIMUM_WORKER_THREADS (24)
+/// Pass as the worker thread count to <c><i>RmtJobQueueInitialize</i></c> to create one worker per hardware thread.
+#define RMT_JOB_QUEUE_DEFAULT_WORKER_THREAD_COUNT (0)
 
-/// The maximum number of jobs that can be queued up.
-#define RMT_MAXIMUM_JOB_COUNT (1024)
+/// The number of job slots allocated at a time as the pool of jobs grows.
+#define RMT_JOB_QUEUE_JOB_BLOCK_SIZE (1024)
+
+/// The maximum number of blocks of job slots, allowing for just over 4 million jobs in flight.
+#define RMT_JOB_QUEUE_MAXIMUM_JOB_BLOCKS (4096)
+
+/// The maximum number of jobs that can depend on a single job.
+#define RMT_MAXIMUM_JOB_CONTINUATIONS (16)
+
+/// The thread id passed to a job function when it is run by a thread that is waiting on the queue rather than a worker thread.
+#define RMT_JOB_QUEUE_EXTERNAL_THREAD_ID (-1)
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,70 +39,120 @@ typedef struct RmtJobQueue RmtJobQueue;
 /// This is the form that all functions should take that are used with the job
 /// system. When using <c><i>RmtJobQueueAddSingle</i></c> or
 /// <c><i>RmtJobQueueAddMultiple</i></c> your function will be called on a
-/// worker thread asynchronously from the main thread.
+/// worker thread asynchronously from the main thread, or on a thread that is
+/// inside <c><i>RmtJobQueueWaitForCompletion</i></c>.
 ///
-/// @param [in] thread_id                   The unique identifier of the worker thread running this function.
+/// A job function may add further jobs to the queue and wait on them.
+///
+/// @param [in] thread_id                   The unique identifier of the worker thread running this function, or <c><i>RMT_JOB_QUEUE_EXTERNAL_THREAD_ID</i></c> if it is not a worker thread.
 /// @param [in] index                       The index of the job, only applicable when using <c><i>RmtJobQueueAddMultiple</i></c>.
 /// @param [in] input                       The user data provided to your call to <c><i>RmtJobQueueAddSingle</i></c> or <c><i>RmtJobQueueAddMultiple</i></c>.
 ///
 typedef void (*RmtJobFunction)(int32_t thread_id, int32_t index, void* input);
 
+/// Counters describing how a worker thread has spent its time.
+typedef struct RmtJobQueueWorkerStatistics
+{
+    uint64_t busy_time;     ///< The time spent running jobs, in <c><i>RmtGetClockFrequency</i></c> ticks.
+    uint64_t elapsed_time;  ///< The time since the worker thread started, in <c><i>RmtGetClockFrequency</i></c> ticks.
+    uint64_t job_count;     ///< The number of jobs the worker has taken from a deque.
+    uint64_t steal_count;   ///< The number of those jobs that were stolen from another worker's deque.
+    uint64_t batch_count;   ///< The number of batches of indices the worker has run.
+    uint64_t index_count;   ///< The number of job indices the worker has run.
+    uint64_t park_count;    ///< The number of times the worker went to sleep for lack of work.
+    int32_t  numa_node;     ///< The NUMA node the worker is pinned to, or -1 if it is not pinned.
+} RmtJobQueueWorkerStatistics;
+
 /// Input structures for the job queue worker threads.
 typedef struct RmtJobQueueWorkerThreadInput
 {
-    RmtJobQueue* job_queue;  ///< Pointer to the job queue that owns the thread.
-    uint64_t     flags;      ///< Flags to control execution of worker thread.
-    uint32_t     thread_id;  ///< The id assigned to this worker thread.
+    RmtJobQueue*                job_queue;        ///< Pointer to the job queue that owns the thread.
+    uint64_t                    flags;            ///< Flags to control execution of worker thread.
+    uint32_t                    thread_id;        ///< The id assigned to this worker thread.
+    uint64_t                    parked;           ///< Non-zero while the worker thread is asleep waiting for work.
+    RmtThreadEvent              wake;             ///< Auto-reset event used to wake the worker thread when it is parked.
+    uint64_t                    start_timestamp;  ///< The time the worker thread started.
+    RmtJobQueueWorkerStatistics statistics;       ///< Counters updated by the worker thread as it runs.
 } RmtJobQueueWorkerThreadInput;
 
 /// A type to represent a handle to a job.
 ///
 /// Handles can be optionally retrieved from <c><i>RmtJobQueueAddSingle</i></c>
 /// or <c><i>RmtJobQueueAddMultiple</i></c>. They can then be passed to
-/// <c><i>RmtJobQueueIsCompleted</i></c> to check if a job has completed.
+/// <c><i>RmtJobQueueWaitForCompletion</i></c> to wait for a job to complete.
+///
+/// The low 32 bits of a handle hold the index of the job slot, the high 32 bits
+/// hold the generation of that slot, so a handle stays valid to wait on after its
+/// slot has been recycled for a later job.
 ///
 typedef uint64_t RmtJobHandle;
 
 /// A structure encapsulating a single job and it's input.
+///
+/// Workers claim ranges of <c><i>batch_size</i></c> indices from a job by atomically
+/// advancing <c><i>next_index</i></c>, so no lock is taken per index.
 typedef struct RmtJobQueueJob
 {
-    RmtJobFunction function;
-    void*          input;
-    RmtJobHandle   handle;
-    int32_t        run_count;
-    int32_t        base_index;
-    int32_t        count;
-    int64_t        completed_count;
+    RmtJobFunction function;         ///< The function to run for each index.
+    void*          input;            ///< The user data passed to the function.
+    RmtJobHandle   handle;           ///< The handle of the job currently occupying this slot.
+    RmtJobHandle   root_handle;      ///< The handle of the outermost job this one was added from, or its own handle if it was added from outside a job.
+    int32_t        base_index;       ///< The index passed to the function for the first instance of the job.
+    int32_t        count;            ///< The number of instances of the job to run.
+    int32_t        batch_size;       ///< The number of indices claimed by a worker at a time.
+    int32_t        reference_count;  ///< The number of worker deque entries still referencing this slot.
+    int64_t        next_index;       ///< The next unclaimed index, relative to <c><i>base_index</i></c>.
+    int64_t        completed_count;  ///< The number of instances of the job that have finished running.
+
+    int32_t dependency_count;                              ///< The number of jobs that must complete before this job is scheduled.
+    int32_t continuation_count;                            ///< The number of jobs waiting on this one, or -1 once it has completed.
+    int32_t continuations[RMT_MAXIMUM_JOB_CONTINUATIONS];  ///< The slot indices of the jobs waiting on this one.
 } RmtJobQueueJob;
 
+/// A double-ended queue of job handles owned by a worker thread.
+///
+/// The owning worker pushes and pops at the bottom, other workers steal from the top.
+typedef struct RmtJobQueueWorkerDeque
+{
+    RmtJobHandle* entries;   ///< A ring of handles to jobs with work remaining, grown when full.
+    int64_t       capacity;  ///< The number of entries the ring can hold.
+    int64_t       top;       ///< The index of the oldest entry, where work is stolen from.
+    int64_t       bottom;    ///< One past the index of the newest entry.
+    RmtMutex      mutex;     ///< A mutex controlling access to this deque.
+} RmtJobQueueWorkerDeque;
+
 /// A structure encapsulating the state of the job system.
 typedef struct RmtJobQueue
 {
-    RmtThread                    worker_threads[RMT_MAXIMUM_WORKER_THREADS];        ///< An array of threads where the jobs may run.
-    RmtJobQueueWorkerThreadInput worker_thread_inputs[RMT_MAXIMUM_WORKER_THREADS];  ///< A queue of inputs to the jobs.
-    int32_t                      worker_thread_count;                               ///< The total number of worker threads in use.
-    RmtThreadEvent               signal;                                            ///< Signal when there is work in the global queue.
-
-    RmtJobQueueJob queue_items[RMT_MAXIMUM_JOB_COUNT];  ///< A queue of jobs.
-    int32_t        queue_head_index;                    ///< The head index of the queue.
-    int32_t        queue_tail_index;                    ///< The tail index of the queue.
-    int32_t        queue_size;                          ///< The current size of the queue.
-    RmtMutex       queue_mutex;                         ///< A mutex controlling queue access.
-
-    RmtJobHandle handle_next;  ///< The next handle to use.
+    RmtThread*                    worker_threads;        ///< An array of threads where the jobs may run.
+    RmtJobQueueWorkerThreadInput* worker_thread_inputs;  ///< A queue of inputs to the jobs.
+    RmtJobQueueWorkerDeque*       worker_deques;         ///< The per-worker deques of jobs with work remaining.
+    int32_t                       worker_thread_count;   ///< The total number of worker threads in use.
+    int32_t                       worker_next;           ///< The worker whose deque receives the next submitted job.
+    int32_t                       pending_count;         ///< The number of entries across all worker deques.
+    int32_t                       waiter_count;          ///< The number of threads asleep in <c><i>RmtJobQueueWaitForCompletion</i></c>.
+    void*                         waiter_list;           ///< The threads asleep in <c><i>RmtJobQueueWaitForCompletion</i></c>, protected by <c><i>queue_mutex</i></c>.
+
+    RmtJobQueueJob* job_blocks[RMT_JOB_QUEUE_MAXIMUM_JOB_BLOCKS];  ///< The pool of job slots, allocated a block at a time so slots never move.
+    int32_t         job_block_count;                                ///< The number of blocks allocated in <c><i>job_blocks</i></c>.
+    int32_t*        free_slots;                                     ///< A stack of the indices of unused job slots.
+    int32_t         free_slot_count;                                ///< The number of entries in <c><i>free_slots</i></c>.
+    RmtMutex        queue_mutex;                                    ///< A mutex controlling allocation of job slots, continuation lists and waiters.
 } RmtJobQueue;
 
 /// Initialize the job queue for the specified number of threads.
 ///
 /// @param [in,out] job_queue                       A pointer to the <c><i>RmtJobSystem</i></c> structure to initialize.
-/// @param [in]     worker_thread_count             The number of worker threads to create.
+/// @param [in]     worker_thread_count             The number of worker threads to create, or <c><i>RMT_JOB_QUEUE_DEFAULT_WORKER_THREAD_COUNT</i></c> for one per hardware thread.
 ///
 /// @retval
 /// RMT_OK                                      The operation completed successfully.
 /// @retval
 /// RMT_ERROR_INVALID_POINTER                   The operation failed because <c><i>jobQueue</i></c> was <c><i>NULL</i></c>.
 /// @retval
-/// RMT_ERROR_INDEX_OUT_OF_RANGE                The operation failed because <c><i>workerThreadCount</i></c> was not in range [0..<c><i>RMT_MAXIMUM_WORKER_THREADS</i></c>].
+/// RMT_ERROR_INDEX_OUT_OF_RANGE                The operation failed because <c><i>workerThreadCount</i></c> was negative.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the worker threads could not be allocated.
 ///
 RmtErrorCode RmtJobQueueInitialize(RmtJobQueue* job_queue, int32_t worker_thread_count);
 
@@ -120,7 +179,7 @@ RmtErrorCode RmtJobQueueShutdown(RmtJobQueue* job_queue);
 /// @retval
 /// RMT_ERROR_INVALID_POINTER                   The operation failed because <c><i>jobQueue</i></c> was <c><i>NULL</i></c>.
 /// @retval
-/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because there was no space left in the queue.
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the pool of job slots could not be grown.
 ///
 RmtErrorCode RmtJobQueueAddSingle(RmtJobQueue* job_queue, RmtJobFunction func, void* input, RmtJobHandle* out_handle);
 
@@ -151,22 +210,85 @@ RmtErrorCode RmtJobQueueAddSingle(RmtJobQueue* job_queue, RmtJobFunction func, v
 /// @retval
 /// RMT_ERROR_INVALID_POINTER                   The operation failed because <c><i>jobQueue</i></c> was <c><i>NULL</i></c>.
 /// @retval
-/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because there was no space left in the queue.
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the pool of job slots could not be grown.
 ///
 RmtErrorCode RmtJobQueueAddMultiple(RmtJobQueue* job_queue, RmtJobFunction func, void* input, int32_t base_index, int32_t count, RmtJobHandle* out_handle);
 
+/// Add multiple copies of the same job to the queue, to run once other jobs have completed.
+///
+/// This behaves like <c><i>RmtJobQueueAddMultiple</i></c>, except that none of the
+/// copies of the job are run until every job in <c><i>dependencies</i></c> has
+/// completed. The returned handle may itself be used as a dependency of later jobs,
+/// so a graph of work can be built up front and any node in it waited on using
+/// <c><i>RmtJobQueueWaitForCompletion</i></c>.
+///
+/// @param [in,out] job_queue                       A pointer to the <c><i>RmtJobSystem</i></c> structure.
+/// @param [in]     func                            A pointer to the function containing your job.
+/// @param [in]     input                           A pointer to some user data to pass to <c><i>func</i></c>. See <c><i>RmtJobFunction</i></c>.
+/// @param [in]     base_index                      The start index of the job.
+/// @param [in]     count                           The total number of copies of the job to execute.
+/// @param [in]     dependencies                    An array of handles to jobs that must complete first. May be NULL if <c><i>dependency_count</i></c> is 0.
+/// @param [in]     dependency_count                The number of handles in <c><i>dependencies</i></c>.
+/// @param [out]    out_handle                      An optional pointer to a <c><i>RmtJobHandle</i></c>.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed because <c><i>jobQueue</i></c> was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_INDEX_OUT_OF_RANGE                The operation failed because a handle in <c><i>dependencies</i></c> was invalid.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                     The operation failed because the pool of job slots could not be grown, or a dependency already has <c><i>RMT_MAXIMUM_JOB_CONTINUATIONS</i></c> jobs waiting on it.
+///
+RmtErrorCode RmtJobQueueAddMultipleWithDependencies(RmtJobQueue*        job_queue,
+                                                    RmtJobFunction      func,
+                                                    void*               input,
+                                                    int32_t             base_index,
+                                                    int32_t             count,
+                                                    const RmtJobHandle* dependencies,
+                                                    int32_t             dependency_count,
+                                                    RmtJobHandle*       out_handle);
+
 /// Wait for a job handle to complete.
 ///
+/// Rather than sitting idle, the calling thread runs pending jobs from the queue
+/// until the job has completed, only sleeping when there is nothing left to run.
+/// This makes it safe to call from inside a job function to wait on jobs that it
+/// added, without tying up the worker thread.
+///
+/// The calling thread only runs jobs belonging to the same root as the job it is
+/// waiting on, that is jobs added from inside the same outermost job. Those jobs run
+/// on top of the waiting job's stack, so a job must not wait on another job that can
+/// only complete once one of the jobs that added it has returned, such as a
+/// continuation of its parent.
+///
 /// @param [in]     job_queue                       A pointer to the <c><i>RmtJobSystem</i></c> structure.
-/// @param [in]     handle                          A handle to the job that was added using <c><i>RmtJobQueueAddSingle</i></c> or <c><i>RmtJobQueueAddMultiple</i></c>.
+/// @param [in]     handle                          A handle to the job that was added using <c><i>RmtJobQueueAddSingle</i></c>, <c><i>RmtJobQueueAddMultiple</i></c> or <c><i>RmtJobQueueAddMultipleWithDependencies</i></c>.
 ///
 /// @retval
 /// RMT_OK                                      The operation completed successfully.
 /// @retval
 /// RMT_ERROR_INVALID_POINTER                   The operation failed because <c><i>jobQueue</i></c> was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_INDEX_OUT_OF_RANGE                The operation failed because <c><i>handle</i></c> was invalid.
 ///
 RmtErrorCode RmtJobQueueWaitForCompletion(RmtJobQueue* job_queue, RmtJobHandle handle);
 
+/// Get the utilization counters of a worker thread.
+///
+/// @param [in]     job_queue                       A pointer to the <c><i>RmtJobSystem</i></c> structure.
+/// @param [in]     worker_index                    The index of the worker thread, in the range [0..<c><i>worker_thread_count</i></c>-1].
+/// @param [out]    out_statistics                  A pointer to a <c><i>RmtJobQueueWorkerStatistics</i></c> structure to receive the counters.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The operation failed because <c><i>jobQueue</i></c> or <c><i>out_statistics</i></c> was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_INDEX_OUT_OF_RANGE                The operation failed because <c><i>worker_index</i></c> was not a valid worker.
+///
+RmtErrorCode RmtJobQueueGetWorkerStatistics(const RmtJobQueue* job_queue, int32_t worker_index, RmtJobQueueWorkerStatistics* out_statistics);
+
 #ifdef __cplusplus
 }
 #endif  // #ifdef __cplusplus
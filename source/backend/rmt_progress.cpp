@@ -0,0 +1,133 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \brief  Implementation of a token to follow and cancel long running operations.
+//=============================================================================
+
+#include "rmt_progress.h"
+
+#include <string.h>
+
+#include <rmt_assert.h>
+#include <rmt_platform.h>
+#include <rmt_util.h>
+#include <rmt_token_heap.h>
+#include <rmt_parser.h>
+#include "rmt_atomic.h"
+
+RmtErrorCode RmtProgressInitialize(RmtProgress* progress, int32_t stage_count)
+{
+    RMT_ASSERT(progress);
+    RMT_RETURN_ON_ERROR(progress, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(stage_count > 0, RMT_ERROR_INVALID_SIZE);
+
+    memset(progress, 0, sizeof(RmtProgress));
+    progress->stage_count     = stage_count;
+    progress->start_timestamp = RmtGetCurrentTimestamp();
+    return RMT_OK;
+}
+
+RmtErrorCode RmtProgressBeginStage(RmtProgress* progress, int32_t stage_index)
+{
+    if (progress == nullptr)
+    {
+        return RMT_OK;
+    }
+
+    RMT_ASSERT(stage_index < (int32_t)progress->stage_count);
+
+    // the stage's work is reset first, so the fraction never jumps ahead to the end of the new stage.
+    RmtThreadAtomicWrite(&progress->work_done, 0);
+    RmtThreadAtomicWrite(&progress->work_total, 0);
+    RmtThreadAtomicWrite(&progress->stage_tokens, RmtThreadAtomicRead(&progress->tokens_processed));
+    RmtThreadAtomicWrite(&progress->stage_index, stage_index);
+
+    return RmtProgressIsCancelled(progress) ? RMT_ERROR_CANCELLED : RMT_OK;
+}
+
+RmtErrorCode RmtProgressUpdate(RmtProgress* progress, uint64_t work_done, uint64_t work_total, uint64_t token_count)
+{
+    if (progress == nullptr)
+    {
+        return RMT_OK;
+    }
+
+    RmtThreadAtomicWrite(&progress->work_total, work_total);
+    RmtThreadAtomicWrite(&progress->work_done, RMT_MINIMUM(work_done, work_total));
+    RmtThreadAtomicWrite(&progress->tokens_processed, RmtThreadAtomicRead(&progress->stage_tokens) + token_count);
+
+    return RmtProgressIsCancelled(progress) ? RMT_ERROR_CANCELLED : RMT_OK;
+}
+
+RmtErrorCode RmtProgressUpdateFromStreams(RmtProgress* progress, const RmtStreamMerger* stream_merger, uint64_t token_count)
+{
+    if (progress == nullptr)
+    {
+        return RMT_OK;
+    }
+
+    RMT_ASSERT(stream_merger);
+
+    // the amount of each stream parsed so far.
+    uint64_t bytes_parsed = 0;
+    uint64_t bytes_total  = 0;
+    for (int32_t current_parser_index = 0; current_parser_index < stream_merger->parser_count; ++current_parser_index)
+    {
+        const RmtParser* current_parser = &stream_merger->parsers[current_parser_index];
+        bytes_parsed += current_parser->stream_current_offset;
+        bytes_total += current_parser->stream_size;
+    }
+
+    return RmtProgressUpdate(progress, bytes_parsed, bytes_total, token_count);
+}
+
+RmtErrorCode RmtProgressCancel(RmtProgress* progress)
+{
+    RMT_RETURN_ON_ERROR(progress, RMT_ERROR_INVALID_POINTER);
+
+    RmtThreadAtomicWrite(&progress->cancelled, 1);
+    return RMT_OK;
+}
+
+bool RmtProgressIsCancelled(RmtProgress* progress)
+{
+    if (progress == nullptr)
+    {
+        return false;
+    }
+
+    return RmtThreadAtomicRead(&progress->cancelled) != 0;
+}
+
+float RmtProgressGetFraction(RmtProgress* progress)
+{
+    RMT_ASSERT(progress);
+    if (progress == nullptr)
+    {
+        return 0.0f;
+    }
+
+    const uint64_t stage_index = RmtThreadAtomicRead(&progress->stage_index);
+    const uint64_t work_done   = RmtThreadAtomicRead(&progress->work_done);
+    const uint64_t work_total  = RmtThreadAtomicRead(&progress->work_total);
+
+    const double stage_fraction = (work_total > 0) ? ((double)work_done / (double)work_total) : 0.0;
+    return (float)((stage_index + stage_fraction) / (double)progress->stage_count);
+}
+
+double RmtProgressGetTokensPerSecond(RmtProgress* progress)
+{
+    RMT_ASSERT(progress);
+    if (progress == nullptr)
+    {
+        return 0.0;
+    }
+
+    const uint64_t elapsed = RmtGetCurrentTimestamp() - progress->start_timestamp;
+    if (elapsed == 0)
+    {
+        return 0.0;
+    }
+
+    return (double)RmtThreadAtomicRead(&progress->tokens_processed) * (double)RmtGetClockFrequency() / (double)elapsed;
+}
@@ -0,0 +1,134 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \brief  Definition of a token to follow and cancel long running operations.
+//=============================================================================
+
+#ifndef RMV_BACKEND_RMT_PROGRESS_H_
+#define RMV_BACKEND_RMT_PROGRESS_H_
+
+#include <rmt_error.h>
+
+/// The number of RMT tokens an operation replays between updates of its progress.
+#define RMT_PROGRESS_TOKEN_INTERVAL (4096)
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // #ifdef __cplusplus
+
+typedef struct RmtStreamMerger RmtStreamMerger;
+
+/// A structure passed to a long running operation, such as loading a data set or generating a snapshot, which the
+/// operation updates as it replays the RMT streams. Any thread may read the progress or cancel the operation, which
+/// then stops the next time it updates the progress and returns <c><i>RMT_ERROR_CANCELLED</i></c>.
+///
+/// An operation made up of several stages, each of which replays the streams, can report its progress as a whole
+/// by giving each stage its own index.
+typedef struct RmtProgress
+{
+    volatile uint64_t cancelled;         ///< Set to non-zero when the operation has been asked to stop.
+    volatile uint64_t stage_index;       ///< The index of the stage being run.
+    volatile uint64_t stage_count;       ///< The number of stages in the operation.
+    volatile uint64_t work_done;         ///< The amount of work done in the current stage, in units chosen by the stage.
+    volatile uint64_t work_total;        ///< The total amount of work in the current stage.
+    volatile uint64_t tokens_processed;  ///< The number of RMT tokens processed by every stage so far.
+    volatile uint64_t stage_tokens;      ///< The number of RMT tokens processed by the stages before the current one.
+    uint64_t          start_timestamp;   ///< The CPU timestamp when the progress was initialized.
+} RmtProgress;
+
+/// Initialize a progress structure before starting an operation.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure.
+/// @param [in]     stage_count                 The number of stages in the operation.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The parameter <c><i>progress</i></c> was NULL.
+/// @retval
+/// RMT_ERROR_INVALID_SIZE                      The parameter <c><i>stage_count</i></c> was less than 1.
+///
+RmtErrorCode RmtProgressInitialize(RmtProgress* progress, int32_t stage_count);
+
+/// Move on to the next stage of an operation.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure, or NULL.
+/// @param [in]     stage_index                 The index of the stage being started.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation has been cancelled.
+///
+RmtErrorCode RmtProgressBeginStage(RmtProgress* progress, int32_t stage_index);
+
+/// Update the progress of the current stage, and check whether the operation has been cancelled.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure, or NULL.
+/// @param [in]     work_done                   The amount of work done in the current stage.
+/// @param [in]     work_total                  The total amount of work in the current stage.
+/// @param [in]     token_count                 The number of RMT tokens processed by the current stage.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation has been cancelled.
+///
+RmtErrorCode RmtProgressUpdate(RmtProgress* progress, uint64_t work_done, uint64_t work_total, uint64_t token_count);
+
+/// Update the progress of the current stage from how far through the RMT streams a stream merger is, and check
+/// whether the operation has been cancelled.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure, or NULL.
+/// @param [in]     stream_merger               The stream merger being used to replay the streams.
+/// @param [in]     token_count                 The number of RMT tokens processed by the current stage.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_CANCELLED                         The operation has been cancelled.
+///
+RmtErrorCode RmtProgressUpdateFromStreams(RmtProgress* progress, const RmtStreamMerger* stream_merger, uint64_t token_count);
+
+/// Ask the operation using a progress structure to stop.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure.
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                   The parameter <c><i>progress</i></c> was NULL.
+///
+RmtErrorCode RmtProgressCancel(RmtProgress* progress);
+
+/// Check whether an operation has been asked to stop.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure, or NULL.
+///
+/// @returns
+/// true if the operation has been cancelled, false if not.
+///
+bool RmtProgressIsCancelled(RmtProgress* progress);
+
+/// Get how far through an operation is.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure.
+///
+/// @returns
+/// The fraction of the operation which is done, from 0 to 1.
+///
+float RmtProgressGetFraction(RmtProgress* progress);
+
+/// Get the rate an operation is processing RMT tokens at.
+///
+/// @param [in]     progress                    A pointer to a <c><i>RmtProgress</i></c> structure.
+///
+/// @returns
+/// The number of tokens processed per second since the progress was initialized.
+///
+double RmtProgressGetTokensPerSecond(RmtProgress* progress);
+
+#ifdef __cplusplus
+}
+#endif  // #ifdef __cplusplus
+#endif  // #ifndef RMV_BACKEND_RMT_PROGRESS_H_
@@ -0,0 +1,384 @@
+//=============================================================================
+/// Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author
+/// \brief Implementation of an index of the RMT events used to build resource histories.
+//=============================================================================
+
+#include "rmt_resource_event_index.h"
+#include "rmt_resource_list.h"
+#include "rmt_virtual_allocation_list.h"
+#include <rmt_format.h>
+#include <rmt_address_helper.h>
+#include <rmt_assert.h>
+#include <stdlib.h>  // for realloc() / free()
+#include <string.h>  // for memset()
+
+// the number of entries allocated the first time a list grows.
+#define INITIAL_ENTRY_CAPACITY (1024)
+
+// append an event to a list, growing the list if required.
+static RmtErrorCode AddEntry(RmtResourceEventIndex*      resource_event_index,
+                             RmtResourceEventIndexList*  list,
+                             const RmtToken*             token,
+                             uint64_t                    key,
+                             uint64_t                    end,
+                             RmtResourceHistoryEventType event_type)
+{
+    if (list->entry_count == list->entry_capacity)
+    {
+        const int32_t new_capacity = (list->entry_capacity == 0) ? INITIAL_ENTRY_CAPACITY : list->entry_capacity * 2;
+        RMT_RETURN_ON_ERROR(new_capacity > list->entry_capacity, RMT_ERROR_OUT_OF_MEMORY);
+
+        RmtResourceEventIndexEntry* entries = (RmtResourceEventIndexEntry*)realloc(list->entries, new_capacity * sizeof(RmtResourceEventIndexEntry));
+        RMT_RETURN_ON_ERROR(entries, RMT_ERROR_OUT_OF_MEMORY);
+        list->entries        = entries;
+        list->entry_capacity = new_capacity;
+    }
+
+    RmtResourceEventIndexEntry* entry = &list->entries[list->entry_count++];
+    entry->key                        = key;
+    entry->end                        = end;
+    entry->timestamp                  = token->common.timestamp;
+    entry->thread_id                  = token->common.thread_id;
+    entry->sequence                   = resource_event_index->event_count++;
+    entry->event_type                 = event_type;
+    return RMT_OK;
+}
+
+// order entries by key, and then by the order they appeared in the RMT streams.
+static int32_t EntryComparator(const void* a, const void* b)
+{
+    const RmtResourceEventIndexEntry* entry_a = (const RmtResourceEventIndexEntry*)a;
+    const RmtResourceEventIndexEntry* entry_b = (const RmtResourceEventIndexEntry*)b;
+
+    if (entry_a->key != entry_b->key)
+    {
+        return (entry_a->key > entry_b->key) ? 1 : -1;
+    }
+
+    if (entry_a->sequence != entry_b->sequence)
+    {
+        return (entry_a->sequence > entry_b->sequence) ? 1 : -1;
+    }
+
+    return 0;
+}
+
+// order pointers to entries by the order they appeared in the RMT streams.
+static int32_t EntrySequenceComparator(const void* a, const void* b)
+{
+    const RmtResourceEventIndexEntry* entry_a = *(const RmtResourceEventIndexEntry**)a;
+    const RmtResourceEventIndexEntry* entry_b = *(const RmtResourceEventIndexEntry**)b;
+
+    if (entry_a->sequence != entry_b->sequence)
+    {
+        return (entry_a->sequence > entry_b->sequence) ? 1 : -1;
+    }
+
+    return 0;
+}
+
+// find the first entry in a sorted list with a key greater than or equal to (or, if inclusive is false, greater than) the key.
+static int32_t FindFirstEntryAfterKey(const RmtResourceEventIndexList* list, uint64_t key, bool inclusive)
+{
+    int32_t first = 0;
+    int32_t last  = list->entry_count;
+    while (first < last)
+    {
+        const int32_t middle = first + ((last - first) / 2);
+        if ((list->entries[middle].key < key) || (!inclusive && (list->entries[middle].key == key)))
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+// find the first entry in the interval list which, or any entry before it, covers an address at or after the address.
+static int32_t FindFirstEntryEndingAfterAddress(const RmtResourceEventIndexList* list, uint64_t address)
+{
+    int32_t first = 0;
+    int32_t last  = list->entry_count;
+    while (first < last)
+    {
+        const int32_t middle = first + ((last - first) / 2);
+        if (list->maximum_ends[middle] < address)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+// sort a list, and build the running maximum of the interval ends if required.
+static RmtErrorCode SortList(RmtResourceEventIndexList* list, bool is_interval_list)
+{
+    if (list->entry_count == 0)
+    {
+        return RMT_OK;
+    }
+
+    qsort(list->entries, list->entry_count, sizeof(RmtResourceEventIndexEntry), EntryComparator);
+
+    if (!is_interval_list)
+    {
+        return RMT_OK;
+    }
+
+    list->maximum_ends = (uint64_t*)malloc(list->entry_count * sizeof(uint64_t));
+    RMT_RETURN_ON_ERROR(list->maximum_ends, RMT_ERROR_OUT_OF_MEMORY);
+
+    uint64_t maximum_end = 0;
+    for (int32_t current_entry_index = 0; current_entry_index < list->entry_count; ++current_entry_index)
+    {
+        maximum_end                             = RMT_MAXIMUM(maximum_end, list->entries[current_entry_index].end);
+        list->maximum_ends[current_entry_index] = maximum_end;
+    }
+
+    return RMT_OK;
+}
+
+// free the memory used by a list.
+static void DestroyList(RmtResourceEventIndexList* list)
+{
+    free(list->entries);
+    free(list->maximum_ends);
+    memset(list, 0, sizeof(RmtResourceEventIndexList));
+}
+
+RmtErrorCode RmtResourceEventIndexInitialize(RmtResourceEventIndex* resource_event_index)
+{
+    RMT_ASSERT(resource_event_index);
+    RMT_RETURN_ON_ERROR(resource_event_index, RMT_ERROR_INVALID_POINTER);
+
+    memset(resource_event_index, 0, sizeof(RmtResourceEventIndex));
+    return RMT_OK;
+}
+
+RmtErrorCode RmtResourceEventIndexAddToken(RmtResourceEventIndex* resource_event_index, const RmtToken* token)
+{
+    RMT_ASSERT(resource_event_index);
+    RMT_ASSERT(token);
+    RMT_RETURN_ON_ERROR(resource_event_index, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(token, RMT_ERROR_INVALID_POINTER);
+
+    switch (token->type)
+    {
+    case kRmtTokenTypeResourceCreate:
+        return AddEntry(resource_event_index,
+                        &resource_event_index->resource_events,
+                        token,
+                        token->resource_create_token.resource_identifier,
+                        0,
+                        kRmtResourceHistoryEventResourceCreated);
+
+    case kRmtTokenTypeResourceDestroy:
+        return AddEntry(resource_event_index,
+                        &resource_event_index->resource_events,
+                        token,
+                        token->resource_destroy_token.resource_identifier,
+                        0,
+                        kRmtResourceHistoryEventResourceDestroyed);
+
+    case kRmtTokenTypeResourceBind:
+        return AddEntry(resource_event_index,
+                        &resource_event_index->resource_events,
+                        token,
+                        token->resource_bind_token.resource_identifier,
+                        0,
+                        kRmtResourceHistoryEventResourceBound);
+
+    case kRmtTokenTypeResourceReference:
+    {
+        const RmtResourceHistoryEventType event_type = (token->resource_reference.residency_update_type == kRmtResidencyUpdateTypeAdd)
+                                                           ? kRmtResourceHistoryEventVirtualMemoryMakeResident
+                                                           : kRmtResourceHistoryEventVirtualMemoryEvict;
+
+        // NOTE: this is keyed on the same field the resource history has always compared against.
+        return AddEntry(resource_event_index, &resource_event_index->address_events, token, token->cpu_map_token.virtual_address, 0, event_type);
+    }
+
+    case kRmtTokenTypeCpuMap:
+    {
+        const RmtResourceHistoryEventType event_type =
+            token->cpu_map_token.is_unmap ? kRmtResourceHistoryEventVirtualMemoryUnmapped : kRmtResourceHistoryEventVirtualMemoryMapped;
+        return AddEntry(resource_event_index, &resource_event_index->address_events, token, token->cpu_map_token.virtual_address, 0, event_type);
+    }
+
+    case kRmtTokenTypeVirtualAllocate:
+    {
+        const RmtGpuAddress address_of_last_byte_allocation =
+            (token->virtual_allocate_token.virtual_address + token->virtual_allocate_token.size_in_bytes) - 1;
+        return AddEntry(resource_event_index,
+                        &resource_event_index->interval_events,
+                        token,
+                        token->virtual_allocate_token.virtual_address,
+                        address_of_last_byte_allocation,
+                        kRmtResourceHistoryEventVirtualMemoryAllocated);
+    }
+
+    case kRmtTokenTypeVirtualFree:
+        return AddEntry(resource_event_index,
+                        &resource_event_index->interval_events,
+                        token,
+                        token->virtual_free_token.virtual_address,
+                        token->virtual_free_token.virtual_address + 1,
+                        kRmtResourceHistoryEventVirtualMemoryFree);
+
+    case kRmtTokenTypePageTableUpdate:
+    {
+        const uint64_t size_in_bytes = RmtGetAllocationSizeInBytes(token->page_table_update_token.size_in_pages, token->page_table_update_token.page_size);
+
+        RmtResourceHistoryEventType event_type = kRmtResourceHistoryEventPhysicalUnmap;
+        if (!token->page_table_update_token.is_unmapping)
+        {
+            event_type = (token->page_table_update_token.physical_address == 0) ? kRmtResourceHistoryEventPhysicalMapToHost
+                                                                                 : kRmtResourceHistoryEventPhysicalMapToLocal;
+        }
+
+        // NOTE: page table updates are compared against the resource with RmtAllocationsOverlap(),
+        // which treats the range as including the byte after the last page.
+        return AddEntry(resource_event_index,
+                        &resource_event_index->interval_events,
+                        token,
+                        token->page_table_update_token.virtual_address,
+                        token->page_table_update_token.virtual_address + size_in_bytes,
+                        event_type);
+    }
+
+    default:
+        break;
+    }
+
+    return RMT_OK;
+}
+
+RmtErrorCode RmtResourceEventIndexFinalize(RmtResourceEventIndex* resource_event_index)
+{
+    RMT_ASSERT(resource_event_index);
+    RMT_RETURN_ON_ERROR(resource_event_index, RMT_ERROR_INVALID_POINTER);
+
+    RmtErrorCode error_code = SortList(&resource_event_index->resource_events, false);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+    error_code = SortList(&resource_event_index->address_events, false);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+    error_code = SortList(&resource_event_index->interval_events, true);
+    RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
+
+    resource_event_index->is_complete = true;
+    return RMT_OK;
+}
+
+RmtErrorCode RmtResourceEventIndexGenerateResourceHistory(const RmtResourceEventIndex* resource_event_index,
+                                                          const RmtResource*           resource,
+                                                          RmtResourceHistory*          out_resource_history)
+{
+    RMT_ASSERT(resource_event_index);
+    RMT_ASSERT(resource);
+    RMT_ASSERT(out_resource_history);
+    RMT_RETURN_ON_ERROR(resource_event_index, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(resource, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(out_resource_history, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(resource_event_index->is_complete, RMT_ERROR_MALFORMED_DATA);
+
+    const RmtResourceEventIndexList* resource_events = &resource_event_index->resource_events;
+    const RmtResourceEventIndexList* address_events  = &resource_event_index->address_events;
+    const RmtResourceEventIndexList* interval_events = &resource_event_index->interval_events;
+
+    // events that reference the resource directly.
+    const int32_t first_resource_event = FindFirstEntryAfterKey(resource_events, resource->identifier, true);
+    const int32_t last_resource_event  = FindFirstEntryAfterKey(resource_events, resource->identifier, false);
+
+    // events on the virtual memory are only interesting if the resource is bound to some.
+    int32_t first_address_event  = 0;
+    int32_t last_address_event   = 0;
+    int32_t first_interval_event = 0;
+    int32_t last_interval_event  = 0;
+
+    const RmtVirtualAllocation* base_allocation = resource->bound_allocation;
+    if (base_allocation != nullptr)
+    {
+        // NOTE: PAL can only map/unmap or make resident/evict a full virtual allocation on CPU, not just a resource.
+        first_address_event = FindFirstEntryAfterKey(address_events, base_allocation->base_address, true);
+        last_address_event  = FindFirstEntryAfterKey(address_events, base_allocation->base_address, false);
+
+        // intervals starting after the resource can't overlap it, and nor can any interval before
+        // the point where the running maximum of the interval ends first reaches the resource.
+        const RmtGpuAddress next_byte_after_resource = resource->address + resource->size_in_bytes;
+        first_interval_event                         = FindFirstEntryEndingAfterAddress(interval_events, resource->address);
+        last_interval_event                          = FindFirstEntryAfterKey(interval_events, next_byte_after_resource, false);
+    }
+
+    const int32_t maximum_event_count = (last_resource_event - first_resource_event) + (last_address_event - first_address_event) +
+                                        RMT_MAXIMUM(last_interval_event - first_interval_event, 0);
+    if (maximum_event_count == 0)
+    {
+        return RMT_OK;
+    }
+
+    const RmtResourceEventIndexEntry** events = (const RmtResourceEventIndexEntry**)malloc(maximum_event_count * sizeof(RmtResourceEventIndexEntry*));
+    RMT_ASSERT(events);
+    RMT_RETURN_ON_ERROR(events, RMT_ERROR_OUT_OF_MEMORY);
+
+    int32_t event_count = 0;
+    for (int32_t current_event_index = first_resource_event; current_event_index < last_resource_event; ++current_event_index)
+    {
+        events[event_count++] = &resource_events->entries[current_event_index];
+    }
+
+    for (int32_t current_event_index = first_address_event; current_event_index < last_address_event; ++current_event_index)
+    {
+        events[event_count++] = &address_events->entries[current_event_index];
+    }
+
+    for (int32_t current_event_index = first_interval_event; current_event_index < last_interval_event; ++current_event_index)
+    {
+        const RmtResourceEventIndexEntry* current_event = &interval_events->entries[current_event_index];
+        if (current_event->end < resource->address)
+        {
+            continue;
+        }
+
+        events[event_count++] = current_event;
+    }
+
+    // put the events back in the order they appeared in the RMT streams.
+    qsort(events, event_count, sizeof(RmtResourceEventIndexEntry*), EntrySequenceComparator);
+
+    for (int32_t current_event_index = 0; current_event_index < event_count; ++current_event_index)
+    {
+        const RmtResourceEventIndexEntry* current_event = events[current_event_index];
+
+        // changes to the physical mappings are compacted, as a resource can span many page table updates at the same time.
+        const bool compact = (current_event->event_type == kRmtResourceHistoryEventPhysicalMapToLocal) ||
+                             (current_event->event_type == kRmtResourceHistoryEventPhysicalUnmap) ||
+                             (current_event->event_type == kRmtResourceHistoryEventPhysicalMapToHost);
+
+        RmtResourceHistoryAddEvent(out_resource_history, current_event->event_type, current_event->thread_id, current_event->timestamp, compact);
+    }
+
+    free(events);
+    return RMT_OK;
+}
+
+RmtErrorCode RmtResourceEventIndexDestroy(RmtResourceEventIndex* resource_event_index)
+{
+    RMT_RETURN_ON_ERROR(resource_event_index, RMT_ERROR_INVALID_POINTER);
+
+    DestroyList(&resource_event_index->resource_events);
+    DestroyList(&resource_event_index->address_events);
+    DestroyList(&resource_event_index->interval_events);
+    resource_event_index->event_count = 0;
+    resource_event_index->is_complete = false;
+    return RMT_OK;
+}
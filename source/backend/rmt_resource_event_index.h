@@ -0,0 +1,126 @@
+//=============================================================================
+/// Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author
+/// \brief Structures and functions for an index of the RMT events used to build resource histories.
+//=============================================================================
+
+#ifndef RMV_BACKEND_RMT_RESOURCE_EVENT_INDEX_H_
+#define RMV_BACKEND_RMT_RESOURCE_EVENT_INDEX_H_
+
+#include <rmt_types.h>
+#include <rmt_error.h>
+#include "rmt_resource_history.h"
+
+#ifdef __cpluplus
+extern "C" {
+#endif  // #ifdef __cplusplus
+
+typedef struct RmtToken    RmtToken;
+typedef struct RmtResource RmtResource;
+
+/// A structure encapsulating a single RMT token that can appear in a resource history.
+typedef struct RmtResourceEventIndexEntry
+{
+    uint64_t                    key;         ///< The resource identifier, or the first virtual address the event covers.
+    uint64_t                    end;         ///< The last virtual address the event covers, for events in the interval list.
+    uint64_t                    timestamp;   ///< The time at which the event occurred.
+    uint64_t                    thread_id;   ///< The CPU thread on which the event occurred.
+    uint32_t                    sequence;    ///< The position of the event in the RMT streams.
+    RmtResourceHistoryEventType event_type;  ///< The type of resource history event the token produces.
+} RmtResourceEventIndexEntry;
+
+/// A structure encapsulating a list of index entries sorted by key.
+typedef struct RmtResourceEventIndexList
+{
+    RmtResourceEventIndexEntry* entries;         ///< A pointer to an array of <c><i>RmtResourceEventIndexEntry</i></c> structures.
+    uint64_t*                   maximum_ends;    ///< The largest <c><i>end</i></c> of any entry up to and including each entry, for the interval list.
+    int32_t                     entry_count;     ///< The number of entries in <c><i>entries</i></c>.
+    int32_t                     entry_capacity;  ///< The number of entries there is memory for.
+} RmtResourceEventIndexList;
+
+/// A structure encapsulating an index of all RMT tokens that can appear in a resource history.
+///
+/// Resource create, destroy and bind tokens are looked up by resource identifier. CPU map
+/// and residency tokens are looked up by the base address of the virtual allocation they
+/// operate on. Virtual allocate, virtual free and page table update tokens are kept in a
+/// list of virtual address intervals sorted by start address, so all the intervals that
+/// overlap a resource can be found with a binary search.
+typedef struct RmtResourceEventIndex
+{
+    RmtResourceEventIndexList resource_events;  ///< Events keyed by resource identifier.
+    RmtResourceEventIndexList address_events;   ///< Events keyed by virtual allocation base address.
+    RmtResourceEventIndexList interval_events;  ///< Events covering a range of virtual addresses.
+    uint32_t                  event_count;      ///< The number of events added to the index.
+    bool                      is_complete;      ///< Set to true once every token in the data set has been added and the index sorted.
+} RmtResourceEventIndex;
+
+/// Initialize an empty resource event index.
+///
+/// @param [in] resource_event_index                A pointer to a <c><i>RmtResourceEventIndex</i></c> structure to initialize.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because <c><i>resource_event_index</i></c> was <c><i>NULL</i></c>.
+RmtErrorCode RmtResourceEventIndexInitialize(RmtResourceEventIndex* resource_event_index);
+
+/// Add an RMT token to the index.
+///
+/// Tokens must be added in the order they are returned from the stream merger. Tokens
+/// that never appear in a resource history are ignored.
+///
+/// @param [in] resource_event_index                A pointer to a <c><i>RmtResourceEventIndex</i></c> structure.
+/// @param [in] token                               A pointer to the <c><i>RmtToken</i></c> structure to add.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because <c><i>resource_event_index</i></c> or <c><i>token</i></c> was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                         The operation failed because the index could not grow.
+RmtErrorCode RmtResourceEventIndexAddToken(RmtResourceEventIndex* resource_event_index, const RmtToken* token);
+
+/// Sort the index once every token has been added, after which it can be queried.
+///
+/// @param [in] resource_event_index                A pointer to a <c><i>RmtResourceEventIndex</i></c> structure.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because <c><i>resource_event_index</i></c> was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                         The operation failed because the interval list could not be allocated.
+RmtErrorCode RmtResourceEventIndexFinalize(RmtResourceEventIndex* resource_event_index);
+
+/// Add the events for a resource to a resource history, in the order they appear in the RMT streams.
+///
+/// @param [in]  resource_event_index               A pointer to a completed <c><i>RmtResourceEventIndex</i></c> structure.
+/// @param [in]  resource                           A pointer to the <c><i>RmtResource</i></c> to find the events for.
+/// @param [out] out_resource_history               A pointer to a <c><i>RmtResourceHistory</i></c> structure to add the events to.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because a parameter was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_MALFORMED_DATA                        The operation failed because the index has not been completed.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                         The operation failed because memory could not be allocated.
+RmtErrorCode RmtResourceEventIndexGenerateResourceHistory(const RmtResourceEventIndex* resource_event_index,
+                                                          const RmtResource*           resource,
+                                                          RmtResourceHistory*          out_resource_history);
+
+/// Destroy the resource event index, freeing all its memory.
+///
+/// @param [in] resource_event_index                A pointer to a <c><i>RmtResourceEventIndex</i></c> structure to destroy.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because <c><i>resource_event_index</i></c> was <c><i>NULL</i></c>.
+RmtErrorCode RmtResourceEventIndexDestroy(RmtResourceEventIndex* resource_event_index);
+
+#ifdef __cpluplus
+}
+#endif  // #ifdef __cplusplus
+#endif  // #ifndef RMV_BACKEND_RMT_RESOURCE_EVENT_INDEX_H_
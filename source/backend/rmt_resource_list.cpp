@@ -17,20 +17,38 @@
 #include "linux/safe_crt.h"
 #endif
 
+// the details shared by resources which aren't in a resource list.
+static const RmtResourceDetails kEmptyResourceDetails = {};
+
+const RmtResourceDetails* RmtResourceGetDetails(const RmtResource* resource)
+{
+    RMT_ASSERT(resource);
+    RMT_RETURN_ON_ERROR(resource, &kEmptyResourceDetails);
+
+    if (resource->details == NULL)
+    {
+        return &kEmptyResourceDetails;
+    }
+
+    return resource->details;
+}
+
 RmtResourceUsageType RmtResourceGetUsageType(const RmtResource* resource)
 {
     RMT_ASSERT(resource);
     RMT_RETURN_ON_ERROR(resource, kRmtResourceUsageTypeUnknown);
 
+    const RmtResourceDetails* details = RmtResourceGetDetails(resource);
+
     switch (resource->resource_type)
     {
     case kRmtResourceTypeBuffer:
-        if (resource->buffer.usage_flags == kRmtBufferUsageFlagVertexBuffer)
+        if (details->buffer.usage_flags == kRmtBufferUsageFlagVertexBuffer)
         {
             return kRmtResourceUsageTypeVertexBuffer;
         }
 
-        if (resource->buffer.usage_flags == kRmtBufferUsageFlagIndexBuffer)
+        if (details->buffer.usage_flags == kRmtBufferUsageFlagIndexBuffer)
         {
             return kRmtResourceUsageTypeIndexBuffer;
         }
@@ -39,11 +57,11 @@ RmtResourceUsageType RmtResourceGetUsageType(const RmtResource* resource)
         break;
 
     case kRmtResourceTypeImage:
-        if ((resource->image.usage_flags & kRmtImageUsageFlagsColorTarget) == kRmtImageUsageFlagsColorTarget)
+        if ((details->image.usage_flags & kRmtImageUsageFlagsColorTarget) == kRmtImageUsageFlagsColorTarget)
         {
             return kRmtResourceUsageTypeRenderTarget;
         }
-        else if ((resource->image.usage_flags & kRmtImageUsageFlagsDepthStencil) == kRmtImageUsageFlagsDepthStencil)
+        else if ((details->image.usage_flags & kRmtImageUsageFlagsDepthStencil) == kRmtImageUsageFlagsDepthStencil)
         {
             return kRmtResourceUsageTypeDepthStencil;
         }
@@ -143,11 +161,55 @@ bool RmtResourceOverlapsVirtualAddressRange(const RmtResource* resource, RmtGpuA
     return true;
 }
 
+// get the backing storage histogram stored for a resource when the snapshot was generated.
+static const uint64_t* GetStoredBackingStorageHistogram(const RmtDataSnapshot* snapshot, const RmtResource* resource)
+{
+    if ((snapshot == nullptr) || (snapshot->resource_backing_storage == nullptr))
+    {
+        return nullptr;
+    }
+
+    // only resources in the resource list have a histogram stored.
+    const uintptr_t first_resource_address = (uintptr_t)snapshot->resource_list.resources;
+    const uintptr_t resource_address       = (uintptr_t)resource;
+    if (resource_address < first_resource_address)
+    {
+        return nullptr;
+    }
+
+    const uintptr_t resource_offset = resource_address - first_resource_address;
+    const uintptr_t resource_index  = resource_offset / sizeof(RmtResource);
+    if (((resource_offset % sizeof(RmtResource)) != 0) || (resource_index >= (uintptr_t)snapshot->resource_backing_storage_count))
+    {
+        return nullptr;
+    }
+
+    return &snapshot->resource_backing_storage[resource_index * kRmtResourceBackingStorageCount];
+}
+
 RmtErrorCode RmtResourceGetBackingStorageHistogram(const RmtDataSnapshot* snapshot, const RmtResource* resource, uint64_t* out_bytes_per_backing_storage_type)
 {
     RMT_RETURN_ON_ERROR(resource, RMT_ERROR_INVALID_POINTER);
     RMT_RETURN_ON_ERROR(out_bytes_per_backing_storage_type, RMT_ERROR_INVALID_POINTER)
 
+    const uint64_t* stored_histogram = GetStoredBackingStorageHistogram(snapshot, resource);
+    if (stored_histogram != nullptr)
+    {
+        for (int32_t current_backing_storage_index = 0; current_backing_storage_index < kRmtResourceBackingStorageCount; ++current_backing_storage_index)
+        {
+            if (current_backing_storage_index == kRmtResourceBackingStorageUnmapped)
+            {
+                out_bytes_per_backing_storage_type[current_backing_storage_index] = stored_histogram[current_backing_storage_index];
+            }
+            else
+            {
+                out_bytes_per_backing_storage_type[current_backing_storage_index] += stored_histogram[current_backing_storage_index];
+            }
+        }
+
+        return RMT_OK;
+    }
+
     const uint64_t size_of_minimum_page = RmtGetPageSize(kRmtPageSize4Kb);
 
     // stride through the resource in 4KB pages and figure out the mapping of each.
@@ -202,6 +264,13 @@ bool RmtResourceIsCompletelyInPreferredHeap(const RmtDataSnapshot* snapshot, con
     const uint64_t    size_of_minimum_page = RmtGetPageSize(kRmtPageSize4Kb);
     const RmtHeapType preferred_heap       = resource->bound_allocation->heap_preferences[0];
 
+    // the resource is completely in its preferred heap if every byte was counted there.
+    const uint64_t* stored_histogram = GetStoredBackingStorageHistogram(snapshot, resource);
+    if ((stored_histogram != nullptr) && (preferred_heap >= 0) && (preferred_heap < kRmtHeapTypeCount))
+    {
+        return stored_histogram[preferred_heap] == resource->size_in_bytes;
+    }
+
     // stride through the resource in 4KB pages and figure out the mapping of each.
     RmtGpuAddress       current_virtual_address = resource->address;
     const RmtGpuAddress end_virtual_address     = resource->address + resource->size_in_bytes;
@@ -266,9 +335,10 @@ bool RmtResourceGetName(const RmtResource* resource, int32_t buffer_size, char**
         return false;
     }
 
-    if (resource->name[0] != '\0')
+    const RmtResourceDetails* details = RmtResourceGetDetails(resource);
+    if (details->name[0] != '\0')
     {
-        strcpy_s(*out_resource_name, buffer_size, resource->name);
+        strcpy_s(*out_resource_name, buffer_size, details->name);
     }
     else
     {
@@ -297,42 +367,7 @@ int32_t RmtResourceGetAliasCount(const RmtResource* resource)
     RMT_RETURN_ON_ERROR(resource->bound_allocation, 0);
     RMT_RETURN_ON_ERROR(resource->resource_type != kRmtResourceTypeHeap, 0);
 
-    const RmtVirtualAllocation* virtual_allocation     = resource->bound_allocation;
-    const RmtGpuAddress         resource_start_address = resource->address;
-    const RmtGpuAddress         resource_end_address   = resource->address + resource->size_in_bytes;
-
-    int32_t total_resource_alias_count = 0;
-    for (int32_t current_resource_index = 0; current_resource_index < virtual_allocation->resource_count; ++current_resource_index)
-    {
-        const RmtResource* current_resource = virtual_allocation->resources[current_resource_index];
-
-        if (current_resource == resource)
-        {
-            continue;
-        }
-
-        // special handle for heaps.
-        if (current_resource->resource_type == kRmtResourceTypeHeap)
-        {
-            continue;
-        }
-
-        // get the start and end address
-        const RmtGpuAddress current_resource_start = current_resource->address;
-        const RmtGpuAddress current_resource_end   = current_resource->address + current_resource->size_in_bytes;
-        if (resource_start_address >= current_resource_end)
-        {
-            continue;
-        }
-        if (resource_end_address <= current_resource_start)
-        {
-            continue;
-        }
-
-        total_resource_alias_count++;
-    }
-
-    return total_resource_alias_count;
+    return resource->alias_count;
 }
 
 // Helper function to improve tree balance by hashing the handles.
@@ -503,7 +538,7 @@ static RmtErrorCode DestroyResource(RmtResourceList* resource_list, RmtResource*
 
     // don't count shareable resources
     bool is_shareable = (resource->resource_type == kRmtResourceTypeImage) &&
-                        ((resource->image.create_flags & kRmtImageCreationFlagShareable) == kRmtImageCreationFlagShareable);
+                        ((RmtResourceGetDetails(resource)->image.create_flags & kRmtImageCreationFlagShareable) == kRmtImageCreationFlagShareable);
 
     if (!is_shareable)
     {
@@ -520,10 +555,13 @@ static RmtErrorCode DestroyResource(RmtResourceList* resource_list, RmtResource*
     const RmtErrorCode error_code = RemoveResourceFromTree(resource_list, hashed_identifier);
     RMT_ASSERT(error_code == RMT_OK);
 
-    // copy the tail into the target.
+    // copy the tail into the target. the details stay where they are, so the target takes the tail's details and
+    // the tail slot takes the target's, which are reused by the next resource created there.
     if (tail_resource != resource)
     {
+        RmtResourceDetails* details = resource->details;
         memcpy(resource, tail_resource, sizeof(RmtResource));
+        tail_resource->details           = details;
         tail_resource->id_node->resource = resource;  // update acceleration structure pointer to this resource's new home.
     }
 
@@ -531,9 +569,15 @@ static RmtErrorCode DestroyResource(RmtResourceList* resource_list, RmtResource*
     return RMT_OK;
 }
 
+// the number of bytes of column data stored for each resource.
+static size_t GetColumnSizePerResource()
+{
+    return sizeof(RmtResourceIdentifier) + sizeof(RmtGpuAddress) + sizeof(uint64_t) + sizeof(uint32_t) + (sizeof(uint8_t) * 4) + sizeof(int8_t);
+}
+
 size_t RmtResourceListGetBufferSize(int32_t maximum_concurrent_resources)
 {
-    return maximum_concurrent_resources * (sizeof(RmtResource) + sizeof(RmtResourceIdNode));
+    return maximum_concurrent_resources * (sizeof(RmtResource) + sizeof(RmtResourceDetails) + sizeof(RmtResourceIdNode) + GetColumnSizePerResource());
 }
 
 RmtErrorCode RmtResourceListInitialize(RmtResourceList*                resource_list,
@@ -554,8 +598,15 @@ RmtErrorCode RmtResourceListInitialize(RmtResourceList*                resource_
     resource_list->virtual_allocation_list      = virtual_allocation_list;
     resource_list->maximum_concurrent_resources = maximum_concurrent_resources;
 
+    // initialize the details side table after the resources, giving each resource slot its own details.
+    resource_list->resource_details = (RmtResourceDetails*)(resource_list->resources + maximum_concurrent_resources);
+    for (int32_t current_resource_index = 0; current_resource_index < maximum_concurrent_resources; ++current_resource_index)
+    {
+        resource_list->resources[current_resource_index].details = &resource_list->resource_details[current_resource_index];
+    }
+
     // initialize the acceleration structure.
-    const uintptr_t resource_node_buffer      = ((uintptr_t)buffer) + (maximum_concurrent_resources * sizeof(RmtResource));
+    const uintptr_t resource_node_buffer      = (uintptr_t)(resource_list->resource_details + maximum_concurrent_resources);
     resource_list->resource_id_nodes          = (RmtResourceIdNode*)resource_node_buffer;
     const size_t       resource_id_nodes_size = maximum_concurrent_resources * sizeof(RmtResourceIdNode);
     const RmtErrorCode error_code =
@@ -564,6 +615,19 @@ RmtErrorCode RmtResourceListInitialize(RmtResourceList*                resource_
     RMT_RETURN_ON_ERROR(error_code == RMT_OK, error_code);
     resource_list->root = NULL;
 
+    // initialize the columns after the acceleration structure, widest first to keep each column aligned.
+    RmtResourceListColumns* columns = &resource_list->columns;
+    columns->identifiers            = (RmtResourceIdentifier*)(resource_node_buffer + resource_id_nodes_size);
+    columns->addresses              = (RmtGpuAddress*)(columns->identifiers + maximum_concurrent_resources);
+    columns->sizes_in_bytes         = (uint64_t*)(columns->addresses + maximum_concurrent_resources);
+    columns->flags                  = (uint32_t*)(columns->sizes_in_bytes + maximum_concurrent_resources);
+    columns->resource_types         = (uint8_t*)(columns->flags + maximum_concurrent_resources);
+    columns->usage_types            = columns->resource_types + maximum_concurrent_resources;
+    columns->commit_types           = columns->usage_types + maximum_concurrent_resources;
+    columns->owner_types            = columns->commit_types + maximum_concurrent_resources;
+    columns->preferred_heaps        = (int8_t*)(columns->owner_types + maximum_concurrent_resources);
+    columns->count                  = 0;
+
     memset(resource_list->resource_usage_count, 0, sizeof(resource_list->resource_usage_count));
     memset(resource_list->resource_usage_size, 0, sizeof(resource_list->resource_usage_size));
 
@@ -604,71 +668,72 @@ RmtErrorCode RmtResourceListAddResourceCreate(RmtResourceList* resource_list, co
     RMT_RETURN_ON_ERROR((resource_list->resource_count + 1) <= resource_list->maximum_concurrent_resources, RMT_ERROR_OUT_OF_MEMORY);
 
     // fill out the stuff we know.
-    RmtResource* new_resource   = &resource_list->resources[resource_list->resource_count++];
-    new_resource->name[0]       = '\0';
-    new_resource->identifier    = resource_create->resource_identifier;
-    new_resource->create_time   = resource_create->common.timestamp;
-    new_resource->flags         = 0;
-    new_resource->commit_type   = resource_create->commit_type;
-    new_resource->resource_type = resource_create->resource_type;
-    new_resource->owner_type    = resource_create->owner_type;
+    RmtResource* new_resource      = &resource_list->resources[resource_list->resource_count++];
+    new_resource->details->name[0] = '\0';
+    new_resource->identifier       = resource_create->resource_identifier;
+    new_resource->create_time      = resource_create->common.timestamp;
+    new_resource->flags            = 0;
+    new_resource->commit_type      = resource_create->commit_type;
+    new_resource->resource_type    = resource_create->resource_type;
+    new_resource->owner_type       = resource_create->owner_type;
+    new_resource->alias_count      = 0;
 
     switch (resource_create->resource_type)
     {
     case kRmtResourceTypeImage:
-        memcpy(&new_resource->image, &resource_create->image, sizeof(RmtResourceDescriptionImage));
+        memcpy(&new_resource->details->image, &resource_create->image, sizeof(RmtResourceDescriptionImage));
         break;
 
     case kRmtResourceTypeBuffer:
-        memcpy(&new_resource->buffer, &resource_create->buffer, sizeof(RmtResourceDescriptionBuffer));
+        memcpy(&new_resource->details->buffer, &resource_create->buffer, sizeof(RmtResourceDescriptionBuffer));
         break;
 
     case kRmtResourceTypeGpuEvent:
-        memcpy(&new_resource->gpu_event, &resource_create->gpu_event, sizeof(RmtResourceDescriptionGpuEvent));
+        memcpy(&new_resource->details->gpu_event, &resource_create->gpu_event, sizeof(RmtResourceDescriptionGpuEvent));
         break;
 
     case kRmtResourceTypeBorderColorPalette:
-        memcpy(&new_resource->border_color_palette, &resource_create->border_color_palette, sizeof(RmtResourceDescriptionBorderColorPalette));
+        memcpy(&new_resource->details->border_color_palette, &resource_create->border_color_palette, sizeof(RmtResourceDescriptionBorderColorPalette));
         break;
 
     case kRmtResourceTypePerfExperiment:
-        memcpy(&new_resource->perf_experiment, &resource_create->perf_experiment, sizeof(RmtResourceDescriptionPerfExperiment));
+        memcpy(&new_resource->details->perf_experiment, &resource_create->perf_experiment, sizeof(RmtResourceDescriptionPerfExperiment));
         break;
 
     case kRmtResourceTypeQueryHeap:
-        memcpy(&new_resource->query_heap, &resource_create->query_heap, sizeof(RmtResourceDescriptionQueryHeap));
+        memcpy(&new_resource->details->query_heap, &resource_create->query_heap, sizeof(RmtResourceDescriptionQueryHeap));
         break;
 
     case kRmtResourceTypeVideoDecoder:
-        memcpy(&new_resource->video_decoder, &resource_create->video_decoder, sizeof(RmtResourceDescriptionVideoDecoder));
+        memcpy(&new_resource->details->video_decoder, &resource_create->video_decoder, sizeof(RmtResourceDescriptionVideoDecoder));
         break;
 
     case kRmtResourceTypeVideoEncoder:
-        memcpy(&new_resource->video_encoder, &resource_create->video_encoder, sizeof(RmtResourceDescriptionVideoEncoder));
+        memcpy(&new_resource->details->video_encoder, &resource_create->video_encoder, sizeof(RmtResourceDescriptionVideoEncoder));
         break;
 
     case kRmtResourceTypeHeap:
-        memcpy(&new_resource->heap, &resource_create->heap, sizeof(RmtResourceDescriptionHeap));
+        memcpy(&new_resource->details->heap, &resource_create->heap, sizeof(RmtResourceDescriptionHeap));
         break;
 
     case kRmtResourceTypePipeline:
-        memcpy(&new_resource->pipeline, &resource_create->pipeline, sizeof(RmtResourceDescriptionPipeline));
+        memcpy(&new_resource->details->pipeline, &resource_create->pipeline, sizeof(RmtResourceDescriptionPipeline));
         break;
 
     case kRmtResourceTypeDescriptorHeap:
-        memcpy(&new_resource->descriptor_heap, &resource_create->descriptor_heap, sizeof(RmtResourceDescriptionDescriptorHeap));
+        memcpy(&new_resource->details->descriptor_heap, &resource_create->descriptor_heap, sizeof(RmtResourceDescriptionDescriptorHeap));
         break;
 
     case kRmtResourceTypeDescriptorPool:
-        memcpy(&new_resource->descriptor_pool, &resource_create->descriptor_pool, sizeof(RmtResourceDescriptionDescriptorPool));
+        memcpy(&new_resource->details->descriptor_pool, &resource_create->descriptor_pool, sizeof(RmtResourceDescriptionDescriptorPool));
         break;
 
     case kRmtResourceTypeCommandAllocator:
-        memcpy(&new_resource->command_allocator, &resource_create->command_allocator, sizeof(RmtResourceDescriptionCommandAllocator));
+        memcpy(&new_resource->details->command_allocator, &resource_create->command_allocator, sizeof(RmtResourceDescriptionCommandAllocator));
         break;
 
     case kRmtResourceTypeMiscInternal:
-        memcpy(&new_resource->misc_internal, &resource_create->misc_internal, sizeof(RmtResourceDescriptionMiscInternal));
+        memcpy(&new_resource->details->misc_internal, &resource_create->misc_internal, sizeof(RmtResourceDescriptionMiscInternal));
         break;
 
     case kRmtResourceTypeIndirectCmdGenerator:
@@ -709,7 +774,7 @@ static void UpdateCommitType(RmtResourceList* resource_list, RmtResource* resour
     // PRT stuff is for sure virtual.
     if (resource->resource_type == kRmtResourceTypeImage)
     {
-        if ((resource->image.create_flags & kRmtImageCreationFlagPrt) == kRmtImageCreationFlagPrt)
+        if ((RmtResourceGetDetails(resource)->image.create_flags & kRmtImageCreationFlagPrt) == kRmtImageCreationFlagPrt)
         {
             const RmtHeapType previous_heap_type = current_virtual_allocation->heap_preferences[0];
             RMT_ASSERT(previous_heap_type != kRmtHeapTypeNone);
@@ -774,7 +839,7 @@ RmtErrorCode RmtResourceListAddResourceBind(RmtResourceList* resource_list, cons
 
     // look for externally shared resources.
     if ((error_code == RMT_ERROR_NO_ALLOCATION_FOUND) && (resource->resource_type == kRmtResourceTypeImage) &&
-        ((resource->image.create_flags & kRmtImageCreationFlagShareable) == kRmtImageCreationFlagShareable))
+        ((RmtResourceGetDetails(resource)->image.create_flags & kRmtImageCreationFlagShareable) == kRmtImageCreationFlagShareable))
     {
         // It is expected that we won't see a virtual allocate token for some shareable resources, as that memory is owned outside
         // the target process.  This error code will result in a dummy allocation being added to the list, so future resource calls
@@ -835,6 +900,95 @@ RmtErrorCode RmtResourceListAddResourceDestroy(RmtResourceList* resource_list, c
     return RMT_OK;
 }
 
+RmtErrorCode RmtResourceListUpdateColumns(RmtResourceList* resource_list)
+{
+    RMT_ASSERT(resource_list);
+    RMT_RETURN_ON_ERROR(resource_list, RMT_ERROR_INVALID_POINTER);
+
+    RmtResourceListColumns* columns = &resource_list->columns;
+    for (int32_t current_resource_index = 0; current_resource_index < resource_list->resource_count; ++current_resource_index)
+    {
+        const RmtResource* resource                     = &resource_list->resources[current_resource_index];
+        columns->identifiers[current_resource_index]    = resource->identifier;
+        columns->addresses[current_resource_index]      = resource->address;
+        columns->sizes_in_bytes[current_resource_index] = resource->size_in_bytes;
+        columns->flags[current_resource_index]          = resource->flags;
+        columns->resource_types[current_resource_index] = (uint8_t)resource->resource_type;
+        columns->usage_types[current_resource_index]    = (uint8_t)RmtResourceGetUsageType(resource);
+        columns->commit_types[current_resource_index]   = (uint8_t)resource->commit_type;
+        columns->owner_types[current_resource_index]    = (uint8_t)resource->owner_type;
+        columns->preferred_heaps[current_resource_index] =
+            (int8_t)((resource->bound_allocation != nullptr) ? resource->bound_allocation->heap_preferences[0] : kRmtHeapTypeUnknown);
+    }
+
+    columns->count = resource_list->resource_count;
+    return RMT_OK;
+}
+
+int32_t RmtResourceListGetResourceIndex(const RmtResourceList* resource_list, const RmtResource* resource)
+{
+    RMT_RETURN_ON_ERROR(resource_list, -1);
+    RMT_RETURN_ON_ERROR(resource, -1);
+
+    if ((resource < resource_list->resources) || (resource >= (resource_list->resources + resource_list->resource_count)))
+    {
+        return -1;
+    }
+
+    return (int32_t)(resource - resource_list->resources);
+}
+
+uint64_t RmtResourceListGetLargestResourceSize(const RmtResourceList* resource_list)
+{
+    RMT_RETURN_ON_ERROR(resource_list, 0);
+
+    uint64_t largest_resource_size_in_bytes = 0;
+    if (resource_list->columns.count == resource_list->resource_count)
+    {
+        for (int32_t current_resource_index = 0; current_resource_index < resource_list->resource_count; ++current_resource_index)
+        {
+            largest_resource_size_in_bytes = RMT_MAXIMUM(largest_resource_size_in_bytes, resource_list->columns.sizes_in_bytes[current_resource_index]);
+        }
+    }
+    else
+    {
+        for (int32_t current_resource_index = 0; current_resource_index < resource_list->resource_count; ++current_resource_index)
+        {
+            largest_resource_size_in_bytes = RMT_MAXIMUM(largest_resource_size_in_bytes, resource_list->resources[current_resource_index].size_in_bytes);
+        }
+    }
+
+    return largest_resource_size_in_bytes;
+}
+
+uint64_t RmtResourceListGetSmallestResourceSize(const RmtResourceList* resource_list)
+{
+    RMT_RETURN_ON_ERROR(resource_list, 0);
+
+    if (resource_list->resource_count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t smallest_resource_size_in_bytes = UINT64_MAX;
+    if (resource_list->columns.count == resource_list->resource_count)
+    {
+        for (int32_t current_resource_index = 0; current_resource_index < resource_list->resource_count; ++current_resource_index)
+        {
+            smallest_resource_size_in_bytes = RMT_MINIMUM(smallest_resource_size_in_bytes, resource_list->columns.sizes_in_bytes[current_resource_index]);
+        }
+    }
+    else
+    {
+        for (int32_t current_resource_index = 0; current_resource_index < resource_list->resource_count; ++current_resource_index)
+        {
+            smallest_resource_size_in_bytes = RMT_MINIMUM(smallest_resource_size_in_bytes, resource_list->resources[current_resource_index].size_in_bytes);
+        }
+    }
+
+    return smallest_resource_size_in_bytes;
+}
+
 RmtErrorCode RmtResourceListGetResourceByResourceId(const RmtResourceList* resource_list,
                                                     RmtResourceIdentifier  resource_identifier,
                                                     const RmtResource**    out_resource)
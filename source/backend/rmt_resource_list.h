@@ -61,21 +61,13 @@ typedef enum RmtResourceUsageType
     kRmtResourceUsageTypeCount
 } RmtResourceUsageType;
 
-/// A structure encapsulating a single resource.
-typedef struct RmtResource
+/// A structure encapsulating the rarely read fields of a resource.
+///
+/// These are kept in a side table of the resource list rather than in the <c><i>RmtResource</i></c>
+/// structure, so scans over the resources don't pull the name and description through the cache.
+typedef struct RmtResourceDetails
 {
-    char                  name[RMT_MAXIMUM_NAME_LENGTH];  ///< The name of the resource.
-    RmtResourceIdentifier identifier;                     ///< A GUID for the this resource.
-    uint64_t              create_time;                    ///< The time the resource was created.
-    uint64_t              bind_time;                      ///< The time the resource was last bound to a virtual address range.
-    uint64_t              address;                        ///< The virtual address of the resource.
-    uint64_t              size_in_bytes;                  ///< The total size of the resource.
-    const RmtVirtualAllocation*
-                    bound_allocation;  ///< An pointers to a <c><i>RmtAllocation</i></c> structure containing the virtual address allocation containing this resource. This is set to NULL if the resource isn't bound to a virtual address.
-    uint32_t        flags;             ///< Flags on the resource.
-    RmtCommitType   commit_type;       ///< The commit type of the resource.
-    RmtResourceType resource_type;     ///< The type of the resource.
-    RmtOwnerType    owner_type;        ///< The owner of the resource.
+    char name[RMT_MAXIMUM_NAME_LENGTH];  ///< The name of the resource.
 
     union
     {
@@ -96,10 +88,36 @@ typedef struct RmtResource
                                            command_allocator;  ///< Valid when <c><i>resourceType</i></c> is <c><i>RMT_RESOURCE_TYPE_COMMAND_ALLOCATOR</i></c>.
         RmtResourceDescriptionMiscInternal misc_internal;      ///< Valid when <c><i>resourceType</i></c> is <c><i>RMT_RESOURCE_TYPE_MISC_INTERNAL</i></c>.
     };
+} RmtResourceDetails;
 
-    RmtResourceIdNode* id_node;  ///< A pointer to the <c><i>RmtResourceIdNode</i></c> structure in the tree, used to quickly locate this resource by ID.
+/// A structure encapsulating a single resource.
+typedef struct RmtResource
+{
+    RmtResourceIdentifier identifier;     ///< A GUID for the this resource.
+    uint64_t              create_time;    ///< The time the resource was created.
+    uint64_t              bind_time;      ///< The time the resource was last bound to a virtual address range.
+    uint64_t              address;        ///< The virtual address of the resource.
+    uint64_t              size_in_bytes;  ///< The total size of the resource.
+    const RmtVirtualAllocation*
+                    bound_allocation;  ///< An pointers to a <c><i>RmtAllocation</i></c> structure containing the virtual address allocation containing this resource. This is set to NULL if the resource isn't bound to a virtual address.
+    uint32_t        flags;             ///< Flags on the resource.
+    RmtCommitType   commit_type;       ///< The commit type of the resource.
+    RmtResourceType resource_type;     ///< The type of the resource.
+    RmtOwnerType    owner_type;        ///< The owner of the resource.
+    int32_t         alias_count;       ///< The number of other resources that alias the memory of this resource, calculated when the snapshot is generated.
+
+    RmtResourceDetails* details;  ///< A pointer to the name and description of the resource, in the side table of the resource list.
+    RmtResourceIdNode*  id_node;  ///< A pointer to the <c><i>RmtResourceIdNode</i></c> structure in the tree, used to quickly locate this resource by ID.
 } RmtResource;
 
+/// Get the name and description of a resource.
+///
+/// @param [in] resource                            A pointer to a <c><i>RmtResource</i></c> structure.
+///
+/// @returns
+/// A pointer to the details of the resource. Resources which aren't in a resource list share empty details.
+const RmtResourceDetails* RmtResourceGetDetails(const RmtResource* resource);
+
 /// Get the resource usage type from the resource.
 ///
 /// @param [in] resource                            A pointer to a <c><i>RmtResource</i></c> structure.
@@ -145,13 +163,18 @@ bool RmtResourceIsCompletelyInPreferredHeap(const RmtDataSnapshot* snapshot, con
 
 /// Calculate a histogram demonstrating the number of bytes of memory in each backing store type.
 ///
+/// Resources in the snapshot's resource list read the histogram stored when the snapshot was
+/// generated. Only other resources walk the page table.
+///
 /// @param [in] snapshot                            A pointer to a <c><i>RmtDataSnapshot</i></c> structure that contains the page table to check.
 /// @param [in] resource                            A pointer to a <c><i>RmtResource</i></c> structure.
 /// @param [out] out_bytes_per_backing_storage_type The number of bytes the resource has in each backing storage type.
 ///
 RmtErrorCode RmtResourceGetBackingStorageHistogram(const RmtDataSnapshot* snapshot, const RmtResource* resource, uint64_t* out_bytes_per_backing_storage_type);
 
-/// Calculate the number of resource that alias the memory underpinning this resource.
+/// Get the number of resource that alias the memory underpinning this resource.
+///
+/// The alias counts of all resources are calculated once when the snapshot is generated.
 ///
 /// @param [in] resource                            A pointer to a <c><i>RmtResource</i></c> structure.
 ///
@@ -168,6 +191,24 @@ typedef struct RmtResourceIdNode
     RmtResourceIdNode*    right;      ///< A pointer to a <c><i>RmtResourceNodeId</i></c> structure that is the right child of this node.
 } RmtResourceIdNode;
 
+/// A structure encapsulating the frequently scanned fields of the resources in a resource list.
+///
+/// Each field is stored in its own array, in the same order as the resources, so a scan over
+/// one field doesn't stride over whole resources.
+typedef struct RmtResourceListColumns
+{
+    RmtResourceIdentifier* identifiers;      ///< The identifier of each resource.
+    RmtGpuAddress*         addresses;        ///< The virtual address of each resource.
+    uint64_t*              sizes_in_bytes;   ///< The size of each resource, in bytes.
+    uint32_t*              flags;            ///< The flags of each resource.
+    uint8_t*               resource_types;   ///< The <c><i>RmtResourceType</i></c> of each resource.
+    uint8_t*               usage_types;      ///< The <c><i>RmtResourceUsageType</i></c> of each resource.
+    uint8_t*               commit_types;     ///< The <c><i>RmtCommitType</i></c> of each resource.
+    uint8_t*               owner_types;      ///< The <c><i>RmtOwnerType</i></c> of each resource.
+    int8_t*                preferred_heaps;  ///< The preferred <c><i>RmtHeapType</i></c> of each resource's allocation, or <c><i>kRmtHeapTypeUnknown</i></c> if unbound.
+    int32_t                count;            ///< The number of resources in the columns. Only equal to the resource count once the columns are updated.
+} RmtResourceListColumns;
+
 /// A structure encapsulating a list of allocations.
 typedef struct RmtResourceList
 {
@@ -178,6 +219,7 @@ typedef struct RmtResourceList
 
     // Storage for resources.
     RmtResource*                    resources;                     ///< A buffer of extra allocation details.
+    RmtResourceDetails*             resource_details;              ///< A buffer of the names and descriptions of the resources, each owned by one resource.
     int32_t                         resource_count;                ///< The number of live allocations in the list.
     int32_t                         maximum_concurrent_resources;  ///< The maximum number of resources that can be in flight at once.
     const RmtVirtualAllocationList* virtual_allocation_list;       ///< The virtual allocation to query for bindings.
@@ -185,6 +227,8 @@ typedef struct RmtResourceList
     int32_t  resource_usage_count[kRmtResourceUsageTypeCount];  ///< The number of each resource usage currently in the list.
     uint64_t resource_usage_size[kRmtResourceUsageTypeCount];
 
+    RmtResourceListColumns columns;  ///< The frequently scanned fields of the resources, updated once the snapshot is generated.
+
 } RmtResourceList;
 
 /// Calculate how many bytes of memory we need for resource list buffers.
@@ -270,6 +314,45 @@ RmtErrorCode RmtResourceListGetResourceByResourceId(const RmtResourceList* resou
                                                     RmtResourceIdentifier  resource_identifier,
                                                     const RmtResource**    out_resource);
 
+/// Update the columns of a resource list from its resources.
+///
+/// The columns are not maintained while tokens are added to the list, as snapshot generation
+/// changes resources after the tokens are processed. They are updated once, when the snapshot
+/// is complete.
+///
+/// @param [in] resource_list                       A pointer to a <c><i>RmtResourceList</i></c> structure.
+///
+/// @retval
+/// RMT_OK                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER       The operation failed because <c><i>resource_list</i></c> was <c><i>NULL</i></c>.
+RmtErrorCode RmtResourceListUpdateColumns(RmtResourceList* resource_list);
+
+/// Get the index of a resource in a resource list, which is also its index in the columns.
+///
+/// @param [in] resource_list                       A pointer to a <c><i>RmtResourceList</i></c> structure.
+/// @param [in] resource                            A pointer to a <c><i>RmtResource</i></c> structure in the list.
+///
+/// @returns
+/// The index of the resource, or -1 if the resource is not in the list.
+int32_t RmtResourceListGetResourceIndex(const RmtResourceList* resource_list, const RmtResource* resource);
+
+/// Get the size of the largest resource in a resource list.
+///
+/// @param [in] resource_list                       A pointer to a <c><i>RmtResourceList</i></c> structure.
+///
+/// @returns
+/// The size of the largest resource, in bytes, or 0 if the list is empty.
+uint64_t RmtResourceListGetLargestResourceSize(const RmtResourceList* resource_list);
+
+/// Get the size of the smallest resource in a resource list.
+///
+/// @param [in] resource_list                       A pointer to a <c><i>RmtResourceList</i></c> structure.
+///
+/// @returns
+/// The size of the smallest resource, in bytes, or 0 if the list is empty.
+uint64_t RmtResourceListGetSmallestResourceSize(const RmtResourceList* resource_list);
+
 /// Get the heap name for the resource passed in.
 ///
 /// @param [in] resource                            A pointer to a <c><i>RmtResource</i></c> structure.
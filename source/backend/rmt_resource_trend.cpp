@@ -0,0 +1,30 @@
+//=============================================================================
+/// Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author
+/// \brief Implementation of the tracking of resources across many snapshot points.
+//=============================================================================
+
+#include "rmt_resource_trend.h"
+#include <rmt_assert.h>
+#include <stdlib.h>  // for free()
+
+bool RmtResourceTrendIsResourceSurviving(const RmtResourceTrend* resource_trend, const RmtResourceTrendResource* resource, int32_t point_index)
+{
+    RMT_RETURN_ON_ERROR(resource_trend, false);
+    RMT_RETURN_ON_ERROR(resource, false);
+
+    return (resource->first_point_index <= point_index) && (resource->last_point_index == (resource_trend->point_count - 1));
+}
+
+RmtErrorCode RmtResourceTrendDestroy(RmtResourceTrend* resource_trend)
+{
+    RMT_RETURN_ON_ERROR(resource_trend, RMT_ERROR_INVALID_POINTER);
+
+    free(resource_trend->points);
+    free(resource_trend->resources);
+    resource_trend->points         = NULL;
+    resource_trend->point_count    = 0;
+    resource_trend->resources      = NULL;
+    resource_trend->resource_count = 0;
+    return RMT_OK;
+}
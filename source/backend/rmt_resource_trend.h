@@ -0,0 +1,73 @@
+//=============================================================================
+/// Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author
+/// \brief Structures and functions for tracking resources across many snapshot points.
+//=============================================================================
+
+#ifndef RMV_BACKEND_RMT_RESOURCE_TREND_H_
+#define RMV_BACKEND_RMT_RESOURCE_TREND_H_
+
+#include <rmt_types.h>
+#include <rmt_error.h>
+#include <rmt_format.h>
+
+#ifdef __cpluplus
+extern "C" {
+#endif  // #ifdef __cplusplus
+
+/// A structure encapsulating the resources alive at one snapshot point.
+typedef struct RmtResourceTrendPoint
+{
+    uint64_t timestamp;                 ///< The time of the snapshot point.
+    int32_t  live_resource_count;       ///< The number of resources alive at the snapshot point.
+    uint64_t live_resource_size;        ///< The size of the resources alive at the snapshot point.
+    int32_t  surviving_resource_count;  ///< The number of resources alive at this and every later snapshot point.
+    uint64_t surviving_resource_size;   ///< The size at this snapshot point of the resources alive at this and every later snapshot point.
+    bool     is_growing;                ///< Set to true if the size of the live resources never decreases from this snapshot point to the last.
+} RmtResourceTrendPoint;
+
+/// A structure encapsulating a resource that is alive at one or more snapshot points.
+typedef struct RmtResourceTrendResource
+{
+    RmtResourceIdentifier identifier;           ///< The identifier of the resource.
+    RmtResourceType       resource_type;        ///< The type of the resource.
+    uint64_t              create_time;          ///< The time the resource was created.
+    int32_t               first_point_index;    ///< The index of the first snapshot point the resource is alive at.
+    int32_t               last_point_index;     ///< The index of the last snapshot point the resource is alive at.
+    uint64_t              first_size_in_bytes;  ///< The size of the resource at the first snapshot point it is alive at.
+    uint64_t              last_size_in_bytes;   ///< The size of the resource at the last snapshot point it is alive at.
+} RmtResourceTrendResource;
+
+/// A structure encapsulating the survival and growth of resources across a set of snapshot points.
+typedef struct RmtResourceTrend
+{
+    RmtResourceTrendPoint*    points;          ///< A pointer to an array of <c><i>RmtResourceTrendPoint</i></c> structures, one per snapshot point in chronological order.
+    int32_t                   point_count;     ///< The number of snapshot points.
+    RmtResourceTrendResource* resources;       ///< A pointer to an array of <c><i>RmtResourceTrendResource</i></c> structures, sorted by identifier.
+    int32_t                   resource_count;  ///< The number of resources alive at one or more snapshot points.
+} RmtResourceTrend;
+
+/// Check if a resource is alive at a snapshot point and every later snapshot point.
+///
+/// @param [in] resource_trend                      A pointer to a <c><i>RmtResourceTrend</i></c> structure.
+/// @param [in] resource                            A pointer to a <c><i>RmtResourceTrendResource</i></c> structure in the trend.
+/// @param [in] point_index                         The index of the snapshot point.
+///
+/// @returns
+/// true if the resource is alive from the snapshot point onwards, false if not.
+bool RmtResourceTrendIsResourceSurviving(const RmtResourceTrend* resource_trend, const RmtResourceTrendResource* resource, int32_t point_index);
+
+/// Destroy a resource trend, freeing its memory.
+///
+/// @param [in] resource_trend                      A pointer to a <c><i>RmtResourceTrend</i></c> structure to destroy.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because <c><i>resource_trend</i></c> was <c><i>NULL</i></c>.
+RmtErrorCode RmtResourceTrendDestroy(RmtResourceTrend* resource_trend);
+
+#ifdef __cpluplus
+}
+#endif  // #ifdef __cplusplus
+#endif  // #ifndef RMV_BACKEND_RMT_RESOURCE_TREND_H_
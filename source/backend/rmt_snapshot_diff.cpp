@@ -0,0 +1,291 @@
+//=============================================================================
+/// Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author
+/// \brief Implementation of the comparison of the resources and heaps of two snapshots.
+//=============================================================================
+
+#include "rmt_snapshot_diff.h"
+#include "rmt_data_snapshot.h"
+#include "rmt_virtual_allocation_list.h"
+#include <rmt_assert.h>
+#include <stdlib.h>  // for malloc() / free()
+#include <string.h>  // for memset()
+
+// the number of bits of the resource identifier sorted in each pass of the radix sort.
+#define RADIX_BITS (11)
+
+// the number of buckets in each pass of the radix sort.
+#define RADIX_BUCKET_COUNT (1 << RADIX_BITS)
+
+// an identifier and the index of its resource in the resource list, sorted together.
+typedef struct ResourceKey
+{
+    RmtResourceIdentifier identifier;  // the identifier of the resource.
+    int32_t               index;       // the index of the resource in the resource list.
+} ResourceKey;
+
+// the fields of a resource that are compared. these are gathered from the resource list columns
+// in one pass, so the merge reads them from one array rather than from several columns.
+typedef struct ResourceFields
+{
+    uint64_t             address;        // the virtual address of the resource.
+    uint64_t             size_in_bytes;  // the size of the resource.
+    RmtResourceUsageType usage_type;     // the usage type of the resource.
+    RmtResourceType      resource_type;  // the type of the resource.
+    RmtCommitType        commit_type;    // the commit type of the resource.
+} ResourceFields;
+
+// the resources of a snapshot sorted by identifier.
+typedef struct SortedResourceList
+{
+    const RmtResourceList* resource_list;  // the resource list that was sorted.
+    ResourceKey*           keys;           // the keys sorted by identifier, followed by the scratch space for sorting.
+    ResourceFields*        fields;         // the compared fields of each resource, in resource list order.
+    int32_t                count;          // the number of resources.
+} SortedResourceList;
+
+// sort the resources of a snapshot by identifier. the identifiers are sorted with a least significant
+// digit radix sort, which skips the digits that are the same for every resource.
+static RmtErrorCode SortResourcesByIdentifier(const RmtDataSnapshot* snapshot, SortedResourceList* out_sorted_resources)
+{
+    const int32_t resource_count        = snapshot->resource_list.resource_count;
+    out_sorted_resources->resource_list = &snapshot->resource_list;
+    out_sorted_resources->count         = resource_count;
+    out_sorted_resources->keys          = NULL;
+    out_sorted_resources->fields        = NULL;
+    if (resource_count == 0)
+    {
+        return RMT_OK;
+    }
+
+    ResourceKey*    keys           = (ResourceKey*)malloc(resource_count * 2 * sizeof(ResourceKey));
+    ResourceFields* fields         = (ResourceFields*)malloc(resource_count * sizeof(ResourceFields));
+    uint32_t*       bucket_offsets = (uint32_t*)malloc(RADIX_BUCKET_COUNT * sizeof(uint32_t));
+    if ((keys == NULL) || (fields == NULL) || (bucket_offsets == NULL))
+    {
+        free(keys);
+        free(fields);
+        free(bucket_offsets);
+        return RMT_ERROR_OUT_OF_MEMORY;
+    }
+
+    RmtResourceIdentifier all_identifier_bits = ~(RmtResourceIdentifier)0;
+    RmtResourceIdentifier any_identifier_bits = 0;
+    const RmtResourceListColumns* columns = &snapshot->resource_list.columns;
+    RMT_ASSERT(columns->count == resource_count);
+    for (int32_t current_resource_index = 0; current_resource_index < resource_count; ++current_resource_index)
+    {
+        const RmtResourceIdentifier identifier       = columns->identifiers[current_resource_index];
+        keys[current_resource_index].identifier      = identifier;
+        keys[current_resource_index].index           = current_resource_index;
+        fields[current_resource_index].address       = columns->addresses[current_resource_index];
+        fields[current_resource_index].size_in_bytes = columns->sizes_in_bytes[current_resource_index];
+        fields[current_resource_index].usage_type    = (RmtResourceUsageType)columns->usage_types[current_resource_index];
+        fields[current_resource_index].resource_type = (RmtResourceType)columns->resource_types[current_resource_index];
+        fields[current_resource_index].commit_type   = (RmtCommitType)columns->commit_types[current_resource_index];
+        all_identifier_bits &= identifier;
+        any_identifier_bits |= identifier;
+    }
+
+    ResourceKey* source      = keys;
+    ResourceKey* destination = keys + resource_count;
+    for (int32_t shift = 0; shift < 64; shift += RADIX_BITS)
+    {
+        // skip the digit if it is the same for every resource.
+        const RmtResourceIdentifier digit_mask = (RmtResourceIdentifier)(RADIX_BUCKET_COUNT - 1) << shift;
+        if ((all_identifier_bits & digit_mask) == (any_identifier_bits & digit_mask))
+        {
+            continue;
+        }
+
+        memset(bucket_offsets, 0, RADIX_BUCKET_COUNT * sizeof(uint32_t));
+        for (int32_t current_key_index = 0; current_key_index < resource_count; ++current_key_index)
+        {
+            bucket_offsets[(source[current_key_index].identifier >> shift) & (RADIX_BUCKET_COUNT - 1)]++;
+        }
+
+        uint32_t offset = 0;
+        for (int32_t current_bucket_index = 0; current_bucket_index < RADIX_BUCKET_COUNT; ++current_bucket_index)
+        {
+            const uint32_t bucket_count          = bucket_offsets[current_bucket_index];
+            bucket_offsets[current_bucket_index] = offset;
+            offset += bucket_count;
+        }
+
+        for (int32_t current_key_index = 0; current_key_index < resource_count; ++current_key_index)
+        {
+            const uint32_t bucket_index                 = (source[current_key_index].identifier >> shift) & (RADIX_BUCKET_COUNT - 1);
+            destination[bucket_offsets[bucket_index]++] = source[current_key_index];
+        }
+
+        ResourceKey* temp = source;
+        source            = destination;
+        destination       = temp;
+    }
+
+    // make sure the sorted keys are at the start of the array.
+    if (source != keys)
+    {
+        memcpy(keys, source, resource_count * sizeof(ResourceKey));
+    }
+
+    free(bucket_offsets);
+    out_sorted_resources->keys   = keys;
+    out_sorted_resources->fields = fields;
+    return RMT_OK;
+}
+
+// free the memory of a sorted resource list.
+static void DestroySortedResources(SortedResourceList* sorted_resources)
+{
+    free(sorted_resources->keys);
+    free(sorted_resources->fields);
+    sorted_resources->keys   = NULL;
+    sorted_resources->fields = NULL;
+}
+
+// add the per-heap totals of the virtual allocations of a snapshot to the deltas, with the sign of the snapshot.
+static void AccumulateHeapDeltas(const RmtDataSnapshot* snapshot, int32_t sign, RmtSnapshotDiff* out_snapshot_diff)
+{
+    for (int32_t current_heap_type_index = 0; current_heap_type_index < kRmtHeapTypeCount; ++current_heap_type_index)
+    {
+        const RmtSnapshotAllocationAggregate* allocations = &snapshot->aggregates.allocations_per_heap[current_heap_type_index];
+
+        RmtSnapshotDiffHeapDelta* heap_delta = &out_snapshot_diff->heap_deltas[current_heap_type_index];
+        heap_delta->allocated_size += sign * (int64_t)allocations->allocated_size;
+        heap_delta->allocated_and_bound += sign * (int64_t)allocations->bound_size;
+        heap_delta->allocated_and_unbound += sign * (int64_t)allocations->unbound_size;
+        heap_delta->allocation_count += sign * allocations->allocation_count;
+        heap_delta->resource_count += sign * allocations->resource_count;
+    }
+}
+
+// add a resource to the per-usage deltas, with the sign of the snapshot it came from.
+static void AccumulateResourceDeltas(const ResourceFields* fields, int32_t sign, RmtSnapshotDiff* out_snapshot_diff)
+{
+    out_snapshot_diff->resource_count_deltas[fields->usage_type] += sign;
+    out_snapshot_diff->resource_size_deltas[fields->usage_type] += sign * (int64_t)fields->size_in_bytes;
+}
+
+// append a record to the diff for the resource at a key index in one or both of the sorted lists.
+static void AddRecord(const SortedResourceList* base_resources,
+                      int32_t                   base_key_index,
+                      const SortedResourceList* diff_resources,
+                      int32_t                   diff_key_index,
+                      RmtSnapshotDiff*          out_snapshot_diff)
+{
+    const ResourceFields* base_fields = NULL;
+    const ResourceFields* diff_fields = NULL;
+
+    RmtSnapshotDiffRecord* record = &out_snapshot_diff->records[out_snapshot_diff->record_count++];
+    record->base_resource         = NULL;
+    record->diff_resource         = NULL;
+    if (base_key_index >= 0)
+    {
+        const int32_t resource_index = base_resources->keys[base_key_index].index;
+        record->base_resource        = &base_resources->resource_list->resources[resource_index];
+        base_fields                  = &base_resources->fields[resource_index];
+        AccumulateResourceDeltas(base_fields, -1, out_snapshot_diff);
+    }
+    if (diff_key_index >= 0)
+    {
+        const int32_t resource_index = diff_resources->keys[diff_key_index].index;
+        record->diff_resource        = &diff_resources->resource_list->resources[resource_index];
+        diff_fields                  = &diff_resources->fields[resource_index];
+        AccumulateResourceDeltas(diff_fields, 1, out_snapshot_diff);
+    }
+
+    if (base_fields == NULL)
+    {
+        record->type = kRmtSnapshotDiffRecordTypeAdded;
+    }
+    else if (diff_fields == NULL)
+    {
+        record->type = kRmtSnapshotDiffRecordTypeRemoved;
+    }
+    else if ((base_fields->size_in_bytes != diff_fields->size_in_bytes) || (base_fields->address != diff_fields->address) ||
+             (base_fields->resource_type != diff_fields->resource_type) || (base_fields->commit_type != diff_fields->commit_type))
+    {
+        record->type = kRmtSnapshotDiffRecordTypeChanged;
+    }
+    else
+    {
+        record->type = kRmtSnapshotDiffRecordTypeCommon;
+    }
+
+    out_snapshot_diff->record_count_per_type[record->type]++;
+    out_snapshot_diff->size_per_type[record->type] += (diff_fields != NULL) ? diff_fields->size_in_bytes : base_fields->size_in_bytes;
+}
+
+RmtErrorCode RmtSnapshotDiffGenerate(const RmtDataSnapshot* base_snapshot, const RmtDataSnapshot* diff_snapshot, RmtSnapshotDiff* out_snapshot_diff)
+{
+    RMT_ASSERT(base_snapshot);
+    RMT_ASSERT(diff_snapshot);
+    RMT_ASSERT(out_snapshot_diff);
+    RMT_RETURN_ON_ERROR(base_snapshot, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(diff_snapshot, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(out_snapshot_diff, RMT_ERROR_INVALID_POINTER);
+
+    memset(out_snapshot_diff, 0, sizeof(RmtSnapshotDiff));
+
+    AccumulateHeapDeltas(base_snapshot, -1, out_snapshot_diff);
+    AccumulateHeapDeltas(diff_snapshot, 1, out_snapshot_diff);
+
+    const int32_t maximum_record_count = base_snapshot->resource_list.resource_count + diff_snapshot->resource_list.resource_count;
+    if (maximum_record_count == 0)
+    {
+        return RMT_OK;
+    }
+
+    SortedResourceList base_resources;
+    SortedResourceList diff_resources;
+    const RmtErrorCode base_error_code = SortResourcesByIdentifier(base_snapshot, &base_resources);
+    const RmtErrorCode diff_error_code = SortResourcesByIdentifier(diff_snapshot, &diff_resources);
+    out_snapshot_diff->records         = (RmtSnapshotDiffRecord*)malloc(maximum_record_count * sizeof(RmtSnapshotDiffRecord));
+    if ((base_error_code != RMT_OK) || (diff_error_code != RMT_OK) || (out_snapshot_diff->records == NULL))
+    {
+        DestroySortedResources(&base_resources);
+        DestroySortedResources(&diff_resources);
+        RmtSnapshotDiffDestroy(out_snapshot_diff);
+        return RMT_ERROR_OUT_OF_MEMORY;
+    }
+
+    // walk both sorted lists together, emitting a record for each identifier in either of them.
+    int32_t base_key_index = 0;
+    int32_t diff_key_index = 0;
+    while ((base_key_index < base_resources.count) || (diff_key_index < diff_resources.count))
+    {
+        if ((diff_key_index == diff_resources.count) ||
+            ((base_key_index < base_resources.count) && (base_resources.keys[base_key_index].identifier < diff_resources.keys[diff_key_index].identifier)))
+        {
+            AddRecord(&base_resources, base_key_index, &diff_resources, -1, out_snapshot_diff);
+            base_key_index++;
+        }
+        else if ((base_key_index == base_resources.count) ||
+                 (diff_resources.keys[diff_key_index].identifier < base_resources.keys[base_key_index].identifier))
+        {
+            AddRecord(&base_resources, -1, &diff_resources, diff_key_index, out_snapshot_diff);
+            diff_key_index++;
+        }
+        else
+        {
+            AddRecord(&base_resources, base_key_index, &diff_resources, diff_key_index, out_snapshot_diff);
+            base_key_index++;
+            diff_key_index++;
+        }
+    }
+
+    DestroySortedResources(&base_resources);
+    DestroySortedResources(&diff_resources);
+    return RMT_OK;
+}
+
+RmtErrorCode RmtSnapshotDiffDestroy(RmtSnapshotDiff* snapshot_diff)
+{
+    RMT_RETURN_ON_ERROR(snapshot_diff, RMT_ERROR_INVALID_POINTER);
+
+    free(snapshot_diff->records);
+    snapshot_diff->records      = NULL;
+    snapshot_diff->record_count = 0;
+    return RMT_OK;
+}
@@ -0,0 +1,93 @@
+//=============================================================================
+/// Copyright (c) 2019-2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author
+/// \brief Structures and functions for comparing the resources and heaps of two snapshots.
+//=============================================================================
+
+#ifndef RMV_BACKEND_RMT_SNAPSHOT_DIFF_H_
+#define RMV_BACKEND_RMT_SNAPSHOT_DIFF_H_
+
+#include <rmt_types.h>
+#include <rmt_error.h>
+#include "rmt_resource_list.h"
+
+#ifdef __cpluplus
+extern "C" {
+#endif  // #ifdef __cplusplus
+
+typedef struct RmtDataSnapshot RmtDataSnapshot;
+
+/// An enumeration of the ways a resource can differ between two snapshots.
+typedef enum RmtSnapshotDiffRecordType
+{
+    kRmtSnapshotDiffRecordTypeCommon  = 0,  ///< The resource is in both snapshots and is unchanged.
+    kRmtSnapshotDiffRecordTypeChanged = 1,  ///< The resource is in both snapshots, but its size, address, type or commit type has changed.
+    kRmtSnapshotDiffRecordTypeAdded   = 2,  ///< The resource is only in the diff snapshot.
+    kRmtSnapshotDiffRecordTypeRemoved = 3,  ///< The resource is only in the base snapshot.
+
+    // Add above this.
+    kRmtSnapshotDiffRecordTypeCount
+} RmtSnapshotDiffRecordType;
+
+/// A structure encapsulating a single resource in one or both of the compared snapshots.
+typedef struct RmtSnapshotDiffRecord
+{
+    const RmtResource*        base_resource;  ///< A pointer to the resource in the base snapshot, or <c><i>NULL</i></c> if the resource was added.
+    const RmtResource*        diff_resource;  ///< A pointer to the resource in the diff snapshot, or <c><i>NULL</i></c> if the resource was removed.
+    RmtSnapshotDiffRecordType type;           ///< How the resource differs between the snapshots.
+} RmtSnapshotDiffRecord;
+
+/// A structure encapsulating the change in the virtual allocations preferring a heap.
+typedef struct RmtSnapshotDiffHeapDelta
+{
+    int64_t allocated_size;         ///< The change in the size of the virtual allocations.
+    int64_t allocated_and_bound;    ///< The change in the memory bound to resources.
+    int64_t allocated_and_unbound;  ///< The change in the memory not bound to any resource.
+    int32_t allocation_count;       ///< The change in the number of virtual allocations.
+    int32_t resource_count;         ///< The change in the number of resources in the virtual allocations.
+} RmtSnapshotDiffHeapDelta;
+
+/// A structure encapsulating the differences between two snapshots.
+typedef struct RmtSnapshotDiff
+{
+    RmtSnapshotDiffRecord*   records;                                                 ///< A pointer to an array of <c><i>RmtSnapshotDiffRecord</i></c> structures, sorted by resource identifier.
+    int32_t                  record_count;                                            ///< The number of records in <c><i>records</i></c>.
+    int32_t                  record_count_per_type[kRmtSnapshotDiffRecordTypeCount];  ///< The number of records of each record type.
+    uint64_t                 size_per_type[kRmtSnapshotDiffRecordTypeCount];          ///< The size of the resources of each record type, taken from the diff snapshot where possible.
+    RmtSnapshotDiffHeapDelta heap_deltas[kRmtHeapTypeCount];                          ///< The change in the virtual allocations whose preferred heap is each heap type.
+    int32_t                  resource_count_deltas[kRmtResourceUsageTypeCount];       ///< The change in the number of resources of each usage type.
+    int64_t                  resource_size_deltas[kRmtResourceUsageTypeCount];        ///< The change in the size of the resources of each usage type.
+} RmtSnapshotDiff;
+
+/// Compare two snapshots.
+///
+/// The resources of both snapshots are sorted by identifier and walked together once, so
+/// each resource produces a single record without any lookups. The per-heap deltas are
+/// gathered with a single pass over the virtual allocations of each snapshot.
+///
+/// @param [in]  base_snapshot                      A pointer to the <c><i>RmtDataSnapshot</i></c> to compare against.
+/// @param [in]  diff_snapshot                      A pointer to the <c><i>RmtDataSnapshot</i></c> to compare.
+/// @param [out] out_snapshot_diff                  A pointer to a <c><i>RmtSnapshotDiff</i></c> structure to populate.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because a parameter was <c><i>NULL</i></c>.
+/// @retval
+/// RMT_ERROR_OUT_OF_MEMORY                         The operation failed because memory could not be allocated.
+RmtErrorCode RmtSnapshotDiffGenerate(const RmtDataSnapshot* base_snapshot, const RmtDataSnapshot* diff_snapshot, RmtSnapshotDiff* out_snapshot_diff);
+
+/// Destroy a snapshot diff, freeing its records.
+///
+/// @param [in] snapshot_diff                       A pointer to a <c><i>RmtSnapshotDiff</i></c> structure to destroy.
+///
+/// @retval
+/// RMT_OK                                          The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER                       The operation failed because <c><i>snapshot_diff</i></c> was <c><i>NULL</i></c>.
+RmtErrorCode RmtSnapshotDiffDestroy(RmtSnapshotDiff* snapshot_diff);
+
+#ifdef __cpluplus
+}
+#endif  // #ifdef __cplusplus
+#endif  // #ifndef RMV_BACKEND_RMT_SNAPSHOT_DIFF_H_
@@ -5,7 +5,11 @@
 //=============================================================================
 
 #ifndef _WIN32
+#include <new>
 #include <thread>
+#include <sched.h>
+#include <stdio.h>
+#include <unistd.h>
 #endif  // #ifndef _WIN32
 
 #include <stdint.h>
@@ -72,3 +76,187 @@ RmtErrorCode RmtThreadWaitForExit(RmtThread* thread)
 
     return RMT_OK;
 }
+
+#ifndef _WIN32
+/* read the list of cpus belonging to a numa node from sysfs, in the "0-3,8-11" format. */
+static bool ReadNumaNodeCpuSet(int32_t node_index, cpu_set_t* out_cpu_set)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node_index);
+
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    CPU_ZERO(out_cpu_set);
+
+    int32_t first_cpu = 0;
+    while (fscanf(file, "%d", &first_cpu) == 1)
+    {
+        int32_t last_cpu  = first_cpu;
+        int     separator = fgetc(file);
+        if (separator == '-')
+        {
+            if (fscanf(file, "%d", &last_cpu) != 1)
+            {
+                break;
+            }
+            separator = fgetc(file);
+        }
+
+        for (int32_t cpu = first_cpu; cpu <= last_cpu && cpu < CPU_SETSIZE; ++cpu)
+        {
+            CPU_SET(cpu, out_cpu_set);
+        }
+
+        if (separator != ',')
+        {
+            break;
+        }
+    }
+
+    fclose(file);
+    return CPU_COUNT(out_cpu_set) > 0;
+}
+
+/* get the cpus of a numa node the calling thread is allowed to run on, respecting any affinity mask the process was started with. */
+static bool GetUsableNumaNodeCpuSet(int32_t node_index, cpu_set_t* out_cpu_set)
+{
+    if (!ReadNumaNodeCpuSet(node_index, out_cpu_set))
+    {
+        return false;
+    }
+
+    cpu_set_t affinity_cpu_set;
+    CPU_ZERO(&affinity_cpu_set);
+    if (sched_getaffinity(0, sizeof(affinity_cpu_set), &affinity_cpu_set) == 0)
+    {
+        CPU_AND(out_cpu_set, out_cpu_set, &affinity_cpu_set);
+    }
+
+    return CPU_COUNT(out_cpu_set) > 0;
+}
+#else
+/* get the processors of a numa node the calling thread is allowed to run on, respecting any affinity mask the process was started with. */
+static bool GetUsableNumaNodeProcessorMask(int32_t node_index, GROUP_AFFINITY* out_group_affinity)
+{
+    if (!GetNumaNodeProcessorMaskEx((USHORT)node_index, out_group_affinity))
+    {
+        return false;
+    }
+
+    // the process affinity mask only covers the group the calling thread is in.
+    GROUP_AFFINITY thread_group_affinity = {};
+    DWORD_PTR      process_mask          = 0;
+    DWORD_PTR      system_mask           = 0;
+    if (GetThreadGroupAffinity(GetCurrentThread(), &thread_group_affinity) && (thread_group_affinity.Group == out_group_affinity->Group) &&
+        GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) && (process_mask != 0))
+    {
+        out_group_affinity->Mask &= (KAFFINITY)process_mask;
+    }
+
+    return out_group_affinity->Mask != 0;
+}
+#endif  // #ifndef _WIN32
+
+/* get the number of hardware threads */
+int32_t RmtThreadGetHardwareThreadCount()
+{
+#ifdef _WIN32
+    const int32_t thread_count = (int32_t)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#else
+    // respect any affinity mask the process was started with.
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    int32_t thread_count = 0;
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+    {
+        thread_count = CPU_COUNT(&cpu_set);
+    }
+    else
+    {
+        thread_count = (int32_t)std::thread::hardware_concurrency();
+    }
+#endif  // #ifdef _WIN32
+
+    return (thread_count > 0) ? thread_count : 1;
+}
+
+/* get the number of numa nodes */
+int32_t RmtThreadGetNumaNodeCount()
+{
+#ifdef _WIN32
+    ULONG highest_node_number = 0;
+    if (!GetNumaHighestNodeNumber(&highest_node_number))
+    {
+        return 1;
+    }
+    return (int32_t)highest_node_number + 1;
+#else
+    int32_t node_count = 0;
+    char    path[64];
+    while (true)
+    {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", node_count);
+        if (access(path, F_OK) != 0)
+        {
+            break;
+        }
+        node_count++;
+    }
+    return (node_count > 0) ? node_count : 1;
+#endif  // #ifdef _WIN32
+}
+
+/* get the number of processors in a numa node the process may run on */
+int32_t RmtThreadGetNumaNodeProcessorCount(int32_t node_index)
+{
+    if ((node_index < 0) || (node_index >= RmtThreadGetNumaNodeCount()))
+    {
+        return 0;
+    }
+
+#ifdef _WIN32
+    GROUP_AFFINITY group_affinity = {};
+    if (!GetUsableNumaNodeProcessorMask(node_index, &group_affinity))
+    {
+        return 0;
+    }
+
+    int32_t   processor_count = 0;
+    KAFFINITY mask            = group_affinity.Mask;
+    while (mask != 0)
+    {
+        mask &= mask - 1;
+        processor_count++;
+    }
+    return processor_count;
+#else
+    cpu_set_t cpu_set;
+    if (!GetUsableNumaNodeCpuSet(node_index, &cpu_set))
+    {
+        return 0;
+    }
+    return CPU_COUNT(&cpu_set);
+#endif  // #ifdef _WIN32
+}
+
+/* restrict the calling thread to a numa node */
+RmtErrorCode RmtThreadSetCurrentThreadNumaNode(int32_t node_index)
+{
+    RMT_RETURN_ON_ERROR(node_index >= 0 && node_index < RmtThreadGetNumaNodeCount(), RMT_ERROR_INDEX_OUT_OF_RANGE);
+
+#ifdef _WIN32
+    GROUP_AFFINITY group_affinity = {};
+    RMT_RETURN_ON_ERROR(GetUsableNumaNodeProcessorMask(node_index, &group_affinity), RMT_ERROR_PLATFORM_FUNCTION_FAILED);
+    RMT_RETURN_ON_ERROR(SetThreadGroupAffinity(GetCurrentThread(), &group_affinity, NULL), RMT_ERROR_PLATFORM_FUNCTION_FAILED);
+#else
+    cpu_set_t cpu_set;
+    RMT_RETURN_ON_ERROR(GetUsableNumaNodeCpuSet(node_index, &cpu_set), RMT_ERROR_PLATFORM_FUNCTION_FAILED);
+    RMT_RETURN_ON_ERROR(sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0, RMT_ERROR_PLATFORM_FUNCTION_FAILED);
+#endif  // #ifdef _WIN32
+
+    return RMT_OK;
+}
@@ -58,6 +58,46 @@ RmtErrorCode RmtThreadCreate(RmtThread* thread, RmtThreadFunc thread_func, void*
 ///
 RmtErrorCode RmtThreadWaitForExit(RmtThread* thread);
 
+/// Get the number of hardware threads the process may run on.
+///
+/// @returns
+/// The number of logical processors available to the process, at least 1.
+///
+int32_t RmtThreadGetHardwareThreadCount();
+
+/// Get the number of NUMA nodes in the system.
+///
+/// @returns
+/// The number of NUMA nodes, 1 if the system is not NUMA or the topology can't be queried.
+///
+int32_t RmtThreadGetNumaNodeCount();
+
+/// Get the number of processors in a NUMA node that the process may run on.
+///
+/// Processors excluded by the affinity mask the process was started with aren't counted.
+///
+/// @param [in]     node_index                  The index of the NUMA node, in the range [0..<c><i>RmtThreadGetNumaNodeCount</i></c>-1].
+///
+/// @returns
+/// The number of usable processors in the node, 0 if there are none or <c><i>node_index</i></c> was not a valid node.
+///
+int32_t RmtThreadGetNumaNodeProcessorCount(int32_t node_index);
+
+/// Restrict the calling thread to run on the processors of a single NUMA node.
+///
+/// The thread is only allowed on the processors of the node that the process may run on.
+///
+/// @param [in]     node_index                  The index of the NUMA node, in the range [0..<c><i>RmtThreadGetNumaNodeCount</i></c>-1].
+///
+/// @retval
+/// RMT_OK                                      The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INDEX_OUT_OF_RANGE                The parameter <c><i>node_index</i></c> was not a valid node.
+/// @retval
+/// RMT_ERROR_PLATFORM_FUNCTION_FAILED          A platform-specific function failed, or none of the node's processors are usable.
+///
+RmtErrorCode RmtThreadSetCurrentThreadNumaNode(int32_t node_index);
+
 #ifdef __cplusplus
 }
 #endif  // #ifdef __cplusplus
@@ -13,6 +13,7 @@
 #include "rmt_data_snapshot.h"
 #include <rmt_assert.h>
 #include <string.h>  // memcpy
+#include <stdlib.h>  // qsort
 
 // Helper function to improve tree balance by hashing the handles.
 static RmtGpuAddress HashGpuAddress(RmtGpuAddress address)
@@ -755,3 +756,109 @@ RmtErrorCode RmtVirtualAllocationGetBackingStorageHistogram(const RmtDataSnapsho
 
     return RMT_OK;
 }
+
+// compare two GPU addresses for sorting.
+static int32_t AddressComparator(const void* a, const void* b)
+{
+    const RmtGpuAddress address_a = *(const RmtGpuAddress*)a;
+    const RmtGpuAddress address_b = *(const RmtGpuAddress*)b;
+    if (address_a == address_b)
+    {
+        return 0;
+    }
+    return (address_a > address_b) ? 1 : -1;
+}
+
+// count the addresses in a sorted array which are less than (or, if inclusive is true, less than or equal to) the address.
+static int32_t CountAddressesBefore(const RmtGpuAddress* addresses, int32_t address_count, RmtGpuAddress address, bool inclusive)
+{
+    int32_t first = 0;
+    int32_t last  = address_count;
+    while (first < last)
+    {
+        const int32_t middle = first + ((last - first) / 2);
+        if ((addresses[middle] < address) || (inclusive && (addresses[middle] == address)))
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+// calculate how many other resources alias each resource with a sweep over the sorted start and end
+// addresses of the resources, rather than comparing every pair of resources.
+RmtErrorCode RmtVirtualAllocationCalculateAliasCounts(RmtVirtualAllocation* virtual_allocation, RmtGpuAddress* scratch_addresses)
+{
+    RMT_ASSERT(virtual_allocation);
+    RMT_ASSERT(scratch_addresses);
+    RMT_RETURN_ON_ERROR(virtual_allocation, RMT_ERROR_INVALID_POINTER);
+    RMT_RETURN_ON_ERROR(scratch_addresses, RMT_ERROR_INVALID_POINTER);
+
+    RmtGpuAddress* start_addresses = scratch_addresses;
+    RmtGpuAddress* end_addresses   = start_addresses + virtual_allocation->resource_count;
+    RmtGpuAddress* empty_addresses = end_addresses + virtual_allocation->resource_count;
+
+    // heaps don't alias the resources placed in them. Empty resources are also grouped by address.
+    int32_t address_count       = 0;
+    int32_t empty_address_count = 0;
+    for (int32_t current_resource_index = 0; current_resource_index < virtual_allocation->resource_count; ++current_resource_index)
+    {
+        const RmtResource* current_resource = virtual_allocation->resources[current_resource_index];
+        if (current_resource->resource_type == kRmtResourceTypeHeap)
+        {
+            continue;
+        }
+
+        start_addresses[address_count] = current_resource->address;
+        end_addresses[address_count]   = current_resource->address + current_resource->size_in_bytes;
+        address_count++;
+
+        if (current_resource->size_in_bytes == 0)
+        {
+            empty_addresses[empty_address_count++] = current_resource->address;
+        }
+    }
+
+    qsort(start_addresses, address_count, sizeof(RmtGpuAddress), AddressComparator);
+    qsort(end_addresses, address_count, sizeof(RmtGpuAddress), AddressComparator);
+    qsort(empty_addresses, empty_address_count, sizeof(RmtGpuAddress), AddressComparator);
+
+    for (int32_t current_resource_index = 0; current_resource_index < virtual_allocation->resource_count; ++current_resource_index)
+    {
+        RmtResource* current_resource = virtual_allocation->resources[current_resource_index];
+        if (current_resource->resource_type == kRmtResourceTypeHeap)
+        {
+            continue;
+        }
+
+        const RmtGpuAddress resource_start_address = current_resource->address;
+        const RmtGpuAddress resource_end_address   = current_resource->address + current_resource->size_in_bytes;
+
+        // a resource overlaps every other resource which starts before it ends, except those that end before it starts.
+        const int32_t starting_before_end = CountAddressesBefore(start_addresses, address_count, resource_end_address, false);
+        const int32_t ending_before_start = CountAddressesBefore(end_addresses, address_count, resource_start_address, true);
+
+        if (resource_start_address < resource_end_address)
+        {
+            // the resource itself is in the first count but not the second.
+            current_resource->alias_count = starting_before_end - ending_before_start - 1;
+        }
+        else
+        {
+            // an empty resource only overlaps resources which span its address, and the empty resources at the
+            // same address (including this one) end before it starts without starting before it ends. They are
+            // the run of that address in the sorted empty addresses.
+            const int32_t empty_resource_count = CountAddressesBefore(empty_addresses, empty_address_count, resource_start_address, true) -
+                                                 CountAddressesBefore(empty_addresses, empty_address_count, resource_start_address, false);
+
+            current_resource->alias_count = starting_before_end - ending_before_start + empty_resource_count;
+        }
+    }
+
+    return RMT_OK;
+}
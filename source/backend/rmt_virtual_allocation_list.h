@@ -143,6 +143,20 @@ RmtErrorCode RmtVirtualAllocationGetBackingStorageHistogram(const RmtDataSnapsho
                                                             uint64_t*                   out_bytes_per_backing_storage_type,
                                                             uint64_t*                   out_histogram_total);
 
+/// Calculate the number of other resources that alias each resource bound to a virtual allocation.
+///
+/// The count is stored in the <c><i>alias_count</i></c> member of each resource. Heaps don't alias the resources placed in them,
+/// so they are skipped.
+///
+/// @param [in] virtual_allocation                  A pointer to a <c><i>RmtVirtualAllocation</i></c> structure.
+/// @param [in] scratch_addresses                   A pointer to a buffer of at least three times <c><i>resource_count</i></c> addresses to sort the resource addresses in.
+///
+/// @retval
+/// RMT_OK                                  The operation completed successfully.
+/// @retval
+/// RMT_ERROR_INVALID_POINTER               The operation failed because <c><i>virtual_allocation</i></c> or <c><i>scratch_addresses</i></c> was <c><i>NULL</i></c>.
+RmtErrorCode RmtVirtualAllocationCalculateAliasCounts(RmtVirtualAllocation* virtual_allocation, RmtGpuAddress* scratch_addresses);
+
 /// A structure encapsulating critical allocation identifier information.
 typedef struct RmtVirtualAllocationInterval
 {
@@ -0,0 +1,156 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Checks the resource alias counts against a pairwise overlap test.
+//=============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "rmt_resource_list.h"
+#include "rmt_virtual_allocation_list.h"
+
+/// The base address of the synthetic heap.
+static const uint64_t kHeapBaseAddress = 0x100000000ull;
+
+/// A small linear congruential generator, so every run builds the same heaps.
+/// \param state The state of the generator.
+/// \return The next pseudo-random value.
+static uint32_t NextRandom(uint64_t* state)
+{
+    *state = (*state * 6364136223846793005ull) + 1442695040888963407ull;
+    return static_cast<uint32_t>(*state >> 33);
+}
+
+/// Count the other resources which overlap a resource by comparing it against every other resource, as
+/// the alias count used to be calculated.
+/// \param virtual_allocation The allocation the resource is bound to.
+/// \param resource The resource to count the aliases of.
+/// \return The number of other non-heap resources which overlap the resource.
+static int32_t CountAliasesPairwise(const RmtVirtualAllocation* virtual_allocation, const RmtResource* resource)
+{
+    const RmtGpuAddress resource_start_address = resource->address;
+    const RmtGpuAddress resource_end_address   = resource->address + resource->size_in_bytes;
+
+    int32_t alias_count = 0;
+    for (int32_t current_resource_index = 0; current_resource_index < virtual_allocation->resource_count; ++current_resource_index)
+    {
+        const RmtResource* current_resource = virtual_allocation->resources[current_resource_index];
+        if ((current_resource == resource) || (current_resource->resource_type == kRmtResourceTypeHeap))
+        {
+            continue;
+        }
+
+        const RmtGpuAddress current_resource_start = current_resource->address;
+        const RmtGpuAddress current_resource_end   = current_resource->address + current_resource->size_in_bytes;
+        if ((resource_start_address >= current_resource_end) || (resource_end_address <= current_resource_start))
+        {
+            continue;
+        }
+
+        alias_count++;
+    }
+
+    return alias_count;
+}
+
+/// Build a heap of heavily overlapping resources and check the alias count of every resource.
+/// \param seed The seed of the random resource placement.
+/// \param resource_count The number of resources bound to the heap.
+/// \param heap_size The size of the heap, in bytes. Smaller heaps overlap more.
+/// \return true if every alias count matches the pairwise count, false if not.
+static bool CheckAliasCounts(uint64_t seed, int32_t resource_count, uint64_t heap_size)
+{
+    std::vector<RmtResource>   resources(resource_count);
+    std::vector<RmtResource*>  resource_pointers(resource_count);
+    std::vector<RmtGpuAddress> scratch_addresses(resource_count * 3);
+
+    RmtVirtualAllocation virtual_allocation;
+    memset(&virtual_allocation, 0, sizeof(virtual_allocation));
+    virtual_allocation.base_address   = kHeapBaseAddress;
+    virtual_allocation.resource_count = resource_count;
+    virtual_allocation.resources      = resource_pointers.data();
+
+    // Place resources at page and byte granularity, with some zero-sized resources sharing addresses and
+    // a heap resource spanning the whole allocation.
+    uint64_t random_state = seed;
+    for (int32_t current_resource_index = 0; current_resource_index < resource_count; ++current_resource_index)
+    {
+        RmtResource* resource = &resources[current_resource_index];
+        memset(resource, 0, sizeof(RmtResource));
+        resource->identifier       = current_resource_index;
+        resource->bound_allocation = &virtual_allocation;
+        resource->resource_type    = kRmtResourceTypeBuffer;
+
+        const uint32_t placement = NextRandom(&random_state) % 8;
+        if (current_resource_index == 0)
+        {
+            resource->resource_type = kRmtResourceTypeHeap;
+            resource->address       = kHeapBaseAddress;
+            resource->size_in_bytes = heap_size;
+        }
+        else if (placement == 0)
+        {
+            resource->address       = kHeapBaseAddress + ((NextRandom(&random_state) % 16) * 4096);
+            resource->size_in_bytes = 0;
+        }
+        else if (placement < 4)
+        {
+            resource->address       = kHeapBaseAddress + ((NextRandom(&random_state) % (heap_size / 4096)) * 4096);
+            resource->size_in_bytes = ((NextRandom(&random_state) % 16) + 1) * 4096;
+        }
+        else
+        {
+            resource->address       = kHeapBaseAddress + (NextRandom(&random_state) % heap_size);
+            resource->size_in_bytes = (NextRandom(&random_state) % (heap_size / 4)) + 1;
+        }
+
+        resource_pointers[current_resource_index] = resource;
+    }
+
+    if (RmtVirtualAllocationCalculateAliasCounts(&virtual_allocation, scratch_addresses.data()) != RMT_OK)
+    {
+        printf("Seed %llu: calculating the alias counts failed.\n", static_cast<unsigned long long>(seed));
+        return false;
+    }
+
+    bool succeeded = true;
+    for (int32_t current_resource_index = 0; current_resource_index < resource_count; ++current_resource_index)
+    {
+        const RmtResource* resource       = &resources[current_resource_index];
+        const int32_t      expected_count = (resource->resource_type == kRmtResourceTypeHeap) ? 0 : CountAliasesPairwise(&virtual_allocation, resource);
+        const int32_t      alias_count    = RmtResourceGetAliasCount(resource);
+        if (alias_count != expected_count)
+        {
+            printf("Seed %llu: resource %d at 0x%llx (%llu bytes) has %d aliases, expected %d.\n",
+                   static_cast<unsigned long long>(seed),
+                   current_resource_index,
+                   static_cast<unsigned long long>(resource->address),
+                   static_cast<unsigned long long>(resource->size_in_bytes),
+                   alias_count,
+                   expected_count);
+            succeeded = false;
+        }
+    }
+
+    return succeeded;
+}
+
+/// Main entry point.
+/// \return 0 if every alias count matched, or 1 if not.
+int main()
+{
+    bool succeeded = true;
+    for (uint64_t seed = 1; seed <= 32; ++seed)
+    {
+        succeeded = CheckAliasCounts(seed, 2, 64 * 1024) && succeeded;
+        succeeded = CheckAliasCounts(seed, 64, 64 * 1024) && succeeded;
+        succeeded = CheckAliasCounts(seed, 1000, 1024 * 1024) && succeeded;
+    }
+
+    printf("Alias counts %s.\n", succeeded ? "matched" : "did not match");
+    return succeeded ? 0 : 1;
+}
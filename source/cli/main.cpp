@@ -0,0 +1,927 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Main entry point of the command line trace analyzer.
+//=============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "rmt_error.h"
+#include "rmt_platform.h"
+#include "rmt_print.h"
+#include "rmt_util.h"
+#include "rmt_data_set.h"
+#include "rmt_data_snapshot.h"
+#include "rmt_data_timeline.h"
+#include "rmt_job_system.h"
+#include "rmt_resource_list.h"
+#include "rmt_snapshot_diff.h"
+
+#ifndef _WIN32
+#include "linux/safe_crt.h"
+#endif  // #ifndef _WIN32
+
+/// The number of buckets a timeline is reduced to if no bucket count is given.
+static const int32_t kDefaultTimelineBucketCount = 256;
+
+/// The largest number of worker threads which can be asked for.
+static const uint64_t kMaximumJobCount = 1024;
+
+/// The return code when every trace was analyzed.
+static const int kReturnCodeSuccess = 0;
+
+/// The return code when the command line couldn't be parsed.
+static const int kReturnCodeInvalidCommandLine = 1;
+
+/// The return code when one or more traces couldn't be analyzed.
+static const int kReturnCodeTraceFailed = 2;
+
+/// The names timelines are requested by on the command line.
+static const char* kTimelineTypeNames[kRmtDataTimelineTypeCount] = {
+    "process",
+    "page-size",
+    "committed",
+    "resource-count",
+    "resource-size",
+    "paging",
+    "virtual-memory",
+    "non-preferred",
+};
+
+/// The names of the resource usage types in the output.
+static const char* kResourceUsageTypeNames[kRmtResourceUsageTypeCount] = {
+    "Unknown",
+    "Depth stencil buffer",
+    "Render target",
+    "Texture",
+    "Vertex buffer",
+    "Index buffer",
+    "UAV",
+    "Shader pipeline",
+    "Command buffer",
+    "Heap",
+    "Descriptors",
+    "Multi-use buffer",
+    "GPU event",
+    "Unbound",
+    "Internal",
+};
+
+/// The names of the snapshot diff record types in the output.
+static const char* kSnapshotDiffRecordTypeNames[kRmtSnapshotDiffRecordTypeCount] = {
+    "common",
+    "changed",
+    "added",
+    "removed",
+};
+
+/// The options given on the command line.
+struct CommandLineOptions
+{
+    std::vector<std::string>                         trace_paths;            ///< The traces to analyze.
+    std::vector<std::string>                         snapshots;              ///< The snapshots to generate, by name or timestamp.
+    std::vector<std::pair<std::string, std::string>> diffs;                  ///< The pairs of snapshots to compare, by name or timestamp.
+    std::vector<RmtDataTimelineType>                 timelines;              ///< The timelines to generate.
+    int32_t                                          timeline_bucket_count;  ///< The number of buckets each timeline is reduced to.
+    int32_t                                          job_count;              ///< The number of worker threads.
+    std::string                                      output_directory;       ///< The directory to write the reports to, or empty for stdout.
+    bool                                             write_cache;            ///< If true, open the traces writable so generated data is kept in their cache files.
+};
+
+/// Builds a JSON document in memory.
+///
+/// Values are written in order, and the writer only keeps track of where the
+/// commas go, so a report is built in a single pass without a DOM.
+class JsonWriter
+{
+public:
+    /// Constructor.
+    JsonWriter()
+        : needs_comma_(false)
+        , depth_(0)
+    {
+    }
+
+    /// Start an object.
+    /// \param key The key of the object, or nullptr if it is in an array or at the root.
+    void BeginObject(const char* key = nullptr)
+    {
+        WriteKey(key);
+        text_ += '{';
+        needs_comma_ = false;
+        depth_++;
+    }
+
+    /// End the current object.
+    void EndObject()
+    {
+        depth_--;
+        WriteNewLine();
+        text_ += '}';
+        needs_comma_ = true;
+    }
+
+    /// Start an array.
+    /// \param key The key of the array, or nullptr if it is in an array or at the root.
+    void BeginArray(const char* key = nullptr)
+    {
+        WriteKey(key);
+        text_ += '[';
+        needs_comma_ = false;
+        depth_++;
+    }
+
+    /// End the current array.
+    void EndArray()
+    {
+        depth_--;
+        WriteNewLine();
+        text_ += ']';
+        needs_comma_ = true;
+    }
+
+    /// Write a string value.
+    /// \param key The key of the value, or nullptr if it is in an array.
+    /// \param value The string to write.
+    void String(const char* key, const char* value)
+    {
+        WriteKey(key);
+        WriteEscaped(value);
+        needs_comma_ = true;
+    }
+
+    /// Write an unsigned integer value.
+    /// \param key The key of the value, or nullptr if it is in an array.
+    /// \param value The value to write.
+    void Unsigned(const char* key, uint64_t value)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+        WriteRaw(key, buffer);
+    }
+
+    /// Write a signed integer value.
+    /// \param key The key of the value, or nullptr if it is in an array.
+    /// \param value The value to write.
+    void Signed(const char* key, int64_t value)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+        WriteRaw(key, buffer);
+    }
+
+    /// Write a floating point value.
+    /// \param key The key of the value, or nullptr if it is in an array.
+    /// \param value The value to write.
+    void Double(const char* key, double value)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.3f", value);
+        WriteRaw(key, buffer);
+    }
+
+    /// Get the document written so far.
+    /// \return The JSON text.
+    const std::string& GetText() const
+    {
+        return text_;
+    }
+
+private:
+    /// Write the separator and key before a value.
+    /// \param key The key of the value, or nullptr if it is in an array or at the root.
+    void WriteKey(const char* key)
+    {
+        if (needs_comma_)
+        {
+            text_ += ',';
+        }
+        if (depth_ > 0)
+        {
+            WriteNewLine();
+        }
+        if (key != nullptr)
+        {
+            WriteEscaped(key);
+            text_ += ": ";
+        }
+        needs_comma_ = false;
+    }
+
+    /// Write a quoted string, escaping the characters JSON doesn't allow in strings.
+    /// \param value The string to write.
+    void WriteEscaped(const char* value)
+    {
+        text_ += '"';
+        for (const char* current_character = value; *current_character != '\0'; ++current_character)
+        {
+            const unsigned char character = static_cast<unsigned char>(*current_character);
+            if (character == '"' || character == '\\')
+            {
+                text_ += '\\';
+                text_ += static_cast<char>(character);
+            }
+            else if (character < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+                text_ += escaped;
+            }
+            else
+            {
+                text_ += static_cast<char>(character);
+            }
+        }
+        text_ += '"';
+    }
+
+    /// Write a value which needs no escaping.
+    /// \param key The key of the value, or nullptr if it is in an array.
+    /// \param value The text of the value.
+    void WriteRaw(const char* key, const char* value)
+    {
+        WriteKey(key);
+        text_ += value;
+        needs_comma_ = true;
+    }
+
+    /// Start a new line, indented to the current depth.
+    void WriteNewLine()
+    {
+        text_ += '\n';
+        text_.append(depth_ * 2, ' ');
+    }
+
+    std::string text_;         ///< The document.
+    bool        needs_comma_;  ///< Set when the next value needs a comma before it.
+    int32_t     depth_;        ///< The number of objects and arrays the writer is inside.
+};
+
+/// The result of analyzing one trace.
+struct TraceReport
+{
+    std::string path;          ///< The path of the trace.
+    std::string json;          ///< The report.
+    bool        succeeded;     ///< Set if the trace was analyzed.
+    double      elapsed_time;  ///< The time taken to analyze the trace, in milliseconds.
+};
+
+/// The input to the job which analyzes each trace.
+struct TraceJobInput
+{
+    const CommandLineOptions* options;  ///< The command line options.
+    std::vector<TraceReport>* reports;  ///< The report of each trace, in the same order as the trace paths.
+};
+
+/// A snapshot generated from a trace, and the name or timestamp it was requested by.
+struct GeneratedSnapshot
+{
+    std::string       specifier;       ///< The name or timestamp given on the command line.
+    RmtSnapshotPoint* snapshot_point;  ///< The snapshot point the snapshot was generated from.
+    RmtDataSnapshot*  snapshot;        ///< The snapshot, or nullptr if it couldn't be generated.
+};
+
+/// Get the time elapsed since a timestamp.
+/// \param start_timestamp The timestamp returned by RmtGetCurrentTimestamp.
+/// \return The elapsed time, in milliseconds.
+static double GetElapsedMilliseconds(uint64_t start_timestamp)
+{
+    const uint64_t elapsed_ticks = RmtGetCurrentTimestamp() - start_timestamp;
+    return (static_cast<double>(elapsed_ticks) * 1000.0) / static_cast<double>(RmtGetClockFrequency());
+}
+
+/// Parse an unsigned integer, failing if there is anything after the number.
+/// \param text The text to parse.
+/// \param out_value The parsed value.
+/// \return true if the whole of the text is a number.
+static bool ParseUnsigned(const char* text, uint64_t* out_value)
+{
+    char* end = nullptr;
+    *out_value = strtoull(text, &end, 0);
+    return (end != text) && (*end == '\0');
+}
+
+/// Print how to use the analyzer.
+static void PrintUsage()
+{
+    fprintf(stderr,
+            "Usage: rmv_cli [options] <trace.rmv> [<trace.rmv> ...]\n"
+            "\n"
+            "Generates snapshots, snapshot comparisons and timelines from RMV traces and\n"
+            "writes a JSON report for each trace.\n"
+            "\n"
+            "Options:\n"
+            "  --snapshot <name|timestamp>   Generate and summarize a snapshot. May be repeated. If no\n"
+            "                                snapshots or comparisons are given, every snapshot in the\n"
+            "                                trace is summarized.\n"
+            "  --diff <base> <diff>          Compare two snapshots, listing the resources only in <diff>.\n"
+            "                                May be repeated.\n"
+            "  --timeline <type>             Generate a timeline. May be repeated. The types are process,\n"
+            "                                page-size, committed, resource-count, resource-size, paging,\n"
+            "                                virtual-memory and non-preferred.\n"
+            "  --timeline-buckets <count>    The number of buckets each timeline is reduced to (default %d).\n"
+            "  --jobs <count>                The number of worker threads (default one per hardware thread).\n"
+            "  --output-dir <directory>      Write <trace>.json to a directory instead of the reports to stdout.\n"
+            "  --cache                       Keep the generated snapshots and timelines in <trace>.rmv.cache\n"
+            "                                for later runs. The traces are opened writable to do this, and\n"
+            "                                are otherwise opened read only.\n",
+            kDefaultTimelineBucketCount);
+}
+
+/// Parse the command line.
+/// \param argc The number of arguments.
+/// \param argv An array containing arguments.
+/// \param out_options The parsed options.
+/// \return true if the command line was valid.
+static bool ParseCommandLine(int argc, char* argv[], CommandLineOptions* out_options)
+{
+    out_options->timeline_bucket_count = kDefaultTimelineBucketCount;
+    out_options->job_count             = RMT_JOB_QUEUE_DEFAULT_WORKER_THREAD_COUNT;
+    out_options->write_cache           = false;
+
+    for (int argument_index = 1; argument_index < argc; ++argument_index)
+    {
+        const char* argument       = argv[argument_index];
+        const int   remaining      = argc - argument_index - 1;
+        uint64_t    parsed_integer = 0;
+
+        if ((strcmp(argument, "--snapshot") == 0) && (remaining >= 1))
+        {
+            out_options->snapshots.push_back(argv[++argument_index]);
+        }
+        else if ((strcmp(argument, "--diff") == 0) && (remaining >= 2))
+        {
+            out_options->diffs.push_back(std::make_pair(std::string(argv[argument_index + 1]), std::string(argv[argument_index + 2])));
+            argument_index += 2;
+        }
+        else if ((strcmp(argument, "--timeline") == 0) && (remaining >= 1))
+        {
+            const char* type_name = argv[++argument_index];
+            int32_t     type      = 0;
+            while ((type < kRmtDataTimelineTypeCount) && (strcmp(type_name, kTimelineTypeNames[type]) != 0))
+            {
+                type++;
+            }
+            if (type == kRmtDataTimelineTypeCount)
+            {
+                fprintf(stderr, "Unknown timeline type '%s'.\n", type_name);
+                return false;
+            }
+            out_options->timelines.push_back(static_cast<RmtDataTimelineType>(type));
+        }
+        else if ((strcmp(argument, "--timeline-buckets") == 0) && (remaining >= 1) && ParseUnsigned(argv[++argument_index], &parsed_integer) &&
+                 (parsed_integer > 0) && (parsed_integer <= INT32_MAX))
+        {
+            out_options->timeline_bucket_count = static_cast<int32_t>(parsed_integer);
+        }
+        else if ((strcmp(argument, "--jobs") == 0) && (remaining >= 1) && ParseUnsigned(argv[++argument_index], &parsed_integer) &&
+                 (parsed_integer > 0) && (parsed_integer <= kMaximumJobCount))
+        {
+            out_options->job_count = static_cast<int32_t>(parsed_integer);
+        }
+        else if ((strcmp(argument, "--output-dir") == 0) && (remaining >= 1))
+        {
+            out_options->output_directory = argv[++argument_index];
+        }
+        else if (strcmp(argument, "--cache") == 0)
+        {
+            out_options->write_cache = true;
+        }
+        else if (argument[0] == '-')
+        {
+            fprintf(stderr, "Invalid option '%s'.\n", argument);
+            return false;
+        }
+        else
+        {
+            out_options->trace_paths.push_back(argument);
+        }
+    }
+
+    return !out_options->trace_paths.empty();
+}
+
+/// Find the snapshot point a snapshot was requested by.
+///
+/// Names are matched against the snapshots saved in the trace first. Otherwise the
+/// specifier is treated as a timestamp, which uses the saved snapshot at that time if
+/// there is one, or a new snapshot point which isn't added to the trace.
+///
+/// \param data_set The data set to search.
+/// \param specifier The name or timestamp of the snapshot.
+/// \param local_snapshot_points The snapshot points created for timestamps. Reserved up front so the points don't move.
+/// \return The snapshot point, or nullptr if the specifier isn't a name or a timestamp.
+static RmtSnapshotPoint* FindSnapshotPoint(RmtDataSet* data_set, const std::string& specifier, std::vector<RmtSnapshotPoint>* local_snapshot_points)
+{
+    for (int32_t snapshot_index = 0; snapshot_index < data_set->snapshot_count; ++snapshot_index)
+    {
+        if (specifier == data_set->snapshots[snapshot_index].name)
+        {
+            return &data_set->snapshots[snapshot_index];
+        }
+    }
+
+    uint64_t timestamp = 0;
+    if (!ParseUnsigned(specifier.c_str(), &timestamp))
+    {
+        return nullptr;
+    }
+
+    for (int32_t snapshot_index = 0; snapshot_index < data_set->snapshot_count; ++snapshot_index)
+    {
+        if (data_set->snapshots[snapshot_index].timestamp == timestamp)
+        {
+            return &data_set->snapshots[snapshot_index];
+        }
+    }
+
+    RmtSnapshotPoint snapshot_point = {};
+    snprintf(snapshot_point.name, sizeof(snapshot_point.name), "%s", specifier.c_str());
+    snapshot_point.timestamp = timestamp;
+    local_snapshot_points->push_back(snapshot_point);
+    return &local_snapshot_points->back();
+}
+
+/// Find a snapshot which has already been generated.
+/// \param snapshots The generated snapshots.
+/// \param specifier The name or timestamp the snapshot was requested by.
+/// \return The snapshot, or nullptr if it hasn't been generated.
+static const GeneratedSnapshot* FindGeneratedSnapshot(const std::vector<GeneratedSnapshot>& snapshots, const std::string& specifier)
+{
+    for (const GeneratedSnapshot& generated_snapshot : snapshots)
+    {
+        if (generated_snapshot.specifier == specifier)
+        {
+            return &generated_snapshot;
+        }
+    }
+    return nullptr;
+}
+
+/// Write the summary of a snapshot.
+/// \param writer The writer to add the summary to.
+/// \param snapshot The snapshot to summarize.
+/// \param elapsed_time The time taken to generate the snapshot, in milliseconds.
+static void WriteSnapshotSummary(JsonWriter* writer, const RmtDataSnapshot* snapshot, double elapsed_time)
+{
+    const RmtSnapshotAggregates* aggregates     = &snapshot->aggregates;
+    const RmtSnapshotPoint*      snapshot_point = snapshot->snapshot_point;
+
+    writer->BeginObject();
+    writer->String("name", snapshot->name);
+    writer->Unsigned("timestamp", snapshot->timestamp);
+    writer->Double("generation_time_ms", elapsed_time);
+    writer->Signed("virtual_allocation_count", aggregates->all_allocations.allocation_count);
+    writer->Unsigned("allocated_size", aggregates->all_allocations.allocated_size);
+    writer->Unsigned("bound_size", aggregates->all_allocations.bound_size);
+    writer->Unsigned("unbound_size", aggregates->all_allocations.unbound_size);
+    writer->Signed("resource_count", snapshot->resource_list.resource_count);
+    writer->Unsigned("largest_resource_size", RmtDataSnapshotGetLargestResourceSize(snapshot));
+
+    writer->BeginArray("heaps");
+    for (int32_t heap_index = 0; heap_index < kRmtHeapTypeCount; ++heap_index)
+    {
+        const RmtSnapshotAllocationAggregate* heap = &aggregates->allocations_per_heap[heap_index];
+        writer->BeginObject();
+        writer->String("heap", RmtGetHeapTypeNameFromHeapType(static_cast<RmtHeapType>(heap_index)));
+        writer->Signed("virtual_allocation_count", heap->allocation_count);
+        writer->Unsigned("allocated_size", heap->allocated_size);
+        writer->Unsigned("bound_size", heap->bound_size);
+        writer->Unsigned("unbound_size", heap->unbound_size);
+        writer->Unsigned("committed_size", snapshot_point->committed_memory[heap_index]);
+        writer->EndObject();
+    }
+    writer->EndArray();
+
+    writer->BeginArray("resource_usages");
+    for (int32_t usage_index = 0; usage_index < kRmtResourceUsageTypeCount; ++usage_index)
+    {
+        if (snapshot->resource_list.resource_usage_count[usage_index] == 0)
+        {
+            continue;
+        }
+        writer->BeginObject();
+        writer->String("usage", kResourceUsageTypeNames[usage_index]);
+        writer->Signed("resource_count", snapshot->resource_list.resource_usage_count[usage_index]);
+        writer->Unsigned("size", snapshot->resource_list.resource_usage_size[usage_index]);
+        writer->EndObject();
+    }
+    writer->EndArray();
+
+    writer->EndObject();
+}
+
+/// Write the comparison of two snapshots. The resources only in the diff snapshot are listed, as
+/// they are the resources which were created and not destroyed between the snapshots.
+/// \param writer The writer to add the comparison to.
+/// \param base_snapshot The snapshot to compare against.
+/// \param diff_snapshot The snapshot to compare.
+/// \param snapshot_diff The comparison of the snapshots.
+static void WriteSnapshotDiff(JsonWriter*            writer,
+                              const RmtDataSnapshot* base_snapshot,
+                              const RmtDataSnapshot* diff_snapshot,
+                              const RmtSnapshotDiff* snapshot_diff)
+{
+    writer->String("base", base_snapshot->name);
+    writer->String("diff", diff_snapshot->name);
+
+    writer->BeginObject("records");
+    for (int32_t type_index = 0; type_index < kRmtSnapshotDiffRecordTypeCount; ++type_index)
+    {
+        writer->BeginObject(kSnapshotDiffRecordTypeNames[type_index]);
+        writer->Signed("resource_count", snapshot_diff->record_count_per_type[type_index]);
+        writer->Unsigned("size", snapshot_diff->size_per_type[type_index]);
+        writer->EndObject();
+    }
+    writer->EndObject();
+
+    writer->BeginArray("heap_deltas");
+    for (int32_t heap_index = 0; heap_index < kRmtHeapTypeCount; ++heap_index)
+    {
+        const RmtSnapshotDiffHeapDelta* heap_delta = &snapshot_diff->heap_deltas[heap_index];
+        writer->BeginObject();
+        writer->String("heap", RmtGetHeapTypeNameFromHeapType(static_cast<RmtHeapType>(heap_index)));
+        writer->Signed("virtual_allocation_count", heap_delta->allocation_count);
+        writer->Signed("resource_count", heap_delta->resource_count);
+        writer->Signed("allocated_size", heap_delta->allocated_size);
+        writer->Signed("bound_size", heap_delta->allocated_and_bound);
+        writer->Signed("unbound_size", heap_delta->allocated_and_unbound);
+        writer->EndObject();
+    }
+    writer->EndArray();
+
+    writer->BeginArray("added_resources");
+    for (int32_t record_index = 0; record_index < snapshot_diff->record_count; ++record_index)
+    {
+        const RmtSnapshotDiffRecord* record = &snapshot_diff->records[record_index];
+        if (record->type != kRmtSnapshotDiffRecordTypeAdded)
+        {
+            continue;
+        }
+
+        const RmtResource* resource = record->diff_resource;
+        writer->BeginObject();
+        writer->Unsigned("identifier", resource->identifier);
+        writer->Unsigned("address", resource->address);
+        writer->Unsigned("size", resource->size_in_bytes);
+        writer->Unsigned("create_time", resource->create_time);
+        writer->String("type", RmtGetResourceTypeNameFromResourceType(resource->resource_type));
+        writer->String("usage", kResourceUsageTypeNames[RmtResourceGetUsageType(resource)]);
+        writer->String("heap", RmtResourceGetHeapTypeName(resource));
+        writer->EndObject();
+    }
+    writer->EndArray();
+}
+
+/// Write a timeline, reduced to a number of buckets by taking the largest value in each.
+/// \param writer The writer to add the timeline to.
+/// \param timeline The timeline to write.
+/// \param bucket_count The number of buckets to reduce each series to.
+static void WriteTimeline(JsonWriter* writer, const RmtDataTimeline* timeline, int32_t bucket_count)
+{
+    writer->String("type", kTimelineTypeNames[timeline->timeline_type]);
+    writer->Unsigned("maximum_timestamp", timeline->max_timestamp);
+    writer->Unsigned("maximum_value", timeline->maximum_value_in_all_series);
+    writer->Signed("bucket_count", bucket_count);
+
+    writer->BeginArray("series");
+    for (int32_t series_index = 0; series_index < timeline->series_count; ++series_index)
+    {
+        const RmtDataTimelineSeriesLevel* level = &timeline->series[series_index].levels[0];
+        writer->BeginArray();
+        for (int32_t bucket_index = 0; bucket_index < bucket_count; ++bucket_index)
+        {
+            const int64_t start_index = (static_cast<int64_t>(bucket_index) * level->value_count) / bucket_count;
+            const int64_t end_index   = (static_cast<int64_t>(bucket_index + 1) * level->value_count) / bucket_count;
+            uint64_t      value       = 0;
+            for (int64_t value_index = start_index; value_index < end_index; ++value_index)
+            {
+                value = (level->values[value_index] > value) ? level->values[value_index] : value;
+            }
+            writer->Unsigned(nullptr, value);
+        }
+        writer->EndArray();
+    }
+    writer->EndArray();
+}
+
+/// Write the time taken by a phase of the analysis.
+/// \param writer The writer to add the timing to.
+/// \param phase The name of the phase.
+/// \param elapsed_time The time taken, in milliseconds.
+static void WriteTiming(JsonWriter* writer, const std::string& phase, double elapsed_time)
+{
+    writer->BeginObject();
+    writer->String("phase", phase.c_str());
+    writer->Double("time_ms", elapsed_time);
+    writer->EndObject();
+}
+
+/// Analyze a trace.
+///
+/// The snapshots and comparisons are written first, then the timelines. Each snapshot
+/// is kept until the comparisons are done, as a snapshot may be compared more than once.
+///
+/// \param options The command line options.
+/// \param path The path of the trace.
+/// \param out_report The report of the trace.
+static void AnalyzeTrace(const CommandLineOptions& options, const std::string& path, TraceReport* out_report)
+{
+    const uint64_t trace_start_timestamp = RmtGetCurrentTimestamp();
+
+    out_report->path         = path;
+    out_report->succeeded    = false;
+    out_report->elapsed_time = 0.0;
+
+    JsonWriter writer;
+    writer.BeginObject();
+    writer.String("trace", path.c_str());
+
+    // the data set is too large for the stack of a worker thread.
+    RmtDataSet* data_set = static_cast<RmtDataSet*>(calloc(1, sizeof(RmtDataSet)));
+    if (data_set == nullptr)
+    {
+        writer.String("error", "Out of memory.");
+        writer.EndObject();
+        out_report->json = writer.GetText();
+        return;
+    }
+
+    uint64_t           phase_start_timestamp = RmtGetCurrentTimestamp();
+    const RmtErrorCode error_code            = RmtDataSetInitialize(path.c_str(), !options.write_cache, nullptr, data_set);
+    const double       load_time             = GetElapsedMilliseconds(phase_start_timestamp);
+    if (error_code != RMT_OK)
+    {
+        char error_message[64];
+        snprintf(error_message, sizeof(error_message), "The trace couldn't be loaded (error 0x%08x).", static_cast<unsigned int>(error_code));
+        writer.String("error", error_message);
+        writer.EndObject();
+        out_report->json         = writer.GetText();
+        out_report->elapsed_time = GetElapsedMilliseconds(trace_start_timestamp);
+        free(data_set);
+        return;
+    }
+
+    std::vector<std::pair<std::string, double>> timings;
+    timings.push_back(std::make_pair(std::string("load"), load_time));
+
+    writer.Unsigned("maximum_timestamp", data_set->maximum_timestamp);
+    writer.Unsigned("cpu_frequency", data_set->cpu_frequency);
+
+    // gather every snapshot needed, once each. If nothing is asked for, all the saved snapshots are summarized.
+    std::vector<std::string> specifiers = options.snapshots;
+    for (const std::pair<std::string, std::string>& diff : options.diffs)
+    {
+        specifiers.push_back(diff.first);
+        specifiers.push_back(diff.second);
+    }
+    if (specifiers.empty())
+    {
+        for (int32_t snapshot_index = 0; snapshot_index < data_set->snapshot_count; ++snapshot_index)
+        {
+            specifiers.push_back(data_set->snapshots[snapshot_index].name);
+        }
+    }
+
+    std::vector<RmtSnapshotPoint> local_snapshot_points;
+    local_snapshot_points.reserve(specifiers.size());
+    std::vector<GeneratedSnapshot> generated_snapshots;
+    bool                           succeeded = true;
+
+    writer.BeginArray("snapshots");
+    for (const std::string& specifier : specifiers)
+    {
+        if (FindGeneratedSnapshot(generated_snapshots, specifier) != nullptr)
+        {
+            continue;
+        }
+
+        GeneratedSnapshot generated_snapshot = {specifier, FindSnapshotPoint(data_set, specifier, &local_snapshot_points), nullptr};
+        if (generated_snapshot.snapshot_point != nullptr)
+        {
+            // calloc leaves the page table untouched until the snapshot uses it.
+            generated_snapshot.snapshot = static_cast<RmtDataSnapshot*>(calloc(1, sizeof(RmtDataSnapshot)));
+        }
+
+        phase_start_timestamp = RmtGetCurrentTimestamp();
+        if ((generated_snapshot.snapshot != nullptr) &&
+            (RmtDataSetGenerateSnapshot(data_set, generated_snapshot.snapshot_point, nullptr, generated_snapshot.snapshot) != RMT_OK))
+        {
+            free(generated_snapshot.snapshot);
+            generated_snapshot.snapshot = nullptr;
+        }
+        const double snapshot_time = GetElapsedMilliseconds(phase_start_timestamp);
+
+        if (generated_snapshot.snapshot != nullptr)
+        {
+            WriteSnapshotSummary(&writer, generated_snapshot.snapshot, snapshot_time);
+            timings.push_back(std::make_pair("snapshot " + specifier, snapshot_time));
+        }
+        else
+        {
+            writer.BeginObject();
+            writer.String("name", specifier.c_str());
+            writer.String("error", (generated_snapshot.snapshot_point == nullptr) ? "No snapshot with this name." : "The snapshot couldn't be generated.");
+            writer.EndObject();
+            succeeded = false;
+        }
+        generated_snapshots.push_back(generated_snapshot);
+    }
+    writer.EndArray();
+
+    writer.BeginArray("diffs");
+    for (const std::pair<std::string, std::string>& diff : options.diffs)
+    {
+        const RmtDataSnapshot* base_snapshot = FindGeneratedSnapshot(generated_snapshots, diff.first)->snapshot;
+        const RmtDataSnapshot* diff_snapshot = FindGeneratedSnapshot(generated_snapshots, diff.second)->snapshot;
+        if ((base_snapshot == nullptr) || (diff_snapshot == nullptr))
+        {
+            // the missing snapshot is already reported.
+            continue;
+        }
+
+        phase_start_timestamp         = RmtGetCurrentTimestamp();
+        RmtSnapshotDiff snapshot_diff = {};
+        if (RmtSnapshotDiffGenerate(base_snapshot, diff_snapshot, &snapshot_diff) != RMT_OK)
+        {
+            writer.BeginObject();
+            writer.String("base", base_snapshot->name);
+            writer.String("diff", diff_snapshot->name);
+            writer.String("error", "The snapshots couldn't be compared.");
+            writer.EndObject();
+            succeeded = false;
+            continue;
+        }
+
+        writer.BeginObject();
+        WriteSnapshotDiff(&writer, base_snapshot, diff_snapshot, &snapshot_diff);
+        writer.EndObject();
+        RmtSnapshotDiffDestroy(&snapshot_diff);
+        timings.push_back(std::make_pair("diff " + diff.first + " " + diff.second, GetElapsedMilliseconds(phase_start_timestamp)));
+    }
+    writer.EndArray();
+
+    for (GeneratedSnapshot& generated_snapshot : generated_snapshots)
+    {
+        if (generated_snapshot.snapshot != nullptr)
+        {
+            RmtDataSnapshotDestroy(generated_snapshot.snapshot);
+            free(generated_snapshot.snapshot);
+        }
+    }
+
+    writer.BeginArray("timelines");
+    for (RmtDataTimelineType timeline_type : options.timelines)
+    {
+        phase_start_timestamp    = RmtGetCurrentTimestamp();
+        RmtDataTimeline timeline = {};
+        if (RmtDataSetGenerateTimeline(data_set, timeline_type, nullptr, &timeline) != RMT_OK)
+        {
+            writer.BeginObject();
+            writer.String("type", kTimelineTypeNames[timeline_type]);
+            writer.String("error", "The timeline couldn't be generated.");
+            writer.EndObject();
+            succeeded = false;
+            continue;
+        }
+
+        writer.BeginObject();
+        WriteTimeline(&writer, &timeline, options.timeline_bucket_count);
+        writer.EndObject();
+        RmtDataTimelineDestroy(&timeline);
+        timings.push_back(std::make_pair(std::string("timeline ") + kTimelineTypeNames[timeline_type], GetElapsedMilliseconds(phase_start_timestamp)));
+    }
+    writer.EndArray();
+
+    RmtDataSetDestroy(data_set);
+    free(data_set);
+
+    out_report->elapsed_time = GetElapsedMilliseconds(trace_start_timestamp);
+    timings.push_back(std::make_pair(std::string("total"), out_report->elapsed_time));
+
+    writer.BeginArray("timings");
+    for (const std::pair<std::string, double>& timing : timings)
+    {
+        WriteTiming(&writer, timing.first, timing.second);
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    out_report->json      = writer.GetText();
+    out_report->succeeded = succeeded;
+}
+
+/// The job which analyzes one of the traces.
+/// \param thread_id The worker thread running the job.
+/// \param index The index of the trace to analyze.
+/// \param input A pointer to the TraceJobInput.
+static void AnalyzeTraceJob(int32_t thread_id, int32_t index, void* input)
+{
+    RMT_UNUSED(thread_id);
+
+    const TraceJobInput* job_input = static_cast<const TraceJobInput*>(input);
+    AnalyzeTrace(*job_input->options, job_input->options->trace_paths[index], &(*job_input->reports)[index]);
+}
+
+/// Get the path of the report for a trace in the output directory.
+/// \param output_directory The directory the reports are written to.
+/// \param trace_path The path of the trace.
+/// \return The path of the report.
+static std::string GetReportPath(const std::string& output_directory, const std::string& trace_path)
+{
+    const size_t      separator_position = trace_path.find_last_of("/\\");
+    const std::string file_name          = (separator_position == std::string::npos) ? trace_path : trace_path.substr(separator_position + 1);
+    const char        last_character     = output_directory.empty() ? '/' : output_directory[output_directory.size() - 1];
+    const bool        has_separator      = (last_character == '/') || (last_character == '\\');
+    return output_directory + (has_separator ? "" : "/") + file_name + ".json";
+}
+
+/// Write the reports, either to stdout or to one file per trace.
+/// \param options The command line options.
+/// \param reports The report of each trace.
+/// \return true if every report was written.
+static bool WriteReports(const CommandLineOptions& options, const std::vector<TraceReport>& reports)
+{
+    if (options.output_directory.empty())
+    {
+        // a single report is written as it is, several as an array.
+        const bool is_array = reports.size() > 1;
+        fprintf(stdout, "%s", is_array ? "[\n" : "");
+        for (size_t report_index = 0; report_index < reports.size(); ++report_index)
+        {
+            fprintf(stdout, "%s%s", reports[report_index].json.c_str(), (report_index + 1 < reports.size()) ? ",\n" : "\n");
+        }
+        fprintf(stdout, "%s", is_array ? "]\n" : "");
+        return true;
+    }
+
+    bool written = true;
+    for (const TraceReport& report : reports)
+    {
+        const std::string report_path = GetReportPath(options.output_directory, report.path);
+        FILE*             file        = nullptr;
+        const errno_t     error_no    = fopen_s(&file, report_path.c_str(), "wb");
+        if ((file == nullptr) || (error_no != 0))
+        {
+            fprintf(stderr, "Couldn't write %s.\n", report_path.c_str());
+            written = false;
+            continue;
+        }
+        fprintf(file, "%s\n", report.json.c_str());
+        fclose(file);
+    }
+    return written;
+}
+
+/// Main entry point.
+/// \param argc The number of arguments.
+/// \param argv An array containing arguments.
+/// \return 0 if every trace was analyzed, 1 if the command line was invalid, or 2 if a trace couldn't be analyzed.
+int main(int argc, char* argv[])
+{
+    CommandLineOptions options;
+    if (!ParseCommandLine(argc, argv, &options))
+    {
+        PrintUsage();
+        return kReturnCodeInvalidCommandLine;
+    }
+
+    static RmtJobQueue job_queue;
+    if (RmtJobQueueInitialize(&job_queue, options.job_count) != RMT_OK)
+    {
+        fprintf(stderr, "Couldn't start the worker threads.\n");
+        return kReturnCodeTraceFailed;
+    }
+
+    // each worker analyzes whole traces.
+    std::vector<TraceReport> reports(options.trace_paths.size());
+    const uint64_t           start_timestamp = RmtGetCurrentTimestamp();
+    TraceJobInput            job_input       = {&options, &reports};
+    RmtJobHandle             job_handle      = 0;
+    if (RmtJobQueueAddMultiple(&job_queue, AnalyzeTraceJob, &job_input, 0, static_cast<int32_t>(reports.size()), &job_handle) == RMT_OK)
+    {
+        RmtJobQueueWaitForCompletion(&job_queue, job_handle);
+    }
+    const double elapsed_time = GetElapsedMilliseconds(start_timestamp);
+
+    bool succeeded = WriteReports(options, reports);
+    for (const TraceReport& report : reports)
+    {
+        fprintf(stderr, "%s: %s in %.1f ms\n", report.path.c_str(), report.succeeded ? "analyzed" : "failed", report.elapsed_time);
+        succeeded = succeeded && report.succeeded;
+    }
+    fprintf(stderr,
+            "%d trace(s) analyzed in %.1f ms using %d worker thread(s).\n",
+            static_cast<int>(reports.size()),
+            elapsed_time,
+            job_queue.worker_thread_count);
+
+    RmtJobQueueShutdown(&job_queue);
+    return succeeded ? kReturnCodeSuccess : kReturnCodeTraceFailed;
+}
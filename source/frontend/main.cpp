@@ -45,44 +45,11 @@ static QString GetTracePath()
     return out;
 }
 
-#if 0
-static RmtDataSet command_line_data_set;
-static RmtDataSnapshot command_line_snapshot;
-#endif
-
 /// Main entry point.
 /// \param argc The number of arguments.
 /// \param argv An array containing arguments.
 int main(int argc, char* argv[])
 {
-#if 0
-    // Test feature to dump RMV file to JSON. Need a bunch of error handling.
-    if (argc == 4)
-    {
-        RmtErrorCode error_code = rmtDataSetInitialize(argv[1], &command_line_data_set);
-        if (error_code != RMT_OK)
-        {
-            return 1;
-        }
-
-        const uint64_t timestamp = strtoull(argv[2], NULL, 0);
-        RMT_UNUSED(timestamp);
-        error_code = rmtDataSetGenerateSnapshot(&command_line_data_set, command_line_data_set.maximumTimestamp, "snapshot 0", &command_line_snapshot);
-        if (error_code != RMT_OK)
-        {
-            return 2;
-        }
-
-        error_code = rmtDataSnapshotDumpJsonToFile(&command_line_snapshot, argv[3]);
-        if (error_code != RMT_OK)
-        {
-            return 3;
-        }
-
-        return 0;
-    }
-#endif
-
     QApplication a(argc, argv);
 
     // Load application stylesheet
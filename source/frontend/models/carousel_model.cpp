@@ -50,8 +50,8 @@ bool CarouselModel::GetCarouselData(RmtDataSnapshot* snapshot, RMVCarouselData&
             uint64_t available_per_type[kRmtHeapTypeCount] = {};
 
             const uint64_t total_available      = RmtVirtualAllocationListGetTotalSizeInBytes(&snapshot->virtual_allocation_list);
-            const uint64_t allocated_and_used   = RmtVirtualAllocationListGetBoundTotalSizeInBytes(snapshot, &snapshot->virtual_allocation_list);
-            const uint64_t allocated_and_unused = RmtVirtualAllocationListGetUnboundTotalSizeInBytes(snapshot, &snapshot->virtual_allocation_list);
+            const uint64_t allocated_and_used   = snapshot->aggregates.all_allocations.bound_size;
+            const uint64_t allocated_and_unused = snapshot->aggregates.all_allocations.unbound_size;
 
             total_size = allocated_and_used + allocated_and_unused;
 
@@ -59,6 +59,7 @@ bool CarouselModel::GetCarouselData(RmtDataSnapshot* snapshot, RMVCarouselData&
 
             for (int heap = 0; heap < kRmtHeapTypeCount; heap++)
             {
+                consumed_per_type[heap]  = snapshot->aggregates.allocations_per_heap[heap].allocated_size;
                 available_per_type[heap] = snapshot->data_set->segment_info[heap].size;
             }
 
@@ -72,21 +73,16 @@ bool CarouselModel::GetCarouselData(RmtDataSnapshot* snapshot, RMVCarouselData&
             RMT_ASSERT(out_carousel_data.memory_types_data.preferred_heap[0].value == 0);
             RMT_ASSERT(out_carousel_data.memory_types_data.preferred_heap[0].max == 0);
 
+            for (int32_t i = 0; i < kRmtResourceUsageTypeCount; i++)
+            {
+                out_carousel_data.resource_types_data.usage_amount[i] = RmtDataSnapshotGetResourceUsageCount(snapshot, static_cast<RmtResourceUsageType>(i));
+            }
+
+            // the bucket ranges are defined by the carousel, so the allocations are still walked to fill them.
             for (int32_t i = 0; i < snapshot->virtual_allocation_list.allocation_count; i++)
             {
                 const RmtVirtualAllocation* current_allocation = &snapshot->virtual_allocation_list.allocation_details[i];
                 uint64_t                    allocation_size    = static_cast<uint64_t>(current_allocation->size_in_4kb_page) * 4096;
-                const int                   resource_count     = current_allocation->resource_count;
-                for (int j = 0; j < resource_count; j++)
-                {
-                    RmtResource*         current_resource = current_allocation->resources[j];
-                    RmtResourceUsageType resource_type    = RmtResourceGetUsageType(current_resource);
-                    out_carousel_data.resource_types_data.usage_amount[resource_type]++;
-                }
-                if (current_allocation->heap_preferences[0] < kRmtHeapTypeCount)
-                {
-                    consumed_per_type[current_allocation->heap_preferences[0]] += allocation_size;
-                }
 
                 int bucket_index = GetAllocationBucketIndex(allocation_size);
                 out_carousel_data.allocation_sizes_data.buckets[bucket_index]++;
@@ -8,14 +8,13 @@
 #include "models/compare/memory_leak_finder_model.h"
 
 #include <QTableView>
-#include <unordered_map>
-#include <unordered_set>
 
 #include "rmt_assert.h"
 #include "rmt_data_set.h"
 #include "rmt_data_snapshot.h"
 #include "rmt_print.h"
 #include "rmt_resource_list.h"
+#include "rmt_snapshot_diff.h"
 #include "rmt_util.h"
 
 #include "models/proxy_models/memory_leak_finder_proxy_model.h"
@@ -56,6 +55,8 @@ namespace rmv
         proxy_model_ = new MemoryLeakFinderProxyModel(compare_id_filter);
         table_model_ = proxy_model_->InitializeResourceTableModels(table_view, num_rows, num_columns);
         table_model_->Initialize(table_view, true);
+
+        connect(table_model_, &ResourceItemModel::RowsReady, this, &MemoryLeakFinderModel::OnResourceRowsReady);
     }
 
     void MemoryLeakFinderModel::ResetModelValues()
@@ -108,78 +109,54 @@ namespace rmv
         SetModelData(kMemoryLeakFinderBaseSnapshot, base_snapshot_name);
         SetModelData(kMemoryLeakFinderDiffSnapshot, diff_snapshot_name);
 
-        // Set up the lists to contain worst-case scenario.
-        // Uses unordered set/map for fast insert/delete
-        std::unordered_map<RmtResourceIdentifier, const RmtResource*> resources_in_base_only;
-        std::unordered_set<const RmtResource*>                        resources_in_diff_only;
-        std::unordered_set<const RmtResource*>                        resources_in_both;
-        resources_in_base_only.reserve(base_snapshot->resource_list.resource_count);
-        resources_in_diff_only.reserve(diff_snapshot->resource_list.resource_count);
-        resources_in_both.reserve(RMT_MAXIMUM(base_snapshot->resource_list.resource_count, diff_snapshot->resource_list.resource_count));
-
-        // Add the base resources to an unordered map, with the resource id as the key.
-        // If this needs speeding up further, look for which resource list is smallest (base or diff) and populate that instead
-        // of the base.
-        for (int32_t current_resource_index = 0; current_resource_index < base_snapshot->resource_list.resource_count; ++current_resource_index)
+        // Merge the resources of both snapshots by resource id. Resources in both snapshots use the diff resource.
+        RmtSnapshotDiff snapshot_diff = {};
+        if (RmtSnapshotDiffGenerate(base_snapshot, diff_snapshot, &snapshot_diff) != RMT_OK)
         {
-            const RmtResource* current_resource = &base_snapshot->resource_list.resources[current_resource_index];
-            resources_in_base_only.insert(std::make_pair(current_resource->identifier, current_resource));
+            return;
         }
 
-        // Add the diff resources. If the diff resource is in the base resource list (look it up via resource id),
-        // add it to the 'both' list and remove from base map, otherwise just add it to the compare (diff)
-        for (int32_t current_resource_index = 0; current_resource_index < diff_snapshot->resource_list.resource_count; ++current_resource_index)
+        std::vector<ResourceItemModel::ResourceRow> rows(snapshot_diff.record_count);
+        for (int32_t record_index = 0; record_index < snapshot_diff.record_count; record_index++)
         {
-            const RmtResource* current_resource = &diff_snapshot->resource_list.resources[current_resource_index];
-
-            auto iter = resources_in_base_only.find(current_resource->identifier);
-            if (iter != resources_in_base_only.end())
+            const RmtSnapshotDiffRecord&    record = snapshot_diff.records[record_index];
+            ResourceItemModel::ResourceRow& row    = rows[record_index];
+            if (record.type == kRmtSnapshotDiffRecordTypeRemoved)
+            {
+                row.resource   = record.base_resource;
+                row.compare_id = kSnapshotCompareIdOpen;
+            }
+            else if (record.type == kRmtSnapshotDiffRecordTypeAdded)
             {
-                // found, so add to both and remove from base
-                resources_in_both.insert(current_resource);
-                resources_in_base_only.erase(iter);
+                row.resource   = record.diff_resource;
+                row.compare_id = kSnapshotCompareIdCompared;
             }
             else
             {
-                // not found, just add to the diff list
-                resources_in_diff_only.insert(current_resource);
+                row.resource   = record.diff_resource;
+                row.compare_id = kSnapshotCompareIdCommon;
             }
         }
+        // The rows are filtered and the size buckets rebuilt in OnResourceRowsReady, once the table has them.
+        table_model_->SetResources(base_snapshot, rows);
 
-        size_t size = resources_in_base_only.size() + resources_in_diff_only.size() + resources_in_both.size();
-        table_model_->SetRowCount(static_cast<int>(size));
+        stats_in_both_.num_resources =
+            snapshot_diff.record_count_per_type[kRmtSnapshotDiffRecordTypeCommon] + snapshot_diff.record_count_per_type[kRmtSnapshotDiffRecordTypeChanged];
+        stats_in_both_.size = snapshot_diff.size_per_type[kRmtSnapshotDiffRecordTypeCommon] + snapshot_diff.size_per_type[kRmtSnapshotDiffRecordTypeChanged];
+        stats_in_base_only_.num_resources = snapshot_diff.record_count_per_type[kRmtSnapshotDiffRecordTypeRemoved];
+        stats_in_base_only_.size          = snapshot_diff.size_per_type[kRmtSnapshotDiffRecordTypeRemoved];
+        stats_in_diff_only_.num_resources = snapshot_diff.record_count_per_type[kRmtSnapshotDiffRecordTypeAdded];
+        stats_in_diff_only_.size          = snapshot_diff.size_per_type[kRmtSnapshotDiffRecordTypeAdded];
 
-        ResetStats();
+        RmtSnapshotDiffDestroy(&snapshot_diff);
 
-        int32_t row_index = 0;
-        for (auto iter = resources_in_both.begin(); iter != resources_in_both.end(); ++iter)
-        {
-            const RmtResource* resource = *iter;
-            table_model_->AddResource(base_snapshot, resource, kSnapshotCompareIdCommon);
-            stats_in_both_.num_resources++;
-            stats_in_both_.size += resource->size_in_bytes;
-            row_index++;
-        }
-
-        for (auto iter = resources_in_base_only.begin(); iter != resources_in_base_only.end(); ++iter)
-        {
-            const RmtResource* resource = (*iter).second;
-            table_model_->AddResource(base_snapshot, resource, kSnapshotCompareIdOpen);
-            stats_in_base_only_.num_resources++;
-            stats_in_base_only_.size += resource->size_in_bytes;
-            row_index++;
-        }
+        proxy_model_->UpdateCompareFilter(compare_filter);
 
-        for (auto iter = resources_in_diff_only.begin(); iter != resources_in_diff_only.end(); ++iter)
-        {
-            const RmtResource* resource = *iter;
-            table_model_->AddResource(base_snapshot, resource, kSnapshotCompareIdCompared);
-            stats_in_diff_only_.num_resources++;
-            stats_in_diff_only_.size += resource->size_in_bytes;
-            row_index++;
-        }
+        UpdateLabels();
+    }
 
-        proxy_model_->UpdateCompareFilter(compare_filter);
+    void MemoryLeakFinderModel::OnResourceRowsReady()
+    {
         proxy_model_->invalidate();
 
         UpdateResourceThresholds();
@@ -229,14 +206,8 @@ namespace rmv
                      kStatsText.arg(rmv::string_util::LocalizedValue(stats_in_diff_only_.num_resources))
                          .arg(rmv::string_util::LocalizedValueMemory(stats_in_diff_only_.size, false, false)));
 
-        uint32_t row_count  = proxy_model_->rowCount();
-        uint64_t total_size = 0;
-
-        for (uint32_t i = 0; i < row_count; i++)
-        {
-            const uint64_t size = proxy_model_->GetData(i, kResourceColumnSize);
-            total_size += size;
-        }
+        const uint32_t row_count  = proxy_model_->rowCount();
+        const uint64_t total_size = proxy_model_->GetFilteredSize();
 
         SetModelData(kMemoryLeakFinderTotalResources, rmv::string_util::LocalizedValue(row_count));
         SetModelData(kMemoryLeakFinderTotalSize, rmv::string_util::LocalizedValueMemory(total_size, false, false));
@@ -244,10 +215,11 @@ namespace rmv
 
     void MemoryLeakFinderModel::SearchBoxChanged(const QString& filter)
     {
-        proxy_model_->SetSearchFilter(filter);
-        proxy_model_->invalidate();
-
-        UpdateLabels();
+        if (proxy_model_->SetSearchFilter(filter))
+        {
+            proxy_model_->invalidate();
+            UpdateLabels();
+        }
     }
 
     void MemoryLeakFinderModel::FilterBySizeChanged(int min_value, int max_value)
@@ -255,22 +227,27 @@ namespace rmv
         const uint64_t scaled_min = resource_thresholds_[min_value];
         const uint64_t scaled_max = resource_thresholds_[max_value];
 
-        proxy_model_->SetSizeFilter(scaled_min, scaled_max);
-        proxy_model_->invalidate();
-
-        UpdateLabels();
+        if (proxy_model_->SetSizeFilter(scaled_min, scaled_max))
+        {
+            proxy_model_->invalidate();
+            UpdateLabels();
+        }
     }
 
     void MemoryLeakFinderModel::UpdatePreferredHeapList(const QString& preferred_heap_filter)
     {
-        proxy_model_->SetPreferredHeapFilter(preferred_heap_filter);
-        proxy_model_->invalidate();
+        if (proxy_model_->SetPreferredHeapFilter(preferred_heap_filter))
+        {
+            proxy_model_->invalidate();
+        }
     }
 
     void MemoryLeakFinderModel::UpdateResourceUsageList(const QString& resource_usage_filter)
     {
-        proxy_model_->SetResourceUsageFilter(resource_usage_filter);
-        proxy_model_->invalidate();
+        if (proxy_model_->SetResourceUsageFilter(resource_usage_filter))
+        {
+            proxy_model_->invalidate();
+        }
     }
 
     MemoryLeakFinderProxyModel* MemoryLeakFinderModel::GetResourceProxyModel() const
@@ -89,6 +89,10 @@ namespace rmv
         /// \param index The model index for the entry selected in the memory leak resource table.
         RmtSnapshotPoint* LoadSnapshot(const QModelIndex& index);
 
+    private slots:
+        /// Filter the rows and update the size buckets and labels once the new rows are in the table.
+        void OnResourceRowsReady();
+
     private:
         /// Update the resource size buckets. This is used by the double-slider to
         /// group the resource sizes. Called whenever the table data changes.
@@ -79,66 +79,23 @@ namespace rmv
         return RmtGetHeapTypeNameFromHeapType((RmtHeapType)heap_index);
     }
 
-    bool SnapshotDeltaModel::GetHeapDelta(RmtDataSnapshot* snapshot, RmtHeapType heap_type, HeapDeltaData& delta_data)
-    {
-        bool success = false;
-
-        if (TraceManager::Get().DataSetValid())
-        {
-            if (snapshot != nullptr)
-            {
-                success = true;
-
-                delta_data               = {};
-                uint64_t total_allocated = 0;
-
-                for (int32_t currentVirtualAllocationIndex = 0; currentVirtualAllocationIndex < snapshot->virtual_allocation_list.allocation_count;
-                     currentVirtualAllocationIndex++)
-                {
-                    const RmtVirtualAllocation* virtual_allocation = &snapshot->virtual_allocation_list.allocation_details[currentVirtualAllocationIndex];
-
-                    if (virtual_allocation->heap_preferences[0] == heap_type)
-                    {
-                        total_allocated += RmtVirtualAllocationGetSizeInBytes(virtual_allocation);
-
-                        // accumulate in here
-                        delta_data.allocation_count++;
-                        delta_data.resource_count += virtual_allocation->resource_count;
-                        delta_data.total_allocated_and_bound += RmtVirtualAllocationGetTotalResourceMemoryInBytes(snapshot, virtual_allocation);
-                        delta_data.total_allocated_and_unbound += RmtVirtualAllocationGetTotalUnboundSpaceInAllocation(snapshot, virtual_allocation);
-                    }
-                }
-
-                delta_data.total_available_size = 0;
-                delta_data.free_space           = 0;
-            }
-        }
-
-        return success;
-    }
-
     bool SnapshotDeltaModel::CalcPerHeapDelta(RmtHeapType heap_type, HeapDeltaData& out_delta_data)
     {
         if (TraceManager::Get().DataSetValid())
         {
-            if (base_snapshot_ != nullptr && diff_snapshot_ != nullptr)
+            if (base_snapshot_ != nullptr && diff_snapshot_ != nullptr && heap_type >= 0 && heap_type < kRmtHeapTypeCount)
             {
-                HeapDeltaData base_data    = {};
-                bool          base_success = GetHeapDelta(base_snapshot_, heap_type, base_data);
-
-                HeapDeltaData diff_data   = {};
-                bool          dff_success = GetHeapDelta(diff_snapshot_, heap_type, diff_data);
-
-                if (base_success && dff_success)
-                {
-                    out_delta_data.total_available_size        = base_data.total_available_size;
-                    out_delta_data.total_allocated_and_bound   = diff_data.total_allocated_and_bound - base_data.total_allocated_and_bound;
-                    out_delta_data.total_allocated_and_unbound = diff_data.total_allocated_and_unbound - base_data.total_allocated_and_unbound;
-                    out_delta_data.free_space                  = diff_data.free_space - base_data.free_space;
-                    out_delta_data.resource_count              = diff_data.resource_count - base_data.resource_count;
-                    out_delta_data.allocation_count            = diff_data.allocation_count - base_data.allocation_count;
-                    return true;
-                }
+                // the per-heap totals are calculated when each snapshot is generated, so the delta doesn't need the resources.
+                const RmtSnapshotAllocationAggregate& base_data = base_snapshot_->aggregates.allocations_per_heap[heap_type];
+                const RmtSnapshotAllocationAggregate& diff_data = diff_snapshot_->aggregates.allocations_per_heap[heap_type];
+
+                out_delta_data.total_available_size        = 0;
+                out_delta_data.total_allocated_and_bound   = (int64_t)diff_data.bound_size - (int64_t)base_data.bound_size;
+                out_delta_data.total_allocated_and_unbound = (int64_t)diff_data.unbound_size - (int64_t)base_data.unbound_size;
+                out_delta_data.free_space                  = 0;
+                out_delta_data.resource_count              = diff_data.resource_count - base_data.resource_count;
+                out_delta_data.allocation_count            = diff_data.allocation_count - base_data.allocation_count;
+                return true;
             }
         }
 
@@ -73,13 +73,6 @@ namespace rmv
         bool CalcPerHeapDelta(RmtHeapType heap_type, HeapDeltaData& out_delta_data);
 
     private:
-        /// Compute delta between snapshots.
-        /// \param snapshot The target snapshot.
-        /// \param heap_type The target heap type.
-        /// \param delta_Data Structure to hold the heap data from the model.
-        /// \return true if data returned successfully, false otherwise.
-        bool GetHeapDelta(RmtDataSnapshot* snapshot, RmtHeapType heap_type, HeapDeltaData& delta_data);
-
         int              base_index_;     ///< The index of the base snapshot.
         int              diff_index_;     ///< The index of the diff snapshot.
         RmtDataSnapshot* base_snapshot_;  ///< The base snapshot.
@@ -25,25 +25,27 @@ namespace rmv
 
     void MemoryLeakFinderProxyModel::UpdateCompareFilter(SnapshotCompareId compare_filter)
     {
-        compare_id_filter_ = compare_filter;
+        if (compare_id_filter_ != static_cast<uint32_t>(compare_filter))
+        {
+            compare_id_filter_ = compare_filter;
+            MarkAcceptedRowsDirty();
+        }
     }
 
-    bool MemoryLeakFinderProxyModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
+    void MemoryLeakFinderProxyModel::FilterAcceptedRows(RowBitset& accepted_rows) const
     {
-        bool pass = ResourceProxyModel::filterAcceptsRow(source_row, source_parent);
-
-        if (pass)
+        // Merge the rows with any of the comparison ids in the filter.
+        RowBitset compare_rows;
+        compare_rows.Resize(accepted_rows.Size());
+        for (int32_t flag_index = 0; flag_index < kSnapshotCompareIdFlagCount; flag_index++)
         {
-            QModelIndex index = sourceModel()->index(source_row, kResourceColumnCompareId, source_parent);
-
-            QString index_data = index.data().toString();
-
-            bool           ok         = false;
-            const uint32_t compare_id = index_data.toULong(&ok, 0);
-
-            pass = ((compare_id_filter_ & compare_id) != 0U);
+            const SnapshotCompareId compare_id = static_cast<SnapshotCompareId>(1 << flag_index);
+            if ((compare_id_filter_ & compare_id) != 0U)
+            {
+                compare_rows.Or(resource_model_->GetCompareIdRows(compare_id));
+            }
         }
 
-        return pass;
+        accepted_rows.And(compare_rows);
     }
 }  // namespace rmv
\ No newline at end of file
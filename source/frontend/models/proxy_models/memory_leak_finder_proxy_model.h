@@ -31,11 +31,9 @@ namespace rmv
         void UpdateCompareFilter(SnapshotCompareId compare_filter);
 
     protected:
-        /// Make the filter run across multiple columns.
-        /// \param source_row The target row.
-        /// \param source_parent The source parent.
-        /// \return true if the row passed the filter, false if not.
-        virtual bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override;
+        /// Remove the rows that don't have a comparison id in the compare filter.
+        /// \param accepted_rows The rows passing the other filters.
+        virtual void FilterAcceptedRows(RowBitset& accepted_rows) const override;
 
         uint32_t compare_id_filter_;  ///< Filtering flags specified in the UI.
     };
@@ -18,6 +18,13 @@ namespace rmv
 {
     ResourceProxyModel::ResourceProxyModel(QObject* parent)
         : TableProxyModel(parent)
+        , resource_model_(nullptr)
+        , row_generation_(0)
+        , preferred_heap_rows_dirty_(true)
+        , resource_usage_rows_dirty_(true)
+        , accepted_rows_dirty_(true)
+        , size_rows_min_(0)
+        , size_rows_max_(UINT64_MAX)
     {
     }
 
@@ -31,6 +38,8 @@ namespace rmv
         model->SetRowCount(num_rows);
         model->SetColumnCount(num_columns);
 
+        resource_model_ = model;
+        row_generation_ = model->GetRowGeneration() - 1;
         setSourceModel(model);
         SetFilterKeyColumns({kResourceColumnName,
                              kResourceColumnVirtualAddress,
@@ -46,51 +55,161 @@ namespace rmv
         return model;
     }
 
-    void ResourceProxyModel::SetPreferredHeapFilter(const QString& preferred_heap_filter)
+    bool ResourceProxyModel::SetPreferredHeapFilter(const QString& preferred_heap_filter)
     {
-        preferred_heap_filter_ = QRegularExpression(preferred_heap_filter, QRegularExpression::CaseInsensitiveOption);
+        if (preferred_heap_filter_.pattern() == preferred_heap_filter)
+        {
+            return false;
+        }
+
+        preferred_heap_filter_     = QRegularExpression(preferred_heap_filter, QRegularExpression::CaseInsensitiveOption);
+        preferred_heap_rows_dirty_ = true;
+        return true;
     }
 
-    void ResourceProxyModel::SetResourceUsageFilter(const QString& resource_usage_filter)
+    bool ResourceProxyModel::SetResourceUsageFilter(const QString& resource_usage_filter)
     {
-        resource_usage_filter_ = QRegularExpression(resource_usage_filter, QRegularExpression::CaseInsensitiveOption);
+        if (resource_usage_filter_.pattern() == resource_usage_filter)
+        {
+            return false;
+        }
+
+        resource_usage_filter_     = QRegularExpression(resource_usage_filter, QRegularExpression::CaseInsensitiveOption);
+        resource_usage_rows_dirty_ = true;
+        return true;
     }
 
-    bool ResourceProxyModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
+    uint64_t ResourceProxyModel::GetFilteredSize() const
     {
-        if (FilterSizeSlider(source_row, kResourceColumnSize, source_parent) == false)
+        if (resource_model_ == nullptr)
         {
-            return false;
+            return 0;
         }
 
-        if (FilterSearchString(source_row, source_parent) == false)
+        UpdateAcceptedRows();
+
+        const std::vector<uint64_t>& resource_sizes = resource_model_->GetResourceSizes();
+        uint64_t                     total_size     = 0;
+        accepted_rows_.ForEachSetRow([&](int32_t row) { total_size += resource_sizes[row]; });
+        return total_size;
+    }
+
+    void ResourceProxyModel::FilterAcceptedRows(RowBitset& accepted_rows) const
+    {
+        Q_UNUSED(accepted_rows);
+    }
+
+    void ResourceProxyModel::MarkAcceptedRowsDirty()
+    {
+        accepted_rows_dirty_ = true;
+    }
+
+    void ResourceProxyModel::BuildCategoryRows(const std::vector<ResourceItemModel::RowCategory>& categories,
+                                               const QRegularExpression&                          filter,
+                                               RowBitset&                                         out_rows) const
+    {
+        // Each distinct string is matched once, then its rows are merged in a word at a time.
+        out_rows.Resize(static_cast<int32_t>(resource_model_->GetResourceSizes().size()));
+        for (const ResourceItemModel::RowCategory& category : categories)
         {
-            return false;
+            if (filter.match(category.name).hasMatch() == true)
+            {
+                out_rows.Or(category.rows);
+            }
         }
+    }
+
+    void ResourceProxyModel::UpdateAcceptedRows() const
+    {
+        const std::vector<uint64_t>& resource_sizes = resource_model_->GetResourceSizes();
+        const int32_t                row_count      = static_cast<int32_t>(resource_sizes.size());
 
-        // Apply the preferred heap filter.
-        const QModelIndex& preferred_heap_index = sourceModel()->index(source_row, kResourceColumnPreferredHeap, source_parent);
-        if (preferred_heap_index.column() == kResourceColumnPreferredHeap)
+        // Rebuild everything if the rows of the source model have changed.
+        if (row_generation_ != resource_model_->GetRowGeneration())
         {
-            QString index_data = preferred_heap_index.data().toString();
-            if (preferred_heap_filter_.match(index_data).hasMatch() == false)
+            row_generation_            = resource_model_->GetRowGeneration();
+            preferred_heap_rows_dirty_ = true;
+            resource_usage_rows_dirty_ = true;
+            size_rows_.Resize(0);
+            search_rows_.Resize(0);
+        }
+
+        if (preferred_heap_rows_dirty_ == true)
+        {
+            BuildCategoryRows(resource_model_->GetPreferredHeapCategories(), preferred_heap_filter_, preferred_heap_rows_);
+            preferred_heap_rows_dirty_ = false;
+            accepted_rows_dirty_       = true;
+        }
+
+        if (resource_usage_rows_dirty_ == true)
+        {
+            BuildCategoryRows(resource_model_->GetUsageCategories(), resource_usage_filter_, resource_usage_rows_);
+            resource_usage_rows_dirty_ = false;
+            accepted_rows_dirty_       = true;
+        }
+
+        if ((size_rows_.Size() != row_count) || (size_rows_min_ != min_size_) || (size_rows_max_ != max_size_))
+        {
+            size_rows_.Resize(row_count);
+            for (int32_t row = 0; row < row_count; row++)
             {
-                return false;
+                if ((resource_sizes[row] >= min_size_) && (resource_sizes[row] <= max_size_))
+                {
+                    size_rows_.Set(row);
+                }
             }
+            size_rows_min_       = min_size_;
+            size_rows_max_       = max_size_;
+            accepted_rows_dirty_ = true;
         }
 
-        // Apply the resource usage filter.
-        const QModelIndex& resource_usage_index = sourceModel()->index(source_row, kResourceColumnUsage, source_parent);
-        if (resource_usage_index.column() == kResourceColumnUsage)
+        if ((search_rows_.Size() != row_count) || (search_rows_filter_ != search_filter_))
         {
-            QString index_data = resource_usage_index.data().toString();
-            if (resource_usage_filter_.match(index_data).hasMatch() == false)
+            // The search matches the text shown in the table. Until the model's search index is ready,
+            // the text for each row is checked directly, but only when the search string changes.
+            search_rows_.Resize(row_count);
+            if (search_filter_.isEmpty() == true || column_filters_.empty() == true)
             {
-                return false;
+                search_rows_.SetAll();
             }
+            else if (resource_model_->SearchRows(column_filters_, search_filter_, search_rows_) == false)
+            {
+                for (int32_t row = 0; row < row_count; row++)
+                {
+                    if (FilterSearchString(row, QModelIndex()) == true)
+                    {
+                        search_rows_.Set(row);
+                    }
+                }
+            }
+            search_rows_filter_  = search_filter_;
+            accepted_rows_dirty_ = true;
         }
 
-        return true;
+        if (accepted_rows_dirty_ == true)
+        {
+            accepted_rows_.Resize(row_count);
+            accepted_rows_.SetAll();
+            accepted_rows_.And(preferred_heap_rows_);
+            accepted_rows_.And(resource_usage_rows_);
+            accepted_rows_.And(size_rows_);
+            accepted_rows_.And(search_rows_);
+            FilterAcceptedRows(accepted_rows_);
+            accepted_rows_dirty_ = false;
+        }
+    }
+
+    bool ResourceProxyModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
+    {
+        Q_UNUSED(source_parent);
+
+        if (resource_model_ == nullptr)
+        {
+            return true;
+        }
+
+        UpdateAcceptedRows();
+        return accepted_rows_.Test(source_row);
     }
 
     bool ResourceProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
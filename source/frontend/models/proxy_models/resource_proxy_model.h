@@ -12,6 +12,7 @@
 
 #include "models/proxy_models/table_proxy_model.h"
 #include "models/resource_item_model.h"
+#include "util/row_bitset.h"
 
 namespace rmv
 {
@@ -39,13 +40,19 @@ namespace rmv
         /// heaps from the 'preferred heap' combo box. Rather than rebuild the table, this regular
         /// expression is added to the filter to filter out heaps that don't need to be shown.
         /// \param heap_filter The regular expression for the heap filter.
-        void SetPreferredHeapFilter(const QString& preferred_heap_filter);
+        /// \return true if the filter changed, false if not.
+        bool SetPreferredHeapFilter(const QString& preferred_heap_filter);
 
         /// Set the preferred heap filter regular expression. Called when the user selects visible
         /// heaps from the 'preferred heap' combo box. Rather than rebuild the table, this regular
         /// expression is added to the filter to filter out heaps that don't need to be shown.
         /// \param heap_filter The regular expression for the heap filter.
-        void SetResourceUsageFilter(const QString& resource_usage_filter);
+        /// \return true if the filter changed, false if not.
+        bool SetResourceUsageFilter(const QString& resource_usage_filter);
+
+        /// Get the total size of the resources that pass the filters.
+        /// \return The total size, in bytes.
+        uint64_t GetFilteredSize() const;
 
     protected:
         /// Make the filter run across multiple columns.
@@ -60,9 +67,41 @@ namespace rmv
         /// \return true if left is less than right, false otherwise.
         virtual bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
 
+        /// Remove any rows failing filters added by derived classes. Called when the accepted rows are rebuilt.
+        /// \param accepted_rows The rows passing the heap, usage, size and search filters.
+        virtual void FilterAcceptedRows(RowBitset& accepted_rows) const;
+
+        /// Force the accepted rows to be rebuilt. Called by derived classes when their filters change.
+        void MarkAcceptedRowsDirty();
+
+        ResourceItemModel* resource_model_;  ///< The source model.
+
     private:
+        /// Build the rows passing any filter that has changed since it was last built, and
+        /// the rows passing every filter.
+        void UpdateAcceptedRows() const;
+
+        /// Build the rows passing a regular expression filter on a column.
+        /// \param categories The rows grouped by the strings in the column.
+        /// \param filter The regular expression.
+        /// \param out_rows The rows passing the filter.
+        void BuildCategoryRows(const std::vector<ResourceItemModel::RowCategory>& categories, const QRegularExpression& filter, RowBitset& out_rows) const;
+
         QRegularExpression preferred_heap_filter_;  ///< The preferred heap filter regular expression.
         QRegularExpression resource_usage_filter_;  ///< The resource usage filter regular expression.
+
+        mutable RowBitset preferred_heap_rows_;        ///< The rows passing the preferred heap filter.
+        mutable RowBitset resource_usage_rows_;        ///< The rows passing the resource usage filter.
+        mutable RowBitset size_rows_;                  ///< The rows passing the size filter.
+        mutable RowBitset search_rows_;                ///< The rows passing the search filter.
+        mutable RowBitset accepted_rows_;              ///< The rows passing every filter.
+        mutable uint32_t  row_generation_;             ///< The generation of the source rows the bitsets were built for.
+        mutable bool      preferred_heap_rows_dirty_;  ///< If true, the preferred heap rows need rebuilding.
+        mutable bool      resource_usage_rows_dirty_;  ///< If true, the resource usage rows need rebuilding.
+        mutable bool      accepted_rows_dirty_;        ///< If true, the accepted rows need rebuilding.
+        mutable QString   search_rows_filter_;         ///< The search string the search rows were built for.
+        mutable uint64_t  size_rows_min_;              ///< The minimum size the size rows were built for.
+        mutable uint64_t  size_rows_max_;              ///< The maximum size the size rows were built for.
     };
 }  // namespace rmv
 
@@ -31,15 +31,19 @@ namespace rmv
         }
     }
 
-    void TableProxyModel::SetSearchFilter(const QString& filter)
+    bool TableProxyModel::SetSearchFilter(const QString& filter)
     {
-        search_filter_ = filter;
+        const bool changed = (search_filter_ != filter);
+        search_filter_     = filter;
+        return changed;
     }
 
-    void TableProxyModel::SetSizeFilter(uint64_t min, uint64_t max)
+    bool TableProxyModel::SetSizeFilter(uint64_t min, uint64_t max)
     {
-        min_size_ = min;
-        max_size_ = max;
+        const bool changed = (min_size_ != min) || (max_size_ != max);
+        min_size_          = min;
+        max_size_          = max;
+        return changed;
     }
 
     uint64_t TableProxyModel::GetIndexValue(const QModelIndex& index) const
@@ -32,12 +32,14 @@ namespace rmv
 
         /// Specify string to use as search filter.
         /// \param filter the search filter.
-        void SetSearchFilter(const QString& filter);
+        /// \return true if the search filter changed, false if not.
+        bool SetSearchFilter(const QString& filter);
 
         /// Specify range to use as size filter.
         /// \param min the min size.
         /// \param max the max size.
-        void SetSizeFilter(uint64_t min, uint64_t max);
+        /// \return true if the size filter changed, false if not.
+        bool SetSizeFilter(uint64_t min, uint64_t max);
 
         /// Get content from proxy model.
         /// \param row The row where the data is located.
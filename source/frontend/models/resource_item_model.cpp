@@ -10,11 +10,16 @@
 
 #include "rmt_assert.h"
 #include "rmt_data_snapshot.h"
+#include "rmt_job_system.h"
 #include "rmt_resource_list.h"
 #include "rmt_util.h"
 
 #include "models/trace_manager.h"
 #include "util/string_util.h"
+#include "views/main_window.h"
+
+// The number of rows each job calculates the cached data for.
+static const int32_t kRowsPerDataCacheJob = 4096;
 
 namespace rmv
 {
@@ -22,17 +27,34 @@ namespace rmv
         : QAbstractItemModel(parent)
         , num_rows_(0)
         , num_columns_(0)
+        , pending_snapshot_(nullptr)
+        , data_cache_request_(0)
+        , data_cache_job_(0)
+        , data_cache_job_pending_(false)
+        , data_cache_cancelled_(false)
+        , row_generation_(0)
+        , search_index_job_(0)
+        , search_index_job_pending_(false)
+        , search_index_ready_(false)
+        , search_index_cancelled_(false)
     {
+        // The job queue signals from a worker thread, so the cached data is swapped in on the GUI thread.
+        connect(this, &ResourceItemModel::DataCacheReady, this, &ResourceItemModel::OnDataCacheReady, Qt::QueuedConnection);
     }
 
     ResourceItemModel::~ResourceItemModel()
     {
+        CancelDataCache();
+        CancelSearchIndex();
     }
 
     void ResourceItemModel::SetRowCount(int rows)
     {
+        CancelDataCache();
+        CancelSearchIndex();
         num_rows_ = rows;
         cache_.clear();
+        UpdateRowFilterData();
     }
 
     void ResourceItemModel::SetColumnCount(int columns)
@@ -72,7 +94,7 @@ namespace rmv
         resource_table->hideColumn(kResourceColumnGlobalId);
     }
 
-    void ResourceItemModel::AddResource(const RmtDataSnapshot* snapshot, const RmtResource* resource, SnapshotCompareId compare_id)
+    void ResourceItemModel::FillDataCache(const RmtDataSnapshot* snapshot, const RmtResource* resource, SnapshotCompareId compare_id, DataCache& out_cache)
     {
         uint64_t memory_segment_histogram[kRmtResourceBackingStorageCount] = {0};
 
@@ -88,22 +110,278 @@ namespace rmv
         const char* buf_ptr                         = &buffer[0];
         RmtResourceGetName(resource, RMT_MAXIMUM_NAME_LENGTH, (char**)&buf_ptr);
 
-        DataCache cache;
-        cache.resource        = resource;
-        cache.compare_id      = compare_id;
-        cache.resource_name   = QString(buffer);
-        cache.local_bytes     = 0;
-        cache.invisible_bytes = 0;
-        cache.host_bytes      = 0;
-        cache.unmapped_bytes  = 0;
+        out_cache.resource        = resource;
+        out_cache.compare_id      = compare_id;
+        out_cache.resource_name   = QString(buffer);
+        out_cache.local_bytes     = 0;
+        out_cache.invisible_bytes = 0;
+        out_cache.host_bytes      = 0;
+        out_cache.unmapped_bytes  = 0;
         if (total_memory_mapped > 0)
         {
-            cache.local_bytes     = memory_segment_histogram[kRmtHeapTypeLocal];
-            cache.invisible_bytes = memory_segment_histogram[kRmtHeapTypeInvisible];
-            cache.host_bytes      = memory_segment_histogram[kRmtHeapTypeSystem];
-            cache.unmapped_bytes  = memory_segment_histogram[kRmtResourceBackingStorageUnmapped];
+            out_cache.local_bytes     = memory_segment_histogram[kRmtHeapTypeLocal];
+            out_cache.invisible_bytes = memory_segment_histogram[kRmtHeapTypeInvisible];
+            out_cache.host_bytes      = memory_segment_histogram[kRmtHeapTypeSystem];
+            out_cache.unmapped_bytes  = memory_segment_histogram[kRmtResourceBackingStorageUnmapped];
+        }
+    }
+
+    void ResourceItemModel::FillDataCacheJob(int32_t thread_id, int32_t index, void* input)
+    {
+        Q_UNUSED(thread_id);
+
+        // Each job writes its own range of the cache, so the ranges can be filled in any order.
+        ResourceItemModel* model     = static_cast<ResourceItemModel*>(input);
+        const int32_t      row_count = static_cast<int32_t>(model->pending_rows_.size());
+        const int32_t      first_row = index * kRowsPerDataCacheJob;
+        const int32_t      last_row  = RMT_MINIMUM(first_row + kRowsPerDataCacheJob, row_count);
+        for (int32_t row = first_row; row < last_row; row++)
+        {
+            if (model->data_cache_cancelled_ == true)
+            {
+                return;
+            }
+
+            const ResourceRow& resource_row = model->pending_rows_[row];
+            FillDataCache(model->pending_snapshot_, resource_row.resource, resource_row.compare_id, model->pending_cache_[row]);
+        }
+    }
+
+    void ResourceItemModel::FillPendingDataCacheJob(int32_t thread_id, int32_t index, void* input)
+    {
+        Q_UNUSED(index);
+
+        // The pending rows can't change while the job is running, as changing them cancels the job and waits for it first.
+        ResourceItemModel* model     = static_cast<ResourceItemModel*>(input);
+        const int32_t      row_count = static_cast<int32_t>(model->pending_rows_.size());
+        const int32_t      job_count = (row_count + kRowsPerDataCacheJob - 1) / kRowsPerDataCacheJob;
+        RmtJobQueue*       job_queue = MainWindow::GetJobQueue();
+        RmtJobHandle       handle    = 0;
+        if ((job_count > 1) && (RmtJobQueueAddMultiple(job_queue, FillDataCacheJob, model, 0, job_count, &handle) == RMT_OK))
+        {
+            // The calling thread runs ranges too while it waits, rather than sitting idle.
+            RmtJobQueueWaitForCompletion(job_queue, handle);
+        }
+        else
+        {
+            for (int32_t job_index = 0; job_index < job_count; job_index++)
+            {
+                FillDataCacheJob(thread_id, job_index, model);
+            }
+        }
+
+        if (model->data_cache_cancelled_ == false)
+        {
+            emit model->DataCacheReady(model->data_cache_request_);
+        }
+    }
+
+    void ResourceItemModel::SetResources(const RmtDataSnapshot* snapshot, const std::vector<ResourceRow>& rows)
+    {
+        CancelDataCache();
+
+        pending_snapshot_ = snapshot;
+        pending_rows_     = rows;
+        pending_cache_.resize(rows.size());
+
+        data_cache_cancelled_   = false;
+        data_cache_job_pending_ = (RmtJobQueueAddSingle(MainWindow::GetJobQueue(), FillPendingDataCacheJob, this, &data_cache_job_) == RMT_OK);
+        if (data_cache_job_pending_ == false)
+        {
+            // No job queue to run it on, so fill the cache here and swap it in straight away.
+            FillPendingDataCacheJob(RMT_JOB_QUEUE_EXTERNAL_THREAD_ID, 0, this);
         }
-        cache_.push_back(cache);
+    }
+
+    void ResourceItemModel::OnDataCacheReady(uint32_t request)
+    {
+        // The rows were changed again after the job signalled, so the cached data is stale.
+        if (request != data_cache_request_)
+        {
+            return;
+        }
+
+        CancelDataCache();
+        CancelSearchIndex();
+        beginResetModel();
+
+        num_rows_ = static_cast<int32_t>(pending_cache_.size());
+        cache_.swap(pending_cache_);
+        UpdateRowFilterData();
+
+        endResetModel();
+
+        pending_cache_.clear();
+        emit RowsReady();
+    }
+
+    void ResourceItemModel::CancelDataCache()
+    {
+        if (data_cache_job_pending_ == true)
+        {
+            data_cache_cancelled_ = true;
+            RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), data_cache_job_);
+            data_cache_job_pending_ = false;
+        }
+
+        data_cache_request_++;
+        pending_snapshot_ = nullptr;
+        pending_rows_.clear();
+    }
+
+    const std::vector<ResourceItemModel::RowCategory>& ResourceItemModel::GetPreferredHeapCategories() const
+    {
+        return preferred_heap_categories_;
+    }
+
+    const std::vector<ResourceItemModel::RowCategory>& ResourceItemModel::GetUsageCategories() const
+    {
+        return usage_categories_;
+    }
+
+    const RowBitset& ResourceItemModel::GetCompareIdRows(SnapshotCompareId compare_id) const
+    {
+        int32_t flag_index = 0;
+        while ((flag_index < kSnapshotCompareIdFlagCount - 1) && ((compare_id & (1 << flag_index)) == 0))
+        {
+            flag_index++;
+        }
+        return compare_id_rows_[flag_index];
+    }
+
+    const std::vector<uint64_t>& ResourceItemModel::GetResourceSizes() const
+    {
+        return resource_sizes_;
+    }
+
+    bool ResourceItemModel::SearchRows(const std::set<qint32>& columns, const QString& search_text, RowBitset& out_rows)
+    {
+        if (columns != search_index_columns_)
+        {
+            CancelSearchIndex();
+            search_index_columns_ = columns;
+        }
+
+        if (search_index_ready_ == true)
+        {
+            search_index_.Search(search_text.toLower().toStdString(), out_rows);
+            return true;
+        }
+
+        // Build the index in the background the first time the rows are searched.
+        if (search_index_job_pending_ == false)
+        {
+            search_index_cancelled_   = false;
+            search_index_job_pending_ = (RmtJobQueueAddSingle(MainWindow::GetJobQueue(), BuildSearchIndexJob, this, &search_index_job_) == RMT_OK);
+        }
+        return false;
+    }
+
+    void ResourceItemModel::CancelSearchIndex()
+    {
+        if (search_index_job_pending_ == true)
+        {
+            search_index_cancelled_ = true;
+            RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), search_index_job_);
+            search_index_job_pending_ = false;
+        }
+
+        search_index_ready_ = false;
+        search_index_.Clear();
+    }
+
+    void ResourceItemModel::BuildSearchIndexJob(int32_t thread_id, int32_t index, void* input)
+    {
+        Q_UNUSED(thread_id);
+        Q_UNUSED(index);
+
+        // The rows can't change while the job is running, as changing them cancels the job and waits for it first.
+        ResourceItemModel* model     = static_cast<ResourceItemModel*>(input);
+        const int32_t      row_count = static_cast<int32_t>(model->cache_.size());
+        for (int32_t row = 0; row < row_count; row++)
+        {
+            if (model->search_index_cancelled_ == true)
+            {
+                return;
+            }
+
+            for (const qint32 column : model->search_index_columns_)
+            {
+                const QString text = model->data(model->createIndex(row, column), Qt::DisplayRole).toString();
+                model->search_index_.AddString(row, text.toLower().toStdString());
+            }
+        }
+
+        model->search_index_.Finalize(row_count);
+        model->search_index_ready_ = true;
+    }
+
+    uint32_t ResourceItemModel::GetRowGeneration() const
+    {
+        return row_generation_;
+    }
+
+    void ResourceItemModel::AddRowToCategory(std::vector<RowCategory>& categories, const char* name, int32_t row)
+    {
+        // There are only a handful of distinct heap names, so a linear search is fine.
+        for (RowCategory& category : categories)
+        {
+            if (category.name == QLatin1String(name))
+            {
+                category.rows.Set(row);
+                return;
+            }
+        }
+
+        RowCategory category;
+        category.name = QString(name);
+        category.rows.Resize(static_cast<int32_t>(cache_.size()));
+        category.rows.Set(row);
+        categories.push_back(category);
+    }
+
+    void ResourceItemModel::UpdateRowFilterData()
+    {
+        const int32_t row_count = static_cast<int32_t>(cache_.size());
+
+        preferred_heap_categories_.clear();
+        usage_categories_.resize(kRmtResourceUsageTypeCount);
+        for (int32_t usage_index = 0; usage_index < kRmtResourceUsageTypeCount; usage_index++)
+        {
+            usage_categories_[usage_index].name = rmv::string_util::GetResourceUsageString(static_cast<RmtResourceUsageType>(usage_index));
+            usage_categories_[usage_index].rows.Resize(row_count);
+        }
+        resource_sizes_.resize(row_count);
+        for (int32_t flag_index = 0; flag_index < kSnapshotCompareIdFlagCount; flag_index++)
+        {
+            compare_id_rows_[flag_index].Resize(row_count);
+        }
+
+        // Group the rows by the strings the filters match against, so a filter only needs
+        // to be matched once per distinct string rather than once per row.
+        for (int32_t row = 0; row < row_count; row++)
+        {
+            const RmtResource* resource = cache_[row].resource;
+            if (resource == nullptr)
+            {
+                resource_sizes_[row] = 0;
+                continue;
+            }
+
+            AddRowToCategory(preferred_heap_categories_, RmtResourceGetHeapTypeName(resource), row);
+            usage_categories_[RmtResourceGetUsageType(resource)].rows.Set(row);
+            resource_sizes_[row] = resource->size_in_bytes;
+
+            for (int32_t flag_index = 0; flag_index < kSnapshotCompareIdFlagCount; flag_index++)
+            {
+                if ((cache_[row].compare_id & (1 << flag_index)) != 0)
+                {
+                    compare_id_rows_[flag_index].Set(row);
+                }
+            }
+        }
+
+        row_generation_++;
     }
 
     QVariant ResourceItemModel::data(const QModelIndex& index, int role) const
@@ -9,12 +9,19 @@
 #define RMV_MODELS_RESOURCE_ITEM_MODEL_H_
 
 #include <QAbstractItemModel>
+#include <atomic>
+#include <set>
+#include <vector>
 
 #include "qt_common/custom_widgets/scaled_table_view.h"
 
 #include "rmt_data_snapshot.h"
+#include "rmt_job_system.h"
 #include "rmt_resource_list.h"
 
+#include "util/row_bitset.h"
+#include "util/trigram_index.h"
+
 /// Column Id's for the fields in the resource tables.
 enum ResourceColumn
 {
@@ -45,11 +52,30 @@ enum SnapshotCompareId
     kSnapshotCompareIdCompared  = 0x4,
 };
 
+/// The number of flags in SnapshotCompareId.
+static const int32_t kSnapshotCompareIdFlagCount = 3;
+
 namespace rmv
 {
     class ResourceItemModel : public QAbstractItemModel
     {
+        Q_OBJECT
+
     public:
+        /// A resource to show in the table, and the ID used when comparing it.
+        struct ResourceRow
+        {
+            const RmtResource* resource;    ///< The resource.
+            SnapshotCompareId  compare_id;  ///< The comparison id (if any).
+        };
+
+        /// The rows of the table that show the same string in one of the filtered columns.
+        struct RowCategory
+        {
+            QString   name;  ///< The string shown in the column.
+            RowBitset rows;  ///< The rows showing the string.
+        };
+
         /// Constructor.
         explicit ResourceItemModel(QObject* parent = nullptr);
 
@@ -70,11 +96,46 @@ namespace rmv
         /// \param compare_visible If false, hide the compare column.
         void Initialize(ScaledTableView* resource_table, bool compare_visible);
 
-        /// Add a resource to the table.
-        /// \param snapshot The snapshot where the resource data is located.
-        /// \param resource The resource to add.
-        /// \param compare_id The ID when used to compare 2 resources.
-        void AddResource(const RmtDataSnapshot* snapshot, const RmtResource* resource, SnapshotCompareId compare_id);
+        /// Replace the contents of the table with a batch of resources.
+        /// The cached data for each row is calculated in the background on the job queue workers,
+        /// and the views are reset once when all the rows are ready. The table keeps showing the
+        /// previous rows until then, and RowsReady is emitted once the new rows are shown.
+        /// \param snapshot The snapshot where the resource data is located. It must stay valid until
+        ///  RowsReady is emitted, or until the rows are changed again.
+        /// \param rows The resources to show, in row order.
+        void SetResources(const RmtDataSnapshot* snapshot, const std::vector<ResourceRow>& rows);
+
+        /// Get the rows grouped by the string in the preferred heap column.
+        /// \return The categories of rows.
+        const std::vector<RowCategory>& GetPreferredHeapCategories() const;
+
+        /// Get the rows grouped by the string in the usage column.
+        /// \return The categories of rows.
+        const std::vector<RowCategory>& GetUsageCategories() const;
+
+        /// Get the rows with a comparison id.
+        /// \param compare_id The comparison id. Only one flag should be set.
+        /// \return The rows with the comparison id.
+        const RowBitset& GetCompareIdRows(SnapshotCompareId compare_id) const;
+
+        /// Get the size of the resource in each row.
+        /// \return The sizes, in row order.
+        const std::vector<uint64_t>& GetResourceSizes() const;
+
+        /// Find the rows with the search text in any of a set of columns, using the search index.
+        /// The first search starts building the index on the job queue, and the index is used by
+        /// later searches once it is ready.
+        /// \param columns The columns to search.
+        /// \param search_text The text to search for. The search ignores case.
+        /// \param out_rows The rows containing the search text.
+        /// \return true if the rows were found using the index, false if the index isn't ready yet
+        ///  and the caller needs to search the rows itself.
+        bool SearchRows(const std::set<qint32>& columns, const QString& search_text, RowBitset& out_rows);
+
+        /// Get a value that changes every time the rows of the table change, so
+        /// anything cached per row can tell when it needs rebuilding.
+        /// \return The generation of the rows.
+        uint32_t GetRowGeneration() const;
 
         // QAbstractItemModel overrides. See Qt documentation for parameter and return values
         virtual QVariant      data(const QModelIndex& index, int role) const Q_DECL_OVERRIDE;
@@ -85,6 +146,19 @@ namespace rmv
         virtual int           rowCount(const QModelIndex& parent = QModelIndex()) const Q_DECL_OVERRIDE;
         virtual int           columnCount(const QModelIndex& parent = QModelIndex()) const Q_DECL_OVERRIDE;
 
+    signals:
+        /// Signal emitted when the rows passed to SetResources are shown in the table.
+        void RowsReady();
+
+        /// Signal emitted from the job queue when the cached data for the pending rows has been calculated.
+        /// \param request The request the cached data was calculated for.
+        void DataCacheReady(uint32_t request);
+
+    private slots:
+        /// Swap the pending cached data in to the table, if it is for the latest request.
+        /// \param request The request the cached data was calculated for.
+        void OnDataCacheReady(uint32_t request);
+
     private:
         /// Data from the backend that needs caching for speed.
         struct DataCache
@@ -108,9 +182,68 @@ namespace rmv
             QString            resource_name;    ///< The resource name.
         };
 
-        int                    num_rows_;     ///< The number of rows in the table.
-        int                    num_columns_;  ///< The number of columns in the table.
-        std::vector<DataCache> cache_;        ///< Cached data from the backend.
+        /// Calculate the cached data for a resource.
+        /// \param snapshot The snapshot where the resource data is located.
+        /// \param resource The resource.
+        /// \param compare_id The ID when used to compare 2 resources.
+        /// \param out_cache The cached data to fill in.
+        static void FillDataCache(const RmtDataSnapshot* snapshot, const RmtResource* resource, SnapshotCompareId compare_id, DataCache& out_cache);
+
+        /// Job function to calculate the pending cached data for one range of rows.
+        /// \param thread_id The worker thread running the job.
+        /// \param index The index of the range of rows.
+        /// \param input A pointer to the ResourceItemModel.
+        static void FillDataCacheJob(int32_t thread_id, int32_t index, void* input);
+
+        /// Job function to calculate the pending cached data for all the pending rows, spreading the
+        /// ranges of rows over the job queue workers, and to signal when it is done.
+        /// \param thread_id The worker thread running the job.
+        /// \param index The index of the job.
+        /// \param input A pointer to the ResourceItemModel.
+        static void FillPendingDataCacheJob(int32_t thread_id, int32_t index, void* input);
+
+        /// Stop calculating the pending cached data, waiting for the job to finish, and discard the pending rows.
+        void CancelDataCache();
+
+        /// Add a row to a category, creating the category if it is the first row with the string.
+        /// \param categories The categories of the column.
+        /// \param name The string shown in the column.
+        /// \param row The row.
+        void AddRowToCategory(std::vector<RowCategory>& categories, const char* name, int32_t row);
+
+        /// Rebuild the categories and sizes of every row.
+        void UpdateRowFilterData();
+
+        /// Stop building the search index, waiting for the job to finish, and discard the index.
+        void CancelSearchIndex();
+
+        /// Job function to build the search index from the strings shown in the rows.
+        /// \param thread_id The worker thread running the job.
+        /// \param index The index of the job.
+        /// \param input A pointer to the ResourceItemModel.
+        static void BuildSearchIndexJob(int32_t thread_id, int32_t index, void* input);
+
+        int                      num_rows_;                                      ///< The number of rows in the table.
+        int                      num_columns_;                                   ///< The number of columns in the table.
+        std::vector<DataCache>   cache_;                                         ///< Cached data from the backend.
+        const RmtDataSnapshot*   pending_snapshot_;                              ///< The snapshot where the pending rows are located.
+        std::vector<ResourceRow> pending_rows_;                                  ///< The rows waiting for their cached data.
+        std::vector<DataCache>   pending_cache_;                                 ///< The cached data being calculated for the pending rows.
+        uint32_t                 data_cache_request_;                            ///< Incremented every time the pending rows change.
+        RmtJobHandle             data_cache_job_;                                ///< The job calculating the pending cached data.
+        bool                     data_cache_job_pending_;                        ///< If true, the pending cached data job has been added to the job queue.
+        std::atomic<bool>        data_cache_cancelled_;                          ///< Set to stop the jobs calculating the pending cached data.
+        std::vector<RowCategory> preferred_heap_categories_;                     ///< The rows grouped by preferred heap.
+        std::vector<RowCategory> usage_categories_;                              ///< The rows grouped by usage.
+        RowBitset                compare_id_rows_[kSnapshotCompareIdFlagCount];  ///< The rows with each comparison id flag.
+        std::vector<uint64_t>    resource_sizes_;                                ///< The size of the resource in each row.
+        uint32_t                 row_generation_;                                ///< Incremented every time the rows change.
+        TrigramIndex             search_index_;                                  ///< The index of the strings shown in the searched columns.
+        std::set<qint32>         search_index_columns_;                          ///< The columns in the search index.
+        RmtJobHandle             search_index_job_;                              ///< The job building the search index.
+        bool                     search_index_job_pending_;                      ///< If true, the search index job has been added to the job queue.
+        std::atomic<bool>        search_index_ready_;                            ///< Set by the job once the search index can be used.
+        std::atomic<bool>        search_index_cancelled_;                        ///< Set to stop the job building the search index.
     };
 }  // namespace rmv
 
@@ -124,15 +124,21 @@ namespace rmv
         // update resource table
         const RmtDataSnapshot* open_snapshot = trace_manager.GetOpenSnapshot();
         resource_count                       = selected_allocation->resource_count;
-        resource_table_model_->SetRowCount(resource_count);
+        std::vector<ResourceItemModel::ResourceRow> rows(resource_count);
         for (int32_t i = 0; i < resource_count; i++)
         {
-            resource_table_model_->AddResource(open_snapshot, selected_allocation->resources[i], kSnapshotCompareIdUndefined);
+            rows[i].resource   = selected_allocation->resources[i];
+            rows[i].compare_id = kSnapshotCompareIdUndefined;
         }
-        resource_proxy_model_->invalidate();
+        resource_table_model_->SetResources(open_snapshot, rows);
         return resource_count;
     }
 
+    void VirtualAllocationExplorerModel::OnResourceRowsReady()
+    {
+        resource_proxy_model_->invalidate();
+    }
+
     void VirtualAllocationExplorerModel::InitializeAllocationTableModel(ScaledTableView* table_view, uint num_rows, uint num_columns)
     {
         RMT_ASSERT(allocation_proxy_model_ == nullptr);
@@ -164,6 +170,8 @@ namespace rmv
         resource_proxy_model_ = new ResourceProxyModel();
         resource_table_model_ = resource_proxy_model_->InitializeResourceTableModels(table_view, num_rows, num_columns);
         resource_table_model_->Initialize(table_view, false);
+
+        connect(resource_table_model_, &ResourceItemModel::RowsReady, this, &VirtualAllocationExplorerModel::OnResourceRowsReady);
     }
 
     void VirtualAllocationExplorerModel::AllocationSearchBoxChanged(const QString& filter)
@@ -184,8 +192,10 @@ namespace rmv
 
     void VirtualAllocationExplorerModel::ResourceSearchBoxChanged(const QString& filter)
     {
-        resource_proxy_model_->SetSearchFilter(filter);
-        resource_proxy_model_->invalidate();
+        if (resource_proxy_model_->SetSearchFilter(filter))
+        {
+            resource_proxy_model_->invalidate();
+        }
     }
 
     void VirtualAllocationExplorerModel::ResourceSizeFilterChanged(int min_value, int max_value)
@@ -195,8 +205,10 @@ namespace rmv
             const uint64_t scaled_min = resource_thresholds_[min_value];
             const uint64_t scaled_max = resource_thresholds_[max_value];
 
-            resource_proxy_model_->SetSizeFilter(scaled_min, scaled_max);
-            resource_proxy_model_->invalidate();
+            if (resource_proxy_model_->SetSizeFilter(scaled_min, scaled_max))
+            {
+                resource_proxy_model_->invalidate();
+            }
         }
     }
 
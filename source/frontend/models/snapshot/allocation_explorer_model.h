@@ -98,7 +98,8 @@ namespace rmv
         /// Update the allocation table. Only needs to be done when loading in a new snapshot.
         void UpdateAllocationTable();
 
-        /// Update the resource table. Updated when an allocation is selected.
+        /// Update the resource table. Updated when an allocation is selected. The rows are shown
+        /// once the table model has calculated them.
         /// \return The number of resources in the allocation.
         int32_t UpdateResourceTable();
 
@@ -117,6 +118,10 @@ namespace rmv
         /// \return The allocation bar model.
         AllocationBarModel* GetAllocationBarModel() const;
 
+    private slots:
+        /// Filter the rows once the new rows are in the resource table.
+        void OnResourceRowsReady();
+
     private:
         AllocationBarModel*   allocation_bar_model_;                       ///< The model for the allocation bar graph.
         AllocationItemModel*  allocation_table_model_;                     ///< Holds the allocation table data.
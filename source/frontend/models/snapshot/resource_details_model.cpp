@@ -290,7 +290,7 @@ namespace rmv
         }
     }
 
-    void ResourceDetailsModel::GenerateResourceHistory(RmtResourceIdentifier resource_identifier)
+    void ResourceDetailsModel::GenerateResourceHistory(RmtResourceIdentifier resource_identifier, RmtProgress* progress)
     {
         const TraceManager& trace_manager = TraceManager::Get();
         if (trace_manager.DataSetValid())
@@ -300,7 +300,7 @@ namespace rmv
             const RmtResource* resource    = nullptr;
             GetResourceFromResourceId(resource_identifier, &resource);
 
-            RmtDataSnapshotGenerateResourceHistory(open_snapshot, resource, &resource_history_);
+            RmtDataSnapshotGenerateResourceHistory(open_snapshot, resource, progress, &resource_history_);
         }
     }
 
@@ -135,7 +135,9 @@ namespace rmv
         /// Generate the resource history from the backend data.
         /// This is run in a background thread so it's important to check the data is valid before
         /// trying to access it.
-        void GenerateResourceHistory(RmtResourceIdentifier resource_identifier);
+        /// \param resource_identifier The identifier of the resource to generate the history for.
+        /// \param progress The progress of the background task, which can be used to cancel it.
+        void GenerateResourceHistory(RmtResourceIdentifier resource_identifier, RmtProgress* progress);
 
         /// Get the data for the heap residency.
         /// \param resource_identifier The ID of the resource to obtain.
@@ -44,14 +44,7 @@ namespace rmv
 
     void ResourceListModel::UpdateBottomLabels()
     {
-        int32_t row_count  = proxy_model_->rowCount();
-        int64_t total_size = 0;
-
-        for (int32_t i = 0; i < row_count; i++)
-        {
-            const uint64_t size = proxy_model_->GetData(i, kResourceColumnSize);
-            total_size += size;
-        }
+        const uint64_t total_size = proxy_model_->GetFilteredSize();
 
         SetModelData(kResourceListTotalResources, rmv::string_util::LocalizedValue(proxy_model_->rowCount()));
         SetModelData(kResourceListTotalSize, rmv::string_util::LocalizedValueMemory(total_size, false, false));
@@ -75,30 +68,38 @@ namespace rmv
 
             RMT_ASSERT(resource_list);
 
-            table_model_->SetRowCount(resource_list->resource_count);
+            std::vector<ResourceItemModel::ResourceRow> rows(resource_list->resource_count);
             for (int32_t currentResourceIndex = 0; currentResourceIndex < resource_list->resource_count; currentResourceIndex++)
             {
-                const RmtResource* resource = &resource_list->resources[currentResourceIndex];
-                table_model_->AddResource(snapshot, resource, kSnapshotCompareIdUndefined);
+                rows[currentResourceIndex].resource   = &resource_list->resources[currentResourceIndex];
+                rows[currentResourceIndex].compare_id = kSnapshotCompareIdUndefined;
             }
-            proxy_model_->invalidate();
+            table_model_->SetResources(snapshot, rows);
         }
     }
 
-    void ResourceListModel::UpdatePreferredHeapList(const QString& preferred_heap_filter)
+    void ResourceListModel::OnResourceRowsReady()
     {
-        proxy_model_->SetPreferredHeapFilter(preferred_heap_filter);
         proxy_model_->invalidate();
-
         UpdateBottomLabels();
     }
 
-    void ResourceListModel::UpdateResourceUsageList(const QString& resource_usage_filter)
+    void ResourceListModel::UpdatePreferredHeapList(const QString& preferred_heap_filter)
     {
-        proxy_model_->SetResourceUsageFilter(resource_usage_filter);
-        proxy_model_->invalidate();
+        if (proxy_model_->SetPreferredHeapFilter(preferred_heap_filter))
+        {
+            proxy_model_->invalidate();
+            UpdateBottomLabels();
+        }
+    }
 
-        UpdateBottomLabels();
+    void ResourceListModel::UpdateResourceUsageList(const QString& resource_usage_filter)
+    {
+        if (proxy_model_->SetResourceUsageFilter(resource_usage_filter))
+        {
+            proxy_model_->invalidate();
+            UpdateBottomLabels();
+        }
     }
 
     void ResourceListModel::InitializeTableModel(ScaledTableView* table_view, uint num_rows, uint num_columns)
@@ -112,14 +113,17 @@ namespace rmv
         proxy_model_ = new ResourceProxyModel();
         table_model_ = proxy_model_->InitializeResourceTableModels(table_view, num_rows, num_columns);
         table_model_->Initialize(table_view, false);
+
+        connect(table_model_, &ResourceItemModel::RowsReady, this, &ResourceListModel::OnResourceRowsReady);
     }
 
     void ResourceListModel::SearchBoxChanged(const QString& filter)
     {
-        proxy_model_->SetSearchFilter(filter);
-        proxy_model_->invalidate();
-
-        UpdateBottomLabels();
+        if (proxy_model_->SetSearchFilter(filter))
+        {
+            proxy_model_->invalidate();
+            UpdateBottomLabels();
+        }
     }
 
     void ResourceListModel::FilterBySizeChanged(int min_value, int max_value)
@@ -128,10 +132,11 @@ namespace rmv
         const uint64_t      scaled_min    = trace_manager.GetSizeFilterThreshold(min_value);
         const uint64_t      scaled_max    = trace_manager.GetSizeFilterThreshold(max_value);
 
-        proxy_model_->SetSizeFilter(scaled_min, scaled_max);
-        proxy_model_->invalidate();
-
-        UpdateBottomLabels();
+        if (proxy_model_->SetSizeFilter(scaled_min, scaled_max))
+        {
+            proxy_model_->invalidate();
+            UpdateBottomLabels();
+        }
     }
 
     ResourceProxyModel* ResourceListModel::GetResourceProxyModel() const
@@ -76,9 +76,15 @@ namespace rmv
         /// Update the labels on the bottom.
         void UpdateBottomLabels();
 
-        /// Update the resource list table.
+        /// Update the resource list table. The rows are shown once the table model has calculated them.
         void UpdateTable();
 
+    private slots:
+        /// Filter the rows and update the labels once the new rows are in the table.
+        void OnResourceRowsReady();
+
+    private:
+
         ResourceItemModel*  table_model_;  ///< Resource table model data.
         ResourceProxyModel* proxy_model_;  ///< Proxy model for resource table.
     };
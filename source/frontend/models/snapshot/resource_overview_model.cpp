@@ -66,6 +66,16 @@ namespace rmv
         return false;
     }
 
+    uint64_t ResourceOverviewModel::GetMinimumResourceSize() const
+    {
+        return min_resource_size_;
+    }
+
+    uint64_t ResourceOverviewModel::GetMaximumResourceSize() const
+    {
+        return max_resource_size_;
+    }
+
     void ResourceOverviewModel::Update()
     {
         ResetModelValues();
@@ -44,6 +44,14 @@ namespace rmv
         /// \return true if the size is in range, false otherwise.
         bool IsSizeInRange(uint64_t resource_size) const;
 
+        /// Get the minimum resource size shown by the size slider.
+        /// \return The minimum resource size, in bytes.
+        uint64_t GetMinimumResourceSize() const;
+
+        /// Get the maximum resource size shown by the size slider.
+        /// \return The maximum resource size, in bytes.
+        uint64_t GetMaximumResourceSize() const;
+
         /// Update the model.
         void Update();
 
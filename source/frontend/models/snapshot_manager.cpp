@@ -5,12 +5,18 @@
 /// \brief  Implementation of the RMV Snapshot Manager.
 //==============================================================================
 
+#include "models/snapshot_manager.h"
+
+#include <algorithm>
+
 #include "rmt_assert.h"
 #include "rmt_data_snapshot.h"
 
 #include "models/message_manager.h"
-#include "models/snapshot_manager.h"
 #include "models/trace_manager.h"
+#include "settings/rmv_settings.h"
+#include "views/debug_window.h"
+#include "views/main_window.h"
 
 /// Worker class definition to generate a snapshot on a separate thread.
 class SnapshotWorker : public rmv::BackgroundTask
@@ -47,10 +53,11 @@ public:
     /// Worker thread function.
     virtual void ThreadFunc()
     {
-        GenerateSnapshot(kSnapshotCompareBase);
-        GenerateSnapshot(kSnapshotCompareDiff);
+        const bool base_generated = GenerateSnapshot(kSnapshotCompareBase);
+        const bool diff_generated = GenerateSnapshot(kSnapshotCompareDiff);
 
-        if (snapshot_[kSnapshotCompareBase] != nullptr)
+        // Nothing is opened if the user cancelled generating either snapshot.
+        if (base_generated && diff_generated)
         {
             if (snapshot_[kSnapshotCompareDiff] != nullptr)
             {
@@ -67,16 +74,27 @@ private:
     /// Call the backend function to generate the snapshot. If the snapshot is already
     /// cached, use that instead.
     /// \param index The index of the snapshot point to use (base or diff).
-    void GenerateSnapshot(int32_t index)
+    /// \return false if generating the snapshot was cancelled, true otherwise.
+    bool GenerateSnapshot(int32_t index)
     {
         if (snapshot_point_[index] != nullptr)
         {
             if (snapshot_point_[index]->cached_snapshot == nullptr)
             {
-                RmtDataSnapshot*   new_snapshot = new RmtDataSnapshot();
-                RmtDataSet*        data_set     = TraceManager::Get().GetDataSet();
-                const RmtErrorCode error_code   = RmtDataSetGenerateSnapshot(data_set, snapshot_point_[index], new_snapshot);
-                RMT_ASSERT(error_code == RMT_OK);
+                // The snapshot may already be being generated in the background.
+                RmtDataSnapshot* new_snapshot = SnapshotManager::Get().TakePrefetchedSnapshot(snapshot_point_[index]);
+                if (new_snapshot == nullptr)
+                {
+                    new_snapshot                  = new RmtDataSnapshot();
+                    RmtDataSet*        data_set   = TraceManager::Get().GetDataSet();
+                    const RmtErrorCode error_code = RmtDataSetGenerateSnapshot(data_set, snapshot_point_[index], GetProgress(), new_snapshot);
+                    if (error_code == static_cast<RmtErrorCode>(RMT_ERROR_CANCELLED))
+                    {
+                        delete new_snapshot;
+                        return false;
+                    }
+                    RMT_ASSERT(error_code == RMT_OK);
+                }
 
                 *snapshot_[index] = new_snapshot;
             }
@@ -85,6 +103,7 @@ private:
                 *snapshot_[index] = snapshot_point_[index]->cached_snapshot;
             }
         }
+        return true;
     }
 
     RmtSnapshotPoint* snapshot_point_[kSnapshotCompareCount];  ///< The snapshot point the snapshot was taken.
@@ -97,7 +116,16 @@ static SnapshotManager snapshot_manager;
 SnapshotManager::SnapshotManager()
     : thread_controller_(nullptr)
     , selected_snapshot_(nullptr)
+    , prefetch_slots_{}
+    , prefetch_count_(0)
+    , prefetch_job_(0)
+    , prefetch_pending_(false)
+    , prefetch_progress_{}
+    , deferred_prefetch_point_(nullptr)
+    , statistics_{}
 {
+    // The prefetch jobs signal from a worker thread, so the snapshots are added to the cache on the GUI thread.
+    connect(this, &SnapshotManager::PrefetchFinished, this, &SnapshotManager::OnPrefetchFinished, Qt::QueuedConnection);
 }
 
 SnapshotManager::~SnapshotManager()
@@ -114,6 +142,8 @@ void SnapshotManager::GenerateSnapshot(RmtSnapshotPoint* snapshot_point, MainWin
     RMT_ASSERT(thread_controller_ == nullptr);
     if (thread_controller_ == nullptr)
     {
+        statistics_.misses++;
+
         // start the processing thread and pass in the worker object. The thread controller will take ownership
         // of the worker and delete it once it's complete. Passes in a pointer to a variable that accepts the
         // generated snapshot ID so this can be saved after the worker thread finishes
@@ -133,6 +163,18 @@ void SnapshotManager::GenerateComparison(RmtSnapshotPoint* snapshot_base_point,
     RMT_ASSERT(thread_controller_ == nullptr);
     if (thread_controller_ == nullptr)
     {
+        for (const RmtSnapshotPoint* snapshot_point : {snapshot_base_point, snapshot_diff_point})
+        {
+            if (snapshot_point->cached_snapshot == nullptr)
+            {
+                statistics_.misses++;
+            }
+            else
+            {
+                statistics_.hits++;
+            }
+        }
+
         // start the processing thread and pass in the worker object. The thread controller will take ownership
         // of the worker and delete it once it's complete. Passes in a pointer to a variable that accepts the
         // generated snapshot ID so this can be saved after the worker thread finishes
@@ -149,6 +191,18 @@ void SnapshotManager::GenerateSnapshotCompleted()
     disconnect(thread_controller_, &rmv::ThreadController::ThreadFinished, this, &SnapshotManager::GenerateSnapshotCompleted);
     thread_controller_->deleteLater();
     thread_controller_ = nullptr;
+
+    // Snapshots generated in the background while the worker was running were left for it to take.
+    AddPrefetchedSnapshots();
+}
+
+void SnapshotManager::OnPrefetchFinished()
+{
+    // The snapshot worker only takes prefetched snapshots that aren't cached yet, so don't cache them under it.
+    if (thread_controller_ == nullptr)
+    {
+        AddPrefetchedSnapshots();
+    }
 }
 
 RmtSnapshotPoint* SnapshotManager::GetSelectedSnapshotPoint() const
@@ -160,3 +214,404 @@ void SnapshotManager::SetSelectedSnapshotPoint(RmtSnapshotPoint* snapshot_point)
 {
     selected_snapshot_ = snapshot_point;
 }
+
+void SnapshotManager::SnapshotsOpened(RmtSnapshotPoint* snapshot_point, RmtSnapshotPoint* diff_snapshot_point)
+{
+    OnPrefetchFinished();
+
+    // Snapshots opened while a snapshot worker is running were counted when the worker was started.
+    const bool generated = (thread_controller_ != nullptr);
+    for (RmtSnapshotPoint* current_snapshot_point : {diff_snapshot_point, snapshot_point})
+    {
+        if (current_snapshot_point == nullptr || current_snapshot_point->cached_snapshot == nullptr)
+        {
+            continue;
+        }
+
+        CachedSnapshot& entry = TouchCachedSnapshot(current_snapshot_point->cached_snapshot);
+        if (generated == false)
+        {
+            statistics_.hits++;
+        }
+        if (entry.prefetched == true)
+        {
+            statistics_.prefetch_hits++;
+            entry.prefetched = false;
+        }
+    }
+
+    TrimCache();
+
+    if (snapshot_point != nullptr)
+    {
+        StartPrefetch(snapshot_point);
+    }
+
+    LogCacheStatistics();
+}
+
+void SnapshotManager::FinishPrefetch()
+{
+    deferred_prefetch_point_ = nullptr;
+
+    RmtJobHandle job_handle       = 0;
+    bool         prefetch_pending = false;
+    {
+        QMutexLocker locker(&prefetch_mutex_);
+        job_handle       = prefetch_job_;
+        prefetch_pending = prefetch_pending_;
+    }
+
+    if (prefetch_pending == false)
+    {
+        return;
+    }
+
+    // The jobs stop at their next progress update, so this doesn't wait for whole snapshots to be generated.
+    RmtProgressCancel(&prefetch_progress_);
+    RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), job_handle);
+    AddPrefetchedSnapshots();
+}
+
+void SnapshotManager::AddPrefetchedSnapshots()
+{
+    // Copy the finished slots out under the lock, then update the cache without it.
+    std::vector<PrefetchSlot> finished_slots;
+    bool                      all_finished = true;
+    {
+        QMutexLocker locker(&prefetch_mutex_);
+        for (int32_t slot_index = 0; slot_index < prefetch_count_; slot_index++)
+        {
+            PrefetchSlot& slot = prefetch_slots_[slot_index];
+            if (slot.snapshot_point == nullptr)
+            {
+                continue;
+            }
+
+            // Leave a snapshot the snapshot worker is waiting for until it has taken it.
+            if (slot.finished == false || (slot.requested == true && slot.taken == false))
+            {
+                all_finished = false;
+                continue;
+            }
+
+            finished_slots.push_back(slot);
+            slot.snapshot_point = nullptr;
+            slot.snapshot       = nullptr;
+        }
+
+        if (all_finished == true)
+        {
+            prefetch_count_   = 0;
+            prefetch_pending_ = false;
+        }
+    }
+
+    for (const PrefetchSlot& slot : finished_slots)
+    {
+        if (slot.taken == true)
+        {
+            // The snapshot worker opened it, so it has already been counted as a miss.
+            if (slot.error_code == RMT_OK)
+            {
+                statistics_.prefetches++;
+                statistics_.prefetch_hits++;
+            }
+        }
+        else if (slot.snapshot != nullptr)
+        {
+            if (slot.snapshot_point->cached_snapshot == nullptr)
+            {
+                slot.snapshot_point->cached_snapshot = slot.snapshot;
+                TouchCachedSnapshot(slot.snapshot).prefetched = true;
+                statistics_.prefetches++;
+            }
+            else
+            {
+                RmtDataSnapshotDestroy(slot.snapshot);
+                delete slot.snapshot;
+            }
+        }
+    }
+
+    if (finished_slots.empty() == false)
+    {
+        TrimCache();
+    }
+
+    if (all_finished == true && deferred_prefetch_point_ != nullptr)
+    {
+        const RmtSnapshotPoint* snapshot_point = deferred_prefetch_point_;
+        deferred_prefetch_point_               = nullptr;
+        StartPrefetch(snapshot_point);
+    }
+}
+
+RmtDataSnapshot* SnapshotManager::TakePrefetchedSnapshot(RmtSnapshotPoint* snapshot_point)
+{
+    // Mark the slot as requested, so it isn't added to the cache while this waits for it.
+    int32_t      requested_slot_index = -1;
+    RmtJobHandle job_handle           = 0;
+    {
+        QMutexLocker locker(&prefetch_mutex_);
+        for (int32_t slot_index = 0; slot_index < prefetch_count_; slot_index++)
+        {
+            PrefetchSlot& slot = prefetch_slots_[slot_index];
+            if (slot.snapshot_point == snapshot_point && slot.requested == false)
+            {
+                slot.requested       = true;
+                requested_slot_index = slot_index;
+                job_handle           = prefetch_job_;
+                break;
+            }
+        }
+    }
+
+    if (requested_slot_index < 0)
+    {
+        return nullptr;
+    }
+
+    RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), job_handle);
+
+    QMutexLocker     locker(&prefetch_mutex_);
+    PrefetchSlot&    slot     = prefetch_slots_[requested_slot_index];
+    RmtDataSnapshot* snapshot = slot.snapshot;
+    slot.snapshot             = nullptr;
+    slot.taken                = true;
+    return snapshot;
+}
+
+void SnapshotManager::ClearCache()
+{
+    // Stop generating any snapshot the user is waiting on, since the data set is about to go. The prefetch is cancelled
+    // first, as the snapshot worker may be waiting for a prefetched snapshot.
+    RmtProgressCancel(&prefetch_progress_);
+    if (thread_controller_ != nullptr)
+    {
+        thread_controller_->Cancel();
+    }
+
+    // Free the snapshots removed from the data set; the rest are freed with the trace.
+    FinishPrefetch();
+    TrimCache();
+    cache_.clear();
+    statistics_.cached_count = 0;
+    statistics_.cached_size  = 0;
+}
+
+SnapshotCacheStatistics SnapshotManager::GetCacheStatistics() const
+{
+    return statistics_;
+}
+
+SnapshotManager::CachedSnapshot& SnapshotManager::TouchCachedSnapshot(RmtDataSnapshot* snapshot)
+{
+    auto it = std::find_if(cache_.begin(), cache_.end(), [snapshot](const CachedSnapshot& entry) { return entry.snapshot == snapshot; });
+    if (it == cache_.end())
+    {
+        const CachedSnapshot entry = {snapshot, RmtDataSnapshotGetMemorySizeInBytes(snapshot), false};
+        cache_.insert(cache_.begin(), entry);
+    }
+    else
+    {
+        std::rotate(cache_.begin(), it, it + 1);
+    }
+
+    return cache_.front();
+}
+
+void SnapshotManager::TrimCache()
+{
+    TraceManager& trace_manager = TraceManager::Get();
+    if (trace_manager.DataSetValid() == false)
+    {
+        return;
+    }
+
+    RmtDataSet* data_set = trace_manager.GetDataSet();
+
+    // Snapshots generated by the snapshot worker go in as recently used. Snapshots in the cache that no snapshot point
+    // refers to were removed from the data set, which destroys their contents but not the snapshot itself.
+    std::vector<RmtSnapshotPoint*> snapshot_points(cache_.size(), nullptr);
+    for (int32_t snapshot_index = 0; snapshot_index < data_set->snapshot_count; snapshot_index++)
+    {
+        RmtSnapshotPoint* snapshot_point = &data_set->snapshots[snapshot_index];
+        if (snapshot_point->cached_snapshot == nullptr)
+        {
+            continue;
+        }
+
+        auto it = std::find_if(
+            cache_.begin(), cache_.end(), [snapshot_point](const CachedSnapshot& entry) { return entry.snapshot == snapshot_point->cached_snapshot; });
+        if (it == cache_.end())
+        {
+            TouchCachedSnapshot(snapshot_point->cached_snapshot);
+            snapshot_points.insert(snapshot_points.begin(), snapshot_point);
+        }
+        else
+        {
+            snapshot_points[it - cache_.begin()] = snapshot_point;
+        }
+    }
+
+    for (size_t entry_index = snapshot_points.size(); entry_index-- > 0;)
+    {
+        if (snapshot_points[entry_index] == nullptr)
+        {
+            delete cache_[entry_index].snapshot;
+            cache_.erase(cache_.begin() + entry_index);
+            snapshot_points.erase(snapshot_points.begin() + entry_index);
+        }
+    }
+
+    uint64_t cached_size = 0;
+    for (const CachedSnapshot& entry : cache_)
+    {
+        cached_size += entry.size_in_bytes;
+    }
+
+    // Free the least recently used snapshots until the cache fits, keeping the snapshots that are in use.
+    const uint64_t budget = GetCacheBudget();
+    for (size_t entry_index = cache_.size(); entry_index-- > 0 && cached_size > budget;)
+    {
+        RmtDataSnapshot* snapshot = cache_[entry_index].snapshot;
+        if (trace_manager.GetOpenSnapshot() == snapshot || trace_manager.GetComparedSnapshot(kSnapshotCompareBase) == snapshot ||
+            trace_manager.GetComparedSnapshot(kSnapshotCompareDiff) == snapshot)
+        {
+            continue;
+        }
+
+        snapshot_points[entry_index]->cached_snapshot = nullptr;
+        RmtDataSnapshotDestroy(snapshot);
+        delete snapshot;
+
+        cached_size -= cache_[entry_index].size_in_bytes;
+        cache_.erase(cache_.begin() + entry_index);
+        snapshot_points.erase(snapshot_points.begin() + entry_index);
+        statistics_.evictions++;
+    }
+
+    statistics_.cached_count = static_cast<int32_t>(cache_.size());
+    statistics_.cached_size  = cached_size;
+}
+
+void SnapshotManager::StartPrefetch(const RmtSnapshotPoint* snapshot_point)
+{
+    // The snapshots still being generated around the last snapshot opened are unlikely to be opened next, so stop them
+    // rather than wait for them.
+    if (prefetch_pending_ == true)
+    {
+        RmtProgressCancel(&prefetch_progress_);
+        deferred_prefetch_point_ = snapshot_point;
+        return;
+    }
+
+    TraceManager& trace_manager = TraceManager::Get();
+    if (trace_manager.DataSetValid() == false || snapshot_point->cached_snapshot == nullptr)
+    {
+        return;
+    }
+
+    // Only prefetch if the snapshots fit in the budget, rather than throwing away snapshots that have been used for
+    // ones that might not be. Snapshots of the same trace are about the same size, so use the opened one as a guide.
+    const uint64_t snapshot_size = RmtDataSnapshotGetMemorySizeInBytes(snapshot_point->cached_snapshot);
+    uint64_t       free_size     = GetCacheBudget() - std::min(GetCacheBudget(), statistics_.cached_size);
+
+    // Find the nearest snapshot points before and after the opened one.
+    RmtDataSet*       data_set                      = trace_manager.GetDataSet();
+    RmtSnapshotPoint* neighbours[kMaxPrefetchCount] = {};
+    for (int32_t snapshot_index = 0; snapshot_index < data_set->snapshot_count; snapshot_index++)
+    {
+        RmtSnapshotPoint* current_snapshot_point = &data_set->snapshots[snapshot_index];
+        if (current_snapshot_point == snapshot_point)
+        {
+            continue;
+        }
+
+        if (current_snapshot_point->timestamp <= snapshot_point->timestamp)
+        {
+            if (neighbours[0] == nullptr || current_snapshot_point->timestamp > neighbours[0]->timestamp)
+            {
+                neighbours[0] = current_snapshot_point;
+            }
+        }
+        else if (neighbours[1] == nullptr || current_snapshot_point->timestamp < neighbours[1]->timestamp)
+        {
+            neighbours[1] = current_snapshot_point;
+        }
+    }
+
+    QMutexLocker locker(&prefetch_mutex_);
+    prefetch_count_ = 0;
+    for (RmtSnapshotPoint* neighbour : neighbours)
+    {
+        if (neighbour == nullptr || neighbour->cached_snapshot != nullptr || free_size < snapshot_size)
+        {
+            continue;
+        }
+
+        prefetch_slots_[prefetch_count_++] = {neighbour, nullptr, RMT_OK, false, false, false};
+        free_size -= snapshot_size;
+    }
+
+    if (prefetch_count_ > 0)
+    {
+        RmtProgressInitialize(&prefetch_progress_, 1);
+        const RmtErrorCode error_code = RmtJobQueueAddMultiple(MainWindow::GetJobQueue(), PrefetchJob, this, 0, prefetch_count_, &prefetch_job_);
+        prefetch_pending_             = (error_code == RMT_OK);
+        if (prefetch_pending_ == false)
+        {
+            prefetch_count_ = 0;
+        }
+    }
+}
+
+void SnapshotManager::PrefetchJob(int32_t thread_id, int32_t index, void* input)
+{
+    Q_UNUSED(thread_id);
+
+    SnapshotManager*  snapshot_manager = static_cast<SnapshotManager*>(input);
+    RmtSnapshotPoint* snapshot_point   = nullptr;
+    {
+        QMutexLocker locker(&snapshot_manager->prefetch_mutex_);
+        snapshot_point = snapshot_manager->prefetch_slots_[index].snapshot_point;
+    }
+
+    // The snapshot is generated without the lock, so the snapshot worker can ask for it in the meantime.
+    RmtDataSnapshot*   snapshot   = new RmtDataSnapshot();
+    const RmtErrorCode error_code = RmtDataSetGenerateSnapshot(TraceManager::Get().GetDataSet(), snapshot_point, &snapshot_manager->prefetch_progress_, snapshot);
+    if (error_code != RMT_OK)
+    {
+        delete snapshot;
+        snapshot = nullptr;
+    }
+
+    {
+        QMutexLocker  locker(&snapshot_manager->prefetch_mutex_);
+        PrefetchSlot& slot = snapshot_manager->prefetch_slots_[index];
+        slot.snapshot      = snapshot;
+        slot.error_code    = error_code;
+        slot.finished      = true;
+    }
+
+    emit snapshot_manager->PrefetchFinished();
+}
+
+uint64_t SnapshotManager::GetCacheBudget()
+{
+    return static_cast<uint64_t>(std::max(RMVSettings::Get().GetSnapshotCacheSize(), 0)) * 1024 * 1024;
+}
+
+void SnapshotManager::LogCacheStatistics() const
+{
+    DebugWindow::DbgMsg("Snapshot cache: %d snapshots, %.1f of %.1f MB, %llu hits, %llu misses, %llu evictions, %llu prefetched (%llu used)",
+                        statistics_.cached_count,
+                        statistics_.cached_size / (1024.0 * 1024.0),
+                        GetCacheBudget() / (1024.0 * 1024.0),
+                        static_cast<unsigned long long>(statistics_.hits),
+                        static_cast<unsigned long long>(statistics_.misses),
+                        static_cast<unsigned long long>(statistics_.evictions),
+                        static_cast<unsigned long long>(statistics_.prefetches),
+                        static_cast<unsigned long long>(statistics_.prefetch_hits));
+}
@@ -8,9 +8,13 @@
 #ifndef RMV_MODELS_SNAPSHOT_MANAGER_H_
 #define RMV_MODELS_SNAPSHOT_MANAGER_H_
 
+#include <QMutex>
 #include <QObject>
+#include <vector>
 
 #include "rmt_data_set.h"
+#include "rmt_job_system.h"
+#include "rmt_progress.h"
 
 #include "util/thread_controller.h"
 
@@ -22,11 +26,27 @@ enum CompareSnapshots
     kSnapshotCompareCount
 };
 
+/// Counters describing how well the snapshot cache is working, shown in the debug window.
+struct SnapshotCacheStatistics
+{
+    uint64_t hits;           ///< The number of snapshots opened that had already been generated.
+    uint64_t misses;         ///< The number of snapshots opened that had to be generated first.
+    uint64_t evictions;      ///< The number of snapshots freed to keep the cache inside its memory budget.
+    uint64_t prefetches;     ///< The number of snapshots generated in the background.
+    uint64_t prefetch_hits;  ///< The number of snapshots generated in the background that were then opened.
+    int32_t  cached_count;   ///< The number of snapshots in the cache.
+    uint64_t cached_size;    ///< The total size of the snapshots in the cache, in bytes.
+};
+
 /// Class to handle the generation of a single snapshot and snapshots used for comparison.
 /// Since snapshot generation can take a few seconds, the generation itself is done on a
 /// worker thread while the main UI thread displays a loading animation. This functionality
 /// is abstracted away in this class and a couple methods are added to initiate snapshot
 /// generation.
+///
+/// Generated snapshots are kept in a least recently used cache with a memory budget, and
+/// the snapshots either side of the one opened are generated on the job queue in case they
+/// are opened next.
 class SnapshotManager : public QObject
 {
     Q_OBJECT
@@ -64,13 +84,105 @@ public:
     /// \param snapshot_point The snapshot point selected.
     void SetSelectedSnapshotPoint(RmtSnapshotPoint* snapshot_point);
 
+    /// Called once snapshots have been generated and opened. Marks them as the most recently used, frees the least
+    /// recently used snapshots that don't fit in the memory budget, and starts generating the snapshots either side
+    /// of the opened one.
+    /// \param snapshot_point The snapshot point opened, or the base snapshot point of a comparison.
+    /// \param diff_snapshot_point The diff snapshot point of a comparison, or nullptr.
+    void SnapshotsOpened(RmtSnapshotPoint* snapshot_point, RmtSnapshotPoint* diff_snapshot_point);
+
+    /// Stop generating snapshots in the background, and add the ones already generated to the cache. Must be called
+    /// before the snapshot points in the data set are added, removed or renamed, as the background jobs update them.
+    void FinishPrefetch();
+
+    /// Take a snapshot generated in the background, waiting for it to finish if needed. Called from the snapshot
+    /// worker thread, so a snapshot that is being prefetched isn't generated twice.
+    /// \param snapshot_point The snapshot point to take the snapshot for.
+    /// \return The snapshot, or nullptr if it wasn't being prefetched. The caller takes ownership of it.
+    RmtDataSnapshot* TakePrefetchedSnapshot(RmtSnapshotPoint* snapshot_point);
+
+    /// Forget all the cached snapshots, stopping any background jobs first. Called before the trace is closed, which
+    /// destroys the snapshots themselves.
+    void ClearCache();
+
+    /// Get the snapshot cache statistics.
+    /// \return The statistics.
+    SnapshotCacheStatistics GetCacheStatistics() const;
+
+signals:
+    /// Signal emitted from the job queue when a snapshot has been generated in the background.
+    void PrefetchFinished();
+
 private slots:
     /// Slot to handle what happens when the snapshot worker thread has finished.
     void GenerateSnapshotCompleted();
 
+    /// Add the snapshots generated in the background to the cache, unless the snapshot worker may be taking them.
+    void OnPrefetchFinished();
+
 private:
-    rmv::ThreadController* thread_controller_;  ///< The thread for processing backend data.
-    RmtSnapshotPoint*      selected_snapshot_;  ///< The selected snapshot point.
+    /// A snapshot in the cache.
+    struct CachedSnapshot
+    {
+        RmtDataSnapshot* snapshot;       ///< The snapshot.
+        uint64_t         size_in_bytes;  ///< The memory used by the snapshot.
+        bool             prefetched;     ///< Set if the snapshot was generated in the background and hasn't been opened yet.
+    };
+
+    /// A snapshot being generated in the background.
+    struct PrefetchSlot
+    {
+        RmtSnapshotPoint* snapshot_point;  ///< The snapshot point being generated, or nullptr once the slot has been added to the cache.
+        RmtDataSnapshot*  snapshot;        ///< The generated snapshot, or nullptr if it failed or was taken by the snapshot worker.
+        RmtErrorCode      error_code;      ///< The result of generating the snapshot.
+        bool              finished;        ///< Set by the job once the snapshot has been generated.
+        bool              requested;       ///< Set when the snapshot worker starts waiting for the snapshot.
+        bool              taken;           ///< Set once the snapshot worker has taken the snapshot.
+    };
+
+    /// Move a snapshot to the front of the cache, adding it if it isn't there.
+    /// \param snapshot The snapshot.
+    /// \return The cache entry, which is only valid until the cache is next changed.
+    CachedSnapshot& TouchCachedSnapshot(RmtDataSnapshot* snapshot);
+
+    /// Add snapshots generated outside the cache, drop snapshots removed from the data set, and free the least recently
+    /// used snapshots until the cache fits in its memory budget. Snapshots that are open or being compared are kept.
+    void TrimCache();
+
+    /// Start generating the nearest snapshots before and after a snapshot point in the background. If snapshots are
+    /// still being generated for another snapshot point, they are cancelled and this starts once they have stopped.
+    /// \param snapshot_point The snapshot point.
+    void StartPrefetch(const RmtSnapshotPoint* snapshot_point);
+
+    /// Add the finished prefetch slots to the cache, and start any prefetch waiting for the slots once they are all done.
+    void AddPrefetchedSnapshots();
+
+    /// Job to generate a prefetched snapshot.
+    /// \param thread_id The worker thread running the job.
+    /// \param index The index of the prefetch slot.
+    /// \param input The snapshot manager.
+    static void PrefetchJob(int32_t thread_id, int32_t index, void* input);
+
+    /// Get the memory budget of the snapshot cache from the settings.
+    /// \return The budget, in bytes.
+    static uint64_t GetCacheBudget();
+
+    /// Write the cache statistics to the debug window.
+    void LogCacheStatistics() const;
+
+    static const int32_t kMaxPrefetchCount = 2;  ///< The number of snapshots prefetched at a time; one either side.
+
+    rmv::ThreadController*      thread_controller_;                  ///< The thread for processing backend data.
+    RmtSnapshotPoint*           selected_snapshot_;                  ///< The selected snapshot point.
+    std::vector<CachedSnapshot> cache_;                              ///< The cached snapshots, most recently used first.
+    QMutex                      prefetch_mutex_;                     ///< Guards the prefetch slots, which the jobs and the snapshot worker share.
+    PrefetchSlot                prefetch_slots_[kMaxPrefetchCount];  ///< The snapshots being generated in the background.
+    int32_t                     prefetch_count_;                     ///< The number of prefetch slots in use.
+    RmtJobHandle                prefetch_job_;                       ///< The handle of the prefetch jobs.
+    bool                        prefetch_pending_;                   ///< Set if the prefetch slots are in use.
+    RmtProgress                 prefetch_progress_;                  ///< Used to cancel the prefetch jobs.
+    const RmtSnapshotPoint*     deferred_prefetch_point_;            ///< The snapshot point to prefetch around once the prefetch slots are free.
+    SnapshotCacheStatistics     statistics_;                         ///< The cache statistics.
 };
 
 #endif  // RMV_MODELS_SNAPSHOT_MANAGER_H_
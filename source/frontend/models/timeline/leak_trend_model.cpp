@@ -0,0 +1,291 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Model implementation for the Leak trend pane
+//=============================================================================
+
+#include "models/timeline/leak_trend_model.h"
+
+#include <algorithm>
+
+#include "rmt_data_set.h"
+#include "rmt_print.h"
+
+#include "models/trace_manager.h"
+#include "util/string_util.h"
+#include "util/time_util.h"
+#include "views/main_window.h"
+
+namespace rmv
+{
+    // Enum for column indices in the snapshot point table.
+    enum LeakTrendPointColumn
+    {
+        kLeakTrendPointColumnName,
+        kLeakTrendPointColumnTime,
+        kLeakTrendPointColumnLiveResources,
+        kLeakTrendPointColumnLiveSize,
+        kLeakTrendPointColumnSurvivingResources,
+        kLeakTrendPointColumnSurvivingSize,
+        kLeakTrendPointColumnGrowing,
+
+        kLeakTrendPointColumnCount,
+    };
+
+    // Enum for column indices in the surviving resource table.
+    enum LeakTrendResourceColumn
+    {
+        kLeakTrendResourceColumnId,
+        kLeakTrendResourceColumnType,
+        kLeakTrendResourceColumnCreateTime,
+        kLeakTrendResourceColumnFirstSnapshot,
+        kLeakTrendResourceColumnFirstSize,
+        kLeakTrendResourceColumnLastSize,
+
+        kLeakTrendResourceColumnCount,
+    };
+
+    LeakTrendModel::LeakTrendModel()
+        : ModelViewMapper(kLeakTrendNumWidgets)
+        , point_table_model_(nullptr)
+        , resource_table_model_(nullptr)
+        , resource_trend_{}
+        , pending_data_set_(nullptr)
+        , pending_trend_{}
+        , trend_progress_{}
+        , trend_request_(0)
+        , trend_job_(0)
+        , trend_job_pending_(false)
+    {
+        // The job queue signals from a worker thread, so the trend is shown on the GUI thread.
+        connect(this, &LeakTrendModel::TrendGenerated, this, &LeakTrendModel::OnTrendGenerated, Qt::QueuedConnection);
+    }
+
+    LeakTrendModel::~LeakTrendModel()
+    {
+        CancelTrend();
+        RmtResourceTrendDestroy(&resource_trend_);
+        delete point_table_model_;
+        delete resource_table_model_;
+    }
+
+    void LeakTrendModel::InitializePointTableModel(QTableView* table_view, uint num_rows, uint num_columns)
+    {
+        Q_UNUSED(num_columns);
+
+        point_table_model_ = new QStandardItemModel(num_rows, kLeakTrendPointColumnCount);
+
+        point_table_model_->setHorizontalHeaderItem(kLeakTrendPointColumnName, new QStandardItem("Snapshot"));
+        point_table_model_->setHorizontalHeaderItem(kLeakTrendPointColumnTime, new QStandardItem("Time"));
+        point_table_model_->setHorizontalHeaderItem(kLeakTrendPointColumnLiveResources, new QStandardItem("Live resources"));
+        point_table_model_->setHorizontalHeaderItem(kLeakTrendPointColumnLiveSize, new QStandardItem("Live size"));
+        point_table_model_->setHorizontalHeaderItem(kLeakTrendPointColumnSurvivingResources, new QStandardItem("Surviving resources"));
+        point_table_model_->setHorizontalHeaderItem(kLeakTrendPointColumnSurvivingSize, new QStandardItem("Surviving size"));
+        point_table_model_->setHorizontalHeaderItem(kLeakTrendPointColumnGrowing, new QStandardItem("Growing"));
+
+        table_view->setModel(point_table_model_);
+    }
+
+    void LeakTrendModel::InitializeResourceTableModel(QTableView* table_view, uint num_rows, uint num_columns)
+    {
+        Q_UNUSED(num_columns);
+
+        resource_table_model_ = new QStandardItemModel(num_rows, kLeakTrendResourceColumnCount);
+
+        resource_table_model_->setHorizontalHeaderItem(kLeakTrendResourceColumnId, new QStandardItem("Resource ID"));
+        resource_table_model_->setHorizontalHeaderItem(kLeakTrendResourceColumnType, new QStandardItem("Type"));
+        resource_table_model_->setHorizontalHeaderItem(kLeakTrendResourceColumnCreateTime, new QStandardItem("Create time"));
+        resource_table_model_->setHorizontalHeaderItem(kLeakTrendResourceColumnFirstSnapshot, new QStandardItem("First snapshot"));
+        resource_table_model_->setHorizontalHeaderItem(kLeakTrendResourceColumnFirstSize, new QStandardItem("First size"));
+        resource_table_model_->setHorizontalHeaderItem(kLeakTrendResourceColumnLastSize, new QStandardItem("Last size"));
+
+        table_view->setModel(resource_table_model_);
+    }
+
+    void LeakTrendModel::ResetModelValues()
+    {
+        CancelTrend();
+        RmtResourceTrendDestroy(&resource_trend_);
+        point_names_.clear();
+
+        point_table_model_->removeRows(0, point_table_model_->rowCount());
+        resource_table_model_->removeRows(0, resource_table_model_->rowCount());
+
+        SetModelData(kLeakTrendSnapshotCount, "-");
+        SetModelData(kLeakTrendSurvivingResources, "-");
+        SetModelData(kLeakTrendSurvivingSize, "-");
+        SetModelData(kLeakTrendGrowingFrom, "-");
+    }
+
+    void LeakTrendModel::Update()
+    {
+        ResetModelValues();
+
+        TraceManager& trace_manager = TraceManager::Get();
+        if (!trace_manager.DataSetValid())
+        {
+            return;
+        }
+
+        RmtDataSet* data_set = trace_manager.GetDataSet();
+        if (data_set->snapshot_count <= 0)
+        {
+            return;
+        }
+
+        // The trend needs the snapshot points in chronological order.
+        std::vector<const RmtSnapshotPoint*> snapshot_points;
+        for (int32_t snapshot_index = 0; snapshot_index < data_set->snapshot_count; snapshot_index++)
+        {
+            snapshot_points.push_back(&data_set->snapshots[snapshot_index]);
+        }
+        std::stable_sort(snapshot_points.begin(), snapshot_points.end(), [](const RmtSnapshotPoint* a, const RmtSnapshotPoint* b) {
+            return a->timestamp < b->timestamp;
+        });
+
+        for (const RmtSnapshotPoint* snapshot_point : snapshot_points)
+        {
+            pending_timestamps_.push_back(snapshot_point->timestamp);
+            pending_point_names_.push_back(QString(snapshot_point->name));
+        }
+
+        // Replaying the streams can take a while on large traces, so the trend is generated on the job queue.
+        pending_data_set_ = data_set;
+        RmtProgressInitialize(&trend_progress_, 1);
+        trend_job_pending_ = (RmtJobQueueAddSingle(MainWindow::GetJobQueue(), GenerateTrendJob, this, &trend_job_) == RMT_OK);
+        if (trend_job_pending_ == false)
+        {
+            // No job queue to run it on, so generate the trend here instead.
+            GenerateTrendJob(RMT_JOB_QUEUE_EXTERNAL_THREAD_ID, 0, this);
+        }
+    }
+
+    void LeakTrendModel::CancelTrend()
+    {
+        if (trend_job_pending_ == true)
+        {
+            RmtProgressCancel(&trend_progress_);
+            RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), trend_job_);
+            trend_job_pending_ = false;
+        }
+
+        trend_request_++;
+        RmtResourceTrendDestroy(&pending_trend_);
+        pending_data_set_ = nullptr;
+        pending_timestamps_.clear();
+        pending_point_names_.clear();
+    }
+
+    void LeakTrendModel::GenerateTrendJob(int32_t thread_id, int32_t index, void* input)
+    {
+        Q_UNUSED(thread_id);
+        Q_UNUSED(index);
+
+        // The pending trend can't change while the job is running, as changing it cancels the job and waits for it first.
+        LeakTrendModel* model = static_cast<LeakTrendModel*>(input);
+        if (RmtDataSetGenerateResourceTrend(model->pending_data_set_,
+                                            model->pending_timestamps_.data(),
+                                            static_cast<int32_t>(model->pending_timestamps_.size()),
+                                            &model->trend_progress_,
+                                            &model->pending_trend_) == RMT_OK)
+        {
+            emit model->TrendGenerated(model->trend_request_);
+        }
+    }
+
+    void LeakTrendModel::OnTrendGenerated(uint32_t request)
+    {
+        // The trend was cancelled or replaced after the job signalled, so it is stale.
+        if (request != trend_request_)
+        {
+            return;
+        }
+
+        if (trend_job_pending_ == true)
+        {
+            RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), trend_job_);
+            trend_job_pending_ = false;
+        }
+
+        RmtResourceTrendDestroy(&resource_trend_);
+        resource_trend_ = pending_trend_;
+        pending_trend_  = {};
+        point_names_.swap(pending_point_names_);
+        pending_point_names_.clear();
+        pending_timestamps_.clear();
+        pending_data_set_ = nullptr;
+
+        point_table_model_->setRowCount(resource_trend_.point_count);
+
+        int32_t growing_from_index = -1;
+        for (int32_t point_index = 0; point_index < resource_trend_.point_count; point_index++)
+        {
+            const RmtResourceTrendPoint& point = resource_trend_.points[point_index];
+            point_table_model_->setData(point_table_model_->index(point_index, kLeakTrendPointColumnName), point_names_[point_index]);
+            point_table_model_->setData(point_table_model_->index(point_index, kLeakTrendPointColumnTime), rmv::time_util::ClockToTimeUnit(point.timestamp));
+            point_table_model_->setData(point_table_model_->index(point_index, kLeakTrendPointColumnLiveResources),
+                                        rmv::string_util::LocalizedValue(point.live_resource_count));
+            point_table_model_->setData(point_table_model_->index(point_index, kLeakTrendPointColumnLiveSize),
+                                        rmv::string_util::LocalizedValueMemory(point.live_resource_size, false, false));
+            point_table_model_->setData(point_table_model_->index(point_index, kLeakTrendPointColumnSurvivingResources),
+                                        rmv::string_util::LocalizedValue(point.surviving_resource_count));
+            point_table_model_->setData(point_table_model_->index(point_index, kLeakTrendPointColumnSurvivingSize),
+                                        rmv::string_util::LocalizedValueMemory(point.surviving_resource_size, false, false));
+            point_table_model_->setData(point_table_model_->index(point_index, kLeakTrendPointColumnGrowing), point.is_growing ? "Yes" : "No");
+
+            if (point.is_growing && growing_from_index < 0)
+            {
+                growing_from_index = point_index;
+            }
+        }
+
+        // The resources alive at every snapshot point are the strongest leak candidates.
+        const RmtResourceTrendPoint& first_point = resource_trend_.points[0];
+        SetModelData(kLeakTrendSnapshotCount, rmv::string_util::LocalizedValue(resource_trend_.point_count));
+        SetModelData(kLeakTrendSurvivingResources, rmv::string_util::LocalizedValue(first_point.surviving_resource_count));
+        SetModelData(kLeakTrendSurvivingSize, rmv::string_util::LocalizedValueMemory(first_point.surviving_resource_size, false, false));
+        if (growing_from_index >= 0 && growing_from_index < resource_trend_.point_count - 1)
+        {
+            SetModelData(kLeakTrendGrowingFrom, point_names_[growing_from_index]);
+        }
+
+        UpdateResourceTable(0);
+        emit TrendReady();
+    }
+
+    void LeakTrendModel::UpdateResourceTable(int32_t point_index)
+    {
+        resource_table_model_->removeRows(0, resource_table_model_->rowCount());
+
+        if (point_index < 0 || point_index >= resource_trend_.point_count)
+        {
+            return;
+        }
+
+        resource_table_model_->setRowCount(resource_trend_.points[point_index].surviving_resource_count);
+
+        int row_index = 0;
+        for (int32_t resource_index = 0; resource_index < resource_trend_.resource_count; resource_index++)
+        {
+            const RmtResourceTrendResource* resource = &resource_trend_.resources[resource_index];
+            if (!RmtResourceTrendIsResourceSurviving(&resource_trend_, resource, point_index))
+            {
+                continue;
+            }
+
+            resource_table_model_->setData(resource_table_model_->index(row_index, kLeakTrendResourceColumnId), QString::number(resource->identifier));
+            resource_table_model_->setData(resource_table_model_->index(row_index, kLeakTrendResourceColumnType),
+                                           RmtGetResourceTypeNameFromResourceType(resource->resource_type));
+            resource_table_model_->setData(resource_table_model_->index(row_index, kLeakTrendResourceColumnCreateTime),
+                                           rmv::time_util::ClockToTimeUnit(resource->create_time));
+            resource_table_model_->setData(resource_table_model_->index(row_index, kLeakTrendResourceColumnFirstSnapshot),
+                                           point_names_[resource->first_point_index]);
+            resource_table_model_->setData(resource_table_model_->index(row_index, kLeakTrendResourceColumnFirstSize),
+                                           rmv::string_util::LocalizedValueMemory(resource->first_size_in_bytes, false, false));
+            resource_table_model_->setData(resource_table_model_->index(row_index, kLeakTrendResourceColumnLastSize),
+                                           rmv::string_util::LocalizedValueMemory(resource->last_size_in_bytes, false, false));
+            row_index++;
+        }
+    }
+}  // namespace rmv
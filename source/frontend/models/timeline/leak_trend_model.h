@@ -0,0 +1,110 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Model header for the Leak trend pane
+//=============================================================================
+
+#ifndef RMV_MODELS_TIMELINE_LEAK_TREND_MODEL_H_
+#define RMV_MODELS_TIMELINE_LEAK_TREND_MODEL_H_
+
+#include <QStandardItemModel>
+#include <QTableView>
+
+#include <vector>
+
+#include "qt_common/utils/model_view_mapper.h"
+
+#include "rmt_data_set.h"
+#include "rmt_job_system.h"
+#include "rmt_progress.h"
+#include "rmt_resource_trend.h"
+
+namespace rmv
+{
+    /// An enum of widgets used by the UI and model. Used to map UI widgets to their
+    /// corresponding model data.
+    enum LeakTrendWidgets
+    {
+        kLeakTrendSnapshotCount,
+        kLeakTrendSurvivingResources,
+        kLeakTrendSurvivingSize,
+        kLeakTrendGrowingFrom,
+
+        kLeakTrendNumWidgets
+    };
+
+    /// Container class that holds model data for the leak trend pane.
+    class LeakTrendModel : public ModelViewMapper
+    {
+        Q_OBJECT
+
+    public:
+        /// Constructor.
+        explicit LeakTrendModel();
+
+        /// Destructor.
+        virtual ~LeakTrendModel();
+
+        /// Initialize the snapshot point table model.
+        /// \param table_view The view to the table.
+        /// \param num_rows Total rows of the table.
+        /// \param num_columns Total columns of the table.
+        void InitializePointTableModel(QTableView* table_view, uint num_rows, uint num_columns);
+
+        /// Initialize the surviving resource table model.
+        /// \param table_view The view to the table.
+        /// \param num_rows Total rows of the table.
+        /// \param num_columns Total columns of the table.
+        void InitializeResourceTableModel(QTableView* table_view, uint num_rows, uint num_columns);
+
+        /// Initialize blank data for the model.
+        void ResetModelValues();
+
+        /// Start generating a trend over all the snapshot points in the trace in the background. The model
+        /// is updated and TrendReady is emitted once the trend has been generated.
+        void Update();
+
+        /// Stop generating the trend, waiting for the job to return.
+        void CancelTrend();
+
+        /// Update the surviving resource table with the resources alive from a snapshot point onwards.
+        /// \param point_index The index of the snapshot point in the trend.
+        void UpdateResourceTable(int32_t point_index);
+
+    signals:
+        /// Signal emitted when the model has been updated with a new trend.
+        void TrendReady();
+
+        /// Signal emitted from the job queue when the pending trend has been generated.
+        /// \param request The request the trend was generated for.
+        void TrendGenerated(uint32_t request);
+
+    private slots:
+        /// Update the model with the pending trend, if it is for the latest request.
+        /// \param request The request the trend was generated for.
+        void OnTrendGenerated(uint32_t request);
+
+    private:
+        /// Job function to generate the pending trend.
+        /// \param thread_id The worker thread running the job.
+        /// \param index The index of the job.
+        /// \param input A pointer to the LeakTrendModel.
+        static void GenerateTrendJob(int32_t thread_id, int32_t index, void* input);
+
+        QStandardItemModel*   point_table_model_;     ///< Holds the snapshot point table data.
+        QStandardItemModel*   resource_table_model_;  ///< Holds the surviving resource table data.
+        RmtResourceTrend      resource_trend_;        ///< The trend over all the snapshot points.
+        std::vector<QString>  point_names_;           ///< The snapshot name of each point in the trend.
+        RmtDataSet*           pending_data_set_;      ///< The data set the pending trend is generated from.
+        std::vector<uint64_t> pending_timestamps_;    ///< The timestamps of the snapshot points in the pending trend.
+        std::vector<QString>  pending_point_names_;   ///< The snapshot name of each point in the pending trend.
+        RmtResourceTrend      pending_trend_;         ///< The trend being generated by the job.
+        RmtProgress           trend_progress_;        ///< Used to cancel the job generating the pending trend.
+        uint32_t              trend_request_;         ///< Incremented every time the pending trend is cancelled.
+        RmtJobHandle          trend_job_;             ///< The job generating the pending trend.
+        bool                  trend_job_pending_;     ///< If true, the pending trend job has been added to the job queue.
+    };
+}  // namespace rmv
+
+#endif  // RMV_MODELS_TIMELINE_LEAK_TREND_MODEL_H_
@@ -13,6 +13,7 @@
 #include "rmt_data_snapshot.h"
 #include "rmt_util.h"
 
+#include "models/snapshot_manager.h"
 #include "models/trace_manager.h"
 #include "util/string_util.h"
 #include "util/time_util.h"
@@ -86,6 +87,7 @@ namespace rmv
             }
 
             // set data in the model
+            SnapshotManager::Get().FinishPrefetch();
             RmtDataSetRenameSnapshot(data_set, row, new_snapshot_name.toLatin1().data());
             return true;
         }
@@ -7,6 +7,8 @@
 
 #include "models/timeline/timeline_model.h"
 
+#include <cmath>
+
 #include "qt_common/utils/common_definitions.h"
 #include "qt_common/utils/qt_util.h"
 
@@ -17,6 +19,7 @@
 #include "rmt_util.h"
 
 #include "models/resource_sorter.h"
+#include "models/snapshot_manager.h"
 #include "models/trace_manager.h"
 #include "settings/rmv_settings.h"
 #include "views/colorizer.h"
@@ -38,6 +41,20 @@ namespace rmv
     // The maximum number of lines of info to show in the timeline tooltip
     static const int kMaxTooltipLines = 6;
 
+    // The number of recently shown histograms to keep, so going back to a previous zoom level or scroll position
+    // doesn't need the histogram to be made again.
+    static const size_t kHistogramCacheSize = 16;
+
+    // The ranges next to the visible range whose histograms are made in the background after each update.
+    enum PrefetchRange
+    {
+        kPrefetchRangeLeft,     // One view width to the left.
+        kPrefetchRangeRight,    // One view width to the right.
+        kPrefetchRangeZoomOut,  // Zoomed out by a factor of 2 around the center of the view.
+
+        kPrefetchRangeCount
+    };
+
     TimelineModel::TimelineModel()
         : ModelViewMapper(kTimelineNumWidgets)
         , table_model_(nullptr)
@@ -46,11 +63,17 @@ namespace rmv
         , max_visible_(0)
         , histogram_{}
         , timeline_type_(kRmtDataTimelineTypeResourceUsageVirtualSize)
+        , prefetch_job_(0)
+        , prefetch_pending_(false)
+        , timeline_changed_(false)
+        , memory_graph_version_(0)
+        , tooltip_cache_version_(0)
     {
     }
 
     TimelineModel::~TimelineModel()
     {
+        ResetMemoryGraph();
         delete table_model_;
     }
 
@@ -69,13 +92,21 @@ namespace rmv
 
         if (trace_manager.DataSetValid())
         {
+            // This runs on a worker thread, so the histograms are thrown away the next time the memory graph is
+            // updated. Prefetching from the old timeline has to finish before it is destroyed, though.
+            if (prefetch_pending_ == true)
+            {
+                RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), prefetch_job_);
+            }
+            timeline_changed_ = true;
+
             // recreate the timeline for the data set.
             RmtDataSet*      data_set   = trace_manager.GetDataSet();
             RmtDataTimeline* timeline   = trace_manager.GetTimeline();
             RmtErrorCode     error_code = RmtDataTimelineDestroy(timeline);
             RMT_UNUSED(error_code);
             RMT_ASSERT_MESSAGE(error_code == RMT_OK, "Error destroying old timeline");
-            error_code = RmtDataSetGenerateTimeline(data_set, timeline_type, timeline);
+            error_code = RmtDataSetGenerateTimeline(data_set, timeline_type, nullptr, timeline);
             RMT_UNUSED(error_code);
             RMT_ASSERT_MESSAGE(error_code == RMT_OK, "Error generating new timeline type");
         }
@@ -162,6 +193,9 @@ namespace rmv
             }
         } while (found_duplicate);
 
+        // Adding a snapshot can move the snapshot points the prefetched snapshots are for.
+        SnapshotManager::Get().FinishPrefetch();
+
         RmtSnapshotPoint* snapshot_point = nullptr;
         RmtDataSetAddSnapshot(data_set, name_buffer, snapshot_time, &snapshot_point);
         if (snapshot_point != nullptr)
@@ -183,6 +217,7 @@ namespace rmv
         TraceManager& trace_manager = TraceManager::Get();
         RmtDataSet*   data_set      = trace_manager.GetDataSet();
 
+        SnapshotManager::Get().FinishPrefetch();
         for (int32_t current_snapshot_point_index = 0; current_snapshot_point_index < data_set->snapshot_count; ++current_snapshot_point_index)
         {
             RmtSnapshotPoint* current_snapshot_point = &data_set->snapshots[current_snapshot_point_index];
@@ -223,9 +258,6 @@ namespace rmv
 
     void TimelineModel::UpdateMemoryGraph(uint64_t min_visible, uint64_t max_visible)
     {
-        min_visible_ = min_visible;
-        max_visible_ = max_visible;
-
         LogFileWriter::Get().WriteLog(LogFileWriter::kDebug, "UpdateMemoryUsage: minVisible %lld, maxVisible %lld", min_visible, max_visible);
 
         TraceManager& trace_manager = TraceManager::Get();
@@ -234,18 +266,259 @@ namespace rmv
             return;
         }
 
-        RmtDataTimeline* timeline = trace_manager.GetTimeline();
-        uint64_t         duration = max_visible - min_visible;
+        if (timeline_changed_.exchange(false) == true)
+        {
+            ResetMemoryGraph();
+        }
 
-        Q_ASSERT(duration > 0);
+        FinishPrefetch();
 
-        double bucket_step = duration / (double)kNumBuckets;
+        // Resizing and repainting the pane also come through here, so only change the histogram if the visible range
+        // has changed.
+        if (histogram_.bucket_data != nullptr && min_visible == min_visible_ && max_visible == max_visible_)
+        {
+            return;
+        }
+
+        Q_ASSERT(max_visible > min_visible);
+
+        // Use a cached histogram if there is one. Otherwise, panning scrolls the shown histogram, and anything else
+        // needs a new one.
+        RmtDataTimelineHistogram cached_histogram = {};
+        const bool               cached           = TakeFromHistogramCache(min_visible, max_visible, cached_histogram);
+        if (cached == true || ScrollMemoryGraphHistogram(min_visible, max_visible) == false)
+        {
+            if (histogram_.bucket_data != nullptr)
+            {
+                MemoryGraphHistogram shown_histogram = {min_visible_, max_visible_, histogram_};
+                AddToHistogramCache(shown_histogram);
+                histogram_ = {};
+            }
+
+            if (cached == true)
+            {
+                histogram_ = cached_histogram;
+            }
+            else
+            {
+                const bool success = CreateMemoryGraphHistogram(min_visible, max_visible, &histogram_);
+                RMT_ASSERT(success == true);
+                RMT_UNUSED(success);
+            }
+        }
+
+        min_visible_ = min_visible;
+        max_visible_ = max_visible;
+
+        memory_graph_version_++;
+
+        StartPrefetch();
+    }
+
+    void TimelineModel::ResetMemoryGraph()
+    {
+        if (prefetch_pending_ == true)
+        {
+            RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), prefetch_job_);
+            prefetch_pending_ = false;
+        }
+
+        for (MemoryGraphHistogram& entry : prefetch_histograms_)
+        {
+            RmtDataTimelineHistogramDestroy(&entry.histogram);
+        }
+        prefetch_histograms_.clear();
+
+        for (MemoryGraphHistogram& entry : histogram_cache_)
+        {
+            RmtDataTimelineHistogramDestroy(&entry.histogram);
+        }
+        histogram_cache_.clear();
+
+        RmtDataTimelineHistogramDestroy(&histogram_);
+        histogram_   = {};
+        min_visible_ = 0;
+        max_visible_ = 0;
+        memory_graph_version_++;
+    }
+
+    uint64_t TimelineModel::GetMemoryGraphVersion() const
+    {
+        return memory_graph_version_;
+    }
+
+    bool TimelineModel::CreateMemoryGraphHistogram(uint64_t min_visible, uint64_t max_visible, RmtDataTimelineHistogram* out_histogram)
+    {
+        const RmtDataTimeline* timeline    = TraceManager::Get().GetTimeline();
+        const uint64_t         duration    = max_visible - min_visible;
+        const double           bucket_step = duration / (double)kNumBuckets;
 
         const RmtErrorCode error_code =
-            RmtDataTimelineCreateHistogram(timeline, MainWindow::GetJobQueue(), kNumBuckets, bucket_step, min_visible_, max_visible_, &histogram_);
+            RmtDataTimelineCreateHistogram(timeline, MainWindow::GetJobQueue(), kNumBuckets, bucket_step, min_visible, max_visible, out_histogram);
+        if (error_code != RMT_OK)
+        {
+            *out_histogram = {};
+            return false;
+        }
+
+        return true;
+    }
+
+    bool TimelineModel::ScrollMemoryGraphHistogram(uint64_t min_visible, uint64_t max_visible)
+    {
+        if (histogram_.bucket_data == nullptr)
+        {
+            return false;
+        }
+
+        // Only a histogram with the same bucket width can be scrolled, which means the view has been panned rather
+        // than zoomed.
+        const uint64_t duration     = max_visible - min_visible;
+        const uint64_t bucket_width = duration / (double)kNumBuckets;
+        if (bucket_width == 0 || bucket_width != histogram_.bucket_width_in_cycles)
+        {
+            return false;
+        }
+
+        // Panning moves the view by any number of cycles, so the new range is snapped to the buckets of the shown
+        // histogram. The graph is out by at most half a bucket, and the buckets in both ranges keep their values
+        // rather than flickering as their sample points move.
+        const int64_t bucket_offset = llround(((double)min_visible - (double)histogram_.start_timestamp) / (double)bucket_width);
+        if (bucket_offset <= -kNumBuckets || bucket_offset >= kNumBuckets)
+        {
+            return false;
+        }
+
+        return RmtDataTimelineHistogramScroll(&histogram_, MainWindow::GetJobQueue(), static_cast<int32_t>(bucket_offset)) == RMT_OK;
+    }
 
-        RMT_ASSERT(error_code == RMT_OK);
-        RMT_UNUSED(error_code);
+    void TimelineModel::AddToHistogramCache(MemoryGraphHistogram& entry)
+    {
+        histogram_cache_.insert(histogram_cache_.begin(), entry);
+        if (histogram_cache_.size() > kHistogramCacheSize)
+        {
+            RmtDataTimelineHistogramDestroy(&histogram_cache_.back().histogram);
+            histogram_cache_.pop_back();
+        }
+    }
+
+    bool TimelineModel::TakeFromHistogramCache(uint64_t min_visible, uint64_t max_visible, RmtDataTimelineHistogram& out_histogram)
+    {
+        for (auto it = histogram_cache_.begin(); it != histogram_cache_.end(); ++it)
+        {
+            if (it->min_visible == min_visible && it->max_visible == max_visible)
+            {
+                out_histogram = it->histogram;
+                histogram_cache_.erase(it);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void TimelineModel::StartPrefetch()
+    {
+        RMT_ASSERT(prefetch_pending_ == false);
+
+        const uint64_t duration      = max_visible_ - min_visible_;
+        const uint64_t max_timestamp = GetMaxTimestamp();
+        const uint64_t center        = min_visible_ + (duration / 2);
+
+        // Only prefetch ranges inside the timeline that aren't already cached.
+        prefetch_histograms_.clear();
+        for (int32_t i = 0; i < kPrefetchRangeCount; i++)
+        {
+            MemoryGraphHistogram entry = {};
+            switch (i)
+            {
+            case kPrefetchRangeLeft:
+                if (min_visible_ < duration)
+                {
+                    continue;
+                }
+                entry.min_visible = min_visible_ - duration;
+                entry.max_visible = min_visible_;
+                break;
+
+            case kPrefetchRangeRight:
+                entry.min_visible = max_visible_;
+                entry.max_visible = max_visible_ + duration;
+                break;
+
+            case kPrefetchRangeZoomOut:
+                if (center < duration)
+                {
+                    continue;
+                }
+                entry.min_visible = center - duration;
+                entry.max_visible = center + duration;
+                break;
+
+            default:
+                continue;
+            }
+
+            if (entry.max_visible > max_timestamp)
+            {
+                continue;
+            }
+
+            bool cached = false;
+            for (const MemoryGraphHistogram& cached_entry : histogram_cache_)
+            {
+                if (cached_entry.min_visible == entry.min_visible && cached_entry.max_visible == entry.max_visible)
+                {
+                    cached = true;
+                    break;
+                }
+            }
+
+            if (cached == false)
+            {
+                prefetch_histograms_.push_back(entry);
+            }
+        }
+
+        if (prefetch_histograms_.empty() == false)
+        {
+            const int32_t      count      = static_cast<int32_t>(prefetch_histograms_.size());
+            const RmtErrorCode error_code = RmtJobQueueAddMultiple(MainWindow::GetJobQueue(), PrefetchJob, this, 0, count, &prefetch_job_);
+            prefetch_pending_             = (error_code == RMT_OK);
+            if (prefetch_pending_ == false)
+            {
+                prefetch_histograms_.clear();
+            }
+        }
+    }
+
+    void TimelineModel::FinishPrefetch()
+    {
+        if (prefetch_pending_ == false)
+        {
+            return;
+        }
+
+        RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), prefetch_job_);
+        prefetch_pending_ = false;
+
+        for (MemoryGraphHistogram& entry : prefetch_histograms_)
+        {
+            if (entry.histogram.bucket_data != nullptr)
+            {
+                AddToHistogramCache(entry);
+            }
+        }
+        prefetch_histograms_.clear();
+    }
+
+    void TimelineModel::PrefetchJob(int32_t thread_id, int32_t index, void* input)
+    {
+        Q_UNUSED(thread_id);
+
+        TimelineModel*        model = static_cast<TimelineModel*>(input);
+        MemoryGraphHistogram& entry = model->prefetch_histograms_[index];
+        CreateMemoryGraphHistogram(entry.min_visible, entry.max_visible, &entry.histogram);
     }
 
     int TimelineModel::GetNumBuckets() const
@@ -261,6 +534,7 @@ namespace rmv
     void TimelineModel::SetTimelineType(RmtDataTimelineType new_timeline_type)
     {
         timeline_type_ = new_timeline_type;
+        tooltip_cache_.clear();
     }
 
     QString TimelineModel::GetValueString(int64_t value, bool display_as_memory) const
@@ -319,17 +593,37 @@ namespace rmv
     bool TimelineModel::GetTimelineTooltipInfo(qreal x_pos, QList<TooltipInfo>& tooltip_info_list)
     {
         int bucket_index = x_pos * kNumBuckets;
+        if (bucket_index < 0 || bucket_index >= kNumBuckets)
+        {
+            return false;
+        }
+
+        // The tooltip is asked for on every mouse move, so the tooltip for each bucket is only made once for each
+        // histogram.
+        if (tooltip_cache_.size() != kNumBuckets || tooltip_cache_version_ != memory_graph_version_)
+        {
+            tooltip_cache_.clear();
+            tooltip_cache_.resize(kNumBuckets);
+            tooltip_cache_version_ = memory_graph_version_;
+        }
+
+        QList<TooltipInfo>& bucket_tooltip_info_list = tooltip_cache_[bucket_index];
+        if (bucket_tooltip_info_list.empty() == false)
+        {
+            tooltip_info_list.append(bucket_tooltip_info_list);
+            return true;
+        }
 
         switch (timeline_type_)
         {
         case kRmtDataTimelineTypeResourceUsageCount:
             // number of each type of resource
-            GetResourceTooltipInfo(bucket_index, false, tooltip_info_list);
+            GetResourceTooltipInfo(bucket_index, false, bucket_tooltip_info_list);
             break;
 
         case kRmtDataTimelineTypeResourceUsageVirtualSize:
             // memory for each type of resource
-            GetResourceTooltipInfo(bucket_index, true, tooltip_info_list);
+            GetResourceTooltipInfo(bucket_index, true, bucket_tooltip_info_list);
             break;
 
         case kRmtDataTimelineTypeVirtualMemory:
@@ -341,7 +635,7 @@ namespace rmv
                 tooltip_info.text =
                     QString("%1: %2").arg(RmtGetHeapTypeNameFromHeapType(RmtHeapType(i))).arg(rmv::string_util::LocalizedValueMemory(value, false, false));
                 tooltip_info.color = Colorizer::GetHeapColor(static_cast<RmtHeapType>(i));
-                tooltip_info_list.push_back(tooltip_info);
+                bucket_tooltip_info_list.push_back(tooltip_info);
             }
             break;
 
@@ -353,7 +647,7 @@ namespace rmv
                 tooltip_info.text =
                     QString("%1: %2").arg(RmtGetHeapTypeNameFromHeapType(RmtHeapType(i))).arg(rmv::string_util::LocalizedValueMemory(value, false, false));
                 tooltip_info.color = Colorizer::GetHeapColor(static_cast<RmtHeapType>(i));
-                tooltip_info_list.push_back(tooltip_info);
+                bucket_tooltip_info_list.push_back(tooltip_info);
             }
             break;
 
@@ -361,6 +655,7 @@ namespace rmv
             return false;
         }
 
+        tooltip_info_list.append(bucket_tooltip_info_list);
         return true;
     }
 
@@ -9,11 +9,15 @@
 #define RMV_MODELS_TIMELINE_TIMELINE_MODEL_H_
 
 #include <QTableView>
+#include <QVector>
+#include <atomic>
+#include <vector>
 
 #include "qt_common/utils/model_view_mapper.h"
 
 #include "rmt_data_set.h"
 #include "rmt_data_timeline.h"
+#include "rmt_job_system.h"
 
 #include "models/proxy_models/snapshot_timeline_proxy_model.h"
 #include "models/timeline/snapshot_item_model.h"
@@ -93,6 +97,15 @@ namespace rmv
         /// Initialize blank data for the model.
         void ResetModelValues();
 
+        /// Throw away the memory graph histograms, including any that are being prefetched. Must be called before
+        /// the timeline they were made from is destroyed.
+        void ResetMemoryGraph();
+
+        /// Get a value that changes whenever the memory graph histogram changes, so views can tell when anything
+        /// they have drawn from it is out of date.
+        /// \return The memory graph version.
+        uint64_t GetMemoryGraphVersion() const;
+
         /// Get content from proxy model.
         /// \param row The table row.
         /// \param col The table column.
@@ -145,6 +158,51 @@ namespace rmv
         void OnModelChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
 
     private:
+        /// A histogram made for a visible range of the timeline.
+        struct MemoryGraphHistogram
+        {
+            uint64_t                 min_visible;  ///< The minimum visible timestamp the histogram was made for.
+            uint64_t                 max_visible;  ///< The maximum visible timestamp the histogram was made for.
+            RmtDataTimelineHistogram histogram;    ///< The histogram. Owns its bucket data.
+        };
+
+        /// Create the histogram for a visible range.
+        /// \param min_visible The minimum visible timestamp.
+        /// \param max_visible The maximum visible timestamp.
+        /// \param out_histogram The histogram to create.
+        /// \return true if the histogram was created, false if not.
+        static bool CreateMemoryGraphHistogram(uint64_t min_visible, uint64_t max_visible, RmtDataTimelineHistogram* out_histogram);
+
+        /// Scroll the shown histogram to a visible range of the same duration. The buckets that are in both ranges are
+        /// kept, and only the buckets scrolled into view are made.
+        /// \param min_visible The minimum visible timestamp.
+        /// \param max_visible The maximum visible timestamp.
+        /// \return true if the histogram was scrolled, false if it has to be made again.
+        bool ScrollMemoryGraphHistogram(uint64_t min_visible, uint64_t max_visible);
+
+        /// Add a histogram to the front of the cache, destroying the least recently used one if the cache is full.
+        /// \param entry The histogram. The cache takes ownership of it.
+        void AddToHistogramCache(MemoryGraphHistogram& entry);
+
+        /// Take a histogram out of the cache.
+        /// \param min_visible The minimum visible timestamp of the histogram.
+        /// \param max_visible The maximum visible timestamp of the histogram.
+        /// \param out_histogram The histogram, if found. The caller takes ownership of it.
+        /// \return true if the histogram was in the cache, false if not.
+        bool TakeFromHistogramCache(uint64_t min_visible, uint64_t max_visible, RmtDataTimelineHistogram& out_histogram);
+
+        /// Start making the histograms for the ranges next to the visible range in the background.
+        void StartPrefetch();
+
+        /// Wait for the prefetch jobs to finish and move their histograms into the cache.
+        void FinishPrefetch();
+
+        /// Job to make one of the prefetched histograms.
+        /// \param thread_id The worker thread running the job.
+        /// \param index The index of the histogram in prefetch_histograms_.
+        /// \param input The model.
+        static void PrefetchJob(int32_t thread_id, int32_t index, void* input);
+
         /// Get a value as a string.
         /// \param value The value to convert.
         /// \param display_as_memory If true, display the value as an amount of memory (ie KB, MB etc).
@@ -164,6 +222,15 @@ namespace rmv
         uint64_t                    max_visible_;    ///< Maximum visible timestamp.
         RmtDataTimelineHistogram    histogram_;      ///< The histogram to render.
         RmtDataTimelineType         timeline_type_;  ///< The timeline type.
+
+        std::vector<MemoryGraphHistogram> histogram_cache_;        ///< Recently shown histograms, most recently used first.
+        std::vector<MemoryGraphHistogram> prefetch_histograms_;    ///< The histograms being made by the prefetch jobs.
+        RmtJobHandle                      prefetch_job_;           ///< The handle of the prefetch jobs.
+        bool                              prefetch_pending_;       ///< Set if the prefetch jobs have been started and not waited for.
+        std::atomic<bool>                 timeline_changed_;       ///< Set by GenerateTimeline() when the histograms are out of date.
+        uint64_t                          memory_graph_version_;   ///< Incremented whenever histogram_ changes.
+        QVector<QList<TooltipInfo>>       tooltip_cache_;          ///< The tooltip for each bucket, made the first time it is shown.
+        uint64_t                          tooltip_cache_version_;  ///< The memory graph version the tooltips were made for.
     };
 }  // namespace rmv
 
@@ -23,6 +23,7 @@
 #include "rmt_virtual_allocation_list.h"
 
 #include "models/message_manager.h"
+#include "models/snapshot_manager.h"
 #include "settings/rmv_settings.h"
 #include "util/definitions.h"
 
@@ -46,6 +47,90 @@ private:
     QByteArray path_data;  ///< The path to the trace being loaded
 };
 
+/// The stages of loading a trace, each of which replays the RMT streams.
+static const int32_t kTraceLoadStageDataSet  = 0;
+static const int32_t kTraceLoadStageTimeline = 1;
+static const int32_t kTraceLoadStageCount    = 2;
+
+/// The state shared by the jobs that make up the trace loading graph.
+struct TraceLoadJobInput
+{
+    const char*      trace_file_name;  ///< The name of the trace file being loaded.
+    RmtDataSet*      data_set;         ///< The data set to load the trace in to.
+    RmtDataTimeline* timeline;         ///< The timeline to generate from the data set.
+    RmtProgress*     progress;         ///< The progress of the load, which can be used to cancel it.
+    RmtProgress*     index_progress;   ///< The progress of the resource event index, cancelled along with the load.
+    RmtErrorCode     data_set_result;  ///< The result of initializing the data set.
+    RmtErrorCode     timeline_result;  ///< The result of generating the timeline.
+    RmtErrorCode     index_result;     ///< The result of building the resource event index.
+};
+
+/// Job to parse the trace file chunks and build the data profile.
+/// \param thread_id The id of the worker thread running the job.
+/// \param index The index of the job.
+/// \param input Pointer to the TraceLoadJobInput structure.
+static void InitializeDataSetJob(int32_t thread_id, int32_t index, void* input)
+{
+    Q_UNUSED(thread_id);
+    Q_UNUSED(index);
+
+    TraceLoadJobInput* job_input = static_cast<TraceLoadJobInput*>(input);
+    job_input->data_set_result   = RmtProgressBeginStage(job_input->progress, kTraceLoadStageDataSet);
+    if (job_input->data_set_result != RMT_OK)
+    {
+        return;
+    }
+
+    job_input->data_set_result = RmtDataSetInitialize(job_input->trace_file_name, false, job_input->progress, job_input->data_set);
+}
+
+/// Job to create the default timeline for the data set. Depends on InitializeDataSetJob.
+/// \param thread_id The id of the worker thread running the job.
+/// \param index The index of the job.
+/// \param input Pointer to the TraceLoadJobInput structure.
+static void GenerateTimelineJob(int32_t thread_id, int32_t index, void* input)
+{
+    Q_UNUSED(thread_id);
+    Q_UNUSED(index);
+
+    TraceLoadJobInput* job_input = static_cast<TraceLoadJobInput*>(input);
+    if (job_input->data_set_result != RMT_OK)
+    {
+        return;
+    }
+
+    job_input->timeline_result = RmtProgressBeginStage(job_input->progress, kTraceLoadStageTimeline);
+    if (job_input->timeline_result != RMT_OK)
+    {
+        return;
+    }
+
+    job_input->timeline_result =
+        RmtDataSetGenerateTimeline(job_input->data_set, kRmtDataTimelineTypeResourceUsageVirtualSize, job_input->progress, job_input->timeline);
+}
+
+/// Job to build the resource event index used by the resource history. Depends on InitializeDataSetJob.
+///
+/// Runs alongside GenerateTimelineJob. If the timeline is read from the cache file this is the only
+/// replay of the streams, so the first resource history request doesn't have to wait for it. If the
+/// timeline replay gets to the streams first, it records the index itself and this job does nothing.
+/// \param thread_id The id of the worker thread running the job.
+/// \param index The index of the job.
+/// \param input Pointer to the TraceLoadJobInput structure.
+static void BuildResourceEventIndexJob(int32_t thread_id, int32_t index, void* input)
+{
+    Q_UNUSED(thread_id);
+    Q_UNUSED(index);
+
+    TraceLoadJobInput* job_input = static_cast<TraceLoadJobInput*>(input);
+    if (job_input->data_set_result != RMT_OK)
+    {
+        return;
+    }
+
+    job_input->index_result = RmtDataSetBuildResourceEventIndex(job_input->data_set, job_input->index_progress);
+}
+
 /// Pointer to the loading thread object.
 static LoadingThread* loading_thread = nullptr;
 
@@ -59,6 +144,8 @@ TraceManager& TraceManager::Get()
 
 TraceManager::TraceManager(QObject* parent)
     : QObject(parent)
+    , load_progress_{}
+    , index_progress_{}
     , open_snapshot_(nullptr)
     , compared_snapshots_{}
     , main_window_(nullptr)
@@ -88,17 +175,72 @@ TraceLoadReturnCode TraceManager::TraceLoad(const char* trace_file_name)
     compared_snapshots_[kSnapshotCompareBase] = nullptr;
     compared_snapshots_[kSnapshotCompareDiff] = nullptr;
 
-    // Loading regular binary RMV data
-    RmtErrorCode error_code = RmtDataSetInitialize(trace_file_name, &data_set_);
+    // Build the load as a graph of jobs. The data set node runs first, then the timeline
+    // and resource event index nodes both hang off it and run at the same time.
+    TraceLoadJobInput job_input = {};
+    job_input.trace_file_name   = trace_file_name;
+    job_input.data_set          = &data_set_;
+    job_input.timeline          = &timeline_;
+    job_input.progress          = &load_progress_;
+    job_input.index_progress    = &index_progress_;
+    job_input.data_set_result   = RMT_ERROR_FILE_NOT_OPEN;
+    job_input.timeline_result   = RMT_ERROR_FILE_NOT_OPEN;
+    job_input.index_result      = RMT_ERROR_FILE_NOT_OPEN;
+
+    RmtJobQueue* job_queue       = MainWindow::GetJobQueue();
+    RmtJobHandle data_set_handle = 0;
+    RmtJobHandle timeline_handle = 0;
+    RmtJobHandle index_handle    = 0;
+
+    RmtErrorCode error_code = RmtJobQueueAddSingle(job_queue, InitializeDataSetJob, &job_input, &data_set_handle);
     if (error_code != RMT_OK)
+    {
+        return kTraceLoadReturnFail;
+    }
+
+    error_code = RmtJobQueueAddMultipleWithDependencies(job_queue, GenerateTimelineJob, &job_input, 0, 1, &data_set_handle, 1, &timeline_handle);
+    const RmtErrorCode index_error_code =
+        RmtJobQueueAddMultipleWithDependencies(job_queue, BuildResourceEventIndexJob, &job_input, 0, 1, &data_set_handle, 1, &index_handle);
+
+    // Waiting on the leaves of the graph also waits on the data set node they depend on.
+    RmtJobQueueWaitForCompletion(job_queue, data_set_handle);
+    if (error_code == RMT_OK)
+    {
+        RmtJobQueueWaitForCompletion(job_queue, timeline_handle);
+    }
+    if (index_error_code == RMT_OK)
+    {
+        RmtJobQueueWaitForCompletion(job_queue, index_handle);
+    }
+
+    // A cancelled load leaves nothing behind.
+    const RmtErrorCode cancelled = static_cast<RmtErrorCode>(RMT_ERROR_CANCELLED);
+    if ((job_input.data_set_result == cancelled) || (job_input.timeline_result == cancelled) || (job_input.index_result == cancelled))
+    {
+        // The timeline may have finished before the resource event index was cancelled.
+        if (job_input.timeline_result == RMT_OK)
+        {
+            RmtDataTimelineDestroy(&timeline_);
+            memset(&timeline_, 0, sizeof(RmtDataTimeline));
+        }
+        if (job_input.data_set_result == RMT_OK)
+        {
+            RmtDataSetDestroy(&data_set_);
+        }
+        memset(&data_set_, 0, sizeof(RmtDataSet));
+        return kTraceLoadReturnCancelled;
+    }
+
+    // Loading regular binary RMV data
+    if (job_input.data_set_result != RMT_OK)
     {
         memset(&data_set_, 0, sizeof(RmtDataSet));
         return kTraceLoadReturnFail;
     }
 
-    // create the default timeline for the data set.
-    error_code = RmtDataSetGenerateTimeline(&data_set_, kRmtDataTimelineTypeResourceUsageVirtualSize, &timeline_);
-    if (error_code != RMT_OK)
+    // create the default timeline for the data set. The resource event index is optional, as
+    // it is built again the first time a resource history is requested if it failed here.
+    if ((error_code != RMT_OK) || (job_input.timeline_result != RMT_OK))
     {
         return kTraceLoadReturnFail;
     }
@@ -111,6 +253,7 @@ void TraceManager::ClearTrace()
     if (DataSetValid())
     {
         // clean up any cached snapshots.
+        SnapshotManager::Get().ClearCache();
         for (int32_t current_snapshot_point_index = 0; current_snapshot_point_index < data_set_.snapshot_count; ++current_snapshot_point_index)
         {
             RmtSnapshotPoint* current_snapshot_point = &data_set_.snapshots[current_snapshot_point_index];
@@ -142,6 +285,10 @@ bool TraceManager::LoadTrace(const QString& path, bool compare)
 
     if (!path.isEmpty() && trace_file.exists())
     {
+        // Set up the progress before the loading thread is started, so the load can be cancelled straight away.
+        RmtProgressInitialize(&load_progress_, kTraceLoadStageCount);
+        RmtProgressInitialize(&index_progress_, 1);
+
         // Nothing loaded, so load
         if (!DataSetValid())
         {
@@ -226,7 +373,7 @@ void TraceManager::OnTraceLoadComplete(TraceLoadReturnCode error_code)
 {
     bool remove_from_list = false;
 
-    if (error_code != kTraceLoadReturnSuccess)
+    if (error_code != kTraceLoadReturnSuccess && error_code != kTraceLoadReturnCancelled)
     {
         // if the trace file doesn't exist, ask the user if they want to remove it from
         // the recent traces list. This has to be done from the main thread.
@@ -290,6 +437,21 @@ bool TraceManager::ReadyToLoadTrace() const
     return (loading_thread == nullptr || loading_thread->isRunning() == false);
 }
 
+RmtProgress* TraceManager::GetLoadProgress()
+{
+    return &load_progress_;
+}
+
+void TraceManager::CancelTraceLoad()
+{
+    if (loading_thread != nullptr && loading_thread->isRunning() == true)
+    {
+        RmtProgressCancel(&load_progress_);
+        RmtProgressCancel(&index_progress_);
+        loading_thread->wait();
+    }
+}
+
 bool TraceManager::TraceValidToLoad(const QString& trace_path) const
 {
     bool may_load = false;
@@ -315,13 +477,9 @@ void TraceManager::SetOpenSnapshot(RmtDataSnapshot* snapshot)
     int                    resource_count = resource_list.resource_count;
     if (resource_count > 0)
     {
-        resource_sizes.reserve(resource_count);
-
-        for (int loop = 0; loop < resource_count; loop++)
-        {
-            const RmtResource& resource = resource_list.resources[loop];
-            resource_sizes.push_back(resource.size_in_bytes);
-        }
+        // Read the sizes from their column rather than from each resource.
+        const uint64_t* sizes_in_bytes = resource_list.columns.sizes_in_bytes;
+        resource_sizes.assign(sizes_in_bytes, sizes_in_bytes + resource_count);
         BuildResourceSizeThresholds(resource_sizes, resource_thresholds_);
     }
 
@@ -28,7 +28,8 @@ enum TraceLoadReturnCode
     kTraceLoadReturnError,
     kTraceLoadReturnSuccess,
     kTraceLoadReturnFail,
-    kTraceLoadReturnAlreadyOpened
+    kTraceLoadReturnAlreadyOpened,
+    kTraceLoadReturnCancelled
 };
 
 Q_DECLARE_METATYPE(TraceLoadReturnCode)
@@ -58,6 +59,13 @@ public:
     /// \return true if ready.
     bool ReadyToLoadTrace() const;
 
+    /// Get the progress of the trace being loaded.
+    /// \return The progress, which can also be used to cancel the load.
+    RmtProgress* GetLoadProgress();
+
+    /// Cancel the trace being loaded, if there is one, and wait for the loading thread to stop.
+    void CancelTraceLoad();
+
     /// Load a trace into memory. Note: This function runs in a separate thread so
     /// doesn't have access to anything QT-related (including the Debug Window).
     /// \param trace_file_name the name of the RMV trace file.
@@ -184,6 +192,8 @@ private:
 
     RmtDataSet                data_set_ = {};                                   ///< The dataset read from file.
     RmtDataTimeline           timeline_;                                        ///< The timeline.
+    RmtProgress               load_progress_;                                   ///< The progress of the trace being loaded.
+    RmtProgress               index_progress_;                                  ///< The progress of the resource event index built alongside the timeline.
     RmtDataSnapshot*          open_snapshot_;                                   ///< A pointer to the open snapshot.
     RmtDataSnapshot*          compared_snapshots_[kSnapshotCompareCount];       ///< A pointer to the compared snapshot.
     MainWindow*               main_window_;                                     ///< Pointer to the main window.
@@ -189,6 +189,7 @@ void RMVSettings::InitDefaultSettings()
     default_settings_[kSettingLastFileOpenLocation]            = {"LastFileOpenLocation", ""};
     default_settings_[kSettingGeneralCheckForUpdatesOnStartup] = {"CheckForUpdatesOnStartup", "False"};
     default_settings_[kSettingGeneralTimeUnits]                = {"TimeUnits", rmv::text::kSettingsUnitsSeconds};
+    default_settings_[kSettingGeneralSnapshotCacheSize]        = {"SnapshotCacheSizeInMB", "1024"};
 
     default_settings_[kSettingThemesAndColorsPalette] = {"ColorPalette",
                                                          "#FFFFBA02,#FFFF8B00,#FFF76210,#FFE17F35,#FFDA3B01,#FFEF6950,#FFD03438,#FFFF4343,"
@@ -466,6 +467,11 @@ bool RMVSettings::GetAllocUniqunessOffset()
     return GetBoolValue(kSettingGeneralAllocUniquenessOffset);
 }
 
+int RMVSettings::GetSnapshotCacheSize() const
+{
+    return GetIntValue(kSettingGeneralSnapshotCacheSize);
+}
+
 const ColorPalette& RMVSettings::GetColorPalette() const
 {
     return *color_palette_;
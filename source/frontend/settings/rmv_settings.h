@@ -40,6 +40,7 @@ enum RMVSettingID
     kSettingGeneralAllocUniquenessHeap,
     kSettingGeneralAllocUniquenessAllocation,
     kSettingGeneralAllocUniquenessOffset,
+    kSettingGeneralSnapshotCacheSize,
 
     kSettingThemesAndColorsPalette,
 
@@ -249,6 +250,10 @@ public:
     /// \return The value of kSettingGeneralAllocUniquenessOffset.
     bool GetAllocUniqunessOffset();
 
+    /// Get the value of kSettingGeneralSnapshotCacheSize in the settings.
+    /// \return The memory budget of the snapshot cache, in megabytes.
+    int GetSnapshotCacheSize() const;
+
     /// Get the color palette from the settings.
     /// \return The current color palette.
     const ColorPalette& GetColorPalette() const;
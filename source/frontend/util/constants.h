@@ -72,6 +72,9 @@ namespace rmv
             "Opening the trace file as read-only (snapshot edits will not be saved). The RMV file is either read only or has been opened in another instance "
             "of RMV";
 
+        // Progress shown while the loading animation is running.
+        static const QString kLoadingProgress = "%1% done, %2 tokens per second. Press Escape to cancel.";
+
         // Open recent trace missing pop up dialog.
         static const QString kOpenRecentTraceTitle = "Trace not opened";
         static const QString kOpenRecentTraceStart = "Trace \"";
@@ -0,0 +1,121 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Implementation of a bitset with one bit per table row.
+//=============================================================================
+
+#include "util/row_bitset.h"
+
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+#include "rmt_assert.h"
+
+namespace rmv
+{
+    RowBitset::RowBitset()
+        : row_count_(0)
+    {
+    }
+
+    RowBitset::~RowBitset()
+    {
+    }
+
+    void RowBitset::Resize(int32_t row_count)
+    {
+        row_count_ = row_count;
+        words_.assign((row_count + 63) / 64, 0);
+    }
+
+    int32_t RowBitset::Size() const
+    {
+        return row_count_;
+    }
+
+    void RowBitset::Set(int32_t row)
+    {
+        RMT_ASSERT(row >= 0 && row < row_count_);
+        words_[row / 64] |= (1ULL << (row % 64));
+    }
+
+    bool RowBitset::Test(int32_t row) const
+    {
+        if (row < 0 || row >= row_count_)
+        {
+            return false;
+        }
+        return (words_[row / 64] & (1ULL << (row % 64))) != 0;
+    }
+
+    void RowBitset::SetAll()
+    {
+        words_.assign(words_.size(), ~0ULL);
+        ClearUnusedBits();
+    }
+
+    void RowBitset::ClearAll()
+    {
+        words_.assign(words_.size(), 0);
+    }
+
+    void RowBitset::Or(const RowBitset& other)
+    {
+        RMT_ASSERT(other.row_count_ == row_count_);
+        for (size_t word_index = 0; word_index < words_.size(); word_index++)
+        {
+            words_[word_index] |= other.words_[word_index];
+        }
+    }
+
+    void RowBitset::And(const RowBitset& other)
+    {
+        RMT_ASSERT(other.row_count_ == row_count_);
+        for (size_t word_index = 0; word_index < words_.size(); word_index++)
+        {
+            words_[word_index] &= other.words_[word_index];
+        }
+    }
+
+    int32_t RowBitset::Count() const
+    {
+        int32_t count = 0;
+        for (size_t word_index = 0; word_index < words_.size(); word_index++)
+        {
+#ifdef _WIN32
+            // Count the bits in parallel, rather than rely on the popcnt instruction being available.
+            uint64_t word = words_[word_index];
+            word          = word - ((word >> 1) & 0x5555555555555555ULL);
+            word          = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+            word          = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            count += static_cast<int32_t>((word * 0x0101010101010101ULL) >> 56);
+#else
+            count += __builtin_popcountll(words_[word_index]);
+#endif
+        }
+        return count;
+    }
+
+    int32_t RowBitset::CountTrailingZeros(uint64_t word)
+    {
+        RMT_ASSERT(word != 0);
+#ifdef _WIN32
+        unsigned long index = 0;
+        _BitScanForward64(&index, word);
+        return static_cast<int32_t>(index);
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+    void RowBitset::ClearUnusedBits()
+    {
+        const int32_t used_bits_in_last_word = row_count_ % 64;
+        if (used_bits_in_last_word != 0)
+        {
+            words_.back() &= (1ULL << used_bits_in_last_word) - 1;
+        }
+    }
+}  // namespace rmv
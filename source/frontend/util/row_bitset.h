@@ -0,0 +1,93 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Definition of a bitset with one bit per table row.
+//=============================================================================
+
+#ifndef RMV_UTIL_ROW_BITSET_H_
+#define RMV_UTIL_ROW_BITSET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rmv
+{
+    /// Class holding one bit per row of a table. Used to cache which rows pass a
+    /// filter, so filters can be combined a word at a time rather than a row at a time.
+    class RowBitset
+    {
+    public:
+        /// Constructor.
+        RowBitset();
+
+        /// Destructor.
+        ~RowBitset();
+
+        /// Set the number of rows, clearing every bit.
+        /// \param row_count The number of rows.
+        void Resize(int32_t row_count);
+
+        /// Get the number of rows.
+        /// \return The number of rows.
+        int32_t Size() const;
+
+        /// Set the bit for a row.
+        /// \param row The row to set.
+        void Set(int32_t row);
+
+        /// Check if the bit for a row is set.
+        /// \param row The row to check.
+        /// \return true if the bit is set, false if not or if the row is out of range.
+        bool Test(int32_t row) const;
+
+        /// Set the bits for every row.
+        void SetAll();
+
+        /// Clear the bits for every row.
+        void ClearAll();
+
+        /// Set the bits that are set in another bitset of the same size.
+        /// \param other The bitset to combine with.
+        void Or(const RowBitset& other);
+
+        /// Clear the bits that are not set in another bitset of the same size.
+        /// \param other The bitset to combine with.
+        void And(const RowBitset& other);
+
+        /// Count the number of bits that are set.
+        /// \return The number of rows with their bit set.
+        int32_t Count() const;
+
+        /// Call a function for every row with its bit set, in row order.
+        /// \param func The function to call with each row.
+        template <typename Function>
+        void ForEachSetRow(Function func) const
+        {
+            for (size_t word_index = 0; word_index < words_.size(); word_index++)
+            {
+                uint64_t word = words_[word_index];
+                while (word != 0)
+                {
+                    func(static_cast<int32_t>(word_index * 64) + CountTrailingZeros(word));
+                    word &= word - 1;
+                }
+            }
+        }
+
+    private:
+        /// Get the index of the lowest bit set in a non-zero word.
+        /// \param word The word.
+        /// \return The index of the lowest set bit.
+        static int32_t CountTrailingZeros(uint64_t word);
+
+        /// Clear the bits in the last word that are past the last row.
+        void ClearUnusedBits();
+
+        std::vector<uint64_t> words_;      ///< The bits, 64 rows per word.
+        int32_t               row_count_;  ///< The number of rows.
+    };
+}  // namespace rmv
+
+#endif  // RMV_UTIL_ROW_BITSET_H_
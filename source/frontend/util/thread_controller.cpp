@@ -14,6 +14,7 @@
 namespace rmv
 {
     BackgroundTask::BackgroundTask()
+        : progress_(nullptr)
     {
     }
 
@@ -27,13 +28,27 @@ namespace rmv
         emit WorkerFinished();
     }
 
+    void BackgroundTask::SetProgress(RmtProgress* progress)
+    {
+        progress_ = progress;
+    }
+
+    RmtProgress* BackgroundTask::GetProgress() const
+    {
+        return progress_;
+    }
+
     ThreadController::ThreadController(MainWindow* main_window, QWidget* parent, BackgroundTask* background_task)
         : main_window_(main_window)
         , background_task_(background_task)
         , finished_(false)
     {
+        // the progress is owned here rather than by the worker, as the worker deletes itself on its own thread.
+        RmtProgressInitialize(&progress_, 1);
+        background_task_->SetProgress(&progress_);
+
         // start the loading animation
-        main_window_->StartAnimation(parent, 0);
+        main_window_->StartAnimation(parent, 0, &progress_);
 
         // create the thread. It will be setup to be deleted below when the thread has
         // finished (it emits a QThread::Finished signal)
@@ -53,6 +68,12 @@ namespace rmv
 
     ThreadController::~ThreadController()
     {
+        // the worker can't be left running, as it reports to progress_.
+        if (finished_ == false)
+        {
+            Cancel();
+            main_window_->StopAnimation();
+        }
     }
 
     void ThreadController::WorkerFinished()
@@ -67,4 +88,22 @@ namespace rmv
         return finished_;
     }
 
+    void ThreadController::Cancel()
+    {
+        if (finished_ == false)
+        {
+            RmtProgressCancel(&progress_);
+
+            // the worker may already have finished, in which case the request to quit its thread is still queued
+            // on this thread. Quitting here means the thread doesn't wait for it.
+            thread_->quit();
+            thread_->wait();
+        }
+    }
+
+    bool ThreadController::Cancelled()
+    {
+        return RmtProgressIsCancelled(&progress_);
+    }
+
 }  // namespace rmv
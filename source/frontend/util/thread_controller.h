@@ -15,6 +15,8 @@
 #include <QWidget>
 #include <QThread>
 
+#include "rmt_progress.h"
+
 class MainWindow;
 
 namespace rmv
@@ -40,9 +42,22 @@ namespace rmv
         /// ThreadFunc() and cleans up afterwards.
         void Start();
 
+        /// Set the progress structure for the task to report to. Called by the thread controller before the
+        /// thread is started.
+        /// \param progress The progress structure.
+        void SetProgress(RmtProgress* progress);
+
+    protected:
+        /// Get the progress structure to pass to the backend, so the task can report its progress and be cancelled.
+        /// \return The progress structure, or nullptr if the task isn't run by a thread controller.
+        RmtProgress* GetProgress() const;
+
     signals:
         /// Indicate that initial processing of the pane has completed.
         void WorkerFinished();
+
+    private:
+        RmtProgress* progress_;  ///< The progress structure owned by the thread controller.
     };
 
     class ThreadController : public QObject
@@ -64,6 +79,13 @@ namespace rmv
         /// \return true if finished, false if not.
         bool Finished() const;
 
+        /// Ask the worker to stop, and wait for it to. ThreadFinished() is still emitted once the worker has stopped.
+        void Cancel();
+
+        /// Has the worker been asked to stop.
+        /// \return true if cancelled, false if not.
+        bool Cancelled();
+
     signals:
         /// Indicate that the worker thread has finished.
         void ThreadFinished();
@@ -73,6 +95,7 @@ namespace rmv
         QThread*        thread_;           ///< The worker thread.
         BackgroundTask* background_task_;  ///< The worker object that does the work.
         bool            finished_;         ///< Is the data valid.
+        RmtProgress     progress_;         ///< The progress of the worker, shown by the loading animation.
     };
 }  // namespace rmv
 
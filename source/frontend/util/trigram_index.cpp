@@ -0,0 +1,219 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Implementation of a trigram index for searching the strings in table rows.
+//=============================================================================
+
+#include "util/trigram_index.h"
+
+#include <algorithm>
+
+#include "rmt_assert.h"
+
+namespace rmv
+{
+    TrigramIndex::TrigramIndex()
+        : row_count_(0)
+    {
+    }
+
+    TrigramIndex::~TrigramIndex()
+    {
+    }
+
+    void TrigramIndex::Clear()
+    {
+        row_count_ = 0;
+        strings_.clear();
+        string_ids_.clear();
+        added_rows_.clear();
+        string_row_offsets_.clear();
+        string_rows_.clear();
+        trigrams_.clear();
+        trigram_offsets_.clear();
+        trigram_strings_.clear();
+        short_strings_.clear();
+    }
+
+    void TrigramIndex::AddString(int32_t row, const std::string& text)
+    {
+        auto    iter      = string_ids_.find(text);
+        int32_t string_id = 0;
+        if (iter == string_ids_.end())
+        {
+            string_id = static_cast<int32_t>(strings_.size());
+            strings_.push_back(text);
+            string_ids_.emplace(text, string_id);
+        }
+        else
+        {
+            string_id = iter->second;
+        }
+
+        added_rows_.push_back(std::make_pair(string_id, row));
+    }
+
+    uint32_t TrigramIndex::GetTrigram(const char* text)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text);
+        return (static_cast<uint32_t>(bytes[0]) << 16) | (static_cast<uint32_t>(bytes[1]) << 8) | static_cast<uint32_t>(bytes[2]);
+    }
+
+    void TrigramIndex::Finalize(int32_t row_count)
+    {
+        row_count_ = row_count;
+        string_ids_.clear();
+
+        // Group the rows by string. A row is added to a string once per column showing it,
+        // so drop the duplicates.
+        std::sort(added_rows_.begin(), added_rows_.end());
+        added_rows_.erase(std::unique(added_rows_.begin(), added_rows_.end()), added_rows_.end());
+
+        const int32_t string_count = static_cast<int32_t>(strings_.size());
+        string_row_offsets_.assign(string_count + 1, 0);
+        string_rows_.resize(added_rows_.size());
+        for (size_t added_index = 0; added_index < added_rows_.size(); added_index++)
+        {
+            string_row_offsets_[added_rows_[added_index].first + 1]++;
+            string_rows_[added_index] = added_rows_[added_index].second;
+        }
+        for (int32_t string_id = 0; string_id < string_count; string_id++)
+        {
+            string_row_offsets_[string_id + 1] += string_row_offsets_[string_id];
+        }
+        std::vector<std::pair<int32_t, int32_t>>().swap(added_rows_);
+
+        // Collect each distinct trigram of each string, then group the strings by trigram.
+        std::vector<std::pair<uint32_t, int32_t>> trigram_pairs;
+        short_strings_.clear();
+        for (int32_t string_id = 0; string_id < string_count; string_id++)
+        {
+            const std::string& text = strings_[string_id];
+            if (text.size() < 3)
+            {
+                short_strings_.push_back(string_id);
+            }
+            for (size_t offset = 0; offset + 3 <= text.size(); offset++)
+            {
+                trigram_pairs.push_back(std::make_pair(GetTrigram(&text[offset]), string_id));
+            }
+        }
+        std::sort(trigram_pairs.begin(), trigram_pairs.end());
+        trigram_pairs.erase(std::unique(trigram_pairs.begin(), trigram_pairs.end()), trigram_pairs.end());
+
+        trigrams_.clear();
+        trigram_offsets_.clear();
+        trigram_strings_.resize(trigram_pairs.size());
+        for (size_t pair_index = 0; pair_index < trigram_pairs.size(); pair_index++)
+        {
+            if (trigrams_.empty() || (trigrams_.back() != trigram_pairs[pair_index].first))
+            {
+                trigrams_.push_back(trigram_pairs[pair_index].first);
+                trigram_offsets_.push_back(static_cast<int32_t>(pair_index));
+            }
+            trigram_strings_[pair_index] = trigram_pairs[pair_index].second;
+        }
+        trigram_offsets_.push_back(static_cast<int32_t>(trigram_pairs.size()));
+    }
+
+    void TrigramIndex::FindTrigramStrings(uint32_t trigram, int32_t& out_first, int32_t& out_last) const
+    {
+        out_first = 0;
+        out_last  = 0;
+
+        const auto iter = std::lower_bound(trigrams_.begin(), trigrams_.end(), trigram);
+        if ((iter != trigrams_.end()) && (*iter == trigram))
+        {
+            const size_t trigram_index = iter - trigrams_.begin();
+            out_first                  = trigram_offsets_[trigram_index];
+            out_last                   = trigram_offsets_[trigram_index + 1];
+        }
+    }
+
+    void TrigramIndex::AddStringRows(int32_t string_id, RowBitset& out_rows) const
+    {
+        for (int32_t row_offset = string_row_offsets_[string_id]; row_offset < string_row_offsets_[string_id + 1]; row_offset++)
+        {
+            out_rows.Set(string_rows_[row_offset]);
+        }
+    }
+
+    void TrigramIndex::SearchShortQuery(const std::string& query, RowBitset& out_rows) const
+    {
+        // A string 3 bytes or longer contains the query if one of its trigrams does, so
+        // match the query against the distinct trigrams rather than every string.
+        RowBitset matched_strings;
+        matched_strings.Resize(static_cast<int32_t>(strings_.size()));
+        for (size_t trigram_index = 0; trigram_index < trigrams_.size(); trigram_index++)
+        {
+            const uint32_t    trigram  = trigrams_[trigram_index];
+            const char        bytes[3] = {static_cast<char>(trigram >> 16), static_cast<char>(trigram >> 8), static_cast<char>(trigram)};
+            const std::string trigram_text(bytes, 3);
+            if (trigram_text.find(query) != std::string::npos)
+            {
+                for (int32_t string_offset = trigram_offsets_[trigram_index]; string_offset < trigram_offsets_[trigram_index + 1]; string_offset++)
+                {
+                    matched_strings.Set(trigram_strings_[string_offset]);
+                }
+            }
+        }
+
+        for (const int32_t string_id : short_strings_)
+        {
+            if (strings_[string_id].find(query) != std::string::npos)
+            {
+                matched_strings.Set(string_id);
+            }
+        }
+
+        matched_strings.ForEachSetRow([&](int32_t string_id) { AddStringRows(string_id, out_rows); });
+    }
+
+    void TrigramIndex::Search(const std::string& query, RowBitset& out_rows) const
+    {
+        out_rows.Resize(row_count_);
+
+        if (query.empty() == true)
+        {
+            out_rows.SetAll();
+            return;
+        }
+
+        if (query.size() < 3)
+        {
+            SearchShortQuery(query, out_rows);
+            return;
+        }
+
+        // Check the strings containing the rarest trigram of the query.
+        int32_t candidate_first = 0;
+        int32_t candidate_last  = 0;
+        for (size_t offset = 0; offset + 3 <= query.size(); offset++)
+        {
+            int32_t first = 0;
+            int32_t last  = 0;
+            FindTrigramStrings(GetTrigram(&query[offset]), first, last);
+            if (first == last)
+            {
+                // No string contains this trigram, so no string contains the query.
+                return;
+            }
+
+            if ((offset == 0) || ((last - first) < (candidate_last - candidate_first)))
+            {
+                candidate_first = first;
+                candidate_last  = last;
+            }
+        }
+
+        for (int32_t candidate_index = candidate_first; candidate_index < candidate_last; candidate_index++)
+        {
+            const int32_t string_id = trigram_strings_[candidate_index];
+            if (strings_[string_id].find(query) != std::string::npos)
+            {
+                AddStringRows(string_id, out_rows);
+            }
+        }
+    }
+}  // namespace rmv
@@ -0,0 +1,87 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Definition of a trigram index for searching the strings in table rows.
+//=============================================================================
+
+#ifndef RMV_UTIL_TRIGRAM_INDEX_H_
+#define RMV_UTIL_TRIGRAM_INDEX_H_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "util/row_bitset.h"
+
+namespace rmv
+{
+    /// Class to find the table rows containing a substring.
+    ///
+    /// Each distinct string is stored once, with the list of rows showing it. Every
+    /// sequence of 3 bytes (trigram) in the strings maps to the strings containing it,
+    /// so a search only checks the strings containing the rarest trigram of the query
+    /// rather than every string in the table.
+    class TrigramIndex
+    {
+    public:
+        /// Constructor.
+        TrigramIndex();
+
+        /// Destructor.
+        ~TrigramIndex();
+
+        /// Remove every string from the index.
+        void Clear();
+
+        /// Add a string shown in a row. Must be called before Finalize.
+        /// \param row The row showing the string.
+        /// \param text The string, as lower case UTF-8.
+        void AddString(int32_t row, const std::string& text);
+
+        /// Build the lookup tables once all the strings have been added.
+        /// \param row_count The number of rows in the table.
+        void Finalize(int32_t row_count);
+
+        /// Find the rows showing a string containing the query.
+        /// \param query The query, as lower case UTF-8.
+        /// \param out_rows The rows containing the query.
+        void Search(const std::string& query, RowBitset& out_rows) const;
+
+    private:
+        /// Get the trigram key for 3 bytes of a string.
+        /// \param text A pointer to the first byte.
+        /// \return The trigram key.
+        static uint32_t GetTrigram(const char* text);
+
+        /// Add the rows of a string to a search result.
+        /// \param string_id The index of the string.
+        /// \param out_rows The search result.
+        void AddStringRows(int32_t string_id, RowBitset& out_rows) const;
+
+        /// Find the rows showing a string containing a query too short to have a trigram.
+        /// \param query The query, as lower case UTF-8.
+        /// \param out_rows The rows containing the query.
+        void SearchShortQuery(const std::string& query, RowBitset& out_rows) const;
+
+        /// Get the range of strings containing a trigram.
+        /// \param trigram The trigram key.
+        /// \param out_first The index of the first string in trigram_strings_.
+        /// \param out_last One past the index of the last string in trigram_strings_.
+        void FindTrigramStrings(uint32_t trigram, int32_t& out_first, int32_t& out_last) const;
+
+        int32_t                                  row_count_;             ///< The number of rows in the table.
+        std::vector<std::string>                 strings_;               ///< The distinct strings.
+        std::unordered_map<std::string, int32_t> string_ids_;            ///< The index of each distinct string, while adding strings.
+        std::vector<std::pair<int32_t, int32_t>> added_rows_;            ///< The (string, row) pairs, while adding strings.
+        std::vector<int32_t>                     string_row_offsets_;    ///< The offset of the rows of each string in string_rows_.
+        std::vector<int32_t>                     string_rows_;           ///< The rows showing each string, grouped by string.
+        std::vector<uint32_t>                    trigrams_;              ///< The distinct trigrams, sorted.
+        std::vector<int32_t>                     trigram_offsets_;       ///< The offset of the strings of each trigram in trigram_strings_.
+        std::vector<int32_t>                     trigram_strings_;       ///< The strings containing each trigram, grouped by trigram.
+        std::vector<int32_t>                     short_strings_;         ///< The strings too short to have a trigram.
+    };
+}  // namespace rmv
+
+#endif  // RMV_UTIL_TRIGRAM_INDEX_H_
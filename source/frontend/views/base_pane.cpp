@@ -29,6 +29,10 @@ void BasePane::SwitchTimeUnits()
 {
 }
 
+void BasePane::OnTraceClosing()
+{
+}
+
 void BasePane::OnTraceClose()
 {
 }
@@ -35,6 +35,9 @@ public:
     /// Switch the time units.
     virtual void SwitchTimeUnits();
 
+    /// Trace about to be closed. Any background work using the trace data should be stopped.
+    virtual void OnTraceClosing();
+
     /// Trace closed.
     virtual void OnTraceClose();
 
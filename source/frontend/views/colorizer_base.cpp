@@ -153,6 +153,11 @@ QColor ColorizerBase::GetResourceUsageColor(RmtResourceUsageType usage_type)
     return out;
 }
 
+ColorizerBase::ColorMode ColorizerBase::GetColorMode() const
+{
+    return color_mode_;
+}
+
 QColor ColorizerBase::GetColor(const uint32_t color_index)
 {
     switch (color_mode_)
@@ -266,14 +271,14 @@ QColor ColorizerBase::GetColor(const RmtVirtualAllocation* const allocation, con
 
     case kColorModeNotAllPreferred:
     {
+        if (!resource || !resource->bound_allocation || resource->resource_type == kRmtResourceTypeCount)
+            return RMVSettings::Get().GetColorResourceFreeSpace();
+
         const RmtDataSnapshot* open_snapshot = TraceManager::Get().GetOpenSnapshot();
 
         uint64_t memory_segment_histogram[kRmtResourceBackingStorageCount] = {0};
         RmtResourceGetBackingStorageHistogram(open_snapshot, resource, memory_segment_histogram);
 
-        if (!resource || !resource->bound_allocation || resource->resource_type == kRmtResourceTypeCount)
-            return RMVSettings::Get().GetColorResourceFreeSpace();
-
         // Check that the preferred heap contains all the bytes.
         const RmtHeapType preferred_heap = resource->bound_allocation->heap_preferences[0];
         if (memory_segment_histogram[preferred_heap] != resource->size_in_bytes)
@@ -285,11 +290,6 @@ QColor ColorizerBase::GetColor(const RmtVirtualAllocation* const allocation, con
 
     case kColorModeAliasing:
     {
-        const RmtDataSnapshot* open_snapshot = TraceManager::Get().GetOpenSnapshot();
-
-        uint64_t memory_segment_histogram[kRmtResourceBackingStorageCount] = {0};
-        RmtResourceGetBackingStorageHistogram(open_snapshot, resource, memory_segment_histogram);
-
         if (!resource || !resource->bound_allocation || resource->resource_type == kRmtResourceTypeCount)
             return RMVSettings::Get().GetColorResourceFreeSpace();
 
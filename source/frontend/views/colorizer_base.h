@@ -62,6 +62,10 @@ public:
     /// \return The color to use.
     QColor GetColor(const RmtVirtualAllocation* allocation, const RmtResource* resource) const;
 
+    /// Get the current coloring mode.
+    /// \return The coloring mode.
+    ColorMode GetColorMode() const;
+
     /// Function to call when picking the color based on color mode.
     /// \param The index of the color for the current color mode.
     /// \return The color to use.
@@ -82,6 +82,7 @@ MemoryLeakFinderPane::MemoryLeakFinderPane(QWidget* parent)
 
     // set up a connection between the timeline being sorted and making sure the selected event is visible
     connect(model_->GetResourceProxyModel(), &rmv::MemoryLeakFinderProxyModel::layoutChanged, this, &MemoryLeakFinderPane::ScrollToSelectedResource);
+    connect(model_->GetResourceProxyModel(), &rmv::MemoryLeakFinderProxyModel::modelReset, this, [=]() { SetMaximumResourceTableHeight(); });
 
     connect(&ScalingManager::Get(), &ScalingManager::ScaleFactorChanged, this, &MemoryLeakFinderPane::OnScaleFactorChanged);
 }
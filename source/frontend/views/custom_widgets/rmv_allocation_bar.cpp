@@ -8,6 +8,7 @@
 #include "views/custom_widgets/rmv_allocation_bar.h"
 
 #include <QGraphicsSceneEvent>
+#include <QPainter>
 
 #include "qt_common/utils/scaling_manager.h"
 
@@ -20,12 +21,18 @@ static const int kTitleFontSize              = 8;
 static const int kDefaultWidth               = 300;
 static const int kDefaultBarPadding          = 5;
 static const int kDefaultAllocationBarHeight = 50;
+static const int kStripMargin                = 2;
 
-RMVAllocationBar::RMVAllocationBar(rmv::AllocationBarModel* model, int32_t allocation_index, int32_t model_index, const Colorizer* colorizer)
+RMVAllocationBar::RMVAllocationBar(rmv::AllocationBarModel* model,
+                                   int32_t                  allocation_index,
+                                   int32_t                  model_index,
+                                   const Colorizer*         colorizer,
+                                   RMVAllocationBarCache*   strip_cache)
     : model_(model)
     , allocation_index_(allocation_index)
     , model_index_(model_index)
     , colorizer_(colorizer)
+    , strip_cache_(strip_cache)
     , item_width_(0)
     , item_height_(0)
     , max_bar_width_(0)
@@ -90,15 +97,72 @@ void RMVAllocationBar::paint(QPainter* painter, const QStyleOptionGraphicsItem*
     const uint64_t allocation_size      = RmtVirtualAllocationGetSizeInBytes(allocation);
     const double   bytes_per_pixel      = model_->GetBytesPerPixel(allocation_index_, model_index_, max_bar_width_);
     const int      allocation_bar_width = (double)allocation_size / bytes_per_pixel;
+    const int      num_rows             = model_->GetNumRows(allocation);
 
+    if (strip_cache_ != nullptr)
+    {
+        // Draw the bar from the cache, rasterizing it first if this allocation hasn't been drawn at this size and
+        // coloring yet. The strip has a margin on each side for the parts of the borders outside the bar.
+        const qreal                    device_pixel_ratio = painter->device()->devicePixelRatioF();
+        const int                      strip_margin       = ScalingManager::Get().Scaled(kStripMargin);
+        const RMVAllocationBarStripKey key                = {
+            allocation->guid, allocation_bar_width, allocation_bar_height_, colorizer_->GetColorMode(), num_rows, bytes_per_pixel, device_pixel_ratio};
+
+        const QPixmap* strip = strip_cache_->Find(key);
+        QPixmap        new_strip;
+        if (strip == nullptr)
+        {
+            new_strip = QPixmap(QSize(allocation_bar_width + (strip_margin * 2), allocation_bar_height_ + (strip_margin * 2)) * device_pixel_ratio);
+            new_strip.setDevicePixelRatio(device_pixel_ratio);
+            new_strip.fill(Qt::transparent);
+
+            QPainter strip_painter(&new_strip);
+            strip_painter.translate(strip_margin, strip_margin);
+            DrawBar(&strip_painter, allocation, 0, bytes_per_pixel, allocation_bar_width, num_rows);
+            strip_painter.end();
+
+            strip = strip_cache_->Insert(key, new_strip);
+        }
+
+        painter->drawPixmap(QPointF(-strip_margin, scaled_bar_y_offset - strip_margin), *strip);
+    }
+    else
+    {
+        DrawBar(painter, allocation, scaled_bar_y_offset, bytes_per_pixel, allocation_bar_width, num_rows);
+    }
+
+    // Draw the hovered and selected resources over the top of the bar.
+    const int32_t hovered_resource  = model_->GetHoveredResourceForAllocation(allocation_index_, model_index_);
+    const int32_t selected_resource = model_->GetSelectedResourceForAllocation(allocation_index_, model_index_);
+    if ((hovered_resource >= 0 || selected_resource >= 0) && num_rows > 0)
+    {
+        const double resource_height = static_cast<double>(allocation_bar_height_) / num_rows;
+        if (hovered_resource >= 0 && hovered_resource != selected_resource)
+        {
+            DrawResource(painter, allocation, hovered_resource, scaled_bar_y_offset, bytes_per_pixel, resource_height, true, false);
+        }
+        if (selected_resource >= 0)
+        {
+            const bool hovered = (selected_resource == hovered_resource);
+            DrawResource(painter, allocation, selected_resource, scaled_bar_y_offset, bytes_per_pixel, resource_height, hovered, true);
+        }
+    }
+}
+
+void RMVAllocationBar::DrawBar(QPainter*                   painter,
+                               const RmtVirtualAllocation* allocation,
+                               double                      y_offset,
+                               double                      bytes_per_pixel,
+                               int                         allocation_bar_width,
+                               int                         num_rows) const
+{
     // paint the background first. Needs to be colored based on the coloring mode.
     QColor background_brush_color = colorizer_->GetColor(allocation, nullptr);
     painter->setPen(Qt::NoPen);
     painter->setBrush(background_brush_color);
-    painter->drawRect(0, scaled_bar_y_offset, allocation_bar_width, allocation_bar_height_);
+    painter->drawRect(0, y_offset, allocation_bar_width, allocation_bar_height_);
 
     // now paint all the resources on top.
-    int num_rows = model_->GetNumRows(allocation);
     if (num_rows > 0)
     {
         double resource_height = allocation_bar_height_;
@@ -107,51 +171,66 @@ void RMVAllocationBar::paint(QPainter* painter, const QStyleOptionGraphicsItem*
         const int resource_count = allocation->resource_count;
         for (int current_resource_index = 0; current_resource_index < resource_count; current_resource_index++)
         {
-            const RmtResource* resource = allocation->resources[current_resource_index];
-
-            if (resource->resource_type == kRmtResourceTypeHeap)
-            {
-                continue;
-            }
-
-            int    row      = model_->GetRowForResourceAtIndex(allocation, current_resource_index);
-            double y_offset = scaled_bar_y_offset + (resource_height * row);
-
-            QColor resource_background_brush_color = colorizer_->GetColor(resource->bound_allocation, resource);
-
-            if (current_resource_index == model_->GetHoveredResourceForAllocation(allocation_index_, model_index_))
-            {
-                resource_background_brush_color = resource_background_brush_color.dark(rmv::kHoverDarkenColor);
-            }
-
-            // calculate the size of the resource
-            const uint64_t offset_in_bytes    = RmtResourceGetOffsetFromBoundAllocation(resource);
-            const int      x_pos              = (double)offset_in_bytes / bytes_per_pixel;
-            const int      resource_bar_width = RMT_MAXIMUM(1, (double)resource->size_in_bytes / bytes_per_pixel);
-
-            // render the resource
-            QPen resource_border_pen(Qt::black);
-            if (current_resource_index == model_->GetSelectedResourceForAllocation(allocation_index_, model_index_))
-            {
-                resource_border_pen.setWidth(ScalingManager::Get().Scaled(2));
-            }
-            else
-            {
-                resource_border_pen.setWidth(ScalingManager::Get().Scaled(1));
-            }
-            painter->setPen(resource_border_pen);
-
-            Qt::BrushStyle style = ((RmtResourceGetAliasCount(resource) > 0) ? Qt::BrushStyle::Dense1Pattern : Qt::BrushStyle::SolidPattern);
-            const QBrush   curr_brush(resource_background_brush_color, style);
-            painter->setBrush(curr_brush);
-            painter->drawRect(x_pos, y_offset, resource_bar_width + 1, resource_height);
+            DrawResource(painter, allocation, current_resource_index, y_offset, bytes_per_pixel, resource_height, false, false);
         }
     }
 
     // render border around the whole allocation
     painter->setPen(QColor(0, 0, 0));
     painter->setBrush(Qt::NoBrush);
-    painter->drawRect(0, scaled_bar_y_offset, allocation_bar_width, allocation_bar_height_);
+    painter->drawRect(0, y_offset, allocation_bar_width, allocation_bar_height_);
+}
+
+void RMVAllocationBar::DrawResource(QPainter*                   painter,
+                                    const RmtVirtualAllocation* allocation,
+                                    int32_t                     resource_index,
+                                    double                      y_offset,
+                                    double                      bytes_per_pixel,
+                                    double                      resource_height,
+                                    bool                        hovered,
+                                    bool                        selected) const
+{
+    if (resource_index >= allocation->resource_count)
+    {
+        return;
+    }
+
+    const RmtResource* resource = allocation->resources[resource_index];
+    if (resource->resource_type == kRmtResourceTypeHeap)
+    {
+        return;
+    }
+
+    int    row               = model_->GetRowForResourceAtIndex(allocation, resource_index);
+    double resource_y_offset = y_offset + (resource_height * row);
+
+    QColor resource_background_brush_color = colorizer_->GetColor(resource->bound_allocation, resource);
+    if (hovered)
+    {
+        resource_background_brush_color = resource_background_brush_color.dark(rmv::kHoverDarkenColor);
+    }
+
+    // calculate the size of the resource
+    const uint64_t offset_in_bytes    = RmtResourceGetOffsetFromBoundAllocation(resource);
+    const int      x_pos              = (double)offset_in_bytes / bytes_per_pixel;
+    const int      resource_bar_width = RMT_MAXIMUM(1, (double)resource->size_in_bytes / bytes_per_pixel);
+
+    // render the resource
+    QPen resource_border_pen(Qt::black);
+    if (selected)
+    {
+        resource_border_pen.setWidth(ScalingManager::Get().Scaled(2));
+    }
+    else
+    {
+        resource_border_pen.setWidth(ScalingManager::Get().Scaled(1));
+    }
+    painter->setPen(resource_border_pen);
+
+    Qt::BrushStyle style = ((RmtResourceGetAliasCount(resource) > 0) ? Qt::BrushStyle::Dense1Pattern : Qt::BrushStyle::SolidPattern);
+    const QBrush   curr_brush(resource_background_brush_color, style);
+    painter->setBrush(curr_brush);
+    painter->drawRect(x_pos, resource_y_offset, resource_bar_width + 1, resource_height);
 }
 
 void RMVAllocationBar::UpdateDimensions(const int width, const int height)
@@ -16,6 +16,7 @@
 #include "models/allocation_bar_model.h"
 #include "util/definitions.h"
 #include "views/colorizer.h"
+#include "views/custom_widgets/rmv_allocation_bar_cache.h"
 
 /// Container class for a memory block widget.
 class RMVAllocationBar : public QGraphicsObject
@@ -28,7 +29,12 @@ public:
     /// \param allocation_index The index of the allocation in the model containing the raw allocation data.
     /// \param model_index The allocation model index this graphic item refers to (for panes with multiple allocation displays).
     /// \param colorizer The colorizer used to color this widget.
-    explicit RMVAllocationBar(rmv::AllocationBarModel* model, int32_t allocation_index, int32_t model_index, const Colorizer* colorizer);
+    /// \param strip_cache The cache to draw the bar through, or nullptr to draw it directly every time it is painted.
+    explicit RMVAllocationBar(rmv::AllocationBarModel* model,
+                              int32_t                  allocation_index,
+                              int32_t                  model_index,
+                              const Colorizer*         colorizer,
+                              RMVAllocationBarCache*   strip_cache);
 
     /// Destructor.
     virtual ~RMVAllocationBar();
@@ -75,10 +81,43 @@ signals:
     void ResourceSelected(RmtResourceIdentifier resource_Identifier, bool navigate_to_pane);
 
 private:
+    /// Draw the allocation background, its resources and its border.
+    /// \param painter The painter object to use.
+    /// \param allocation The allocation.
+    /// \param y_offset The offset of the top of the bar.
+    /// \param bytes_per_pixel The number of bytes each pixel represents.
+    /// \param allocation_bar_width The width of the bar.
+    /// \param num_rows The number of rows the resources are stacked in.
+    void DrawBar(QPainter*                   painter,
+                 const RmtVirtualAllocation* allocation,
+                 double                      y_offset,
+                 double                      bytes_per_pixel,
+                 int                         allocation_bar_width,
+                 int                         num_rows) const;
+
+    /// Draw a single resource.
+    /// \param painter The painter object to use.
+    /// \param allocation The allocation containing the resource.
+    /// \param resource_index The index of the resource in the allocation.
+    /// \param y_offset The offset of the top of the bar.
+    /// \param bytes_per_pixel The number of bytes each pixel represents.
+    /// \param resource_height The height of a row of resources.
+    /// \param hovered If true, draw the resource highlighted.
+    /// \param selected If true, draw the resource with a selection border.
+    void DrawResource(QPainter*                   painter,
+                      const RmtVirtualAllocation* allocation,
+                      int32_t                     resource_index,
+                      double                      y_offset,
+                      double                      bytes_per_pixel,
+                      double                      resource_height,
+                      bool                        hovered,
+                      bool                        selected) const;
+
     rmv::AllocationBarModel* model_;             ///< The underlying model holding the backend data.
     int32_t                  allocation_index_;  ///< The index of this object in the scene.
     int32_t                  model_index_;       ///< The allocation model index this graphic item refers to (for panes with multiple allocation displays).
     const Colorizer*         colorizer_;         ///< The colorizer used to color this widget.
+    RMVAllocationBarCache*   strip_cache_;       ///< The cache of rasterized bars, or nullptr if the bar isn't cached.
     QFont                    title_font_;        ///< Font used for painting the title.
     QFont                    description_font_;  ///< Font used for painting the description.
 
@@ -0,0 +1,60 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Implementation of a cache of rasterized allocation bars
+//=============================================================================
+
+#include "views/custom_widgets/rmv_allocation_bar_cache.h"
+
+#include <QHash>
+#include <algorithm>
+
+bool RMVAllocationBarStripKey::operator==(const RMVAllocationBarStripKey& other) const
+{
+    return allocation_guid == other.allocation_guid && width == other.width && height == other.height && color_mode == other.color_mode &&
+           row_count == other.row_count && bytes_per_pixel == other.bytes_per_pixel && device_pixel_ratio == other.device_pixel_ratio;
+}
+
+uint qHash(const RMVAllocationBarStripKey& key, uint seed)
+{
+    uint hash = qHash(key.allocation_guid, seed);
+    hash      = (hash * 31) ^ qHash(key.width, seed);
+    hash      = (hash * 31) ^ qHash(key.height, seed);
+    hash      = (hash * 31) ^ qHash(key.color_mode, seed);
+    hash      = (hash * 31) ^ qHash(key.row_count, seed);
+    return hash;
+}
+
+RMVAllocationBarCache::RMVAllocationBarCache(int32_t max_size_in_bytes)
+    : strips_(max_size_in_bytes / 1024)
+{
+}
+
+RMVAllocationBarCache::~RMVAllocationBarCache()
+{
+}
+
+const QPixmap* RMVAllocationBarCache::Find(const RMVAllocationBarStripKey& key)
+{
+    return strips_.object(key);
+}
+
+const QPixmap* RMVAllocationBarCache::Insert(const RMVAllocationBarStripKey& key, const QPixmap& strip)
+{
+    const int cost = std::max((strip.width() * strip.height() * strip.depth() / 8) / 1024, 1);
+
+    QPixmap* cached_strip = new QPixmap(strip);
+    if (strips_.insert(key, cached_strip, cost) == false)
+    {
+        // Too big to ever be cached. QCache has already deleted the copy, so hand back the original.
+        return &strip;
+    }
+
+    return cached_strip;
+}
+
+void RMVAllocationBarCache::Clear()
+{
+    strips_.clear();
+}
@@ -0,0 +1,66 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Header for a cache of rasterized allocation bars
+//=============================================================================
+
+#ifndef RMV_VIEWS_CUSTOM_WIDGETS_RMV_ALLOCATION_BAR_CACHE_H_
+#define RMV_VIEWS_CUSTOM_WIDGETS_RMV_ALLOCATION_BAR_CACHE_H_
+
+#include <QCache>
+#include <QPixmap>
+
+/// Everything that changes how an allocation bar strip looks.
+struct RMVAllocationBarStripKey
+{
+    int32_t allocation_guid;     ///< The GUID of the allocation.
+    int32_t width;               ///< The width of the bar, in pixels.
+    int32_t height;              ///< The height of the bar, in pixels.
+    int32_t color_mode;          ///< The colorizer mode the bar was drawn with.
+    int32_t row_count;           ///< The number of rows the resources are stacked in.
+    double  bytes_per_pixel;     ///< The number of bytes each pixel represents.
+    qreal   device_pixel_ratio;  ///< The device pixel ratio of the strip.
+
+    bool operator==(const RMVAllocationBarStripKey& other) const;
+};
+
+/// Hash function for a strip key, so it can be used with QCache.
+/// \param key The key.
+/// \param seed The hash seed.
+/// \return The hash value.
+uint qHash(const RMVAllocationBarStripKey& key, uint seed = 0);
+
+/// A least recently used cache of allocation bars drawn into strips, shared by the allocation bars in a pane.
+/// As the bars in a scrolling view are reused for different allocations, caching per allocation rather than per
+/// bar means scrolling only has to draw the strips for allocations that weren't on screen before.
+class RMVAllocationBarCache
+{
+public:
+    /// Constructor.
+    /// \param max_size_in_bytes The total size of the strips to keep before the least recently used are thrown away.
+    explicit RMVAllocationBarCache(int32_t max_size_in_bytes);
+
+    /// Destructor.
+    ~RMVAllocationBarCache();
+
+    /// Look up a strip.
+    /// \param key The key the strip was added with.
+    /// \return The strip, or nullptr if it isn't cached. The pointer is only valid until the next call to Insert().
+    const QPixmap* Find(const RMVAllocationBarStripKey& key);
+
+    /// Add a strip.
+    /// \param key The key to add the strip with.
+    /// \param strip The strip.
+    /// \return The cached strip. The pointer is only valid until the next call to Insert().
+    const QPixmap* Insert(const RMVAllocationBarStripKey& key, const QPixmap& strip);
+
+    /// Throw all the strips away. Must be called when the allocations or the colors used to draw them change in a way
+    /// the strip key doesn't cover, such as a new snapshot being opened.
+    void Clear();
+
+private:
+    QCache<RMVAllocationBarStripKey, QPixmap> strips_;  ///< The strips, with a cost in kilobytes.
+};
+
+#endif  // RMV_VIEWS_CUSTOM_WIDGETS_RMV_ALLOCATION_BAR_CACHE_H_
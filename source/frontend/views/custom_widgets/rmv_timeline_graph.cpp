@@ -9,6 +9,7 @@
 #include "views/custom_widgets/rmv_timeline_graph.h"
 
 #include <QPainter>
+#include <QPolygonF>
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 
@@ -29,6 +30,7 @@ RMVTimelineGraph::RMVTimelineGraph(const RMVTimelineGraphConfig& config)
     : mouse_hovering_(false)
     , tooltip_contents_(nullptr)
     , tooltip_background_(nullptr)
+    , graph_cache_version_(0)
 {
     setAcceptHoverEvents(true);
 
@@ -49,48 +51,74 @@ void RMVTimelineGraph::paint(QPainter* painter, const QStyleOptionGraphicsItem*
     Q_UNUSED(option);
     Q_UNUSED(widget);
 
-    painter->save();
-
-    qreal scaled_height = ScaledHeight();
-    int   num_buckets   = config_.model_data->GetNumBuckets();
+    if (ScaledWidth() <= 0 || ScaledHeight() <= 0)
+    {
+        return;
+    }
 
-    // for each bucket, ask the model for a rectangle to draw.
-    int  bucket_index = 0;
-    bool success      = true;
-    do
+    // Repaints for the tooltip, the snapshot markers and the selection just copy the cached graph. It is only drawn
+    // again when the histogram, the size or the colors change.
+    QVector<QColor> colors;
+    for (int bucket_group_index = 0; bucket_group_index < config_.model_data->GetNumBucketGroups(); bucket_group_index++)
     {
-        for (int bucket_group_index = 0; bucket_group_index < config_.model_data->GetNumBucketGroups(); bucket_group_index++)
-        {
-            QColor color  = config_.colorizer->GetColor(bucket_group_index);
-            qreal  y_pos  = 0.0f;
-            qreal  height = 0.0f;
-            success       = config_.model_data->GetHistogramData(bucket_group_index, bucket_index, y_pos, height);
-            if (success)
-            {
-                QRectF rect;
+        colors.push_back(config_.colorizer->GetColor(bucket_group_index));
+    }
 
-                // flip the y-coord so (0, 0) is at the bottom left and scale values up to fit the view
-                rect.setY(scaled_height - (y_pos * scaled_height));
-                rect.setHeight(height * scaled_height);
+    const qreal device_pixel_ratio = painter->device()->devicePixelRatioF();
+    if (graph_cache_.isNull() || graph_cache_.devicePixelRatioF() != device_pixel_ratio ||
+        graph_cache_.width() != qRound(ScaledWidth() * device_pixel_ratio) || graph_cache_.height() != qRound(ScaledHeight() * device_pixel_ratio) ||
+        graph_cache_version_ != config_.model_data->GetMemoryGraphVersion() || graph_cache_colors_ != colors)
+    {
+        UpdateGraphCache(device_pixel_ratio, colors);
+    }
 
-                // calculate the x offset and width based on the bucket number and number of buckets
-                qreal w = (qreal)ScaledWidth() / (qreal)num_buckets;
-                rect.setX(w * (qreal)bucket_index);
+    painter->drawPixmap(0, 0, graph_cache_);
+}
 
-                // allow for rounding error on width since coords are floating point
-                rect.setWidth(w + 0.5);
+void RMVTimelineGraph::UpdateGraphCache(qreal device_pixel_ratio, const QVector<QColor>& colors)
+{
+    graph_cache_ = QPixmap(QSize(ScaledWidth(), ScaledHeight()) * device_pixel_ratio);
+    graph_cache_.setDevicePixelRatio(device_pixel_ratio);
+    graph_cache_.fill(Qt::transparent);
+    graph_cache_version_ = config_.model_data->GetMemoryGraphVersion();
+    graph_cache_colors_  = colors;
+
+    const qreal scaled_height = ScaledHeight();
+    const int   num_buckets   = config_.model_data->GetNumBuckets();
+    const qreal bucket_width  = (qreal)ScaledWidth() / (qreal)num_buckets;
+
+    // Draw the stack one bucket group at a time, from the top group down. Each group is a single polygon running from
+    // the bottom of the graph up to the top of its part of the stack, so the groups below it paint over its lower
+    // part. This draws one polygon per group rather than one rectangle per bucket and group.
+    QPainter cache_painter(&graph_cache_);
+    cache_painter.setPen(Qt::NoPen);
+
+    QPolygonF polygon;
+    polygon.reserve((num_buckets * 2) + 2);
+    for (int bucket_group_index = colors.size() - 1; bucket_group_index >= 0; bucket_group_index--)
+    {
+        polygon.clear();
+        polygon << QPointF(0.0, scaled_height);
 
-                painter->fillRect(rect, color);
-            }
-            else
+        for (int bucket_index = 0; bucket_index < num_buckets; bucket_index++)
+        {
+            qreal y_pos  = 0.0;
+            qreal height = 0.0;
+            if (config_.model_data->GetHistogramData(bucket_group_index, bucket_index, y_pos, height) == false)
             {
                 break;
             }
+
+            // flip the y-coord so (0, 0) is at the bottom left and scale values up to fit the view
+            const qreal top = scaled_height - (y_pos * scaled_height);
+            polygon << QPointF(bucket_width * bucket_index, top) << QPointF(bucket_width * (bucket_index + 1), top);
         }
-        bucket_index++;
-    } while (success);
 
-    painter->restore();
+        polygon << QPointF(polygon.last().x(), scaled_height);
+
+        cache_painter.setBrush(colors[bucket_group_index]);
+        cache_painter.drawPolygon(polygon);
+    }
 }
 
 void RMVTimelineGraph::hoverEnterEvent(QGraphicsSceneHoverEvent* event)
@@ -10,6 +10,8 @@
 #define RMV_VIEWS_CUSTOM_WIDGETS_RMV_TIMELINE_GRAPH_H_
 
 #include <QGraphicsObject>
+#include <QPixmap>
+#include <QVector>
 
 #include "models/timeline/timeline_model.h"
 #include "util/definitions.h"
@@ -84,12 +86,20 @@ private:
     /// \return scaled height.
     int32_t ScaledHeight() const;
 
+    /// Draw the stacked memory graph into the graph cache.
+    /// \param device_pixel_ratio The device pixel ratio of the device the cache will be drawn on.
+    /// \param colors The color of each bucket group.
+    void UpdateGraphCache(qreal device_pixel_ratio, const QVector<QColor>& colors);
+
     RMVTimelineGraphConfig config_;                ///< Description of this widget.
     bool                   mouse_hovering_;        ///< Tracks if mouse is hovering over the widget.
     QPointF                last_scene_hover_pos_;  ///< Keeps track of the last mouse scene hover position.
     QPointF                last_hover_pos_;        ///< Keeps track of the last mouse hover position (view coords).
     RMVTimelineTooltip*    tooltip_contents_;      ///< Contents of the custom tool tip implementation.
     QGraphicsRectItem*     tooltip_background_;    ///< Background rect of the custom tool tip implementation.
+    QPixmap                graph_cache_;           ///< The memory graph, drawn once for each histogram and size.
+    uint64_t               graph_cache_version_;   ///< The model's memory graph version when the cache was drawn.
+    QVector<QColor>        graph_cache_colors_;    ///< The bucket group colors the cache was drawn with.
 };
 
 #endif  // RMV_VIEWS_CUSTOM_WIDGETS_RMV_TIMELINE_GRAPH_H_
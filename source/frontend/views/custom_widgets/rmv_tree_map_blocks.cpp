@@ -6,15 +6,12 @@
 
 #include "views/custom_widgets/rmv_tree_map_blocks.h"
 
-#ifndef _WIN32
-#include "linux/safe_crt.h"  // for strcpy_s
-#endif
-
 #include <QPainter>
 #include <QGraphicsSceneHoverEvent>
 #include <QDebug>
 #include <QVector>
 #include <QMap>
+#include <algorithm>
 #include <math.h>
 
 #include "qt_common/utils/scaling_manager.h"
@@ -22,6 +19,7 @@
 #include "rmt_assert.h"
 #include "rmt_data_set.h"
 #include "rmt_data_snapshot.h"
+#include "rmt_job_system.h"
 #include "rmt_resource_list.h"
 #include "rmt_util.h"
 #include "rmt_virtual_allocation_list.h"
@@ -30,12 +28,17 @@
 #include "models/snapshot/resource_overview_model.h"
 #include "models/trace_manager.h"
 #include "settings/rmv_settings.h"
+#include "views/main_window.h"
 
-// The mimimum area that a resource can use. Anything smaller than this is ignored.
+// The mimimum area that a resource can use. Anything smaller than this is drawn as part of its cluster's summary block.
 const static int kMinArea = 4;
 
-// The number of values a boolean can have (true or false).
-const static int kBooleanCount = 2;
+// The brush style used to draw summary blocks.
+const static Qt::BrushStyle kSummaryBrushStyle = Qt::Dense4Pattern;
+
+// The width and height of a cell in the hit test grid, in pixels. As no block is smaller than kMinArea, a cell can
+// only ever overlap a handful of blocks.
+const static int kGridCellSize = 16;
 
 /// Sorting function.
 /// \param a1 First RmvMemoryBlockAllocation.
@@ -46,6 +49,37 @@ static bool SortResourcesBySizeFunc(const RmtResource* a1, const RmtResource* a2
     return a1->size_in_bytes > a2->size_in_bytes;
 }
 
+/// Check if a heap is shown by a heap filter.
+/// \param heap_filter The heap filter, with an entry per heap.
+/// \param heap The heap.
+/// \return true if the heap is shown, false if not.
+static bool IsHeapInFilter(const bool* heap_filter, RmtHeapType heap)
+{
+    return (heap >= 0) && (heap < kRmtHeapTypeCount) && heap_filter[heap];
+}
+
+/// Check if a size is shown by the size filter.
+/// \param filter The tree map filter.
+/// \param size The size, in bytes.
+/// \return true if the size is shown, false if not.
+static bool IsSizeInFilter(const TreeMapFilter& filter, uint64_t size)
+{
+    return (size >= filter.minimum_size) && (size <= filter.maximum_size);
+}
+
+TreeMapHierarchy::TreeMapHierarchy()
+    : total_size(0)
+{
+}
+
+TreeMapHierarchy::~TreeMapHierarchy()
+{
+    for (int32_t i = 0; i < unbound_resources.size(); i++)
+    {
+        delete unbound_resources[i];
+    }
+}
+
 RMVTreeMapBlocks::RMVTreeMapBlocks(const RMVTreeMapBlocksConfig& config)
     : config_(config)
     , hovered_resource_identifier_(0)
@@ -53,16 +87,23 @@ RMVTreeMapBlocks::RMVTreeMapBlocks(const RMVTreeMapBlocksConfig& config)
     , hovered_resource_(nullptr)
     , selected_resource_(nullptr)
     , colorizer_(nullptr)
+    , layout_job_input_()
+    , layout_job_(0)
+    , layout_job_pending_(false)
+    , layout_cancelled_(false)
+    , layout_generation_(0)
+    , hovered_block_index_(-1)
+    , selected_block_index_(-1)
 {
     setAcceptHoverEvents(true);
+
+    // The layout job emits this from a worker thread, so queue it to run on the thread that owns the blocks.
+    connect(this, &RMVTreeMapBlocks::LayoutFinished, this, &RMVTreeMapBlocks::ApplyLayout, Qt::QueuedConnection);
 }
 
 RMVTreeMapBlocks::~RMVTreeMapBlocks()
 {
-    for (int32_t i = 0; i < unbound_resources_.size(); i++)
-    {
-        delete unbound_resources_[i];
-    }
+    CancelLayout();
 }
 
 void RMVTreeMapBlocks::SetColorizer(const Colorizer* colorizer)
@@ -70,102 +111,81 @@ void RMVTreeMapBlocks::SetColorizer(const Colorizer* colorizer)
     colorizer_ = colorizer;
 }
 
+void RMVTreeMapBlocks::UpdateColorCache()
+{
+    block_cache_ = QPixmap();
+    update();
+}
+
 QRectF RMVTreeMapBlocks::boundingRect() const
 {
     return QRectF(0, 0, config_.width, config_.height);
 }
 
-void RMVTreeMapBlocks::PaintClusterParents(QPainter* painter, ResourceCluster& cluster)
+void RMVTreeMapBlocks::UpdateBlockCache(qreal device_pixel_ratio)
 {
-    // This paints the borders around slicing modes
-    QPen pen;
-    pen.setWidth(ScalingManager::Get().Scaled(2));
-    pen.setColor(Qt::black);
-    painter->setPen(pen);
-    painter->setBrush(Qt::NoBrush);
-    painter->drawRect(cluster.geometry);
-
-    // Go to next parent
-    if (cluster.sub_clusters.size() != 0)
-    {
-        QMutableMapIterator<uint32_t, ResourceCluster> next_it(cluster.sub_clusters);
-        while (next_it.hasNext())
-        {
-            next_it.next();
+    block_cache_ = QPixmap(QSize(config_.width, config_.height) * device_pixel_ratio);
+    block_cache_.setDevicePixelRatio(device_pixel_ratio);
+    block_cache_.fill(Qt::transparent);
 
-            ResourceCluster& subCluster = next_it.value();
+    QPainter painter(&block_cache_);
 
-            PaintClusterParents(painter, subCluster);
-        }
-    }
-}
-
-void RMVTreeMapBlocks::PaintClusterChildren(QPainter*         painter,
-                                            ResourceCluster&  cluster,
-                                            TreeMapBlockData& hovered_resource,
-                                            TreeMapBlockData& selected_resource)
-{
     // This paints blocks inside each cluster
-    if (cluster.sub_clusters.size() == 0)
+    for (const TreeMapBlock& block : geometry_->blocks)
     {
-        QMutableMapIterator<const RmtResource*, QRectF> render_it(cluster.alloc_geometry_map);
-        while (render_it.hasNext())
-        {
-            render_it.next();
+        const RmtResource* resource      = block.resource;
+        const QRectF&      bounding_rect = block.bounding_rect;
 
-            const RmtResource* resource      = render_it.key();
-            const QRectF&      bounding_rect = render_it.value();
+        const QRectF block_rect(bounding_rect.left() + 1, bounding_rect.top() + 1, bounding_rect.width() - 1, bounding_rect.height() - 1);
 
-            const QRectF block_rect(bounding_rect.left() + 1, bounding_rect.top() + 1, bounding_rect.width() - 1, bounding_rect.height() - 1);
+        if (block_rect.width() > 0 && block_rect.height() > 0)
+        {
+            const QColor& curr_color = colorizer_->GetColor(resource->bound_allocation, resource);
 
-            if (block_rect.width() > 0 && block_rect.height() > 0)
+            // figure out the brush style.
+            Qt::BrushStyle style = ((RmtResourceGetAliasCount(resource) > 0) ? Qt::BrushStyle::Dense1Pattern : Qt::BrushStyle::SolidPattern);
+            if (block.is_summary)
             {
-                const QColor& curr_color = colorizer_->GetColor(resource->bound_allocation, resource);
-
-                // figure out the brush style.
-                Qt::BrushStyle style = ((RmtResourceGetAliasCount(resource) > 0) ? Qt::BrushStyle::Dense1Pattern : Qt::BrushStyle::SolidPattern);
-                const QBrush   curr_brush(curr_color, style);
-
-                painter->fillRect(block_rect, curr_brush);
-
-                // Figure out what we hovered over
-                if (hovered_resource.is_visible == false)
-                {
-                    if (hovered_resource_identifier_ == resource->identifier && hovered_resource_ == resource)
-                    {
-                        hovered_resource.bounding_rect = block_rect;
-                        hovered_resource.resource      = resource;
-                        hovered_resource.is_visible    = true;
-                    }
-                }
-
-                // Figure out what we selected
-                if (selected_resource.is_visible == false)
-                {
-                    if (selected_resource_identifier_ == resource->identifier && selected_resource_ == resource)
-                    {
-                        selected_resource.bounding_rect = block_rect;
-                        selected_resource.resource      = resource;
-                        selected_resource.is_visible    = true;
-                    }
-                }
+                style = kSummaryBrushStyle;
             }
+            const QBrush curr_brush(curr_color, style);
+
+            painter.fillRect(block_rect, curr_brush);
         }
     }
 
-    // Move onto next set of subslices
-    else
+    // This paints the borders around slicing modes
+    QPen pen;
+    pen.setWidth(ScalingManager::Get().Scaled(2));
+    pen.setColor(Qt::black);
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+    for (const QRectF& cluster_rect : geometry_->cluster_rects)
     {
-        QMutableMapIterator<uint32_t, ResourceCluster> next_it(cluster.sub_clusters);
-        while (next_it.hasNext())
-        {
-            next_it.next();
+        painter.drawRect(cluster_rect);
+    }
+}
+
+TreeMapBlockData RMVTreeMapBlocks::GetBlockData(int32_t block_index) const
+{
+    TreeMapBlockData block_data = {};
+
+    if (geometry_ != nullptr && block_index >= 0)
+    {
+        const TreeMapBlock& block         = geometry_->blocks[block_index];
+        const QRectF&       bounding_rect = block.bounding_rect;
 
-            ResourceCluster& sub_cluster = next_it.value();
+        const QRectF block_rect(bounding_rect.left() + 1, bounding_rect.top() + 1, bounding_rect.width() - 1, bounding_rect.height() - 1);
 
-            PaintClusterChildren(painter, sub_cluster, hovered_resource, selected_resource);
+        if (block_rect.width() > 0 && block_rect.height() > 0)
+        {
+            block_data.bounding_rect = block_rect;
+            block_data.resource      = block.resource;
+            block_data.is_visible    = true;
         }
     }
+
+    return block_data;
 }
 
 void RMVTreeMapBlocks::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
@@ -173,12 +193,22 @@ void RMVTreeMapBlocks::paint(QPainter* painter, const QStyleOptionGraphicsItem*
     Q_UNUSED(option);
     Q_UNUSED(widget);
 
-    TreeMapBlockData hovered_block  = {};
-    TreeMapBlockData selected_block = {};
+    if (geometry_ == nullptr || config_.width <= 0 || config_.height <= 0)
+    {
+        return;
+    }
 
-    PaintClusterChildren(painter, clusters_[kSliceTypeNone], hovered_block, selected_block);
+    // The blocks only need drawing again when the layout, size or colors change. Hovering and selecting just
+    // draw over the cached blocks.
+    const qreal device_pixel_ratio = painter->device()->devicePixelRatioF();
+    if (block_cache_.isNull() || block_cache_.devicePixelRatioF() != device_pixel_ratio)
+    {
+        UpdateBlockCache(device_pixel_ratio);
+    }
+    painter->drawPixmap(0, 0, block_cache_);
 
-    PaintClusterParents(painter, clusters_[kSliceTypeNone]);
+    const TreeMapBlockData hovered_block  = GetBlockData(hovered_block_index_);
+    const TreeMapBlockData selected_block = GetBlockData(selected_block_index_);
 
     if (hovered_block.resource && selected_block.resource && hovered_block.resource->identifier == selected_block.resource->identifier &&
         hovered_block.resource->bound_allocation == selected_block.resource->bound_allocation)
@@ -218,61 +248,76 @@ void RMVTreeMapBlocks::paint(QPainter* painter, const QStyleOptionGraphicsItem*
     }
 }
 
-bool RMVTreeMapBlocks::FindBlockData(ResourceCluster& cluster, QPointF user_location, RmtResourceIdentifier& resource_identifier, const RmtResource*& resource)
+int32_t RMVTreeMapBlocks::FindBlockAtLocation(QPointF user_location) const
 {
-    resource_identifier = 0;
-
-    bool result = false;
-
-    // Move onto next levels
-    QMutableMapIterator<uint32_t, ResourceCluster> next_it(cluster.sub_clusters);
-    while (next_it.hasNext())
+    if (geometry_ == nullptr || geometry_->grid_cell_starts.isEmpty())
     {
-        next_it.next();
+        return -1;
+    }
 
-        ResourceCluster& sub_cluster = next_it.value();
+    const int32_t column = static_cast<int32_t>(floor(user_location.x() / kGridCellSize));
+    const int32_t row    = static_cast<int32_t>(floor(user_location.y() / kGridCellSize));
+    if (column < 0 || column >= geometry_->grid_columns || row < 0 || row >= geometry_->grid_rows)
+    {
+        return -1;
+    }
 
-        result = FindBlockData(sub_cluster, user_location, resource_identifier, resource);
+    const int32_t cell_index = (row * geometry_->grid_columns) + column;
+    for (int32_t i = geometry_->grid_cell_starts[cell_index]; i < geometry_->grid_cell_starts[cell_index + 1]; i++)
+    {
+        const int32_t block_index   = geometry_->grid_block_indices[i];
+        const QRectF& bounding_rect = geometry_->blocks[block_index].bounding_rect;
 
-        if (result == true)
+        if (user_location.x() > bounding_rect.left() && user_location.x() < bounding_rect.right())
         {
-            return true;
+            if (user_location.y() > bounding_rect.top() && user_location.y() < bounding_rect.bottom())
+            {
+                return block_index;
+            }
         }
     }
 
-    // Only perform search at bottom-most level
-    if (cluster.sub_clusters.size() == 0)
-    {
-        QMutableMapIterator<const RmtResource*, QRectF> search_it(cluster.alloc_geometry_map);
-        while (search_it.hasNext())
-        {
-            search_it.next();
+    return -1;
+}
 
-            const RmtResource* res           = search_it.key();
-            const QRectF&      bounding_rect = search_it.value();
+int32_t RMVTreeMapBlocks::FindBlock(RmtResourceIdentifier resource_identifier, const RmtResource* resource) const
+{
+    if (geometry_ == nullptr || resource == nullptr)
+    {
+        return -1;
+    }
 
-            if (user_location.x() > bounding_rect.left() && user_location.x() < bounding_rect.right())
-            {
-                if (user_location.y() > bounding_rect.top() && user_location.y() < bounding_rect.bottom())
-                {
-                    resource_identifier = res->identifier;
-                    resource            = res;
+    const QVector<TreeMapBlock>& blocks = geometry_->blocks;
+    auto                         it     = std::lower_bound(geometry_->resource_blocks.begin(),
+                                       geometry_->resource_blocks.end(),
+                                       resource,
+                                       [&blocks](int32_t block_index, const RmtResource* value) { return blocks[block_index].resource < value; });
 
-                    result = true;
-                    break;
-                }
-            }
-        }
+    if (it != geometry_->resource_blocks.end() && blocks[*it].resource == resource && resource->identifier == resource_identifier)
+    {
+        return *it;
     }
 
-    return result;
+    return -1;
 }
 
 void RMVTreeMapBlocks::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
 {
     setCursor(Qt::PointingHandCursor);
 
-    FindBlockData(clusters_[kSliceTypeNone], event->pos(), hovered_resource_identifier_, hovered_resource_);
+    const int32_t block_index = FindBlockAtLocation(event->pos());
+    if (block_index == hovered_block_index_)
+    {
+        return;
+    }
+
+    hovered_block_index_         = block_index;
+    hovered_resource_identifier_ = 0;
+    if (block_index >= 0)
+    {
+        hovered_resource_identifier_ = geometry_->blocks[block_index].resource->identifier;
+        hovered_resource_            = geometry_->blocks[block_index].resource;
+    }
 
     update();
 }
@@ -283,13 +328,22 @@ void RMVTreeMapBlocks::hoverLeaveEvent(QGraphicsSceneHoverEvent* event)
 
     hovered_resource_identifier_ = 0;
     hovered_resource_            = nullptr;
+    hovered_block_index_         = -1;
 
     update();
 }
 
 void RMVTreeMapBlocks::mousePressEvent(QGraphicsSceneMouseEvent* event)
 {
-    const bool found_resource = FindBlockData(clusters_[kSliceTypeNone], event->pos(), selected_resource_identifier_, selected_resource_);
+    selected_block_index_         = FindBlockAtLocation(event->pos());
+    selected_resource_identifier_ = 0;
+
+    const bool found_resource = (selected_block_index_ >= 0);
+    if (found_resource)
+    {
+        selected_resource_identifier_ = geometry_->blocks[selected_block_index_].resource->identifier;
+        selected_resource_            = geometry_->blocks[selected_block_index_].resource;
+    }
     update();
 
     if (!found_resource)
@@ -327,6 +381,7 @@ void RMVTreeMapBlocks::UpdateDimensions(int width, int height)
 {
     config_.width  = width;
     config_.height = height;
+    block_cache_   = QPixmap();
 }
 
 int32_t RMVTreeMapBlocks::ScaledHeight() const
@@ -345,11 +400,19 @@ void RMVTreeMapBlocks::ResetSelections()
     selected_resource_identifier_ = 0;
     hovered_resource_             = nullptr;
     selected_resource_            = nullptr;
+    hovered_block_index_          = -1;
+    selected_block_index_         = -1;
 }
 
 void RMVTreeMapBlocks::Reset()
 {
-    clusters_.clear();
+    CancelLayout();
+    layout_job_input_ = {};
+    hierarchy_.reset();
+    geometry_.reset();
+    block_cache_          = QPixmap();
+    hovered_block_index_  = -1;
+    selected_block_index_ = -1;
 }
 
 double RMVTreeMapBlocks::CalculateAspectRatio(double width, double height)
@@ -362,34 +425,25 @@ bool RMVTreeMapBlocks::ShouldDrawVertically(double width, double height)
     return (width > height);
 }
 
-void RMVTreeMapBlocks::DumpCut(const CutData& existing_cut, uint32_t offset_x, uint32_t offset_y, AllocGeometryMap& alloc_geometry_map) const
+void RMVTreeMapBlocks::DumpCut(const CutData& existing_cut, uint32_t offset_x, uint32_t offset_y, QVector<TreeMapBlock>& blocks)
 {
     // Dump all the rectangles from the cut into the allocation rectangles.
     if (!existing_cut.is_null)
     {
-        for (int32_t current_allocation_index = 0; current_allocation_index < existing_cut.resources.size(); ++current_allocation_index)
+        for (int i = 0; i < existing_cut.rectangles.size(); i++)
         {
-            bool visible_rects = true;
-
-            for (int i = 0; i < existing_cut.rectangles.size(); i++)
+            if (existing_cut.rectangles[i].width() < 1 || existing_cut.rectangles[i].height() < 1)
             {
-                if (existing_cut.rectangles[i].width() < 1 || existing_cut.rectangles[i].height() < 1)
-                {
-                    visible_rects = false;
-                    break;
-                }
+                return;
             }
+        }
 
-            if (visible_rects == true)
-            {
-                for (int i = 0; i < existing_cut.rectangles.size(); i++)
-                {
-                    QRectF newBound = existing_cut.rectangles[i];
-                    newBound.translate(offset_x, offset_y);
+        for (int i = 0; i < existing_cut.rectangles.size(); i++)
+        {
+            QRectF newBound = existing_cut.rectangles[i];
+            newBound.translate(offset_x, offset_y);
 
-                    alloc_geometry_map[existing_cut.resources[i]] = newBound;
-                }
-            }
+            blocks.push_back({existing_cut.resources[i], newBound, false});
         }
     }
 }
@@ -398,19 +452,22 @@ void RMVTreeMapBlocks::SelectResource(RmtResourceIdentifier resource_identifier)
 {
     selected_resource_identifier_ = resource_identifier;
     selected_resource_            = nullptr;
+    selected_block_index_         = FindBlock(selected_resource_identifier_, selected_resource_);
 
     update();
 }
 
-void RMVTreeMapBlocks::GenerateTreeMapRects(QVector<const RmtResource*>& resources,
-                                            uint64_t                     total_size,
-                                            uint32_t                     view_width,
-                                            uint32_t                     view_height,
-                                            uint32_t                     offset_x,
-                                            uint32_t                     offset_y,
-                                            AllocGeometryMap&            alloc_geometry_map)
+void RMVTreeMapBlocks::GenerateTreeMapRects(const QVector<const RmtResource*>& resources,
+                                            int32_t                            resource_count,
+                                            uint64_t                           total_size,
+                                            uint32_t                           view_width,
+                                            uint32_t                           view_height,
+                                            uint32_t                           offset_x,
+                                            uint32_t                           offset_y,
+                                            QVector<TreeMapBlock>&             blocks)
 {
-    if (resources.isEmpty() == true)
+    RMT_ASSERT(resource_count <= resources.size());
+    if (resource_count == 0)
     {
         return;
     }
@@ -422,7 +479,7 @@ void RMVTreeMapBlocks::GenerateTreeMapRects(QVector<const RmtResource*>& resourc
     CutData existing_cut = {};
     existing_cut.is_null = true;
 
-    for (int32_t i = 0; i < resources.size(); i++)
+    for (int32_t i = 0; i < resource_count; i++)
     {
         const RmtResource* resource = resources[i];
 
@@ -537,7 +594,7 @@ void RMVTreeMapBlocks::GenerateTreeMapRects(QVector<const RmtResource*>& resourc
             }
         }
 
-        DumpCut(existing_cut, offset_x, offset_y, alloc_geometry_map);
+        DumpCut(existing_cut, offset_x, offset_y, blocks);
         existing_cut.is_null = true;
 
         // Fall back to making a new cut.
@@ -579,7 +636,7 @@ void RMVTreeMapBlocks::GenerateTreeMapRects(QVector<const RmtResource*>& resourc
         }
     }
 
-    DumpCut(existing_cut, offset_x, offset_y, alloc_geometry_map);
+    DumpCut(existing_cut, offset_x, offset_y, blocks);
     existing_cut.is_null = true;
 }
 
@@ -588,549 +645,585 @@ void RMVTreeMapBlocks::GenerateTreemap(const rmv::ResourceOverviewModel* overvie
                                        uint32_t                          view_width,
                                        uint32_t                          view_height)
 {
+    // The filters have changed, so the hierarchy needs building again.
+    CancelLayout();
+    hierarchy_.reset();
+
     const TraceManager& trace_manager = TraceManager::Get();
     RmtDataSnapshot*    open_snapshot = trace_manager.GetOpenSnapshot();
 
     if (trace_manager.DataSetValid() && open_snapshot != nullptr)
     {
-        clusters_.clear();
-        for (int32_t i = 0; i < unbound_resources_.size(); i++)
-        {
-            delete unbound_resources_[i];
-        }
-        unbound_resources_.clear();
-
-        ResourceCluster& parent_cluster   = clusters_[kSliceTypeNone];
-        const int32_t    allocation_count = open_snapshot->virtual_allocation_list.allocation_count;
-
-        // calculate how much memory is to be displayed
-        uint64_t total_memory = 0;
-        for (int32_t i = 0; i < allocation_count; i++)
-        {
-            RmtVirtualAllocation* current_virtual_allocation = &open_snapshot->virtual_allocation_list.allocation_details[i];
-
-            if (tree_map_models.preferred_heap_model->ItemInList(current_virtual_allocation->heap_preferences[0]) == false)
-            {
-                continue;
-            }
-
-            for (int32_t j = 0; j < current_virtual_allocation->resource_count; j++)
-            {
-                RmtResource* resource = current_virtual_allocation->resources[j];
-                if (ResourceFiltered(overview_model, tree_map_models, open_snapshot, resource) == true)
-                {
-                    total_memory += resource->size_in_bytes;
-                }
-            }
-
-            if (tree_map_models.resource_usage_model->ItemInList(kRmtResourceUsageTypeFree) == false)
-            {
-                continue;
-            }
-
-            for (int32_t current_unbound_region_index = 0; current_unbound_region_index < current_virtual_allocation->unbound_memory_region_count;
-                 ++current_unbound_region_index)
-            {
-                // add any unbound memory
-                const RmtMemoryRegion* current_unbound_region = &current_virtual_allocation->unbound_memory_regions[current_unbound_region_index];
-                if (current_unbound_region->size == 0)
-                {
-                    continue;
-                }
-                if (overview_model->IsSizeInRange(current_unbound_region->size) == false)
-                {
-                    continue;
-                }
-                total_memory += current_unbound_region->size;
-            }
-        }
-
-        const double bytes_per_pixel = static_cast<double>(total_memory) / (static_cast<double>(view_width) * view_height);
-        for (int32_t i = 0; i < allocation_count; i++)
-        {
-            RmtVirtualAllocation* current_virtual_allocation = &open_snapshot->virtual_allocation_list.allocation_details[i];
-
-            if (tree_map_models.preferred_heap_model->ItemInList(current_virtual_allocation->heap_preferences[0]) == false)
-            {
-                continue;
-            }
-
-            for (int32_t j = 0; j < current_virtual_allocation->resource_count; j++)
-            {
-                RmtResource* resource = current_virtual_allocation->resources[j];
-                if (ResourceFiltered(overview_model, tree_map_models, open_snapshot, resource) == true)
-                {
-                    const double total_cut_area = resource->size_in_bytes / bytes_per_pixel;
+        layout_job_input_.snapshot    = open_snapshot;
+        layout_job_input_.slice_types = slice_types_;
+        layout_job_input_.hierarchy   = nullptr;
+        layout_job_input_.view_width  = view_width;
+        layout_job_input_.view_height = view_height;
+        GetFilter(overview_model, tree_map_models, layout_job_input_.filter);
+
+        StartLayout();
+    }
+    else
+    {
+        Reset();
+    }
+}
 
-                    // Only include allocations that could actually be visible
-                    if (total_cut_area >= kMinArea)
-                    {
-                        parent_cluster.amount += resource->size_in_bytes;
-                        parent_cluster.sorted_resources.push_back(resource);
-                    }
-                }
-            }
+void RMVTreeMapBlocks::LayoutTreemap(uint32_t view_width, uint32_t view_height)
+{
+    if (layout_job_input_.snapshot == nullptr)
+    {
+        return;
+    }
 
-            if (tree_map_models.resource_usage_model->ItemInList(kRmtResourceUsageTypeFree) == false)
-            {
-                continue;
-            }
+    // If the hierarchy hasn't been built yet, the cancelled job is started again from scratch at the new size.
+    CancelLayout();
+    layout_job_input_.hierarchy   = hierarchy_;
+    layout_job_input_.view_width  = view_width;
+    layout_job_input_.view_height = view_height;
 
-            for (int32_t current_unbound_region_index = 0; current_unbound_region_index < current_virtual_allocation->unbound_memory_region_count;
-                 ++current_unbound_region_index)
-            {
-                // add any unbound memory
-                const RmtMemoryRegion* current_unbound_region = &current_virtual_allocation->unbound_memory_regions[current_unbound_region_index];
-                if (current_unbound_region->size == 0)
-                {
-                    continue;
-                }
-                if (overview_model->IsSizeInRange(current_unbound_region->size) == false)
-                {
-                    continue;
-                }
-                const double total_cut_area = current_unbound_region->size / bytes_per_pixel;
-                if (total_cut_area >= kMinArea)
-                {
-                    // Create a temporary 'unbound' resource so the unbound resource can be sorted along with other resources
-                    // in the tree map. All unbound resources have a resource identifier of 0. Their base address and size are
-                    // copied from their unbound region data.
-                    RmtResource* unbound_resource      = new RmtResource();
-                    unbound_resource->identifier       = 0;
-                    unbound_resource->size_in_bytes    = current_unbound_region->size;
-                    unbound_resource->address          = current_virtual_allocation->base_address + current_unbound_region->offset;
-                    unbound_resource->bound_allocation = current_virtual_allocation;
-                    unbound_resource->resource_type    = kRmtResourceTypeCount;
-#ifdef _DEBUG
-                    strcpy_s(unbound_resource->name, RMT_MAXIMUM_NAME_LENGTH, "unbound");
-#endif
-                    // keep track of the unbound resource
-                    unbound_resources_.push_back(unbound_resource);
-
-                    parent_cluster.amount += current_unbound_region->size;
-                    parent_cluster.sorted_resources.push_back(unbound_resource);
-                }
-            }
-        }
+    StartLayout();
+}
 
-        std::stable_sort(parent_cluster.sorted_resources.begin(), parent_cluster.sorted_resources.end(), SortResourcesBySizeFunc);
+void RMVTreeMapBlocks::StartLayout()
+{
+    RMT_ASSERT(layout_job_pending_ == false);
 
-        // Something actually selected in the UI
-        if (slice_types_.empty() == false)
-        {
-            FillClusterResources(parent_cluster, slice_types_, 0, slice_types_.size());
-        }
+    layout_generation_++;
+    layout_job_input_.generation = layout_generation_;
+    layout_job_input_.geometry   = nullptr;
+    layout_cancelled_            = false;
 
-        // Nothing selected, so just show all allocations without slicing
-        else
-        {
-            for (int i = 0; i < parent_cluster.sorted_resources.size(); i++)
-            {
-                const RmtResource* resource = parent_cluster.sorted_resources[i];
+    layout_job_pending_ = (RmtJobQueueAddSingle(MainWindow::GetJobQueue(), LayoutJob, this, &layout_job_) == RMT_OK);
+    if (layout_job_pending_ == false)
+    {
+        // No job queue, so lay out the tree map here instead.
+        LayoutJob(0, 0, this);
+    }
+}
 
-                parent_cluster.sub_clusters[kSliceTypeNone].amount += resource->size_in_bytes;
-                parent_cluster.sub_clusters[kSliceTypeNone].sorted_resources.push_back(resource);
-            }
-        }
-        FillClusterGeometry(clusters_[kSliceTypeNone], view_width, view_height, 0, 0);
+void RMVTreeMapBlocks::CancelLayout()
+{
+    if (layout_job_pending_ == true)
+    {
+        layout_cancelled_ = true;
+        RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), layout_job_);
+        layout_job_pending_ = false;
     }
 }
 
-bool RMVTreeMapBlocks::ResourceFiltered(const rmv::ResourceOverviewModel* overview_model,
-                                        const TreeMapModels&              tree_map_models,
-                                        const RmtDataSnapshot*            snapshot,
-                                        const RmtResource*                resource)
+void RMVTreeMapBlocks::ApplyLayout(quint64 generation)
 {
-    if (tree_map_models.actual_heap_model->ItemInList(RmtResourceGetActualHeap(snapshot, resource)) == false)
+    // Ignore jobs that were cancelled or replaced by a later request after they finished.
+    if (generation != layout_generation_)
     {
-        return false;
+        return;
     }
-    if (tree_map_models.resource_usage_model->ItemInList(RmtResourceGetUsageType(resource)) == false)
+
+    if (layout_job_pending_ == true)
     {
-        return false;
+        RmtJobQueueWaitForCompletion(MainWindow::GetJobQueue(), layout_job_);
+        layout_job_pending_ = false;
     }
-    if (overview_model->IsSizeInRange(resource->size_in_bytes) == false)
+
+    if (layout_job_input_.geometry != nullptr)
     {
-        return false;
+        geometry_                   = layout_job_input_.geometry;
+        hierarchy_                  = geometry_->hierarchy;
+        layout_job_input_.hierarchy = hierarchy_;
+        block_cache_                = QPixmap();
+        hovered_block_index_        = FindBlock(hovered_resource_identifier_, hovered_resource_);
+        selected_block_index_       = FindBlock(selected_resource_identifier_, selected_resource_);
+        update();
     }
-    return true;
 }
 
-void RMVTreeMapBlocks::FillClusterGeometry(ResourceCluster& parent_cluster, int parent_width, int parent_height, int parent_offset_x, int parent_offset_y)
+void RMVTreeMapBlocks::LayoutJob(int32_t thread_id, int32_t index, void* input)
 {
-    parent_cluster.geometry = QRectF(parent_offset_x, parent_offset_y, parent_width, parent_height);
+    Q_UNUSED(thread_id);
+    Q_UNUSED(index);
 
-    if (parent_cluster.sub_clusters.size() == 0)
+    // The job input can't change while the job is running, as changing it cancels the job and waits for it first.
+    RMVTreeMapBlocks* blocks    = static_cast<RMVTreeMapBlocks*>(input);
+    LayoutJobInput&   job_input = blocks->layout_job_input_;
+
+    std::shared_ptr<const TreeMapHierarchy> hierarchy = job_input.hierarchy;
+    if (hierarchy == nullptr)
     {
-        return;
+        std::shared_ptr<TreeMapHierarchy> new_hierarchy = std::make_shared<TreeMapHierarchy>();
+        if (blocks->BuildHierarchy(job_input, *new_hierarchy) == false)
+        {
+            return;
+        }
+        hierarchy = new_hierarchy;
     }
 
-    // Helper map to associate a slice key to a resource
-    QMap<uint32_t, const RmtResource*> sliceIdToAlloc;  // probably can just be an array of vectors.
+    std::shared_ptr<TreeMapGeometry> geometry = std::make_shared<TreeMapGeometry>();
+    geometry->hierarchy                       = hierarchy;
 
-    // Create some temporary allocations so we can later compute geometry for parent bounds
-    uint64_t                                temp_parent_allocs_size = 0;
-    QVector<const RmtResource*>             temp_resources;
-    QMapIterator<uint32_t, ResourceCluster> it_1(parent_cluster.sub_clusters);
-    while (it_1.hasNext())
+    const double bytes_per_pixel = static_cast<double>(hierarchy->total_size) / (static_cast<double>(job_input.view_width) * job_input.view_height);
+    if (blocks->FillClusterGeometry(hierarchy->root, bytes_per_pixel, job_input.view_width, job_input.view_height, 0, 0, *geometry) == false)
     {
-        it_1.next();
-
-        uint32_t        sliceType  = it_1.key();
-        ResourceCluster subCluster = it_1.value();
-
-        RmtResource* temp_resource   = new RmtResource();
-        temp_resource->size_in_bytes = subCluster.amount;
-        temp_resources.push_back(temp_resource);
-        temp_parent_allocs_size += subCluster.amount;
-
-        // Fill out helper map
-        sliceIdToAlloc[sliceType] = temp_resource;
+        return;
     }
 
-    std::stable_sort(temp_resources.begin(), temp_resources.end(), SortResourcesBySizeFunc);
+    BuildBlockIndex(job_input.view_width, job_input.view_height, *geometry);
 
-    // Figure out geometry for parent bounds
-    GenerateTreeMapRects(
-        temp_resources, temp_parent_allocs_size, parent_width, parent_height, parent_offset_x, parent_offset_y, parent_cluster.alloc_geometry_map);
+    job_input.geometry = geometry;
+    emit blocks->LayoutFinished(job_input.generation);
+}
 
-    // Clean up temp RmvMemoryBlockAllocations
-    for (int32_t i = 0; i < temp_resources.size(); i++)
+void RMVTreeMapBlocks::BuildBlockIndex(int32_t view_width, int32_t view_height, TreeMapGeometry& geometry)
+{
+    const QVector<TreeMapBlock>& blocks = geometry.blocks;
+
+    geometry.grid_columns = std::max((view_width + kGridCellSize - 1) / kGridCellSize, 1);
+    geometry.grid_rows    = std::max((view_height + kGridCellSize - 1) / kGridCellSize, 1);
+
+    const int32_t cell_count = geometry.grid_columns * geometry.grid_rows;
+    geometry.grid_cell_starts.fill(0, cell_count + 1);
+
+    // Get the range of cells a block overlaps, clamped to the grid. Summary blocks can't be picked, so are left out.
+    auto get_cell_range = [&geometry](const QRectF& rect, int32_t& first_column, int32_t& last_column, int32_t& first_row, int32_t& last_row) {
+        first_column = std::max(static_cast<int32_t>(floor(rect.left() / kGridCellSize)), 0);
+        last_column  = std::min(static_cast<int32_t>(ceil(rect.right() / kGridCellSize)) - 1, geometry.grid_columns - 1);
+        first_row    = std::max(static_cast<int32_t>(floor(rect.top() / kGridCellSize)), 0);
+        last_row     = std::min(static_cast<int32_t>(ceil(rect.bottom() / kGridCellSize)) - 1, geometry.grid_rows - 1);
+    };
+
+    // Count the blocks in each cell, then turn the counts into offsets so the cells can share one array.
+    int32_t first_column = 0;
+    int32_t last_column  = 0;
+    int32_t first_row    = 0;
+    int32_t last_row     = 0;
+    for (const TreeMapBlock& block : blocks)
     {
-        delete temp_resources[i];
+        if (block.is_summary == false)
+        {
+            get_cell_range(block.bounding_rect, first_column, last_column, first_row, last_row);
+            for (int32_t row = first_row; row <= last_row; row++)
+            {
+                for (int32_t column = first_column; column <= last_column; column++)
+                {
+                    geometry.grid_cell_starts[(row * geometry.grid_columns) + column + 1]++;
+                }
+            }
+        }
     }
 
-    // Figure out geometry for sub-clusters, but bound by parent bounds
-    QMutableMapIterator<uint32_t, ResourceCluster> it_2(parent_cluster.sub_clusters);
-    while (it_2.hasNext())
+    for (int32_t i = 0; i < cell_count; i++)
     {
-        it_2.next();
-
-        uint32_t         sliceType  = it_2.key();
-        ResourceCluster& subCluster = it_2.value();
-
-        QRectF& bounding_rect = parent_cluster.alloc_geometry_map[sliceIdToAlloc[sliceType]];
-
-        // Figure out child geometry
-        GenerateTreeMapRects(subCluster.sorted_resources,
-                             subCluster.amount,
-                             bounding_rect.width(),
-                             bounding_rect.height(),
-                             bounding_rect.left(),
-                             bounding_rect.top(),
-                             subCluster.alloc_geometry_map);
+        geometry.grid_cell_starts[i + 1] += geometry.grid_cell_starts[i];
+    }
 
-        // Next child
-        FillClusterGeometry(subCluster, bounding_rect.width(), bounding_rect.height(), bounding_rect.left(), bounding_rect.top());
+    QVector<int32_t> cell_fill = geometry.grid_cell_starts;
+    geometry.grid_block_indices.resize(geometry.grid_cell_starts[cell_count]);
+    geometry.resource_blocks.clear();
+    geometry.resource_blocks.reserve(blocks.size());
+    for (int32_t i = 0; i < blocks.size(); i++)
+    {
+        if (blocks[i].is_summary == false)
+        {
+            get_cell_range(blocks[i].bounding_rect, first_column, last_column, first_row, last_row);
+            for (int32_t row = first_row; row <= last_row; row++)
+            {
+                for (int32_t column = first_column; column <= last_column; column++)
+                {
+                    geometry.grid_block_indices[cell_fill[(row * geometry.grid_columns) + column]++] = i;
+                }
+            }
+            geometry.resource_blocks.push_back(i);
+        }
     }
+
+    std::sort(geometry.resource_blocks.begin(), geometry.resource_blocks.end(), [&blocks](int32_t a, int32_t b) {
+        return blocks[a].resource < blocks[b].resource;
+    });
 }
 
-int32_t RMVTreeMapBlocks::GetSliceCount(const SliceType slice_type, const RmtDataSnapshot* snapshot) const
+bool RMVTreeMapBlocks::BuildHierarchy(const LayoutJobInput& input, TreeMapHierarchy& hierarchy) const
 {
-    switch (slice_type)
+    const RmtDataSnapshot* snapshot         = input.snapshot;
+    const TreeMapFilter&   filter           = input.filter;
+    ResourceCluster&       parent_cluster   = hierarchy.root;
+    const int32_t          allocation_count = snapshot->virtual_allocation_list.allocation_count;
+
+    // Gather everything that passes the filters in a single pass. Resources too small to be seen at the current size
+    // are kept, so the hierarchy can be laid out again at any size.
+    for (int32_t i = 0; i < allocation_count; i++)
     {
-    case kSliceTypeResourceUsageType:
-        return kRmtResourceUsageTypeCount;
-
-    case kSliceTypeResourceCreateAge:
-    case kSliceTypeResourceBindAge:
-    case kSliceTypeAllocationAge:
-        return colorizer_->GetNumAgeBuckets();
+        if (layout_cancelled_ == true)
+        {
+            return false;
+        }
 
-    case kSliceTypePreferredHeap:
-    case kSliceTypeActualHeap:
-        return kRmtHeapTypeCount;
+        const RmtVirtualAllocation* current_virtual_allocation = &snapshot->virtual_allocation_list.allocation_details[i];
 
-    case kSliceTypeVirtualAllocation:
-        return snapshot->virtual_allocation_list.allocation_count;
+        if (IsHeapInFilter(filter.preferred_heap, current_virtual_allocation->heap_preferences[0]) == false)
+        {
+            continue;
+        }
 
-    case kSliceTypeCpuMapped:
-    case kSliceTypeInPreferredHeap:
-        return kBooleanCount;
+        for (int32_t j = 0; j < current_virtual_allocation->resource_count; j++)
+        {
+            const RmtResource* resource = current_virtual_allocation->resources[j];
+            if (ResourceFiltered(filter, snapshot, resource) == true)
+            {
+                parent_cluster.amount += resource->size_in_bytes;
+                parent_cluster.sorted_resources.push_back(resource);
+            }
+        }
 
-    case kSliceTypeResourceCommitType:
-        return kRmtCommitTypeCount;
+        if (filter.resource_usage[kRmtResourceUsageTypeFree] == false)
+        {
+            continue;
+        }
 
-    case kSliceTypeResourceOwner:
-        return kRmtOwnerTypeCount;
+        for (int32_t current_unbound_region_index = 0; current_unbound_region_index < current_virtual_allocation->unbound_memory_region_count;
+             ++current_unbound_region_index)
+        {
+            // add any unbound memory
+            const RmtMemoryRegion* current_unbound_region = &current_virtual_allocation->unbound_memory_regions[current_unbound_region_index];
+            if (current_unbound_region->size == 0)
+            {
+                continue;
+            }
+            if (IsSizeInFilter(filter, current_unbound_region->size) == false)
+            {
+                continue;
+            }
 
-    default:
-        RMT_ASSERT(false);
-        break;
+            // Create a temporary 'unbound' resource so the unbound resource can be sorted along with other resources
+            // in the tree map. All unbound resources have a resource identifier of 0. Their base address and size are
+            // copied from their unbound region data.
+            RmtResource* unbound_resource      = new RmtResource();
+            unbound_resource->identifier       = 0;
+            unbound_resource->size_in_bytes    = current_unbound_region->size;
+            unbound_resource->address          = current_virtual_allocation->base_address + current_unbound_region->offset;
+            unbound_resource->bound_allocation = current_virtual_allocation;
+            unbound_resource->resource_type    = kRmtResourceTypeCount;
+            // keep track of the unbound resource
+            hierarchy.unbound_resources.push_back(unbound_resource);
+
+            parent_cluster.amount += current_unbound_region->size;
+            parent_cluster.sorted_resources.push_back(unbound_resource);
+        }
     }
-    return 0;
-}
 
-void RMVTreeMapBlocks::AddClusterResource(ResourceCluster& parent_cluster, const int32_t slice_index, const RmtResource* resource, bool& resource_added) const
-{
-    parent_cluster.sub_clusters[slice_index].amount += resource->size_in_bytes;
-    parent_cluster.sub_clusters[slice_index].sorted_resources.push_back(resource);
-    resource_added = true;
-}
+    hierarchy.total_size = parent_cluster.amount;
 
-void RMVTreeMapBlocks::FilterResourceUsageType(ResourceCluster&       parent_cluster,
-                                               int32_t                slice_index,
-                                               const RmtDataSnapshot* snapshot,
-                                               const RmtResource*     resource,
-                                               bool&                  resource_added) const
-{
-    RMT_ASSERT(snapshot);
-    if (resource != nullptr && RmtResourceGetUsageType(resource) == slice_index)
-    {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
-    }
-}
+    std::stable_sort(parent_cluster.sorted_resources.begin(), parent_cluster.sorted_resources.end(), SortResourcesBySizeFunc);
 
-void RMVTreeMapBlocks::FilterResourceCreateAge(ResourceCluster&       parent_cluster,
-                                               int32_t                slice_index,
-                                               const RmtDataSnapshot* snapshot,
-                                               const RmtResource*     resource,
-                                               bool&                  resource_added) const
-{
-    RMT_ASSERT(snapshot);
-    if (resource != nullptr && colorizer_->GetAgeIndex(resource->create_time) == slice_index)
+    // Something actually selected in the UI
+    if (input.slice_types.empty() == false)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        return FillClusterResources(parent_cluster, input.slice_types, 0, snapshot);
     }
-}
 
-void RMVTreeMapBlocks::FilterResourceBindAge(ResourceCluster&       parent_cluster,
-                                             int32_t                slice_index,
-                                             const RmtDataSnapshot* snapshot,
-                                             const RmtResource*     resource,
-                                             bool&                  resource_added) const
-{
-    RMT_ASSERT(snapshot);
-    if (resource != nullptr && colorizer_->GetAgeIndex(resource->bind_time) == slice_index)
-    {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
-    }
+    // Nothing selected, so just show all allocations without slicing
+    ResourceCluster& sub_cluster = parent_cluster.sub_clusters[kSliceTypeNone];
+    sub_cluster.amount           = parent_cluster.amount;
+    sub_cluster.sorted_resources.swap(parent_cluster.sorted_resources);
+    return true;
 }
 
-void RMVTreeMapBlocks::FilterAllocationAge(ResourceCluster&       parent_cluster,
-                                           int32_t                slice_index,
-                                           const RmtDataSnapshot* snapshot,
-                                           const RmtResource*     resource,
-                                           bool&                  resource_added) const
+void RMVTreeMapBlocks::GetFilter(const rmv::ResourceOverviewModel* overview_model, const TreeMapModels& tree_map_models, TreeMapFilter& filter)
 {
-    RMT_ASSERT(snapshot);
-    if (resource != nullptr && resource->bound_allocation != nullptr && colorizer_->GetAgeIndex(resource->bound_allocation->timestamp) == slice_index)
+    for (int32_t heap = 0; heap < kRmtHeapTypeCount; heap++)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        filter.preferred_heap[heap] = tree_map_models.preferred_heap_model->ItemInList(heap);
+        filter.actual_heap[heap]    = tree_map_models.actual_heap_model->ItemInList(heap);
     }
-}
 
-void RMVTreeMapBlocks::FilterPreferredHeap(ResourceCluster&       parent_cluster,
-                                           int32_t                slice_index,
-                                           const RmtDataSnapshot* snapshot,
-                                           const RmtResource*     resource,
-                                           bool&                  resource_added) const
-{
-    RMT_ASSERT(snapshot);
-    if (resource != nullptr && resource->bound_allocation->heap_preferences[0] == slice_index)
+    for (int32_t usage = 0; usage < kRmtResourceUsageTypeCount; usage++)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        filter.resource_usage[usage] = tree_map_models.resource_usage_model->ItemInList(usage);
     }
+
+    filter.minimum_size = overview_model->GetMinimumResourceSize();
+    filter.maximum_size = overview_model->GetMaximumResourceSize();
 }
 
-void RMVTreeMapBlocks::FilterCpuMapped(ResourceCluster&       parent_cluster,
-                                       int32_t                slice_index,
-                                       const RmtDataSnapshot* snapshot,
-                                       const RmtResource*     resource,
-                                       bool&                  resource_added) const
+bool RMVTreeMapBlocks::ResourceFiltered(const TreeMapFilter& filter, const RmtDataSnapshot* snapshot, const RmtResource* resource)
 {
-    RMT_ASSERT(snapshot);
-    if (((resource->bound_allocation->flags & kRmtAllocationDetailIsCpuMapped) == kRmtAllocationDetailIsCpuMapped) && slice_index == 1)
+    if (IsHeapInFilter(filter.actual_heap, RmtResourceGetActualHeap(snapshot, resource)) == false)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        return false;
     }
-    else if (((resource->bound_allocation->flags & kRmtAllocationDetailIsCpuMapped) != kRmtAllocationDetailIsCpuMapped) && slice_index == 0)
+    if (filter.resource_usage[RmtResourceGetUsageType(resource)] == false)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        return false;
     }
-}
-
-void RMVTreeMapBlocks::FilterResourceCommitType(ResourceCluster&       parent_cluster,
-                                                int32_t                slice_index,
-                                                const RmtDataSnapshot* snapshot,
-                                                const RmtResource*     resource,
-                                                bool&                  resource_added) const
-{
-    RMT_ASSERT(snapshot);
-    if (resource != nullptr && resource->commit_type == slice_index)
+    if (IsSizeInFilter(filter, resource->size_in_bytes) == false)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        return false;
     }
+    return true;
 }
 
-void RMVTreeMapBlocks::FilterResourceOwner(ResourceCluster&       parent_cluster,
-                                           int32_t                slice_index,
-                                           const RmtDataSnapshot* snapshot,
-                                           const RmtResource*     resource,
-                                           bool&                  resource_added) const
+void RMVTreeMapBlocks::GetLevelOfDetail(const ResourceCluster& cluster,
+                                        double                 bytes_per_pixel,
+                                        int32_t&               visible_count,
+                                        uint64_t&              visible_size,
+                                        uint64_t&              summary_size)
 {
-    RMT_ASSERT(snapshot);
-    if (resource != nullptr && resource->owner_type == slice_index)
+    const auto first_hidden =
+        std::partition_point(cluster.sorted_resources.begin(), cluster.sorted_resources.end(), [bytes_per_pixel](const RmtResource* resource) {
+            return (resource->size_in_bytes / bytes_per_pixel) >= kMinArea;
+        });
+    visible_count = static_cast<int32_t>(first_hidden - cluster.sorted_resources.begin());
+
+    visible_size = 0;
+    for (int32_t i = 0; i < visible_count; i++)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        visible_size += cluster.sorted_resources[i]->size_in_bytes;
     }
-}
 
-void RMVTreeMapBlocks::FilterActualHeap(ResourceCluster&       parent_cluster,
-                                        int32_t                slice_index,
-                                        const RmtDataSnapshot* snapshot,
-                                        const RmtResource*     resource,
-                                        bool&                  resource_added) const
-{
-    if (resource != nullptr && RmtResourceGetActualHeap(snapshot, resource) == slice_index)
+    // The resources too small to draw are drawn together, if they add up to something that can be seen.
+    summary_size = cluster.amount - visible_size;
+    if ((summary_size / bytes_per_pixel) < kMinArea)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        summary_size = 0;
     }
 }
 
-void RMVTreeMapBlocks::FilterInPreferredHeap(ResourceCluster&       parent_cluster,
-                                             int32_t                slice_index,
-                                             const RmtDataSnapshot* snapshot,
-                                             const RmtResource*     resource,
-                                             bool&                  resource_added) const
+uint64_t RMVTreeMapBlocks::GetVisibleClusterSize(const ResourceCluster& cluster, double bytes_per_pixel)
 {
-    if (!resource || !resource->bound_allocation || resource->resource_type == kRmtResourceTypeCount)
-        return;
-
-    uint64_t memory_segment_histogram[kRmtResourceBackingStorageCount] = {0};
-    RmtResourceGetBackingStorageHistogram(snapshot, resource, memory_segment_histogram);
+    uint64_t visible_size = 0;
 
-    const RmtHeapType preferred_heap = resource->bound_allocation->heap_preferences[0];
-    if (memory_segment_histogram[preferred_heap] != resource->size_in_bytes && slice_index == 0)
+    if (cluster.sub_clusters.size() == 0)
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        int32_t  visible_count = 0;
+        uint64_t summary_size  = 0;
+        GetLevelOfDetail(cluster, bytes_per_pixel, visible_count, visible_size, summary_size);
+        visible_size += summary_size;
     }
-    else if (memory_segment_histogram[preferred_heap] == resource->size_in_bytes && slice_index == 1)
+    else
     {
-        AddClusterResource(parent_cluster, slice_index, resource, resource_added);
+        for (auto it = cluster.sub_clusters.constBegin(); it != cluster.sub_clusters.constEnd(); ++it)
+        {
+            visible_size += GetVisibleClusterSize(it.value(), bytes_per_pixel);
+        }
     }
+
+    return visible_size;
 }
 
-void RMVTreeMapBlocks::FillClusterResources(ResourceCluster& parent_cluster, QVector<SliceType>& target_slice_types, int level, int max_level)
+bool RMVTreeMapBlocks::FillClusterGeometry(const ResourceCluster& parent_cluster,
+                                           double                 bytes_per_pixel,
+                                           int                    parent_width,
+                                           int                    parent_height,
+                                           int                    parent_offset_x,
+                                           int                    parent_offset_y,
+                                           TreeMapGeometry&       geometry) const
 {
-    RMT_ASSERT(level <= max_level);
-
-    if (level == max_level)
+    if (layout_cancelled_ == true)
     {
-        return;
+        return false;
     }
 
-    RMT_ASSERT(level < target_slice_types.size());
-    SliceType slice_type = target_slice_types[level];
+    geometry.cluster_rects.push_back(QRectF(parent_offset_x, parent_offset_y, parent_width, parent_height));
 
-    const TraceManager&    trace_manager = TraceManager::Get();
-    const RmtDataSnapshot* snapshot      = trace_manager.GetOpenSnapshot();
-    if (!trace_manager.DataSetValid() || snapshot == nullptr)
+    // Only the resources in the bottom-most clusters are drawn.
+    if (parent_cluster.sub_clusters.size() == 0)
     {
-        return;
-    }
+        int32_t  visible_count = 0;
+        uint64_t visible_size  = 0;
+        uint64_t summary_size  = 0;
+        GetLevelOfDetail(parent_cluster, bytes_per_pixel, visible_count, visible_size, summary_size);
+
+        if (summary_size == 0)
+        {
+            GenerateTreeMapRects(
+                parent_cluster.sorted_resources, visible_count, visible_size, parent_width, parent_height, parent_offset_x, parent_offset_y, geometry.blocks);
+            return true;
+        }
 
-    int32_t slice_count = GetSliceCount(slice_type, snapshot);
+        // Lay out the summary block along with the resources large enough to draw. It is colored like the largest
+        // resource it stands in for.
+        geometry.summary_resources.push_back(*parent_cluster.sorted_resources[visible_count]);
+        RmtResource* summary_resource   = &geometry.summary_resources.back();
+        summary_resource->size_in_bytes = summary_size;
 
-    // Special case the virtual allocation.
-    if (slice_type == kSliceTypeVirtualAllocation)
-    {
-        for (int32_t slice_index = 0; slice_index < slice_count; slice_index++)
+        QVector<const RmtResource*> resources;
+        resources.reserve(visible_count + 1);
+        for (int32_t i = 0; i < visible_count; i++)
         {
-            const RmtVirtualAllocation* virtual_allocation = &snapshot->virtual_allocation_list.allocation_details[slice_index];
-            bool                        found_allocs       = false;
+            resources.push_back(parent_cluster.sorted_resources[i]);
+        }
+        resources.insert(std::upper_bound(resources.begin(), resources.end(), summary_resource, SortResourcesBySizeFunc), summary_resource);
 
-            for (int32_t resource_index = 0; resource_index < parent_cluster.sorted_resources.size(); resource_index++)
-            {
-                const RmtResource* resource = parent_cluster.sorted_resources[resource_index];
-                if (resource != nullptr && resource->bound_allocation == virtual_allocation)
-                {
-                    AddClusterResource(parent_cluster, slice_index, resource, found_allocs);
-                }
-            }
+        const int32_t first_block_index = geometry.blocks.size();
+        GenerateTreeMapRects(
+            resources, resources.size(), visible_size + summary_size, parent_width, parent_height, parent_offset_x, parent_offset_y, geometry.blocks);
 
-            if (found_allocs)
+        for (int32_t i = first_block_index; i < geometry.blocks.size(); i++)
+        {
+            if (geometry.blocks[i].resource == summary_resource)
             {
-                FillClusterResources(parent_cluster.sub_clusters[slice_index], target_slice_types, level + 1, max_level);
+                geometry.blocks[i].is_summary = true;
             }
         }
+        return true;
     }
 
-    else
+    // Create some temporary resources so we can compute geometry for the sub-cluster bounds. The identifier of each
+    // temporary resource is the slice key of its sub-cluster.
+    QVector<RmtResource>        temp_resources(parent_cluster.sub_clusters.size());
+    QVector<const RmtResource*> sorted_temp_resources;
+    uint64_t                    temp_parent_allocs_size = 0;
+    for (auto it = parent_cluster.sub_clusters.constBegin(); it != parent_cluster.sub_clusters.constEnd(); ++it)
     {
-        typedef void (RMVTreeMapBlocks::*FilterFunction)(
-            ResourceCluster & parent_cluster, int32_t slice_index, const RmtDataSnapshot* snapshot, const RmtResource* resource, bool& found_allocs) const;
-
-        FilterFunction fn = nullptr;
-
-        switch (slice_type)
+        const uint64_t visible_size = GetVisibleClusterSize(it.value(), bytes_per_pixel);
+        if (visible_size == 0)
         {
-        case kSliceTypeResourceUsageType:
-            fn = &RMVTreeMapBlocks::FilterResourceUsageType;
-            break;
+            continue;
+        }
 
-        case kSliceTypeResourceCreateAge:
-            fn = &RMVTreeMapBlocks::FilterResourceCreateAge;
-            break;
+        RmtResource& temp_resource  = temp_resources[sorted_temp_resources.size()];
+        temp_resource.identifier    = it.key();
+        temp_resource.size_in_bytes = visible_size;
+        sorted_temp_resources.push_back(&temp_resource);
+        temp_parent_allocs_size += visible_size;
+    }
 
-        case kSliceTypeResourceBindAge:
-            fn = &RMVTreeMapBlocks::FilterResourceBindAge;
-            break;
+    std::stable_sort(sorted_temp_resources.begin(), sorted_temp_resources.end(), SortResourcesBySizeFunc);
 
-        case kSliceTypeAllocationAge:
-            fn = &RMVTreeMapBlocks::FilterAllocationAge;
-            break;
+    // Figure out geometry for parent bounds
+    QVector<TreeMapBlock> sub_cluster_blocks;
+    GenerateTreeMapRects(sorted_temp_resources,
+                         sorted_temp_resources.size(),
+                         temp_parent_allocs_size,
+                         parent_width,
+                         parent_height,
+                         parent_offset_x,
+                         parent_offset_y,
+                         sub_cluster_blocks);
 
-        case kSliceTypePreferredHeap:
-            fn = &RMVTreeMapBlocks::FilterPreferredHeap;
-            break;
+    // Figure out geometry for sub-clusters, but bound by parent bounds
+    for (const TreeMapBlock& sub_cluster_block : sub_cluster_blocks)
+    {
+        const ResourceCluster& sub_cluster   = parent_cluster.sub_clusters.constFind(sub_cluster_block.resource->identifier).value();
+        const QRectF&          bounding_rect = sub_cluster_block.bounding_rect;
 
-        case kSliceTypeCpuMapped:
-            fn = &RMVTreeMapBlocks::FilterCpuMapped;
-            break;
+        if (FillClusterGeometry(
+                sub_cluster, bytes_per_pixel, bounding_rect.width(), bounding_rect.height(), bounding_rect.left(), bounding_rect.top(), geometry) == false)
+        {
+            return false;
+        }
+    }
 
-        case kSliceTypeResourceCommitType:
-            fn = &RMVTreeMapBlocks::FilterResourceCommitType;
-            break;
+    return true;
+}
 
-        case kSliceTypeResourceOwner:
-            fn = &RMVTreeMapBlocks::FilterResourceOwner;
-            break;
+int32_t RMVTreeMapBlocks::GetSliceIndex(const SliceType slice_type, const RmtDataSnapshot* snapshot, const RmtResource* resource) const
+{
+    switch (slice_type)
+    {
+    case kSliceTypeResourceUsageType:
+        return RmtResourceGetUsageType(resource);
 
-        case kSliceTypeActualHeap:
-            fn = &RMVTreeMapBlocks::FilterActualHeap;
-            break;
+    case kSliceTypeResourceCreateAge:
+        return colorizer_->GetAgeIndex(resource->create_time);
 
-        case kSliceTypeInPreferredHeap:
-            fn = &RMVTreeMapBlocks::FilterInPreferredHeap;
-            break;
+    case kSliceTypeResourceBindAge:
+        return colorizer_->GetAgeIndex(resource->bind_time);
 
-        default:
-            break;
+    case kSliceTypeAllocationAge:
+        if (resource->bound_allocation != nullptr)
+        {
+            return colorizer_->GetAgeIndex(resource->bound_allocation->timestamp);
         }
+        break;
 
-        if (fn != nullptr)
+    case kSliceTypeVirtualAllocation:
+        if (resource->bound_allocation != nullptr)
         {
-            for (int32_t slice_index = 0; slice_index < slice_count; slice_index++)
+            const RmtVirtualAllocation* allocation_details = snapshot->virtual_allocation_list.allocation_details;
+            const ptrdiff_t             allocation_index   = resource->bound_allocation - allocation_details;
+            if (allocation_index >= 0 && allocation_index < snapshot->virtual_allocation_list.allocation_count)
             {
-                bool found_allocs = false;
+                return static_cast<int32_t>(allocation_index);
+            }
+        }
+        break;
 
-                for (int32_t resource_index = 0; resource_index < parent_cluster.sorted_resources.size(); resource_index++)
-                {
-                    const RmtResource* resource = parent_cluster.sorted_resources[resource_index];
-                    (this->*fn)(parent_cluster, slice_index, snapshot, resource, found_allocs);
-                }
+    case kSliceTypePreferredHeap:
+        return resource->bound_allocation->heap_preferences[0];
 
-                if (found_allocs)
-                {
-                    FillClusterResources(parent_cluster.sub_clusters[slice_index], target_slice_types, level + 1, max_level);
-                }
-            }
+    case kSliceTypeActualHeap:
+        return RmtResourceGetActualHeap(snapshot, resource);
+
+    case kSliceTypeCpuMapped:
+        return ((resource->bound_allocation->flags & kRmtAllocationDetailIsCpuMapped) == kRmtAllocationDetailIsCpuMapped) ? 1 : 0;
+
+    case kSliceTypeResourceCommitType:
+        return resource->commit_type;
+
+    case kSliceTypeResourceOwner:
+        return resource->owner_type;
+
+    case kSliceTypeInPreferredHeap:
+        if (resource->bound_allocation != nullptr && resource->resource_type != kRmtResourceTypeCount)
+        {
+            uint64_t memory_segment_histogram[kRmtResourceBackingStorageCount] = {0};
+            RmtResourceGetBackingStorageHistogram(snapshot, resource, memory_segment_histogram);
+
+            const RmtHeapType preferred_heap = resource->bound_allocation->heap_preferences[0];
+            return (memory_segment_histogram[preferred_heap] == resource->size_in_bytes) ? 1 : 0;
         }
+        break;
+
+    default:
+        RMT_ASSERT(false);
+        break;
     }
+    return -1;
+}
+
+bool RMVTreeMapBlocks::FillClusterResources(ResourceCluster&          parent_cluster,
+                                            const QVector<SliceType>& target_slice_types,
+                                            int                       level,
+                                            const RmtDataSnapshot*    snapshot) const
+{
+    RMT_ASSERT(level <= target_slice_types.size());
+
+    if (level == target_slice_types.size())
+    {
+        return true;
+    }
+
+    if (layout_cancelled_ == true)
+    {
+        return false;
+    }
+
+    const SliceType slice_type = target_slice_types[level];
+
+    // Move each resource into the sub-cluster for its slice. The resources stay sorted by size.
+    for (const RmtResource* resource : parent_cluster.sorted_resources)
+    {
+        const int32_t slice_index = GetSliceIndex(slice_type, snapshot, resource);
+        if (slice_index >= 0)
+        {
+            ResourceCluster& sub_cluster = parent_cluster.sub_clusters[slice_index];
+            sub_cluster.amount += resource->size_in_bytes;
+            sub_cluster.sorted_resources.push_back(resource);
+        }
+    }
+    parent_cluster.sorted_resources.clear();
+
+    for (auto it = parent_cluster.sub_clusters.begin(); it != parent_cluster.sub_clusters.end(); ++it)
+    {
+        if (FillClusterResources(it.value(), target_slice_types, level + 1, snapshot) == false)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 void RMVTreeMapBlocks::UpdateSliceTypes(const QVector<SliceType>& slice_types)
 {
     slice_types_ = slice_types;
-}
\ No newline at end of file
+}
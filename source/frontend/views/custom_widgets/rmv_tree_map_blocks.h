@@ -9,7 +9,13 @@
 #define RMV_VIEWS_CUSTOM_WIDGETS_RMV_TREE_MAP_BLOCKS_H_
 
 #include <QGraphicsObject>
+#include <QPixmap>
+#include <atomic>
+#include <deque>
+#include <memory>
 
+#include "rmt_data_snapshot.h"
+#include "rmt_job_system.h"
 #include "rmt_resource_list.h"
 
 #include "models/combo_box_model.h"
@@ -44,8 +50,6 @@ struct CutData
     bool                        is_null;        ///< Good or bad.
 };
 
-typedef QMap<const RmtResource*, QRectF> AllocGeometryMap;
-
 /// Describes a cluster, which is a square with potentially other child clusters.
 struct ResourceCluster
 {
@@ -54,11 +58,9 @@ struct ResourceCluster
     {
     }
 
-    AllocGeometryMap                alloc_geometry_map;  ///< Association of allocation pointers to their rendered geometry.
-    QVector<const RmtResource*>     sorted_resources;    ///< Array of all child allocations, sorted by size.
-    QMap<uint32_t, ResourceCluster> sub_clusters;        ///< Collection of children clusters.
-    uint64_t                        amount;              ///< Total size of this cluster.
-    QRectF                          geometry;            ///< Encompassing geometry.
+    QVector<const RmtResource*>     sorted_resources;  ///< Array of all child allocations, sorted by size. Only leaf clusters keep their resources.
+    QMap<uint32_t, ResourceCluster> sub_clusters;      ///< Collection of children clusters.
+    uint64_t                        amount;            ///< Total size of this cluster.
 };
 
 /// Various models used to filter the tree map.
@@ -69,7 +71,52 @@ struct TreeMapModels
     rmv::ResourceUsageComboBoxModel* resource_usage_model;  ///< The resource usage model.
 };
 
-typedef QMap<uint32_t, ResourceCluster> ClusterMap;
+/// A copy of the filter state of the tree map models, so the tree map can be built away from the GUI thread.
+struct TreeMapFilter
+{
+    bool     preferred_heap[kRmtHeapTypeCount];           ///< Set if resources in allocations preferring each heap are shown.
+    bool     actual_heap[kRmtHeapTypeCount];              ///< Set if resources in each actual heap are shown.
+    bool     resource_usage[kRmtResourceUsageTypeCount];  ///< Set if resources of each usage type are shown.
+    uint64_t minimum_size;                                ///< The smallest resource size shown.
+    uint64_t maximum_size;                                ///< The largest resource size shown.
+};
+
+/// The filtered and sliced resources shown in the tree map. This doesn't depend on the size of the view, so it is
+/// kept and laid out again when the view is resized.
+struct TreeMapHierarchy
+{
+    /// Constructor.
+    TreeMapHierarchy();
+
+    /// Destructor.
+    ~TreeMapHierarchy();
+
+    ResourceCluster       root;               ///< The cluster holding all the shown resources.
+    uint64_t              total_size;         ///< The size of all the shown resources, including those too small to be seen.
+    QVector<RmtResource*> unbound_resources;  ///< Temporary resources representing the unbound memory regions.
+};
+
+/// A single resource rectangle in a laid out tree map.
+struct TreeMapBlock
+{
+    const RmtResource* resource;       ///< The resource.
+    QRectF             bounding_rect;  ///< The offset and size.
+    bool               is_summary;     ///< Set if the block stands in for the resources in its cluster too small to draw.
+};
+
+/// The result of laying out a hierarchy at a particular size. This is never changed once the layout job has made it.
+struct TreeMapGeometry
+{
+    std::shared_ptr<const TreeMapHierarchy> hierarchy;           ///< The hierarchy that was laid out. Keeps the unbound resources alive.
+    QVector<TreeMapBlock>                   blocks;              ///< The resource rectangles.
+    QVector<QRectF>                         cluster_rects;       ///< The borders around each cluster.
+    std::deque<RmtResource>                 summary_resources;   ///< The resources drawn by the summary blocks.
+    int32_t                                 grid_columns;        ///< The number of columns of cells in the hit test grid.
+    int32_t                                 grid_rows;           ///< The number of rows of cells in the hit test grid.
+    QVector<int32_t>                        grid_cell_starts;    ///< The offset of each cell's first entry in grid_block_indices, plus an end offset.
+    QVector<int32_t>                        grid_block_indices;  ///< The indices of the blocks overlapping each cell, one run per cell.
+    QVector<int32_t>                        resource_blocks;     ///< The indices of the resource blocks, sorted by resource pointer.
+};
 
 /// Container class for a widget that manages TreeMap rendering.
 class RMVTreeMapBlocks : public QGraphicsObject
@@ -129,13 +176,20 @@ public:
     /// \param widget Points to the widget that is being painted on if specified.
     virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) Q_DECL_OVERRIDE;
 
-    /// Parse dataset and generate rectangle positions.
+    /// Parse dataset and generate rectangle positions. The resources are filtered, sliced and laid out by a job in the
+    /// background, cancelling any job started by an earlier call, and the blocks are repainted once it has finished.
     /// \param overview_model The model data for the resource overview model.
     /// \param tree_map_models The models used to filter the resource data.
     /// \param view_width available width.
     /// \param view_height available height.
     void GenerateTreemap(const rmv::ResourceOverviewModel* overview_model, const TreeMapModels& tree_map_models, uint32_t view_width, uint32_t view_height);
 
+    /// Lay out the resources from the last call to GenerateTreemap() at a new size. The filtered and sliced resources
+    /// are reused, so only the rectangles are calculated again.
+    /// \param view_width available width.
+    /// \param view_height available height.
+    void LayoutTreemap(uint32_t view_width, uint32_t view_height);
+
     /// Reset state.
     void Reset();
 
@@ -159,6 +213,9 @@ public:
     /// \param colorizer The colorizer to use.
     void SetColorizer(const Colorizer* colorizer);
 
+    /// Redraw the cached blocks after the colors have changed.
+    void UpdateColorCache();
+
 signals:
     /// Signal that a resource has been selected.
     /// \param resource_identifier The selected resource.
@@ -176,69 +233,148 @@ signals:
     /// broadcast to and which pane to navigate to).
     void UnboundResourceSelected(const RmtResource* unbound_resource, bool broadcast, bool navigate_to_pane);
 
+    /// Signal emitted from the layout job when it has finished.
+    /// \param generation The generation of the layout request the job was started for.
+    void LayoutFinished(quint64 generation);
+
 private:
+    /// The input to the job that builds and lays out the tree map.
+    struct LayoutJobInput
+    {
+        const RmtDataSnapshot*                  snapshot;     ///< The snapshot containing the resources.
+        TreeMapFilter                           filter;       ///< The filters applied to the resources.
+        QVector<SliceType>                      slice_types;  ///< The slicing modes, one per level.
+        std::shared_ptr<const TreeMapHierarchy> hierarchy;    ///< The hierarchy to lay out, or null to build it first.
+        uint32_t                                view_width;   ///< The available width.
+        uint32_t                                view_height;  ///< The available height.
+        quint64                                 generation;   ///< The generation of the layout request.
+        std::shared_ptr<const TreeMapGeometry>  geometry;     ///< The geometry made by the job.
+    };
+
+    /// Start the layout job for the current layout job input.
+    void StartLayout();
+
+    /// Stop the layout job if it is running, and wait for it to return.
+    void CancelLayout();
+
+    /// Take the geometry made by the layout job, if it was made for the latest layout request.
+    /// \param generation The generation of the layout request the finished job was started for.
+    void ApplyLayout(quint64 generation);
+
+    /// Job function to filter, slice and lay out the resources.
+    /// \param thread_id The worker thread running the job.
+    /// \param index The index of the job.
+    /// \param input A pointer to the RMVTreeMapBlocks that started the job.
+    static void LayoutJob(int32_t thread_id, int32_t index, void* input);
+
+    /// Filter the resources in a snapshot and slice them into clusters.
+    /// \param input The layout job input.
+    /// \param hierarchy The hierarchy to fill in.
+    /// \return true if the hierarchy was built, false if the job was cancelled.
+    bool BuildHierarchy(const LayoutJobInput& input, TreeMapHierarchy& hierarchy) const;
+
     /// Calculate aspect ratio.
     /// \param width width.
     /// \param height height.
     /// \return aspect ratio.
-    double CalculateAspectRatio(double width, double height);
+    static double CalculateAspectRatio(double width, double height);
 
     /// Add a cut to the list of rectangles that will be rendered out.
     /// \param existing_cut the cut.
     /// \param offset_x x offset.
     /// \param offset_y y offset.
-    /// \param alloc_geometry_map the geometry map.
-    void DumpCut(const CutData& existing_cut, uint32_t offset_x, uint32_t offset_y, AllocGeometryMap& alloc_geometry_map) const;
+    /// \param blocks the list of rectangles.
+    static void DumpCut(const CutData& existing_cut, uint32_t offset_x, uint32_t offset_y, QVector<TreeMapBlock>& blocks);
 
-    /// Fill in a cluster with resources that fall within it.
+    /// Fill in a cluster with resources that fall within it. The resources are moved from the cluster into its
+    /// sub-clusters.
     /// \param parent_cluster the cluster process.
     /// \param target_slice_types a vector of the currently selected slicing types.
     /// \param level current recursion level.
-    /// \param max_level max allowed depth.
-    void FillClusterResources(ResourceCluster& parent_cluster, QVector<SliceType>& target_slice_types, int level, int max_mevel);
+    /// \param snapshot The snapshot containing the resources.
+    /// \return true if the cluster was filled in, false if the job was cancelled.
+    bool FillClusterResources(ResourceCluster& parent_cluster, const QVector<SliceType>& target_slice_types, int level, const RmtDataSnapshot* snapshot) const;
 
     /// Compute geometry for a cluster.
     /// \param parent_cluster the cluster to look at.
+    /// \param bytes_per_pixel The number of bytes each pixel in the view represents.
     /// \param parent_width parent width.
     /// \param parent_height parent height.
     /// \param parent_offset_x starting X-offset.
     /// \param parent_offset_y starting Y-offset.
-    void FillClusterGeometry(ResourceCluster& parent_cluster, int parent_width, int parent_height, int parent_offset_x, int parent_offset_y);
-
-    /// Get block data given a set of coordinates.
-    /// \param cluster the cluster to look at.
+    /// \param geometry The geometry to add the rectangles to.
+    /// \return true if the geometry was computed, false if the job was cancelled.
+    bool FillClusterGeometry(const ResourceCluster& parent_cluster,
+                             double                 bytes_per_pixel,
+                             int                    parent_width,
+                             int                    parent_height,
+                             int                    parent_offset_x,
+                             int                    parent_offset_y,
+                             TreeMapGeometry&       geometry) const;
+
+    /// Split the resources in a leaf cluster into those large enough to be drawn as blocks of their own and those
+    /// drawn together as a single summary block. As the resources are sorted by size, the large ones are always at
+    /// the start of the cluster.
+    /// \param cluster The cluster.
+    /// \param bytes_per_pixel The number of bytes each pixel in the view represents.
+    /// \param visible_count The number of resources drawn as blocks of their own.
+    /// \param visible_size The size of the resources drawn as blocks of their own.
+    /// \param summary_size The size of the summary block, or 0 if it is too small to be seen as well.
+    static void GetLevelOfDetail(const ResourceCluster& cluster,
+                                 double                 bytes_per_pixel,
+                                 int32_t&               visible_count,
+                                 uint64_t&              visible_size,
+                                 uint64_t&              summary_size);
+
+    /// Get the size of the blocks drawn for a cluster and its sub-clusters.
+    /// \param cluster The cluster.
+    /// \param bytes_per_pixel The number of bytes each pixel in the view represents.
+    /// \return The size of the visible blocks.
+    static uint64_t GetVisibleClusterSize(const ResourceCluster& cluster, double bytes_per_pixel);
+
+    /// Build the hit test grid and the resource lookup for the blocks in a geometry.
+    /// \param view_width The width of the view the geometry was laid out for.
+    /// \param view_height The height of the view the geometry was laid out for.
+    /// \param geometry The geometry.
+    static void BuildBlockIndex(int32_t view_width, int32_t view_height, TreeMapGeometry& geometry);
+
+    /// Get the block at a set of coordinates.
     /// \param user_location the position.
-    /// \param resource_identifier output resource identifier.
-    /// \param out_resource output parent resource.
-    bool FindBlockData(ResourceCluster& cluster, QPointF user_location, RmtResourceIdentifier& resource_identifier, const RmtResource*& resource);
+    /// \return The index of the block, or -1 if there is no resource block at the position.
+    int32_t FindBlockAtLocation(QPointF user_location) const;
+
+    /// Get the block showing a resource.
+    /// \param resource_identifier The resource identifier.
+    /// \param resource The resource (incase the resource is unbound).
+    /// \return The index of the block, or -1 if the resource isn't shown.
+    int32_t FindBlock(RmtResourceIdentifier resource_identifier, const RmtResource* resource) const;
+
+    /// Get the rectangle drawn for a block.
+    /// \param block_index The index of the block, or -1.
+    /// \return The block data. This isn't visible if the block index is -1 or the block is too small to draw.
+    TreeMapBlockData GetBlockData(int32_t block_index) const;
+
+    /// Draw the blocks and the cluster borders into the block cache.
+    /// \param device_pixel_ratio The device pixel ratio of the paint device the cache is drawn to.
+    void UpdateBlockCache(qreal device_pixel_ratio);
 
     /// Workhorse function to calculate tree map geometry.
     /// \param resources incoming resources to map out.
+    /// \param resource_count The number of resources to map out, from the start of the resources.
     /// \param total_size total byte size.
     /// \param view_width available width.
     /// \param view_height available height.
     /// \param offset_x x offset.
     /// \param offset_y y offset.
-    /// \param alloc_geometry_map output data containing alloc offsets and sizes.
-    void GenerateTreeMapRects(QVector<const RmtResource*>& resources,
-                              uint64_t                     total_size,
-                              uint32_t                     view_width,
-                              uint32_t                     view_height,
-                              uint32_t                     offset_x,
-                              uint32_t                     offset_y,
-                              AllocGeometryMap&            alloc_geometry_map);
-
-    /// Recursive paint function to draw borders around slicing modes.
-    /// \param painter Qt painter pointer.
-    /// \param cluster The current cluster we're rendering.
-    void PaintClusterParents(QPainter* painter, ResourceCluster& cluster);
-
-    /// Recursive paint function to paint blocks inside each cluster.
-    /// \param painter Qt painter pointer.
-    /// \param cluster The current cluster we're rendering.
-    /// \param hovered_resource output hovered resource.
-    /// \param selected_resource output selected resource.
-    void PaintClusterChildren(QPainter* painter, ResourceCluster& cluster, TreeMapBlockData& hovered_resource, TreeMapBlockData& selected_resource);
+    /// \param blocks output data containing alloc offsets and sizes.
+    static void GenerateTreeMapRects(const QVector<const RmtResource*>& resources,
+                                     int32_t                            resource_count,
+                                     uint64_t                           total_size,
+                                     uint32_t                           view_width,
+                                     uint32_t                           view_height,
+                                     uint32_t                           offset_x,
+                                     uint32_t                           offset_y,
+                                     QVector<TreeMapBlock>&             blocks);
 
     /// Get scaled height.
     /// \return scaled height.
@@ -252,163 +388,46 @@ private:
     /// \param width width.
     /// \param height height.
     /// \return true if should draw vertically.
-    bool ShouldDrawVertically(double width, double height);
+    static bool ShouldDrawVertically(double width, double height);
 
-    /// Apply the filters to the resource to see if it should be shown in the treemap.
+    /// Copy the state of the filter models.
     /// \param overview_model The model data for the resource overview model.
     /// \param tree_map_models The models used to filter the resource data.
+    /// \param filter The filter to fill in.
+    static void GetFilter(const rmv::ResourceOverviewModel* overview_model, const TreeMapModels& tree_map_models, TreeMapFilter& filter);
+
+    /// Apply the filters to the resource to see if it should be shown in the treemap.
+    /// \param filter The filters to apply.
     /// \param snapshot The current snapshot.
     /// \param resource The resource to test.
     /// \return true if the resource should be included, false if not.
-    bool ResourceFiltered(const rmv::ResourceOverviewModel* overview_model,
-                          const TreeMapModels&              tree_map_models,
-                          const RmtDataSnapshot*            snapshot,
-                          const RmtResource*                resource);
-
-    /// Get the slice count depending on the slicing mode. This is the number of slices needed to
-    /// show the data, for example, slicing by whether a resource is in its preferred heap would
-    /// return a count of 2 (those in the preferred heap and those not).
+    static bool ResourceFiltered(const TreeMapFilter& filter, const RmtDataSnapshot* snapshot, const RmtResource* resource);
+
+    /// Get the slice a resource belongs to, for example, slicing by whether a resource is in its preferred heap
+    /// would return 1 for those in the preferred heap and 0 for those not.
     /// \param slice_type The slicing mode.
     /// \param snapshot The currently opened snapshot.
-    /// \return The slicing count.
-    int32_t GetSliceCount(const SliceType slice_type, const RmtDataSnapshot* snapshot) const;
-
-    /// Add a resource to the current cluster.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void AddClusterResource(ResourceCluster& parent_cluster, const int32_t slice_index, const RmtResource* resource, bool& resource_added) const;
-
-    /// Filter to slice by resource usage type.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterResourceUsageType(ResourceCluster&       parent_cluster,
-                                 int32_t                slice_index,
-                                 const RmtDataSnapshot* snapshot,
-                                 const RmtResource*     resource,
-                                 bool&                  resource_added) const;
-
-    /// Filter to slice by resource create age.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterResourceCreateAge(ResourceCluster&       parent_cluster,
-                                 int32_t                slice_index,
-                                 const RmtDataSnapshot* snapshot,
-                                 const RmtResource*     resource,
-                                 bool&                  resource_added) const;
-
-    /// Filter to slice by resource bind age.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterResourceBindAge(ResourceCluster&       parent_cluster,
-                               int32_t                slice_index,
-                               const RmtDataSnapshot* snapshot,
-                               const RmtResource*     resource,
-                               bool&                  resource_added) const;
-
-    /// Filter to slice by allocation age.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterAllocationAge(ResourceCluster&       parent_cluster,
-                             int32_t                slice_index,
-                             const RmtDataSnapshot* snapshot,
-                             const RmtResource*     resource,
-                             bool&                  resource_added) const;
-
-    /// Filter to slice by preferred heap.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterPreferredHeap(ResourceCluster&       parent_cluster,
-                             int32_t                slice_index,
-                             const RmtDataSnapshot* snapshot,
-                             const RmtResource*     resource,
-                             bool&                  resource_added) const;
-
-    /// Filter to slice by whether a resource is CPU mapped.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterCpuMapped(ResourceCluster&       parent_cluster,
-                         int32_t                slice_index,
-                         const RmtDataSnapshot* snapshot,
-                         const RmtResource*     resource,
-                         bool&                  resource_added) const;
-
-    /// Filter to slice by resource commit type.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterResourceCommitType(ResourceCluster&       parent_cluster,
-                                  int32_t                slice_index,
-                                  const RmtDataSnapshot* snapshot,
-                                  const RmtResource*     resource,
-                                  bool&                  resource_added) const;
-
-    /// Filter to slice by resource owner.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterResourceOwner(ResourceCluster&       parent_cluster,
-                             int32_t                slice_index,
-                             const RmtDataSnapshot* snapshot,
-                             const RmtResource*     resource,
-                             bool&                  resource_added) const;
-
-    /// Filter to slice by actual heap.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterActualHeap(ResourceCluster&       parent_cluster,
-                          int32_t                slice_index,
-                          const RmtDataSnapshot* snapshot,
-                          const RmtResource*     resource,
-                          bool&                  resource_added) const;
-
-    /// Filter to slice by whether a resource is in its preferred heap.
-    /// \param parent_cluster the parent cluster.
-    /// \param slice_index The slice index.
-    /// \param snapshot The currently opened snapshot.
-    /// \param resource The resource to add.
-    /// \param resource_added A variable that is updated to indicate that a resource has been added.
-    void FilterInPreferredHeap(ResourceCluster&       parent_cluster,
-                               int32_t                slice_index,
-                               const RmtDataSnapshot* snapshot,
-                               const RmtResource*     resource,
-                               bool&                  resource_added) const;
-
-    RMVTreeMapBlocksConfig          config_;                        ///< Description of this widget.
-    RmtResourceIdentifier           hovered_resource_identifier_;   ///< Id of the allocation hovered over.
-    RmtResourceIdentifier           selected_resource_identifier_;  ///< Id of the selected allocation.
-    const RmtResource*              hovered_resource_;              ///< The hovered resource (incase the resource is unbound).
-    const RmtResource*              selected_resource_;             ///< The selected resource (incase the resource is unbound).
-    QMap<uint32_t, ResourceCluster> clusters_;                      ///< The master data structure that holds all recursive block layouts.
-    QVector<SliceType>              slice_types_;                   ///< Holds UI slicing selections.
-    const Colorizer*                colorizer_;                     ///< The colorizer for deciding how to color the blocks.
-    QVector<RmtResource*>           unbound_resources_;             ///< A list of unbound resources.
+    /// \param resource The resource.
+    /// \return The slice index, or -1 if the resource isn't in any slice.
+    int32_t GetSliceIndex(const SliceType slice_type, const RmtDataSnapshot* snapshot, const RmtResource* resource) const;
+
+    RMVTreeMapBlocksConfig                  config_;                        ///< Description of this widget.
+    RmtResourceIdentifier                   hovered_resource_identifier_;   ///< Id of the allocation hovered over.
+    RmtResourceIdentifier                   selected_resource_identifier_;  ///< Id of the selected allocation.
+    const RmtResource*                      hovered_resource_;              ///< The hovered resource (incase the resource is unbound).
+    const RmtResource*                      selected_resource_;             ///< The selected resource (incase the resource is unbound).
+    QVector<SliceType>                      slice_types_;                   ///< Holds UI slicing selections.
+    const Colorizer*                        colorizer_;                     ///< The colorizer for deciding how to color the blocks.
+    std::shared_ptr<const TreeMapHierarchy> hierarchy_;                     ///< The filtered and sliced resources, once the layout job has built them.
+    std::shared_ptr<const TreeMapGeometry>  geometry_;                      ///< The blocks being painted.
+    QPixmap                                 block_cache_;                   ///< The blocks and cluster borders, drawn once per layout or color change.
+    int32_t                                 hovered_block_index_;           ///< The index of the hovered block, or -1.
+    int32_t                                 selected_block_index_;          ///< The index of the selected block, or -1.
+    LayoutJobInput                          layout_job_input_;              ///< The input to the layout job.
+    RmtJobHandle                            layout_job_;                    ///< The layout job.
+    bool                                    layout_job_pending_;            ///< If true, the layout job has been added to the job queue.
+    std::atomic<bool>                       layout_cancelled_;              ///< Set to stop the layout job.
+    quint64                                 layout_generation_;             ///< Incremented for every layout request.
 };
 
 #endif  // RMV_VIEWS_CUSTOM_WIDGETS_RMV_TREE_MAP_BLOCKS_H_
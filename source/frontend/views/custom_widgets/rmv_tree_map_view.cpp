@@ -71,8 +71,7 @@ void RMVTreeMapView::resizeEvent(QResizeEvent* event)
     const QRectF scene_rect = QRectF(1, 1, view_width - kViewMargin, view_height - kViewMargin);
     scene_->setSceneRect(scene_rect);
     blocks_->UpdateDimensions(view_width - kViewMargin, view_height - kViewMargin);
-
-    UpdateTreeMap();
+    blocks_->LayoutTreemap(view_width - kViewMargin, view_height - kViewMargin);
 }
 
 void RMVTreeMapView::SetModels(const rmv::ResourceOverviewModel* overview_model, const TreeMapModels* tree_map_models, const Colorizer* colorizer)
@@ -105,7 +104,7 @@ void RMVTreeMapView::SelectResource(RmtResourceIdentifier resource_identifier)
 
 void RMVTreeMapView::UpdateColorCache()
 {
-    blocks_->update();
+    blocks_->UpdateColorCache();
 }
 
 RMVTreeMapBlocks* RMVTreeMapView::BlocksWidget()
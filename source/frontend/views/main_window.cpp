@@ -16,6 +16,7 @@
 #include <QFileDialog>
 #include <QDesktopServices>
 #include <QMimeData>
+#include <QStatusBar>
 
 #include "qt_common/utils/common_definitions.h"
 #include "qt_common/utils/qt_util.h"
@@ -23,6 +24,7 @@
 
 #include "rmt_data_snapshot.h"
 #include "rmt_assert.h"
+#include "rmt_platform.h"
 
 #include "models/snapshot_manager.h"
 #include "models/trace_manager.h"
@@ -44,8 +46,10 @@
 #include "views/start/about_pane.h"
 #include "views/timeline/timeline_pane.h"
 #include "views/timeline/device_configuration_pane.h"
+#include "views/timeline/leak_trend_pane.h"
 #include "settings/rmv_settings.h"
 #include "settings/rmv_geometry_settings.h"
+#include "util/string_util.h"
 #include "util/time_util.h"
 #include "util/thread_controller.h"
 #include "util/version.h"
@@ -56,11 +60,12 @@
 static const int kIndexEmptyPane     = 0;
 static const int kIndexPopulatedPane = 1;
 
-// Thread count for the job queue.
-static const int32_t kThreadCount = 8;
-
 static const int kMaxSubmenuSnapshots = 10;
-RmtJobQueue      MainWindow::job_queue_;
+
+// How often the progress shown with the loading animation is updated, in milliseconds.
+static const int kProgressUpdateInterval = 100;
+
+RmtJobQueue MainWindow::job_queue_;
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
@@ -71,9 +76,12 @@ MainWindow::MainWindow(QWidget* parent)
     , exit_action_(nullptr)
     , help_action_(nullptr)
     , about_action_(nullptr)
+    , cancel_action_(nullptr)
     , help_menu_(nullptr)
     , recent_traces_menu_(nullptr)
     , file_load_animation_(nullptr)
+    , animation_progress_(nullptr)
+    , progress_timer_(nullptr)
     , navigation_bar_(this)
 {
     const bool loaded_settings = RMVSettings::Get().LoadSettings();
@@ -99,6 +107,7 @@ MainWindow::MainWindow(QWidget* parent)
     BasePane* resource_list_pane                 = CreatePane<ResourceListPane>();
     BasePane* resource_details_pane              = CreatePane<ResourceDetailsPane>();
     BasePane* device_configuration_pane          = CreatePane<DeviceConfigurationPane>();
+    BasePane* leak_trend_pane                    = CreatePane<LeakTrendPane>();
     BasePane* allocation_explorer_pane           = CreatePane<AllocationExplorerPane>();
     BasePane* heap_overview_pane                 = CreatePane<HeapOverviewPane>();
     snapshot_delta_pane_                         = CreatePane<SnapshotDeltaPane>();
@@ -115,6 +124,7 @@ MainWindow::MainWindow(QWidget* parent)
     ui_->start_stack_->addWidget(about_pane);
     ui_->timeline_stack_->addWidget(timeline_pane_);
     ui_->timeline_stack_->addWidget(device_configuration_pane);
+    ui_->timeline_stack_->addWidget(leak_trend_pane);
     ui_->snapshot_stack_->addWidget(heap_overview_pane);
     ui_->snapshot_stack_->addWidget(resource_overview_pane);
     ui_->snapshot_stack_->addWidget(allocation_overview_pane);
@@ -135,6 +145,9 @@ MainWindow::MainWindow(QWidget* parent)
     CreateActions();
     CreateMenus();
 
+    progress_timer_ = new QTimer(this);
+    connect(progress_timer_, &QTimer::timeout, this, &MainWindow::UpdateAnimationProgress);
+
     ResetUI();
 
     rmv::widget_util::InitSingleSelectComboBox(this, ui_->snapshot_combo_box_, "Snapshot", false);
@@ -293,6 +306,7 @@ void MainWindow::CreateActions()
     SetupHotkeyNavAction(signal_mapper, rmv::kGotoRecentSnapshotsPane, rmv::kPaneStartRecentTraces);
     SetupHotkeyNavAction(signal_mapper, rmv::kGotoGenerateSnapshotPane, rmv::kPaneTimelineGenerateSnapshot);
     SetupHotkeyNavAction(signal_mapper, rmv::kGotoDeviceConfigurationPane, rmv::kPaneTimelineDeviceConfiguration);
+    SetupHotkeyNavAction(signal_mapper, rmv::kGotoLeakTrendPane, rmv::kPaneTimelineLeakTrend);
     SetupHotkeyNavAction(signal_mapper, rmv::kGotoHeapOverviewPane, rmv::kPaneSnapshotHeapOverview);
     SetupHotkeyNavAction(signal_mapper, rmv::kGotoResourceOverviewPane, rmv::kPaneSnapshotResourceOverview);
     SetupHotkeyNavAction(signal_mapper, rmv::kGotoAllocationOverviewPane, rmv::kPaneSnapshotAllocationOverview);
@@ -330,6 +344,15 @@ void MainWindow::CreateActions()
     connect(shortcut, &QAction::triggered, this, &MainWindow::CycleTimeUnits);
     this->addAction(shortcut);
 
+    // Set up cancelling the loading animation. Only enabled while the animation is shown, so the key is left for the
+    // panes the rest of the time.
+    cancel_action_ = new QAction(this);
+    cancel_action_->setShortcut(rmv::kKeyCancelLoading);
+    cancel_action_->setEnabled(false);
+
+    connect(cancel_action_, &QAction::triggered, this, &MainWindow::CancelAnimation);
+    this->addAction(cancel_action_);
+
     open_trace_action_ = new QAction(tr("Open trace"), this);
     open_trace_action_->setShortcut(Qt::CTRL | Qt::Key_O);
     connect(open_trace_action_, &QAction::triggered, this, &MainWindow::OpenTrace);
@@ -433,7 +456,7 @@ void MainWindow::LoadTrace(const QString& trace_file)
 
             if (success)
             {
-                StartAnimation(ui_->main_tab_widget_, ui_->main_tab_widget_->TabHeight());
+                StartAnimation(ui_->main_tab_widget_, ui_->main_tab_widget_->TabHeight(), trace_manager.GetLoadProgress());
             }
         }
         else
@@ -459,12 +482,21 @@ void MainWindow::TraceLoadComplete()
     SetupRecentTracesMenu();
 
     UpdateTitlebar();
+
+    LogJobQueueStatistics();
 }
 
-void MainWindow::StartAnimation(QWidget* parent, int height_offset)
+void MainWindow::StartAnimation(QWidget* parent, int height_offset, RmtProgress* progress)
 {
     if (file_load_animation_ == nullptr)
     {
+        animation_progress_ = progress;
+        if (animation_progress_ != nullptr)
+        {
+            cancel_action_->setEnabled(true);
+            progress_timer_->start(kProgressUpdateInterval);
+        }
+
         file_load_animation_ = new FileLoadingWidget(parent);
 
         // Set overall size of the widget to cover the tab contents.
@@ -493,6 +525,12 @@ void MainWindow::StopAnimation()
         delete file_load_animation_;
         file_load_animation_ = nullptr;
 
+        animation_progress_ = nullptr;
+        cancel_action_->setEnabled(false);
+        progress_timer_->stop();
+        statusBar()->clearMessage();
+        statusBar()->hide();
+
         ui_->main_tab_widget_->setEnabled(true);
         file_menu_->setEnabled(true);
 
@@ -500,6 +538,27 @@ void MainWindow::StopAnimation()
     }
 }
 
+void MainWindow::UpdateAnimationProgress()
+{
+    if (animation_progress_ != nullptr)
+    {
+        const int     percentage = static_cast<int>(RmtProgressGetFraction(animation_progress_) * 100.0F);
+        const QString rate       = rmv::string_util::LocalizedValue(static_cast<int64_t>(RmtProgressGetTokensPerSecond(animation_progress_)));
+        statusBar()->showMessage(rmv::text::kLoadingProgress.arg(percentage).arg(rate));
+        statusBar()->show();
+    }
+}
+
+void MainWindow::CancelAnimation()
+{
+    if (animation_progress_ != nullptr)
+    {
+        // The work stops the next time it reports its progress, then finishes as usual.
+        RmtProgressCancel(animation_progress_);
+        cancel_action_->setEnabled(false);
+    }
+}
+
 void MainWindow::resizeEvent(QResizeEvent* event)
 {
     QWidget::resizeEvent(event);
@@ -544,6 +603,7 @@ void MainWindow::OpenTrace()
 
 void MainWindow::CloseTrace()
 {
+    pane_manager_.OnTraceClosing();
     TraceManager::Get().ClearTrace();
 
     BroadcastOnTraceClose();
@@ -601,6 +661,8 @@ void MainWindow::OpenAboutPane()
 
 void MainWindow::CloseRmv()
 {
+    // Stop any trace still loading rather than waiting for it to finish.
+    TraceManager::Get().CancelTraceLoad();
     CloseTrace();
 #if RMV_DEBUG_WINDOW
     debug_window_.close();
@@ -870,6 +932,7 @@ void MainWindow::OpenSnapshot(RmtSnapshotPoint* snapshot_point)
         UpdateCompares();
 
         pane_manager_.OpenSnapshot(snapshot_point->cached_snapshot);
+        SnapshotManager::Get().SnapshotsOpened(snapshot_point, nullptr);
 
         UpdateTitlebar();
         UpdateSnapshotCombobox(snapshot_point);
@@ -909,6 +972,7 @@ void MainWindow::CompareSnapshot(RmtSnapshotPoint* snapshot_base, RmtSnapshotPoi
     else
     {
         TraceManager::Get().SetComparedSnapshot(snapshot_base->cached_snapshot, snapshot_diff->cached_snapshot);
+        SnapshotManager::Get().SnapshotsOpened(snapshot_base, snapshot_diff);
 
         UpdateCompares();
 
@@ -993,10 +1057,38 @@ void MainWindow::BroadcastChangeColoring()
 
 void MainWindow::InitializeJobQueue()
 {
-    const RmtErrorCode error_code = RmtJobQueueInitialize(&job_queue_, kThreadCount);
+    // One worker per hardware thread. Threads waiting on the queue also run jobs, so
+    // the GUI and loading threads don't need workers of their own.
+    const RmtErrorCode error_code = RmtJobQueueInitialize(&job_queue_, RMT_JOB_QUEUE_DEFAULT_WORKER_THREAD_COUNT);
     RMT_ASSERT(error_code == RMT_OK);
 }
 
+void MainWindow::LogJobQueueStatistics()
+{
+    const double clock_frequency = static_cast<double>(RmtGetClockFrequency());
+
+    for (int32_t worker_index = 0; worker_index < job_queue_.worker_thread_count; ++worker_index)
+    {
+        RmtJobQueueWorkerStatistics statistics = {};
+        if (RmtJobQueueGetWorkerStatistics(&job_queue_, worker_index, &statistics) != RMT_OK)
+        {
+            continue;
+        }
+
+        const double utilization = (statistics.elapsed_time > 0) ? (100.0 * statistics.busy_time) / statistics.elapsed_time : 0.0;
+        DebugWindow::DbgMsg("Job worker %d (NUMA node %d): %.1f%% busy over %.2fs, %llu jobs (%llu stolen), %llu batches, %llu indices, %llu parks",
+                            worker_index,
+                            statistics.numa_node,
+                            utilization,
+                            statistics.elapsed_time / clock_frequency,
+                            static_cast<unsigned long long>(statistics.job_count),
+                            static_cast<unsigned long long>(statistics.steal_count),
+                            static_cast<unsigned long long>(statistics.batch_count),
+                            static_cast<unsigned long long>(statistics.index_count),
+                            static_cast<unsigned long long>(statistics.park_count));
+    }
+}
+
 RmtJobQueue* MainWindow::GetJobQueue()
 {
     return &job_queue_;
@@ -12,6 +12,7 @@
 #include <QAction>
 #include <QMenu>
 #include <QSignalMapper>
+#include <QTimer>
 
 #include "qt_common/custom_widgets/file_loading_widget.h"
 #include "qt_common/custom_widgets/navigation_bar.h"
@@ -20,6 +21,7 @@
 #include "rmt_data_set.h"
 #include "rmt_resource_list.h"
 #include "rmt_job_system.h"
+#include "rmt_progress.h"
 
 #include "models/trace_manager.h"
 #include "util/definitions.h"
@@ -89,10 +91,15 @@ public:
     /// Destroy the job queue.
     static void DestroyJobQueue();
 
+    /// Write the utilization counters of each job queue worker thread to the debug window.
+    static void LogJobQueueStatistics();
+
     /// Called when an animation needs to be loaded onto a window.
     /// \param parent The parent window.
     /// \param height_offset The offset from the top of the parent widget.
-    void StartAnimation(QWidget* parent, int height_offset);
+    /// \param progress The progress of the work being waited for, or nullptr if it doesn't report any. The work can be
+    /// cancelled through it while the animation is shown. It must stay valid until StopAnimation() is called.
+    void StartAnimation(QWidget* parent, int height_offset, RmtProgress* progress = nullptr);
 
     /// Called when trace file changed to stop animation.
     void StopAnimation();
@@ -192,6 +199,12 @@ private slots:
     /// \param pane The pane to jump to.
     void ViewPane(int pane);
 
+    /// Show the progress of the work the loading animation is waiting for.
+    void UpdateAnimationProgress();
+
+    /// Cancel the work the loading animation is waiting for.
+    void CancelAnimation();
+
 private:
     /// Let all panes know a pane switch happened.
     void BroadcastPaneSwitched();
@@ -268,6 +281,7 @@ private:
     QAction* exit_action_;         ///< Action to exit RMV.
     QAction* help_action_;         ///< Action to display help.
     QAction* about_action_;        ///< Action to display About Radeon Memory Visualizer.
+    QAction* cancel_action_;       ///< Action to cancel the work the loading animation is waiting for.
 
     QMenu* help_menu_;  ///< Help menu control
 
@@ -276,6 +290,8 @@ private:
     QVector<QAction*>       recent_trace_actions_;  ///< List of actions for recent traces.
 
     FileLoadingWidget* file_load_animation_;  ///< Widget to show animation.
+    RmtProgress*       animation_progress_;   ///< The progress of the work the animation is waiting for.
+    QTimer*            progress_timer_;       ///< Timer to update the progress shown with the animation.
 
     WelcomePane*      welcome_pane_;        ///< Pointer to welcome pane.
     RecentTracesPane* recent_traces_pane_;  ///< Pointer to recent traces pane.
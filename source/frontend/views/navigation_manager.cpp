@@ -251,6 +251,9 @@ namespace rmv
         case kPaneTimelineDeviceConfiguration:
             out = "Device configuration";
             break;
+        case kPaneTimelineLeakTrend:
+            out = "Leak trend";
+            break;
         case kPaneSnapshotResourceOverview:
             out = "Resource overview";
             break;
@@ -26,6 +26,7 @@ namespace rmv
     {
         kTimelinePaneGenerateSnapshot,
         kTimelinePaneDeviceConfiguration,
+        kTimelinePaneLeakTrend,
 
         kTimelinePaneCount,
     };
@@ -74,6 +75,7 @@ namespace rmv
 
         {kPaneTimelineGenerateSnapshot, (kMainPaneTimeline << kShift) | kTimelinePaneGenerateSnapshot},
         {kPaneTimelineDeviceConfiguration, (kMainPaneTimeline << kShift) | kTimelinePaneDeviceConfiguration},
+        {kPaneTimelineLeakTrend, (kMainPaneTimeline << kShift) | kTimelinePaneLeakTrend},
 
         {kPaneSnapshotHeapOverview, (kMainPaneSnapshot << kShift) | kSnapshotPaneHeapOverview},
         {kPaneSnapshotResourceOverview, (kMainPaneSnapshot << kShift) | kSnapshotPaneResourceOverview},
@@ -317,6 +319,17 @@ namespace rmv
         panes_.push_back(pane);
     }
 
+    void PaneManager::OnTraceClosing()
+    {
+        for (auto it = panes_.begin(); it != panes_.end(); ++it)
+        {
+            if ((*it) != nullptr)
+            {
+                (*it)->OnTraceClosing();
+            }
+        }
+    }
+
     void PaneManager::OnTraceClose()
     {
         for (auto it = panes_.begin(); it != panes_.end(); ++it)
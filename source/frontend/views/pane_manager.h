@@ -51,6 +51,7 @@ namespace rmv
         kPaneStartAbout,
         kPaneTimelineGenerateSnapshot,
         kPaneTimelineDeviceConfiguration,
+        kPaneTimelineLeakTrend,
         kPaneSnapshotHeapOverview,
         kPaneSnapshotResourceOverview,
         kPaneSnapshotAllocationOverview,
@@ -67,6 +68,7 @@ namespace rmv
     /// Hotkeys.
     static const int kGotoGenerateSnapshotPane    = Qt::Key_F;
     static const int kGotoDeviceConfigurationPane = Qt::Key_G;
+    static const int kGotoLeakTrendPane           = Qt::Key_H;
     static const int kGotoHeapOverviewPane        = Qt::Key_Q;
     static const int kGotoResourceOverviewPane    = Qt::Key_W;
     static const int kGotoAllocationOverviewPane  = Qt::Key_E;
@@ -83,6 +85,7 @@ namespace rmv
     static const int kKeyNavForwardArrow          = Qt::Key_Right;
     static const int kKeyNavUpArrow               = Qt::Key_Up;
     static const int kKeyNavDownArrow             = Qt::Key_Down;
+    static const int kKeyCancelLoading            = Qt::Key_Escape;
 
     /// Class to manage the panes and navigating betweem them.
     class PaneManager : public QObject
@@ -132,6 +135,9 @@ namespace rmv
         /// \param pane The pane to add.
         void AddPane(BasePane* pane);
 
+        /// Call OnTraceClosing() for all panes.
+        void OnTraceClosing();
+
         /// Call OnTraceClose() for all panes.
         void OnTraceClose();
 
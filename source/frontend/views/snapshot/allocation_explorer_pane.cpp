@@ -61,7 +61,7 @@ AllocationExplorerPane::AllocationExplorerPane(QWidget* parent)
     colorizer_ = new Colorizer();
 
     allocation_scene_ = new QGraphicsScene;
-    allocation_item_  = new RMVAllocationBar(model_->GetAllocationBarModel(), 0, kAllocationModelIndex, colorizer_);
+    allocation_item_  = new RMVAllocationBar(model_->GetAllocationBarModel(), 0, kAllocationModelIndex, colorizer_, nullptr);
     allocation_scene_->addItem(allocation_item_);
     ui_->memory_block_view_->setScene(allocation_scene_);
 
@@ -106,6 +106,7 @@ AllocationExplorerPane::AllocationExplorerPane(QWidget* parent)
     // set up a connection between the tables being sorted and making sure the selected event is visible
     connect(model_->GetAllocationProxyModel(), &rmv::ResourceProxyModel::layoutChanged, this, &AllocationExplorerPane::ScrollToSelectedAllocation);
     connect(model_->GetResourceProxyModel(), &rmv::ResourceProxyModel::layoutChanged, this, &AllocationExplorerPane::ScrollToSelectedResource);
+    connect(model_->GetResourceProxyModel(), &rmv::ResourceProxyModel::modelReset, this, [=]() { SetMaximumResourceTableHeight(); });
 
     connect(allocation_item_, &RMVAllocationBar::ResourceSelected, this, &AllocationExplorerPane::SelectedResource);
 
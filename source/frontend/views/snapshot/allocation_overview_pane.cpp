@@ -29,14 +29,10 @@
 #include "views/pane_manager.h"
 #include "views/colorizer.h"
 #include "views/custom_widgets/rmv_allocation_bar.h"
+#include "views/custom_widgets/rmv_allocation_bar_cache.h"
 
-// The number of graphic objects in the scene to show allocations. It's inefficient to
-// have one graphics object per allocation, particularly when there are thousands of
-// allocations. Instead, the graphic objects are positioned in the currently visible
-// area of the scene. Rather than each graphic object having a fixed allocation index,
-// an offset is added to each allocation depending on where the visible region of the
-// scene is.
-static const int32_t kMaxAllocationObjects = 100;
+// The total size of the allocation bar strips kept in the cache. Enough for a few screens of bars at 4K.
+static const int32_t kStripCacheSize = 128 * 1024 * 1024;
 
 // Enum for the number of allocation models needed. For this pane, one model is needed for all
 // allocations shown in the table.
@@ -131,7 +127,8 @@ AllocationOverviewPane::AllocationOverviewPane(QWidget* parent)
     allocation_list_scene_ = new QGraphicsScene();
     ui_->allocation_list_view_->setScene(allocation_list_scene_);
 
-    colorizer_ = new Colorizer();
+    colorizer_   = new Colorizer();
+    strip_cache_ = new RMVAllocationBarCache(kStripCacheSize);
 
     // Set up a list of required coloring modes, in order
     // The list is terminated with COLOR_MODE_COUNT
@@ -182,6 +179,7 @@ AllocationOverviewPane::~AllocationOverviewPane()
     delete model_;
     delete preferred_heap_combo_box_model_;
     delete colorizer_;
+    delete strip_cache_;
 }
 
 void AllocationOverviewPane::OnTraceClose()
@@ -189,6 +187,7 @@ void AllocationOverviewPane::OnTraceClose()
     model_->ResetModelValues();
     allocation_graphic_objects_.clear();
     allocation_list_scene_->clear();
+    strip_cache_->Clear();
     preferred_heap_combo_box_model_->ResetHeapComboBox(ui_->preferred_heap_combo_box_);
 }
 
@@ -211,6 +210,7 @@ void AllocationOverviewPane::Reset()
 
 void AllocationOverviewPane::ChangeColoring()
 {
+    strip_cache_->Clear();
     colorizer_->UpdateLegends();
     ResizeItems();
 }
@@ -232,7 +232,8 @@ void AllocationOverviewPane::OpenSnapshot(RmtDataSnapshot* snapshot)
 
         if (snapshot->virtual_allocation_list.allocation_count > 0)
         {
-            // remove any old allocations from the last snapshot and disconnect any connections
+            // remove any old allocations from the last snapshot and disconnect any connections. The items needed to fill
+            // the view are added back by ResizeItems().
             size_t current_size = allocation_graphic_objects_.size();
             for (size_t i = 0; i < current_size; i++)
             {
@@ -241,18 +242,9 @@ void AllocationOverviewPane::OpenSnapshot(RmtDataSnapshot* snapshot)
             }
             allocation_graphic_objects_.clear();
             allocation_list_scene_->clear();
+            strip_cache_->Clear();
 
-            // add the graphics items to the scene, one item per allocation
-            int32_t count = std::min<int>(kMaxAllocationObjects, snapshot->virtual_allocation_list.allocation_count);
-            for (int i = 0; i < count; i++)
-            {
-                RMVAllocationBar* allocation_item = new RMVAllocationBar(model_->GetAllocationBarModel(), i, kAllocationModelIndex, colorizer_);
-                allocation_list_scene_->addItem(allocation_item);
-                allocation_graphic_objects_.push_back(allocation_item);
-                connect(allocation_item, &RMVAllocationBar::ResourceSelected, this, &AllocationOverviewPane::SelectedResource);
-            }
-
-            // Apply filters and sorting to the newly added items
+            // Apply filters and sorting to the allocations
             ApplyFilters();
             ApplySort();
         }
@@ -315,6 +307,10 @@ void AllocationOverviewPane::ResizeItems()
     const int scrollbar_width = qApp->style()->pixelMetric(QStyle::PM_ScrollBarExtent);
     const int view_width      = ui_->allocation_list_view_->width() - scrollbar_width - 2;
 
+    // Only keep enough items to fill the view, including the partly visible allocations at the top and bottom.
+    const size_t visible_count = (ui_->allocation_list_view_->viewport()->height() / allocation_height_) + 2;
+    SetAllocationObjectCount(std::min(visible_count, model_->GetViewableAllocationCount()));
+
     const size_t num_objects = allocation_graphic_objects_.size();
 
     for (size_t current_allocation_graphic_object_index = 0; current_allocation_graphic_object_index < num_objects; current_allocation_graphic_object_index++)
@@ -343,7 +339,28 @@ void AllocationOverviewPane::ApplyFilters()
     // instead it changes the underlying objects that are referenced by the items in the scene.
     model_->ApplyFilters(ui_->search_box_->text(), &heaps[0]);
 
-    UpdateAllocationListSceneRect();
+    ResizeItems();
+}
+
+void AllocationOverviewPane::SetAllocationObjectCount(size_t count)
+{
+    while (allocation_graphic_objects_.size() < count)
+    {
+        const int32_t     allocation_index = static_cast<int32_t>(allocation_graphic_objects_.size());
+        RMVAllocationBar* allocation_item =
+            new RMVAllocationBar(model_->GetAllocationBarModel(), allocation_index, kAllocationModelIndex, colorizer_, strip_cache_);
+        allocation_list_scene_->addItem(allocation_item);
+        allocation_graphic_objects_.push_back(allocation_item);
+        connect(allocation_item, &RMVAllocationBar::ResourceSelected, this, &AllocationOverviewPane::SelectedResource);
+    }
+
+    while (allocation_graphic_objects_.size() > count)
+    {
+        RMVAllocationBar* allocation_item = allocation_graphic_objects_.back();
+        allocation_graphic_objects_.pop_back();
+        allocation_list_scene_->removeItem(allocation_item);
+        delete allocation_item;
+    }
 }
 
 // Update the scene rect of the allocationListView.
@@ -444,6 +461,8 @@ void AllocationOverviewPane::HeapChanged(bool checked)
 
 void AllocationOverviewPane::OnScaleFactorChanged()
 {
+    // The border widths in the cached strips depend on the scale factor.
+    strip_cache_->Clear();
     ResizeItems();
 }
 
@@ -19,6 +19,7 @@
 #include "views/base_pane.h"
 #include "views/colorizer.h"
 #include "views/custom_widgets/rmv_allocation_bar.h"
+#include "views/custom_widgets/rmv_allocation_bar_cache.h"
 
 /// Class declaration.
 class AllocationOverviewPane : public BasePane
@@ -103,6 +104,11 @@ private:
     /// Update the scene rect of the allocationListView.
     void UpdateAllocationListSceneRect();
 
+    /// Add or remove allocation items so there are just enough to fill the view. The items are reused for different
+    /// allocations as the view is scrolled.
+    /// \param count The number of items needed.
+    void SetAllocationObjectCount(size_t count);
+
     Ui::allocation_overview_pane* ui_;  ///< Pointer to the Qt UI design.
 
     rmv::AllocationOverviewModel*  model_;                           ///< Container class for the widget models.
@@ -110,6 +116,7 @@ private:
     QGraphicsScene*                allocation_list_scene_;           ///< Scene containing all allocation widgets.
     std::vector<RMVAllocationBar*> allocation_graphic_objects_;      ///< The list of allocation objects.
     Colorizer*                     colorizer_;                       ///< The colorizer used by the 'color by' combo box.
+    RMVAllocationBarCache*         strip_cache_;                     ///< The rasterized allocation bars shared by the allocation items.
     int                            allocation_height_;               ///< The allocation height.
 };
 
@@ -46,7 +46,7 @@ public:
     /// Worker thread function
     virtual void ThreadFunc()
     {
-        model_->GenerateResourceHistory(resource_identifier_);
+        model_->GenerateResourceHistory(resource_identifier_, GetProgress());
     }
 
 private:
@@ -74,6 +74,12 @@ ResourceListPane::ResourceListPane(QWidget* parent)
     // set up a connection between the timeline being sorted and making sure the selected event is visible
     connect(model_->GetResourceProxyModel(), &rmv::ResourceProxyModel::layoutChanged, this, &ResourceListPane::ScrollToSelectedResource);
 
+    // the rows are filled in the background, so select the resource again once they arrive
+    connect(model_->GetResourceProxyModel(), &rmv::ResourceProxyModel::modelReset, this, [=]() {
+        SetMaximumResourceTableHeight();
+        SelectResourceInTable();
+    });
+
     connect(&MessageManager::Get(), &MessageManager::ResourceSelected, this, &ResourceListPane::SelectResource);
     connect(&ScalingManager::Get(), &ScalingManager::ScaleFactorChanged, this, &ResourceListPane::OnScaleFactorChanged);
 }
@@ -221,6 +221,12 @@ void ResourceOverviewPane::Reset()
     UpdateDetailsTitle();
 }
 
+void ResourceOverviewPane::OnTraceClosing()
+{
+    // Stop the tree map layout job before the snapshot it is reading is freed.
+    ui_->tree_map_view_->Reset();
+}
+
 void ResourceOverviewPane::ChangeColoring()
 {
     ui_->tree_map_view_->UpdateColorCache();
@@ -409,7 +415,7 @@ void ResourceOverviewPane::UpdateDetailsTitle()
     }
     else
     {
-        ui_->resource_name_label_->setText(selected_resource_->name);
+        ui_->resource_name_label_->setText(RmtResourceGetDetails(selected_resource_)->name);
 
         if (ui_->resource_details_checkbox_->isChecked())
         {
@@ -417,7 +423,7 @@ void ResourceOverviewPane::UpdateDetailsTitle()
         }
         else
         {
-            ui_->resource_name_label_minimized_->setText(selected_resource_->name);
+            ui_->resource_name_label_minimized_->setText(RmtResourceGetDetails(selected_resource_)->name);
         }
     }
 }
@@ -44,6 +44,9 @@ public:
     /// Reset UI state.
     virtual void Reset() Q_DECL_OVERRIDE;
 
+    /// Trace about to be closed.
+    virtual void OnTraceClosing() Q_DECL_OVERRIDE;
+
     /// Update UI coloring.
     virtual void ChangeColoring() Q_DECL_OVERRIDE;
 
@@ -0,0 +1,83 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief  Implementation of RMV's leak trend pane.
+//=============================================================================
+
+#include "views/timeline/leak_trend_pane.h"
+
+#include <QHeaderView>
+
+#include "util/widget_util.h"
+
+LeakTrendPane::LeakTrendPane(QWidget* parent)
+    : BasePane(parent)
+    , ui_(new Ui::LeakTrendPane)
+{
+    ui_->setupUi(this);
+
+    // Set white background for this pane
+    rmv::widget_util::SetWidgetBackgroundColor(this, Qt::white);
+
+    model_ = new rmv::LeakTrendModel();
+
+    model_->InitializeModel(ui_->content_snapshot_count_, rmv::kLeakTrendSnapshotCount, "text");
+    model_->InitializeModel(ui_->content_surviving_resources_, rmv::kLeakTrendSurvivingResources, "text");
+    model_->InitializeModel(ui_->content_surviving_size_, rmv::kLeakTrendSurvivingSize, "text");
+    model_->InitializeModel(ui_->content_growing_from_, rmv::kLeakTrendGrowingFrom, "text");
+
+    model_->InitializePointTableModel(ui_->point_table_view_, 0, 0);
+    model_->InitializeResourceTableModel(ui_->resource_table_view_, 0, 0);
+
+    ui_->point_table_view_->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeMode::ResizeToContents);
+    ui_->point_table_view_->horizontalHeader()->setStretchLastSection(true);
+    ui_->point_table_view_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui_->point_table_view_->setSelectionMode(QAbstractItemView::SingleSelection);
+    ui_->resource_table_view_->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeMode::ResizeToContents);
+    ui_->resource_table_view_->horizontalHeader()->setStretchLastSection(true);
+
+    connect(ui_->point_table_view_, &QTableView::clicked, this, &LeakTrendPane::PointSelected);
+    connect(model_, &rmv::LeakTrendModel::TrendReady, this, &LeakTrendPane::TrendReady);
+}
+
+LeakTrendPane::~LeakTrendPane()
+{
+    delete ui_;
+    delete model_;
+}
+
+void LeakTrendPane::showEvent(QShowEvent* event)
+{
+    Refresh();
+    QWidget::showEvent(event);
+}
+
+void LeakTrendPane::Refresh()
+{
+    model_->Update();
+}
+
+void LeakTrendPane::Reset()
+{
+    model_->ResetModelValues();
+}
+
+void LeakTrendPane::OnTraceClosing()
+{
+    // Stop generating the trend before the data set it is replaying is freed.
+    model_->CancelTrend();
+}
+
+void LeakTrendPane::TrendReady()
+{
+    ui_->point_table_view_->selectRow(0);
+}
+
+void LeakTrendPane::PointSelected(const QModelIndex& index)
+{
+    if (index.isValid())
+    {
+        model_->UpdateResourceTable(index.row());
+    }
+}
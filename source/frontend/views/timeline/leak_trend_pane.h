@@ -0,0 +1,56 @@
+//=============================================================================
+/// Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+/// \brief Header for RMV's leak trend pane.
+//=============================================================================
+
+#ifndef RMV_VIEWS_TIMELINE_LEAK_TREND_PANE_H_
+#define RMV_VIEWS_TIMELINE_LEAK_TREND_PANE_H_
+
+#include "ui_leak_trend_pane.h"
+
+#include <QWidget>
+
+#include "models/timeline/leak_trend_model.h"
+#include "views/base_pane.h"
+
+class LeakTrendPane : public BasePane
+{
+    Q_OBJECT
+
+public:
+    /// Constructor.
+    /// \param parent The widget's parent.
+    explicit LeakTrendPane(QWidget* parent = nullptr);
+
+    /// Destructor.
+    ~LeakTrendPane();
+
+    /// Overridden Qt show event. Fired when this pane is opened.
+    /// \param event The show event object.
+    virtual void showEvent(QShowEvent* event) Q_DECL_OVERRIDE;
+
+    /// Reset UI state.
+    virtual void Reset() Q_DECL_OVERRIDE;
+
+    /// Trace about to be closed.
+    virtual void OnTraceClosing() Q_DECL_OVERRIDE;
+
+private slots:
+    /// Slot to handle what happens when a snapshot point in the table is clicked.
+    /// \param index The model index of the clicked row.
+    void PointSelected(const QModelIndex& index);
+
+    /// Slot to select the first snapshot point once the trend has been generated.
+    void TrendReady();
+
+private:
+    /// Refresh the UI.
+    void Refresh();
+
+    Ui::LeakTrendPane*   ui_;     ///< Pointer to the Qt UI design.
+    rmv::LeakTrendModel* model_;  ///< The model for this pane.
+};
+
+#endif  // RMV_VIEWS_TIMELINE_LEAK_TREND_PANE_H_
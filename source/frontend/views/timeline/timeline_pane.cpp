@@ -269,6 +269,12 @@ void TimelinePane::UpdateSnapshotMarkers()
     ui_->timeline_view_->SelectSnapshot(snapshot_point);
 }
 
+void TimelinePane::OnTraceClosing()
+{
+    // Stop prefetching the memory graph before the timeline it is reading is freed.
+    model_->ResetMemoryGraph();
+}
+
 void TimelinePane::OnTraceClose()
 {
     // reset the timeline type combo back to default
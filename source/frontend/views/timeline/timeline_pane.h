@@ -68,6 +68,9 @@ public:
 
     // Handlers from BasePane
 
+    /// Trace about to be closed.
+    virtual void OnTraceClosing() Q_DECL_OVERRIDE;
+
     /// Clean up.
     virtual void OnTraceClose() Q_DECL_OVERRIDE;
 
@@ -24,7 +24,7 @@ errno_t fopen_s(FILE** file, const char* filename, const char* mode)
 
     *file = fopen(filename, mode);
 
-    if (*file)
+    if (*file == nullptr)
     {
         return errno;
     }
@@ -77,6 +77,9 @@
 /// The operation failed because a file was already opened.
 #define RMT_ERROR_FILE_ALREADY_OPENED (0x80000013)
 
+/// The operation was cancelled before it completed.
+#define RMT_ERROR_CANCELLED (0x80000014)
+
 /// Helper macro to return error code y from a function when a specific condition, x, is not met.
 #define RMT_RETURN_ON_ERROR(x, y) \
     if (!(x))                     \